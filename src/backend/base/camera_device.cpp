@@ -7,6 +7,7 @@ namespace bias
     { 
         connected_ = false; 
         capturing_ = false; 
+        rawOutput_ = false;
     }
 
 
@@ -15,6 +16,7 @@ namespace bias
         guid_ = guid;
         connected_ = false;
         capturing_ = false;
+        rawOutput_ = false;
     }
 
 
@@ -56,6 +58,24 @@ namespace bias
     }
 
 
+    void CameraDevice::setRawOutput(bool value)
+    {
+        rawOutput_ = value;
+    }
+
+
+    bool CameraDevice::getRawOutput()
+    {
+        return rawOutput_;
+    }
+
+
+    BayerPattern CameraDevice::getBayerPattern()
+    {
+        return BAYER_PATTERN_NONE;
+    }
+
+
     bool CameraDevice::isSupported(VideoMode vidMode, FrameRate frmRate)
     {
         return false;
@@ -34,6 +34,12 @@ namespace bias
             virtual bool isConnected(); 
             virtual bool isCapturing();
             virtual bool isColor(); 
+
+            // Raw output - color cameras deliver the undemosaiced Bayer 
+            // image (single channel) when supported by the backend.
+            virtual void setRawOutput(bool value);
+            virtual bool getRawOutput();
+            virtual BayerPattern getBayerPattern();
             virtual bool isSupported(VideoMode vidMode, FrameRate frmRate);
             virtual bool isSupported(ImageMode imgMode);
             virtual unsigned int getNumberOfImageMode();
@@ -80,6 +86,7 @@ namespace bias
             Guid guid_;
             bool connected_;
             bool capturing_;
+            bool rawOutput_;
     };
 
     typedef std::shared_ptr<CameraDevice> CameraDevicePtr;
@@ -313,6 +313,12 @@ namespace bias {
         return bool(cameraInfo_.isColorCamera);
     } 
 
+
+    BayerPattern CameraDevice_fc2::getBayerPattern()
+    {
+        return convertBayerTileFormat_from_fc2(cameraInfo_.bayerTileFormat);
+    }
+
     
     VideoMode CameraDevice_fc2::getVideoMode() 
     {
@@ -1051,6 +1057,12 @@ namespace bias {
         // Convert image to suitable format 
         fc2PixelFormat convertedFormat = getSuitablePixelFormat(rawImage_.format);
 
+        // Raw output - leave 16 bit Bayer images undemosaiced 
+        if (rawOutput_ && (rawImage_.format == FC2_PIXEL_FORMAT_RAW16))
+        {
+            convertedFormat = FC2_PIXEL_FORMAT_RAW16;
+        }
+
         if (rawImage_.format != convertedFormat)
         {
             useConverted_ = true;
@@ -1444,7 +1456,22 @@ namespace bias {
         fc2PixelFormat pixelFormat;
         bool havePixelFormat = false;
 
-        if (isColor())
+        if (isColor() && rawOutput_)
+        {
+            // Raw output requested - use the Bayer format and demosaic later
+            if (format7Info.pixelFormatBitField & FC2_PIXEL_FORMAT_RAW8)
+            {
+                pixelFormat = FC2_PIXEL_FORMAT_RAW8;
+                havePixelFormat = true;
+            }
+            else if (format7Info.pixelFormatBitField & FC2_PIXEL_FORMAT_RAW16)
+            {
+                pixelFormat = FC2_PIXEL_FORMAT_RAW16;
+                havePixelFormat = true;
+            }
+        }
+
+        if (isColor() && !havePixelFormat)
         {
             // Camera is color - try to find a suitable color format
             //
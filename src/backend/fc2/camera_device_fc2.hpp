@@ -36,6 +36,7 @@ namespace bias {
             virtual void grabImage(cv::Mat &image);
 
             virtual bool isColor();
+            virtual BayerPattern getBayerPattern();
             virtual bool isSupported(VideoMode vidMode, FrameRate frmRate);
             virtual bool isSupported(ImageMode imgMode);
             virtual unsigned int getNumberOfImageMode();
@@ -70,6 +70,7 @@ namespace bias
                 opencvFormat = CV_8UC1;
                 break;
 
+            case FC2_PIXEL_FORMAT_RAW16:
             case FC2_PIXEL_FORMAT_MONO16:
                 opencvFormat = CV_16UC1;
                 break;
@@ -631,6 +632,36 @@ namespace bias
     }
 
 
+    BayerPattern convertBayerTileFormat_from_fc2(fc2BayerTileFormat bayerFormat_fc2)
+    {
+        BayerPattern pattern = BAYER_PATTERN_NONE;
+
+        switch (bayerFormat_fc2)
+        {
+            case FC2_BT_RGGB:
+                pattern = BAYER_PATTERN_RGGB;
+                break;
+
+            case FC2_BT_GRBG:
+                pattern = BAYER_PATTERN_GRBG;
+                break;
+
+            case FC2_BT_GBRG:
+                pattern = BAYER_PATTERN_GBRG;
+                break;
+
+            case FC2_BT_BGGR:
+                pattern = BAYER_PATTERN_BGGR;
+                break;
+
+            default:
+                pattern = BAYER_PATTERN_NONE;
+                break;
+        }
+        return pattern;
+    }
+
+
     Format7Settings convertFormat7Settings_from_fc2(fc2Format7ImageSettings settings_fc2)
     {
         Format7Settings settings;
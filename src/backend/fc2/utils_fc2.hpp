@@ -54,6 +54,8 @@ namespace bias
 
     PixelFormat convertPixelFormat_from_fc2(fc2PixelFormat pixFormat_fc2);
 
+    BayerPattern convertBayerTileFormat_from_fc2(fc2BayerTileFormat bayerFormat_fc2);
+
     Format7Settings convertFormat7Settings_from_fc2(fc2Format7ImageSettings settings_fc2);
 
 
@@ -358,6 +358,24 @@ namespace bias {
         }
 
 
+        spinPixelFormatEnums origPixelFormat = getImagePixelFormat_spin(hSpinImage_);
+
+        // Raw output - pass unpacked Bayer images through undemosaiced
+        int rawOpencvFormat = getBayerOpencvFormat_spin(origPixelFormat);
+        if (rawOutput_ && (rawOpencvFormat != -1))
+        {
+            ImageInfo_spin rawInfo = getImageInfo_spin(hSpinImage_);
+            cv::Mat rawTmp = cv::Mat(
+                    rawInfo.rows+rawInfo.ypad, 
+                    rawInfo.cols+rawInfo.xpad, 
+                    rawOpencvFormat, 
+                    rawInfo.dataPtr, 
+                    rawInfo.stride
+                    );
+            rawTmp.copyTo(image);
+            return;
+        }
+
         spinError err = SPINNAKER_ERR_SUCCESS;
         spinImage hSpinImageConv = nullptr; 
 
@@ -370,7 +388,6 @@ namespace bias {
             throw RuntimeError(ERROR_SPIN_IMAGE_CREATE_EMPTY, ssError.str());
         }
         
-        spinPixelFormatEnums origPixelFormat = getImagePixelFormat_spin(hSpinImage_);
         spinPixelFormatEnums convPixelFormat = getSuitablePixelFormat(origPixelFormat);
         
         err = spinImageConvert(hSpinImage_, convPixelFormat, hSpinImageConv);
@@ -425,6 +442,12 @@ namespace bias {
         return test;
     } 
 
+
+    BayerPattern CameraDevice_spin::getBayerPattern()
+    {
+        return getBayerPattern_spin(getPixelFormat_spin());
+    }
+
     
     VideoMode CameraDevice_spin::getVideoMode() 
     {
@@ -38,6 +38,7 @@ namespace bias {
             virtual void grabImage(cv::Mat &image);
 
             virtual bool isColor();
+            virtual BayerPattern getBayerPattern();
             
             virtual bool isSupported(VideoMode vidMode, FrameRate frmRate);
             virtual bool isSupported(ImageMode imgMode);
@@ -310,6 +310,70 @@ namespace bias
     }
 
 
+    BayerPattern getBayerPattern_spin(spinPixelFormatEnums pixFormat)
+    {
+        BayerPattern pattern = BAYER_PATTERN_NONE;
+
+        switch (pixFormat)
+        {
+            case PixelFormat_BayerRG8:
+            case PixelFormat_BayerRG16:
+                pattern = BAYER_PATTERN_RGGB;
+                break;
+
+            case PixelFormat_BayerGR8:
+            case PixelFormat_BayerGR16:
+                pattern = BAYER_PATTERN_GRBG;
+                break;
+
+            case PixelFormat_BayerGB8:
+            case PixelFormat_BayerGB16:
+                pattern = BAYER_PATTERN_GBRG;
+                break;
+
+            case PixelFormat_BayerBG8:
+            case PixelFormat_BayerBG16:
+                pattern = BAYER_PATTERN_BGGR;
+                break;
+
+            default:
+                pattern = BAYER_PATTERN_NONE;
+                break;
+        }
+        return pattern;
+    }
+
+
+    int getBayerOpencvFormat_spin(spinPixelFormatEnums pixFormat)
+    {
+        // Opencv format for unpacked Bayer images passed through without
+        // conversion. Returns -1 for packed or non-Bayer formats.
+        int opencvFormat = -1;
+
+        switch (pixFormat)
+        {
+            case PixelFormat_BayerRG8:
+            case PixelFormat_BayerGR8:
+            case PixelFormat_BayerGB8:
+            case PixelFormat_BayerBG8:
+                opencvFormat = CV_8UC1;
+                break;
+
+            case PixelFormat_BayerRG16:
+            case PixelFormat_BayerGR16:
+            case PixelFormat_BayerGB16:
+            case PixelFormat_BayerBG16:
+                opencvFormat = CV_16UC1;
+                break;
+
+            default:
+                opencvFormat = -1;
+                break;
+        }
+        return opencvFormat;
+    }
+
+
     static std::map<PixelFormat, spinPixelFormatEnums> pixelFormatMap_to_spin = 
     {
         {PIXEL_FORMAT_MONO8,     PixelFormat_Mono8},
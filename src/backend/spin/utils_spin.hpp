@@ -44,6 +44,10 @@ namespace bias
 
     int getCompatibleOpencvFormat(spinPixelFormatEnums pixFormat);
 
+    BayerPattern getBayerPattern_spin(spinPixelFormatEnums pixFormat);
+
+    int getBayerOpencvFormat_spin(spinPixelFormatEnums pixFormat);
+
     spinPixelFormatEnums convertPixelFormat_to_spin(PixelFormat pixFormat);
 
     PixelFormat convertPixelFormat_from_spin(spinPixelFormatEnums pixFormat_spin);
@@ -200,10 +200,15 @@ namespace bias {
         ERROR_VIDEO_WRITER_INITIALIZE,
         ERROR_VIDEO_WRITER_FINISH,
 
+        // Video Reader Errors
+        ERROR_VIDEO_READER_OPEN,
+        ERROR_VIDEO_READER_READ_FRAME,
+
         // Image Logger Errors
         ERROR_IMAGE_LOGGER_MAX_QUEUE_SIZE,
         ERROR_FRAMES_TODO_MAX_QUEUE_SIZE,
         ERROR_FRAMES_FINISHED_MAX_SET_SIZE,
+        ERROR_FRAMES_DROPPED_AT_FINISH,
 
         // Capture Errors
         ERROR_CAPTURE_MAX_ERROR_COUNT,
@@ -363,6 +368,16 @@ namespace bias {
     typedef std::list<PixelFormat> PixelFormatList;
     typedef std::set<PixelFormat> PixleFormatSet;
 
+    enum BayerPattern
+    {
+        BAYER_PATTERN_NONE,
+        BAYER_PATTERN_RGGB,
+        BAYER_PATTERN_GRBG,
+        BAYER_PATTERN_GBRG,
+        BAYER_PATTERN_BGGR,
+        NUMBER_OF_BAYER_PATTERN,
+    };
+
     enum TriggerType
     {
         TRIGGER_INTERNAL,
@@ -395,6 +410,7 @@ namespace bias {
         VIDEOFILE_FORMAT_AVI,
         VIDEOFILE_FORMAT_FMF,
         VIDEOFILE_FORMAT_UFMF,
+        VIDEOFILE_FORMAT_ZFMF,
         NUMBER_OF_VIDEOFILE_FORMAT,
         VIDEOFILE_FORMAT_UNSPECIFIED,
     };
@@ -131,6 +131,24 @@ namespace bias {
     }
 
 
+    void Camera::setRawOutput(bool value)
+    {
+        cameraDevicePtr_ -> setRawOutput(value);
+    }
+
+
+    bool Camera::getRawOutput()
+    {
+        return cameraDevicePtr_ -> getRawOutput();
+    }
+
+
+    BayerPattern Camera::getBayerPattern()
+    {
+        return cameraDevicePtr_ -> getBayerPattern();
+    }
+
+
     VideoMode Camera::getVideoMode()
     {
         return cameraDevicePtr_ -> getVideoMode();
@@ -128,6 +128,11 @@ namespace bias {
             std::string getVendorName();
             std::string getModelName();
             bool isColor();
+
+            // Raw Bayer output for color cameras (deferred demosaic)
+            void setRawOutput(bool value);
+            bool getRawOutput();
+            BayerPattern getBayerPattern();
                 
             // Print methods for displaying information
             void printInfo();
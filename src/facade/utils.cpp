@@ -280,6 +280,35 @@ namespace bias
         return trigTypeString;
     }
 
+    std::string getBayerPatternString(BayerPattern pattern)
+    {
+        // Names follow the fmf/ufmf format string convention e.g. RAW8:RGGB
+        std::string patternString;
+        switch (pattern)
+        {
+            case BAYER_PATTERN_RGGB:
+                patternString = std::string("RGGB");
+                break;
+
+            case BAYER_PATTERN_GRBG:
+                patternString = std::string("GRBG");
+                break;
+
+            case BAYER_PATTERN_GBRG:
+                patternString = std::string("GBRG");
+                break;
+
+            case BAYER_PATTERN_BGGR:
+                patternString = std::string("BGGR");
+                break;
+
+            default:
+                patternString = std::string("NONE");
+                break;
+        }
+        return patternString;
+    }
+
     static std::map<ImageMode, std::string> createImageModeToStringMap()
     {
         std::map<ImageMode, std::string> map;
@@ -40,6 +40,8 @@ namespace bias
 
     std::string getImageModeString(ImageMode mode);
 
+    std::string getBayerPatternString(BayerPattern pattern);
+
     // ------------------------------------------------------------------------
     float getFrameRateAsFloat(FrameRate frmRate);
 
@@ -0,0 +1,272 @@
+/* clock_gettime, CLOCK_MONOTONIC and syscall are not declared in strict 
+ * ISO C modes (e.g. gcc -std=c99) without this */
+#define _GNU_SOURCE
+
+#include "bias_frame_shm.h"
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define POLL_INTERVAL_US 500
+
+
+/* Layout
+ * ------------------------------------------------------------------------ */
+
+uint64_t bias_frame_shm_slot_header_size(void)
+{
+    uint64_t size = sizeof(BiasFrameShmSlotHeader);
+    return (size + BIAS_FRAME_SHM_ALIGN - 1)/BIAS_FRAME_SHM_ALIGN*BIAS_FRAME_SHM_ALIGN;
+}
+
+
+uint64_t bias_frame_shm_slot_offset(const BiasFrameShmHeader *header, uint64_t slot)
+{
+    return header->headerSize + slot*header->slotSize;
+}
+
+
+/* Helpers
+ * ------------------------------------------------------------------------ */
+
+static BiasFrameShmSlotHeader *get_slot(const BiasFrameShmClient *client, uint64_t index)
+{
+    uint64_t slot = index % client->header->numSlots;
+    char *ptr = (char *) client->base + bias_frame_shm_slot_offset(client->header, slot);
+    return (BiasFrameShmSlotHeader *) ptr;
+}
+
+
+static int is_closed(const BiasFrameShmClient *client)
+{
+    uint32_t state = LOAD_ACQUIRE(&client->header->state);
+    uint64_t sessionId = LOAD_ACQUIRE(&client->header->sessionId);
+    return (state != BIAS_FRAME_SHM_STATE_OPEN) || (sessionId != client->sessionId);
+}
+
+
+static double get_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 1.0e3*ts.tv_sec + 1.0e-6*ts.tv_nsec;
+}
+
+
+/* Sleeps until the wake counter changes from wakeCount or timeoutMs elapses */
+static void wait_for_wake(const BiasFrameShmClient *client, uint32_t wakeCount, double timeoutMs)
+{
+#if defined(__linux__)
+    struct timespec ts;
+    ts.tv_sec = (time_t) (timeoutMs/1.0e3);
+    ts.tv_nsec = (long) ((timeoutMs - 1.0e3*ts.tv_sec)*1.0e6);
+    syscall(
+            SYS_futex, 
+            &client->header->wakeCount, 
+            FUTEX_WAIT, 
+            wakeCount, 
+            (timeoutMs < 0.0) ? NULL : &ts, 
+            NULL, 
+            0
+            );
+#else
+    struct timespec ts;
+    (void) client;
+    (void) wakeCount;
+    (void) timeoutMs;
+    ts.tv_sec = 0;
+    ts.tv_nsec = 1000L*POLL_INTERVAL_US;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+
+/* Client
+ * ------------------------------------------------------------------------ */
+
+int bias_frame_shm_attach(BiasFrameShmClient *client, const char *name)
+{
+    struct stat st;
+    BiasFrameShmHeader *header;
+
+    memset(client, 0, sizeof(BiasFrameShmClient));
+    client->fd = shm_open(name, O_RDONLY, 0);
+    if (client->fd < 0)
+    {
+        return BIAS_FRAME_SHM_ERROR;
+    }
+
+    if ((fstat(client->fd, &st) != 0) || ((size_t) st.st_size < sizeof(BiasFrameShmHeader)))
+    {
+        bias_frame_shm_detach(client);
+        return BIAS_FRAME_SHM_ERROR;
+    }
+
+    client->mapSize = (size_t) st.st_size;
+    client->base = mmap(NULL, client->mapSize, PROT_READ, MAP_SHARED, client->fd, 0);
+    if (client->base == MAP_FAILED)
+    {
+        client->base = NULL;
+        bias_frame_shm_detach(client);
+        return BIAS_FRAME_SHM_ERROR;
+    }
+
+    header = (BiasFrameShmHeader *) client->base;
+    client->header = header;
+
+    if ((header->magic != BIAS_FRAME_SHM_MAGIC) || (header->version != BIAS_FRAME_SHM_VERSION))
+    {
+        bias_frame_shm_detach(client);
+        return BIAS_FRAME_SHM_ERROR;
+    }
+    if ((header->numSlots == 0) 
+            || (header->headerSize + header->numSlots*header->slotSize > client->mapSize))
+    {
+        bias_frame_shm_detach(client);
+        return BIAS_FRAME_SHM_ERROR;
+    }
+
+    client->sessionId = LOAD_ACQUIRE(&header->sessionId);
+    client->nextFrame = LOAD_ACQUIRE(&header->writeCount);
+    client->numberLost = 0;
+    return BIAS_FRAME_SHM_OK;
+}
+
+
+void bias_frame_shm_detach(BiasFrameShmClient *client)
+{
+    if (client->base != NULL)
+    {
+        munmap(client->base, client->mapSize);
+    }
+    if (client->fd >= 0)
+    {
+        close(client->fd);
+    }
+    memset(client, 0, sizeof(BiasFrameShmClient));
+    client->fd = -1;
+}
+
+
+int bias_frame_shm_next(BiasFrameShmClient *client, BiasFrameShmFrame *frame, int timeoutMs)
+{
+    double startTime = get_time_ms();
+    BiasFrameShmHeader *header = client->header;
+
+    if (header == NULL)
+    {
+        return BIAS_FRAME_SHM_ERROR;
+    }
+
+    while (1)
+    {
+        uint32_t wakeCount = LOAD_ACQUIRE(&header->wakeCount);
+        uint64_t writeCount = LOAD_ACQUIRE(&header->writeCount);
+        double remainingMs;
+
+        if (writeCount > client->nextFrame)
+        {
+            uint64_t index = client->nextFrame;
+            BiasFrameShmSlotHeader *slot = get_slot(client, index);
+            uint64_t seq = LOAD_ACQUIRE(&slot->seq);
+
+            if ((writeCount - index > header->numSlots) || (seq != 2*index + 2))
+            {
+                /* Overwritten - skip to the oldest frame which can still be read */
+                uint64_t oldest = index + 1;
+                if (writeCount > header->numSlots + index)
+                {
+                    oldest = writeCount - header->numSlots + 1;
+                }
+                client->numberLost += oldest - index;
+                client->nextFrame = oldest;
+                return BIAS_FRAME_SHM_OVERRUN;
+            }
+
+            frame->index = index;
+            frame->frameCount = slot->frameCount;
+            frame->timeStamp = slot->timeStamp;
+            frame->width = slot->width;
+            frame->height = slot->height;
+            frame->stride = slot->stride;
+            frame->type = slot->type;
+            frame->dataSize = slot->dataSize;
+            frame->data = (const char *) slot + bias_frame_shm_slot_header_size();
+            frame->seq = seq;
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if ((frame->dataSize > header->slotDataSize) || (LOAD_ACQUIRE(&slot->seq) != seq))
+            {
+                client->numberLost += 1;
+                client->nextFrame = index + 1;
+                return BIAS_FRAME_SHM_OVERRUN;
+            }
+            client->nextFrame = index + 1;
+            return BIAS_FRAME_SHM_OK;
+        }
+
+        if (is_closed(client))
+        {
+            return BIAS_FRAME_SHM_CLOSED;
+        }
+
+        if (timeoutMs < 0)
+        {
+            remainingMs = -1.0;
+        }
+        else
+        {
+            remainingMs = timeoutMs - (get_time_ms() - startTime);
+            if (remainingMs <= 0.0)
+            {
+                return BIAS_FRAME_SHM_TIMEOUT;
+            }
+        }
+        wait_for_wake(client, wakeCount, remainingMs);
+    }
+}
+
+
+int bias_frame_shm_check(const BiasFrameShmClient *client, const BiasFrameShmFrame *frame)
+{
+    BiasFrameShmSlotHeader *slot;
+    if (client->header == NULL)
+    {
+        return BIAS_FRAME_SHM_ERROR;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    slot = get_slot(client, frame->index);
+    if (LOAD_ACQUIRE(&slot->seq) != frame->seq)
+    {
+        return BIAS_FRAME_SHM_OVERRUN;
+    }
+    return BIAS_FRAME_SHM_OK;
+}
+
+
+int bias_frame_shm_copy(
+        const BiasFrameShmClient *client, 
+        const BiasFrameShmFrame *frame, 
+        void *buffer, 
+        size_t bufferSize
+        )
+{
+    size_t numBytes = (size_t) frame->dataSize;
+    if (numBytes > bufferSize)
+    {
+        numBytes = bufferSize;
+    }
+    memcpy(buffer, frame->data, numBytes);
+    return bias_frame_shm_check(client, frame);
+}
@@ -0,0 +1,126 @@
+#ifndef BIAS_FRAME_SHM_H
+#define BIAS_FRAME_SHM_H
+/*
+ * Shared-memory frame ring published by bias (POSIX shm_open/mmap).
+ *
+ * The segment is a header followed by numSlots fixed size slots. Frame n 
+ * (counting from 0 since the segment was created) is written to slot 
+ * n % numSlots. Each slot carries a sequence number which is odd while the 
+ * publisher is writing it and 2n+2 once frame n is complete, so a reader 
+ * can detect when a slot was overwritten while it was looking at it.
+ *
+ * The header and slot layouts are shared by the publisher (bias gui) and
+ * the client functions below. All multi-byte values are native endian.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BIAS_FRAME_SHM_MAGIC        0x53414942u   /* "BIAS" */
+#define BIAS_FRAME_SHM_VERSION      1u
+#define BIAS_FRAME_SHM_ALIGN        64u
+#define BIAS_FRAME_SHM_NAME_PREFIX  "/bias_frames_cam"
+
+/* Publisher state */
+#define BIAS_FRAME_SHM_STATE_OPEN   1u
+#define BIAS_FRAME_SHM_STATE_CLOSED 2u
+
+/* Client return codes */
+#define BIAS_FRAME_SHM_OK            0
+#define BIAS_FRAME_SHM_TIMEOUT       1   /* no new frame within the timeout */
+#define BIAS_FRAME_SHM_OVERRUN       2   /* frames were overwritten before being read */
+#define BIAS_FRAME_SHM_CLOSED        3   /* publisher stopped - detach and attach again */
+#define BIAS_FRAME_SHM_ERROR        -1
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t state;
+    uint32_t numSlots;
+    uint64_t headerSize;      /* bytes, offset of the first slot */
+    uint64_t slotSize;        /* bytes, slot header + image data */
+    uint64_t slotDataSize;    /* bytes, maximum image data per slot */
+    uint64_t sessionId;       /* changes each time the publisher creates the segment */
+    uint64_t writeCount;      /* number of frames published - atomic */
+    uint32_t wakeCount;       /* futex word, incremented per frame - atomic */
+    uint32_t reserved;
+} BiasFrameShmHeader;
+
+typedef struct
+{
+    uint64_t seq;             /* odd while writing, 2n+2 when frame n is complete - atomic */
+    uint64_t frameCount;      /* camera frame count */
+    double timeStamp;         /* camera time stamp (s) */
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;          /* bytes per row */
+    uint32_t type;            /* OpenCV type e.g. CV_8UC1 = 0 */
+    uint64_t dataSize;        /* bytes of image data */
+} BiasFrameShmSlotHeader;
+
+/* Offsets of slot i and of its image data from the start of the segment */
+uint64_t bias_frame_shm_slot_offset(const BiasFrameShmHeader *header, uint64_t slot);
+uint64_t bias_frame_shm_slot_header_size(void);
+
+
+/* Client 
+ * ------------------------------------------------------------------------ */
+
+typedef struct
+{
+    int fd;
+    void *base;
+    size_t mapSize;
+    BiasFrameShmHeader *header;
+    uint64_t sessionId;
+    uint64_t nextFrame;       /* index of the next frame to read */
+    uint64_t numberLost;      /* frames overwritten before they could be read */
+} BiasFrameShmClient;
+
+typedef struct
+{
+    uint64_t index;           /* frame index within the session */
+    uint64_t frameCount;
+    double timeStamp;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t type;
+    uint64_t dataSize;
+    const void *data;         /* points into shared memory - no copy */
+    uint64_t seq;             /* slot sequence number when the frame was read */
+} BiasFrameShmFrame;
+
+/* Attach to a segment by name, e.g. "/bias_frames_cam0". Reading starts 
+ * with the next frame published. Returns BIAS_FRAME_SHM_OK on success. */
+int bias_frame_shm_attach(BiasFrameShmClient *client, const char *name);
+void bias_frame_shm_detach(BiasFrameShmClient *client);
+
+/* Waits up to timeoutMs (negative waits forever) for the next frame and 
+ * returns a view of it in shared memory. On BIAS_FRAME_SHM_OVERRUN the 
+ * client skipped ahead to the oldest frame still available - numberLost
+ * is updated and the call can be repeated. */
+int bias_frame_shm_next(BiasFrameShmClient *client, BiasFrameShmFrame *frame, int timeoutMs);
+
+/* Returns BIAS_FRAME_SHM_OK if the frame's slot hasn't been overwritten 
+ * since it was read, i.e. the data used so far was valid. */
+int bias_frame_shm_check(const BiasFrameShmClient *client, const BiasFrameShmFrame *frame);
+
+/* Copies the frame data (up to bufferSize bytes) and checks it afterwards */
+int bias_frame_shm_copy(
+        const BiasFrameShmClient *client, 
+        const BiasFrameShmFrame *frame, 
+        void *buffer, 
+        size_t bufferSize
+        );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIAS_FRAME_SHM_H */
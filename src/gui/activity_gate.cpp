@@ -0,0 +1,365 @@
+#include "activity_gate.hpp"
+#include "json.hpp"
+#include "json_utils.hpp"
+#include <algorithm>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QVariantMap>
+#include <QVariantList>
+#include <opencv2/imgproc/imgproc.hpp>
+
+namespace bias
+{
+    // Constants
+    // ------------------------------------------------------------------------
+    const bool ActivityGate::DEFAULT_ACTIVITY_FLAG = false;
+    const unsigned int ActivityGate::DEFAULT_THRESHOLD = 20;
+    const double ActivityGate::DEFAULT_START_FRACTION = 0.002;
+    const double ActivityGate::DEFAULT_STOP_FRACTION = 0.001;
+    const unsigned int ActivityGate::DEFAULT_DOWNSAMPLE = 4;
+    const double ActivityGate::DEFAULT_BACKGROUND_SECONDS = 30.0;
+    const double ActivityGate::DEFAULT_PRE_SECONDS = 1.0;
+    const double ActivityGate::DEFAULT_HOLD_SECONDS = 2.0;
+    const double ActivityGate::DEFAULT_MIN_CLIP_SECONDS = 2.0;
+    const unsigned long ActivityGate::DEFAULT_MAX_MEGABYTES = 256;
+    const QString ActivityGate::INDEX_FILE_POSTFIX = QString("_activity.json");
+
+
+    // Public methods
+    // ------------------------------------------------------------------------
+    ActivityGate::ActivityGate()
+    {
+        clear();
+    }
+
+
+    ActivityGate::ActivityGate(VideoWriterParams_activity params) : ActivityGate()
+    {
+        setParams(params);
+    }
+
+
+    void ActivityGate::setParams(VideoWriterParams_activity params)
+    {
+        params_ = params;
+        params_.downsample = std::max(params_.downsample, 1u);
+        params_.stopFraction = std::min(params_.stopFraction, params_.startFraction);
+        evictFrames();
+    }
+
+
+    VideoWriterParams_activity ActivityGate::getParams() const
+    {
+        return params_;
+    }
+
+
+    void ActivityGate::setIndexFileName(QString fileName, QString videoFileName)
+    {
+        indexFileName_ = fileName;
+        videoFileName_ = videoFileName;
+    }
+
+
+    void ActivityGate::clear()
+    {
+        FrameGate::clear();
+        background_ = cv::Mat();
+        lastTimeStamp_ = 0.0;
+        activity_ = 0.0;
+        preBuffer_.clear();
+        preBufferBytes_ = 0;
+        active_ = false;
+        lastActiveTimeStamp_ = 0.0;
+        clip_ = ActivityClip();
+        clipVec_.clear();
+        numberOfFramesSeen_ = 0;
+        numberOfFramesLogged_ = 0;
+    }
+
+
+    bool ActivityGate::isEnabled() const
+    {
+        return params_.activityFlag;
+    }
+
+
+    void ActivityGate::addFrame(StampedImage stampedImg, std::vector<StampedImage> &releaseVec)
+    {
+        if (!params_.activityFlag)
+        {
+            releaseVec.push_back(stampedImg);
+            return;
+        }
+
+        numberOfFramesSeen_++;
+        activity_ = computeActivity(stampedImg);
+
+        if (!active_)
+        {
+            if (activity_ < params_.startFraction)
+            {
+                BufferedFrame bufferedFrame;
+                bufferedFrame.stampedImg = stampedImg;
+                bufferedFrame.activity = activity_;
+                preBuffer_.push_back(bufferedFrame);
+                preBufferBytes_ += (unsigned long long)(stampedImg.image.total()*stampedImg.image.elemSize());
+                evictFrames();
+                return;
+            }
+            startClip(stampedImg, releaseVec);
+        }
+
+        addToClip(stampedImg, activity_, releaseVec);
+
+        // Hysteresis - the clip continues while activity stays above the 
+        // (lower) stop fraction, plus holdSeconds.
+        if (activity_ >= params_.stopFraction)
+        {
+            lastActiveTimeStamp_ = stampedImg.timeStamp;
+        }
+        bool idle = (stampedImg.timeStamp - lastActiveTimeStamp_) > params_.holdSeconds;
+        bool longEnough = (stampedImg.timeStamp - clip_.startTime) >= params_.minClipSeconds;
+        if (idle && longEnough)
+        {
+            endClip();
+        }
+    }
+
+
+    bool ActivityGate::finish()
+    {
+        if (active_)
+        {
+            endClip();
+        }
+        preBuffer_.clear();
+        preBufferBytes_ = 0;
+        return writeIndex();
+    }
+
+
+    bool ActivityGate::isActive() const
+    {
+        return active_;
+    }
+
+
+    double ActivityGate::getActivity() const
+    {
+        return activity_;
+    }
+
+
+    std::vector<ActivityClip> ActivityGate::getClipVec() const
+    {
+        return clipVec_;
+    }
+
+
+    unsigned long ActivityGate::numberOfFramesSeen() const
+    {
+        return numberOfFramesSeen_;
+    }
+
+
+    unsigned long ActivityGate::numberOfFramesLogged() const
+    {
+        return numberOfFramesLogged_;
+    }
+
+
+    QString ActivityGate::getIndexFileName(QString videoFileName)
+    {
+        QFileInfo fileInfo(videoFileName);
+        QString indexName = fileInfo.completeBaseName() + INDEX_FILE_POSTFIX;
+        return fileInfo.absoluteDir().absoluteFilePath(indexName);
+    }
+
+
+    // Private methods
+    // ------------------------------------------------------------------------
+    double ActivityGate::computeActivity(const StampedImage &stampedImg)
+    {
+        const cv::Mat &image = stampedImg.image;
+        if (image.empty())
+        {
+            return 0.0;
+        }
+
+        cv::Mat grayImage;
+        if (image.channels() == 3)
+        {
+            cv::cvtColor(image, grayImage, cv::COLOR_BGR2GRAY);
+        }
+        else if (image.channels() == 4)
+        {
+            cv::cvtColor(image, grayImage, cv::COLOR_BGRA2GRAY);
+        }
+        else
+        {
+            grayImage = image;
+        }
+
+        // Shrink first, convert second - keeps the per frame cost small
+        int downsample = int(params_.downsample);
+        if (downsample > 1)
+        {
+            cv::Size smallSize(
+                    std::max(grayImage.cols/downsample, 1), 
+                    std::max(grayImage.rows/downsample, 1)
+                    );
+            cv::resize(grayImage, grayImage, smallSize, 0, 0, cv::INTER_AREA);
+        }
+        double scale = (grayImage.depth() == CV_16U) ? 1.0/256.0 : 1.0;
+        grayImage.convertTo(smallImage_, CV_32F, scale);
+
+        if (background_.empty() || (background_.size() != smallImage_.size()))
+        {
+            background_ = smallImage_.clone();
+            lastTimeStamp_ = stampedImg.timeStamp;
+            return 0.0;
+        }
+
+        cv::absdiff(smallImage_, background_, diffImage_);
+        int numberActive = cv::countNonZero(diffImage_ > double(params_.threshold));
+        double fraction = double(numberActive)/double(diffImage_.total());
+
+        double dt = std::max(stampedImg.timeStamp - lastTimeStamp_, 0.0);
+        double alpha = 1.0;
+        if (params_.backgroundSeconds > 0.0)
+        {
+            alpha = std::min(dt/params_.backgroundSeconds, 1.0);
+        }
+        cv::accumulateWeighted(smallImage_, background_, alpha);
+        lastTimeStamp_ = stampedImg.timeStamp;
+
+        return fraction;
+    }
+
+
+    void ActivityGate::startClip(const StampedImage &stampedImg, std::vector<StampedImage> &releaseVec)
+    {
+        active_ = true;
+        lastActiveTimeStamp_ = stampedImg.timeStamp;
+
+        clip_ = ActivityClip();
+        clip_.firstFrameCount = stampedImg.frameCount;
+        clip_.startTime = stampedImg.timeStamp;
+        clip_.numberOfFrames = 0;
+        clip_.maxFraction = 0.0;
+
+        double preBegTimeStamp = stampedImg.timeStamp - params_.preSeconds;
+        for (BufferedFrame &bufferedFrame : preBuffer_)
+        {
+            if (bufferedFrame.stampedImg.timeStamp >= preBegTimeStamp)
+            {
+                addToClip(bufferedFrame.stampedImg, bufferedFrame.activity, releaseVec);
+            }
+        }
+        preBuffer_.clear();
+        preBufferBytes_ = 0;
+    }
+
+
+    void ActivityGate::addToClip(
+            const StampedImage &stampedImg, 
+            double activity, 
+            std::vector<StampedImage> &releaseVec
+            )
+    {
+        if (clip_.numberOfFrames == 0)
+        {
+            clip_.firstFrameCount = stampedImg.frameCount;
+            clip_.firstLogFrame = numberReleased_;
+            clip_.startTime = stampedImg.timeStamp;
+        }
+        clip_.lastFrameCount = stampedImg.frameCount;
+        clip_.endTime = stampedImg.timeStamp;
+        clip_.numberOfFrames++;
+        clip_.maxFraction = std::max(clip_.maxFraction, activity);
+        release(stampedImg, releaseVec);
+        numberOfFramesLogged_++;
+    }
+
+
+    void ActivityGate::endClip()
+    {
+        if (clip_.numberOfFrames > 0)
+        {
+            clipVec_.push_back(clip_);
+        }
+        clip_ = ActivityClip();
+        active_ = false;
+    }
+
+
+    void ActivityGate::evictFrames()
+    {
+        unsigned long long maxBytes = (unsigned long long)(params_.maxMegaBytes)*1024ull*1024ull;
+        while (!preBuffer_.empty())
+        {
+            double bufferSeconds = preBuffer_.back().stampedImg.timeStamp - preBuffer_.front().stampedImg.timeStamp;
+            if ((bufferSeconds <= params_.preSeconds) && (preBufferBytes_ <= maxBytes))
+            {
+                break;
+            }
+            const cv::Mat &image = preBuffer_.front().stampedImg.image;
+            unsigned long long frameBytes = (unsigned long long)(image.total()*image.elemSize());
+            preBufferBytes_ -= std::min(preBufferBytes_, frameBytes);
+            preBuffer_.pop_front();
+        }
+    }
+
+
+    bool ActivityGate::writeIndex()
+    {
+        if (indexFileName_.isEmpty())
+        {
+            return true;
+        }
+
+        QVariantList clipList;
+        for (unsigned int i=0; i<clipVec_.size(); i++)
+        {
+            ActivityClip &clip = clipVec_[i];
+            QVariantMap clipMap;
+            clipMap.insert("index", i);
+            clipMap.insert("firstFrame", (unsigned long long)(clip.firstFrameCount));
+            clipMap.insert("lastFrame", (unsigned long long)(clip.lastFrameCount));
+            clipMap.insert("firstLogFrame", (unsigned long long)(clip.firstLogFrame));
+            clipMap.insert("numberOfFrames", (unsigned long long)(clip.numberOfFrames));
+            clipMap.insert("startTime", clip.startTime);
+            clipMap.insert("endTime", clip.endTime);
+            clipMap.insert("maxFraction", clip.maxFraction);
+            clipList.append(clipMap);
+        }
+
+        QVariantMap indexMap;
+        indexMap.insert("videoFile", QFileInfo(videoFileName_).fileName());
+        indexMap.insert("numberOfFramesSeen", (unsigned long long)(numberOfFramesSeen_));
+        indexMap.insert("numberOfFramesLogged", (unsigned long long)(numberOfFramesLogged_));
+        indexMap.insert("threshold", params_.threshold);
+        indexMap.insert("startFraction", params_.startFraction);
+        indexMap.insert("stopFraction", params_.stopFraction);
+        indexMap.insert("clips", clipList);
+
+        bool ok = false;
+        QByteArray indexJson = QtJson::serialize(indexMap, ok);
+        if (!ok)
+        {
+            return false;
+        }
+
+        QFile indexFile(indexFileName_);
+        if (!indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            return false;
+        }
+        indexFile.write(prettyIndentJson(indexJson));
+        indexFile.close();
+        return true;
+    }
+
+} // namespace bias
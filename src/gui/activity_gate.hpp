@@ -0,0 +1,119 @@
+#ifndef BIAS_ACTIVITY_GATE_HPP
+#define BIAS_ACTIVITY_GATE_HPP
+#include "frame_gate.hpp"
+#include "video_writer_params.hpp"
+#include <deque>
+#include <vector>
+#include <QString>
+#include <opencv2/core/core.hpp>
+
+namespace bias
+{
+
+    struct ActivityClip
+    {
+        unsigned long firstFrameCount;      // camera frame counts
+        unsigned long lastFrameCount;
+        unsigned long firstLogFrame;        // position in the logged video
+        unsigned long numberOfFrames;
+        double startTime;
+        double endTime;
+        double maxFraction;
+    };
+
+
+    class ActivityGate : public FrameGate
+    {
+        // Activity gated logging. Each frame is reduced to a downsampled 
+        // grayscale image and compared against a slowly updated running
+        // background; the fraction of pixels which differ by more than 
+        // threshold is the frame's activity.  A clip starts when the 
+        // activity reaches startFraction (with up to preSeconds of buffered
+        // frames in front of it) and ends once activity has stayed below 
+        // stopFraction for holdSeconds and the clip is at least 
+        // minClipSeconds long. Idle frames are never logged. The clips are 
+        // listed in a json index written when logging finishes, with both 
+        // the camera frame counts and the frame numbers in the logged video
+        // (released frames are renumbered, see FrameGate). Runs on the image
+        // logger's thread, not the dispatcher's.
+
+        public:
+
+            static const bool DEFAULT_ACTIVITY_FLAG;
+            static const unsigned int DEFAULT_THRESHOLD;
+            static const double DEFAULT_START_FRACTION;
+            static const double DEFAULT_STOP_FRACTION;
+            static const unsigned int DEFAULT_DOWNSAMPLE;
+            static const double DEFAULT_BACKGROUND_SECONDS;
+            static const double DEFAULT_PRE_SECONDS;
+            static const double DEFAULT_HOLD_SECONDS;
+            static const double DEFAULT_MIN_CLIP_SECONDS;
+            static const unsigned long DEFAULT_MAX_MEGABYTES;
+            static const QString INDEX_FILE_POSTFIX;
+
+            ActivityGate();
+            explicit ActivityGate(VideoWriterParams_activity params);
+
+            // Use lock when calling these methods
+            // ----------------------------------
+            void setParams(VideoWriterParams_activity params);
+            VideoWriterParams_activity getParams() const;
+            void setIndexFileName(QString fileName, QString videoFileName);
+
+            virtual void clear();
+            virtual bool isEnabled() const;
+            virtual void addFrame(StampedImage stampedImg, std::vector<StampedImage> &releaseVec);
+
+            // Closes any open clip and writes the clip index
+            bool finish();
+
+            bool isActive() const;
+            double getActivity() const;
+            std::vector<ActivityClip> getClipVec() const;
+            unsigned long numberOfFramesSeen() const;
+            unsigned long numberOfFramesLogged() const;
+            // ----------------------------------
+
+            static QString getIndexFileName(QString videoFileName);
+
+        private:
+
+            VideoWriterParams_activity params_;
+            QString indexFileName_;
+            QString videoFileName_;
+
+            cv::Mat background_;
+            cv::Mat smallImage_;
+            cv::Mat diffImage_;
+            double lastTimeStamp_;
+            double activity_;
+
+            struct BufferedFrame
+            {
+                StampedImage stampedImg;
+                double activity;
+            };
+
+            std::deque<BufferedFrame> preBuffer_;
+            unsigned long long preBufferBytes_;
+
+            bool active_;
+            double lastActiveTimeStamp_;
+            ActivityClip clip_;
+            std::vector<ActivityClip> clipVec_;
+
+            unsigned long numberOfFramesSeen_;
+            unsigned long numberOfFramesLogged_;
+
+            double computeActivity(const StampedImage &stampedImg);
+            void startClip(const StampedImage &stampedImg, std::vector<StampedImage> &releaseVec);
+            void addToClip(const StampedImage &stampedImg, double activity, std::vector<StampedImage> &releaseVec);
+            void endClip();
+            void evictFrames();
+            bool writeIndex();
+
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_ACTIVITY_GATE_HPP
@@ -0,0 +1,175 @@
+#include "background_running_median_ufmf.hpp"
+#include "background_histogram_ufmf.hpp"
+#include "stamped_image.hpp"
+#include "affinity.hpp"
+#include <QThread>
+#include <iostream>
+
+namespace bias
+{
+
+    // Methods
+    BackgroundRunningMedian_ufmf::BackgroundRunningMedian_ufmf(QObject *parent)
+        : QObject(parent)
+    {
+        initialize(NULL,NULL,0);
+    }
+
+
+    BackgroundRunningMedian_ufmf::BackgroundRunningMedian_ufmf(
+            std::shared_ptr<LockableQueue<StampedImage>> bgImageQueuePtr,
+            std::shared_ptr<LockableQueue<cv::Mat>> medianMatQueuePtr,
+            unsigned int cameraNumber,
+            QObject *parent
+            )
+        : QObject(parent)
+    {
+        initialize(bgImageQueuePtr, medianMatQueuePtr, cameraNumber);
+    }
+
+
+    void BackgroundRunningMedian_ufmf::initialize(
+            std::shared_ptr<LockableQueue<StampedImage>> bgImageQueuePtr,
+            std::shared_ptr<LockableQueue<cv::Mat>> medianMatQueuePtr,
+            unsigned int cameraNumber
+            )
+    {
+        ready_ = false;
+        stopped_ = true;
+        bgImageQueuePtr_ = bgImageQueuePtr;
+        medianMatQueuePtr_ = medianMatQueuePtr;
+        medianUpdateCount_ = BackgroundHistogram_ufmf::DEFAULT_MEDIAN_UPDATE_COUNT;
+        medianUpdateInterval_ = BackgroundHistogram_ufmf::DEFAULT_MEDIAN_UPDATE_INTERVAL;
+
+        // Make sure none of the queue pointers are null
+        bool notNull = true;
+        notNull &= (bgImageQueuePtr_ != NULL);
+        notNull &= (medianMatQueuePtr_ != NULL);
+
+        if (notNull)
+        {
+            ready_ = true;
+        }
+        cameraNumber_ = cameraNumber;
+    }
+
+
+    void BackgroundRunningMedian_ufmf::stop()
+    {
+        stopped_ = true;
+    }
+
+
+    void BackgroundRunningMedian_ufmf::setMedianUpdateCount(unsigned int medianUpdateCount)
+    {
+        medianUpdateCount_ = medianUpdateCount;
+    }
+
+
+    void BackgroundRunningMedian_ufmf::setMedianUpdateInterval(unsigned int medianUpdateInterval)
+    {
+        medianUpdateInterval_ = medianUpdateInterval;
+    }
+
+
+    void BackgroundRunningMedian_ufmf::updateRunningMedian(
+            const cv::Mat &image,
+            cv::Mat &medianImage
+            )
+    {
+        // Move each median pixel one step towards the new pixel value. The
+        // inner loop is branch free over contiguous uchar rows so that the
+        // compiler can vectorize it. Values can't leave [0,255] as the median
+        // only moves towards a value which is itself in range.
+        int numRows = image.rows;
+        int numCols = image.cols;
+        if (image.isContinuous() && medianImage.isContinuous())
+        {
+            numCols *= numRows;
+            numRows = 1;
+        }
+
+        for (int row=0; row<numRows; row++)
+        {
+            const uchar *imagePtr = image.ptr<uchar>(row);
+            uchar *medianPtr = medianImage.ptr<uchar>(row);
+            for (int col=0; col<numCols; col++)
+            {
+                uchar pix = imagePtr[col];
+                uchar med = medianPtr[col];
+                medianPtr[col] = uchar(med + (pix > med) - (pix < med));
+            }
+        }
+    }
+
+
+    void BackgroundRunningMedian_ufmf::run()
+    {
+        bool done = false;
+        bool isFirst = true;
+        unsigned long count = 0;
+        double lastUpdateTime = 0.0;
+        double updateDt;
+
+        StampedImage newStampedImg;
+
+        if (!ready_)
+        {
+            return;
+        }
+
+        QThread *thisThread = QThread::currentThread();
+        thisThread -> setPriority(QThread::NormalPriority);
+        ThreadAffinityService::assignThreadAffinity(false,cameraNumber_);
+
+        acquireLock();
+        stopped_ = false;
+        releaseLock();
+
+        while (!done)
+        {
+            // Grab background image from queue
+            bgImageQueuePtr_ -> acquireLock();
+            bgImageQueuePtr_ -> waitIfEmpty();
+            if ((bgImageQueuePtr_ -> empty()))
+            {
+                bgImageQueuePtr_ -> releaseLock();
+                break;
+            }
+            newStampedImg = bgImageQueuePtr_ -> front();
+            bgImageQueuePtr_ -> pop();
+            bgImageQueuePtr_ -> releaseLock();
+
+            if (isFirst)
+            {
+                // Seed running median with the first image - same as the
+                // initial keyframe written by the video writer.
+                medianImage_ = newStampedImg.image.clone();
+                lastUpdateTime = newStampedImg.timeStamp - medianUpdateInterval_;
+                isFirst = false;
+            }
+            else
+            {
+                updateRunningMedian(newStampedImg.image, medianImage_);
+            }
+            count++;
+
+            // Publish a copy of the running median on schedule
+            updateDt = newStampedImg.timeStamp - lastUpdateTime;
+            if ( (count > medianUpdateCount_) && (updateDt > medianUpdateInterval_))
+            {
+                medianMatQueuePtr_ -> acquireLock();
+                medianMatQueuePtr_ -> push(medianImage_.clone());
+                medianMatQueuePtr_ -> releaseLock();
+
+                count = 0;
+                lastUpdateTime = newStampedImg.timeStamp;
+            }
+
+            acquireLock();
+            done = stopped_;
+            releaseLock();
+        }
+    }
+
+} // namespace bias
@@ -0,0 +1,64 @@
+#ifndef BIAS_BACKGROUND_RUNNING_MEDIAN_UFMF_HPP
+#define BIAS_BACKGROUND_RUNNING_MEDIAN_UFMF_HPP
+#include <memory>
+#include <QObject>
+#include <QRunnable>
+#include <opencv2/core/core.hpp>
+#include "lockable.hpp"
+
+namespace bias
+{
+    struct StampedImage;
+
+    // Streaming alternative to BackgroundHistogram_ufmf + BackgroundMedian_ufmf.
+    // Keeps a single byte per pixel - an approximate running median which is
+    // nudged by +/-1 towards each new background image - and publishes a copy
+    // of it to the median image queue on the same count/interval schedule as
+    // the histogram model.
+
+    class BackgroundRunningMedian_ufmf
+        : public QObject, public QRunnable, public Lockable<Empty>
+    {
+        Q_OBJECT
+
+        public:
+            BackgroundRunningMedian_ufmf(QObject *parent=0);
+            BackgroundRunningMedian_ufmf(
+                    std::shared_ptr<LockableQueue<StampedImage>> bgImageQueuePtr,
+                    std::shared_ptr<LockableQueue<cv::Mat>> medianMatQueuePtr,
+                    unsigned int cameraNumber,
+                    QObject *parent=0
+                    );
+            void initialize(
+                    std::shared_ptr<LockableQueue<StampedImage>> bgImageQueuePtr,
+                    std::shared_ptr<LockableQueue<cv::Mat>> medianMatQueuePtr,
+                    unsigned int cameraNumber
+                    );
+            void stop();
+            void setMedianUpdateCount(unsigned int medianUpdateCount);
+            void setMedianUpdateInterval(unsigned int medianUpdateInterval);
+
+            static void updateRunningMedian(const cv::Mat &image, cv::Mat &medianImage);
+
+        private:
+
+            bool ready_;
+            bool stopped_;
+            unsigned int cameraNumber_;
+            unsigned int medianUpdateCount_;
+            unsigned int medianUpdateInterval_;
+
+            cv::Mat medianImage_;
+
+            // Queue of incoming images for background model
+            std::shared_ptr<LockableQueue<StampedImage>> bgImageQueuePtr_;
+
+            // Queue of outgoing median images
+            std::shared_ptr<LockableQueue<cv::Mat>> medianMatQueuePtr_;
+
+            void run();
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_BACKGROUND_RUNNING_MEDIAN_UFMF_HPP
@@ -13,6 +13,9 @@
 #include "video_writer_avi.hpp"
 #include "video_writer_fmf.hpp"
 #include "video_writer_ufmf.hpp"
+#include "video_writer_zfmf.hpp"
+#include "video_writer_segmented.hpp"
+#include "video_writer_factory.hpp"
 #include "affinity.hpp"
 #include "property_dialog.hpp"
 #include "timer_settings_dialog.hpp"
@@ -25,6 +28,10 @@
 #include "json_utils.hpp"
 #include "ext_ctl_http_server.hpp"
 #include "plugin_handler.hpp"
+#include "pretrigger_buffer.hpp"
+#include "activity_gate.hpp"
+#include "frame_shm_publisher.hpp"
+#include "basic_image_proc.hpp"
 
 //#include <cstdlib>
 #include <cmath>
@@ -89,17 +96,8 @@ namespace bias
     const unsigned int ROI_BOUNDARY_LINE_WIDTH = 5;
     const QColor ROI_BOUNDARY_COLOR = QColor(255,0,0);
 
-    QMap<VideoFileFormat, QString> createExtensionMap()
-    {
-        QMap<VideoFileFormat, QString> map;
-        map.insert(VIDEOFILE_FORMAT_BMP,  QString("bmp"));
-        map.insert(VIDEOFILE_FORMAT_JPG,  QString("jpg"));
-        map.insert(VIDEOFILE_FORMAT_AVI,  QString("avi"));
-        map.insert(VIDEOFILE_FORMAT_FMF,  QString("fmf"));
-        map.insert(VIDEOFILE_FORMAT_UFMF, QString("ufmf"));
-        return map;
-    };
-    const QMap<VideoFileFormat, QString> VIDEOFILE_EXTENSION_MAP = createExtensionMap();
+    const QMap<VideoFileFormat, QString> VIDEOFILE_EXTENSION_MAP = getVideoFileExtensionMap();
+
 
     const int COLORMAP_NONE = -1;
     QMap<int, QString>  createColorMapIntToStringMap()
@@ -159,6 +157,7 @@ namespace bias
         {
             try
             {
+                cameraPtr_ -> setRawOutput(videoWriterParams_.rawBayerFlag);
                 cameraPtr_ -> connect();
 #ifdef WITH_FC2
                 // WBD DEVEL TEMP
@@ -320,7 +319,27 @@ namespace bias
             return rtnStatus;
         }
 
+        if (frameExportEnabled_)
+        {
+            frameExportPtr_ = std::make_shared<FrameShmPublisher>(frameExportName_, frameExportSlots_);
+            RtnStatus exportStatus = frameExportPtr_ -> open();
+            if (!exportStatus.success)
+            {
+                frameExportPtr_.reset();
+                QString msgTitle("Capture Error");
+                QString msgText = QString("Unable to start image capture: %1").arg(exportStatus.message);
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this, msgTitle, msgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = msgText;
+                return rtnStatus;
+            }
+        }
+
         frameCount_ = 0;
+        pluginDropCount_ = 0;
         timeStamp_ = 0.0;
         framesPerSec_ = 0.0;
         skippedFramesWarning_ = false;
@@ -329,6 +348,27 @@ namespace bias
         logImageQueuePtr_ -> clear();
         pluginImageQueuePtr_ -> clear();
 
+        // Raw Bayer output - frames are logged undemosaiced and converted 
+        // only for the display and for plugins which require color.
+        BayerPattern bayerPattern = BAYER_PATTERN_NONE;
+        if (cameraPtr_ -> tryLock(CAMERA_LOCK_TRY_DT))
+        {
+            try
+            {
+                cameraPtr_ -> setRawOutput(videoWriterParams_.rawBayerFlag);
+                if (videoWriterParams_.rawBayerFlag)
+                {
+                    bayerPattern = cameraPtr_ -> getBayerPattern();
+                }
+            }
+            catch (RuntimeError &runtimeError)
+            {
+                cameraPtr_ -> setRawOutput(false);
+                bayerPattern = BAYER_PATTERN_NONE;
+            }
+            cameraPtr_ -> releaseLock();
+        }
+
 
         QString autoNamingString = getAutoNamingString();
         unsigned int versionNumber = 0;
@@ -339,60 +379,38 @@ namespace bias
             QString videoFileFullPath = getVideoFileFullPath(autoNamingString);
             std::shared_ptr<VideoWriter> videoWriterPtr; 
 
-            switch (videoFileFormat_)
+            if (videoWriterParams_.segment.segmentFlag)
             {
-                case VIDEOFILE_FORMAT_BMP:
-                    videoWriterPtr = std::make_shared<VideoWriter_bmp>(
-                            videoWriterParams_.bmp,
-                            videoFileFullPath,
-                            cameraNumber_
-                            );
-                    break;
-
-                case VIDEOFILE_FORMAT_JPG:
-                    videoWriterPtr = std::make_shared<VideoWriter_jpg>(
-                            videoWriterParams_.jpg,
-                            videoFileFullPath,
-                            cameraNumber_
-                            );
-                    break;
-
-                case VIDEOFILE_FORMAT_AVI:  
-                    videoWriterPtr = std::make_shared<VideoWriter_avi>(
-                            videoWriterParams_.avi,
-                            videoFileFullPath,
-                            cameraNumber_
-                            );
-                    break;
-
-                case VIDEOFILE_FORMAT_FMF:
-                    videoWriterPtr = std::make_shared<VideoWriter_fmf>(
-                            videoWriterParams_.fmf,
-                            videoFileFullPath,
-                            cameraNumber_
-                            );
-                    break;
-
-                case VIDEOFILE_FORMAT_UFMF:
-                    videoWriterPtr = std::make_shared<VideoWriter_ufmf>(
-                            videoWriterParams_.ufmf,
-                            videoFileFullPath,
-                            cameraNumber_
-                            );
-                    break;
-
-                default:
-                    videoWriterPtr = std::make_shared<VideoWriter>(
-                            videoFileFullPath,
-                            cameraNumber_
-                            );
-                    break;
-
-            } // switch (videoFileFormat) 
+                // Rotate output files - each segment gets a new writer from the factory.
+                VideoFileFormat videoFileFormat = videoFileFormat_;
+                VideoWriterParams videoWriterParams = videoWriterParams_;
+                unsigned int cameraNumber = cameraNumber_;
+                VideoWriterFactory writerFactory = [=](QString fileName)
+                {
+                    return createVideoWriter(videoFileFormat, videoWriterParams, fileName, cameraNumber);
+                };
+                videoWriterPtr = std::make_shared<VideoWriter_segmented>(
+                        videoWriterParams_.segment,
+                        writerFactory,
+                        videoFileFullPath,
+                        cameraNumber_
+                        );
+                videoWriterPtr -> setFinishTimeout(videoWriterParams_.finishTimeout);
+            }
+            else
+            {
+                videoWriterPtr = createVideoWriter(
+                        videoFileFormat_, 
+                        videoWriterParams_, 
+                        videoFileFullPath, 
+                        cameraNumber_
+                        );
+            }
 
             // Set output file
             videoWriterPtr -> setFileName(videoFileFullPath);
             videoWriterPtr -> setVersioning(autoNamingOptions_.includeVersionNumber);
+            videoWriterPtr -> setBayerPattern(bayerPattern);
             versionNumber = videoWriterPtr -> getNextVersionNumber();
 
             imageLoggerPtr_ = new ImageLogger(
@@ -418,6 +436,34 @@ namespace bias
                     SLOT(imageLoggingError(unsigned int, QString))
                    );
 
+            if (videoWriterParams_.pretrigger.pretriggerFlag)
+            {
+                // Event triggered logging - frames only reach the writer around triggers
+                pretriggerBufferPtr_ -> acquireLock();
+                pretriggerBufferPtr_ -> clear();
+                pretriggerBufferPtr_ -> setParams(videoWriterParams_.pretrigger);
+                pretriggerBufferPtr_ -> releaseLock();
+                imageLoggerPtr_ -> setLogGate(pretriggerBufferPtr_);
+            }
+            else if (videoWriterParams_.activity.activityFlag)
+            {
+                // Activity gated logging - only active bouts reach the writer 
+                if (versionNumber > 0)
+                {
+                    QFileInfo videoFileInfo = VideoWriter::getVersionFileInfo(videoFileFullPath, versionNumber);
+                    videoFileFullPath = videoFileInfo.absoluteFilePath();
+                }
+                activityGatePtr_ -> acquireLock();
+                activityGatePtr_ -> clear();
+                activityGatePtr_ -> setParams(videoWriterParams_.activity);
+                activityGatePtr_ -> setIndexFileName(
+                        ActivityGate::getIndexFileName(videoFileFullPath),
+                        videoFileFullPath
+                        );
+                activityGatePtr_ -> releaseLock();
+                imageLoggerPtr_ -> setLogGate(activityGatePtr_);
+            }
+
             threadPoolPtr_ -> start(imageLoggerPtr_);
 
         } // if (logging_)
@@ -460,6 +506,29 @@ namespace bias
                 this
                 );
         imageDispatcherPtr_ -> setAutoDelete(false);
+        imageDispatcherPtr_ -> setLogRoi(videoWriterParams_.roi);
+        imageDispatcherPtr_ -> setBayerPattern(bayerPattern);
+        imageDispatcherPtr_ -> setFrameExport(frameExportPtr_);
+        if (isPluginEnabled())
+        {
+            QPointer<BiasPlugin> currentPluginPtr = getCurrentPlugin(); 
+            if (!currentPluginPtr.isNull())
+            {
+                imageDispatcherPtr_ -> setPluginDemosaic(currentPluginPtr -> requireColor());
+                imageDispatcherPtr_ -> setPluginSubscription(
+                        currentPluginPtr -> subscriptionMode(),
+                        currentPluginPtr -> subscriptionInterval(),
+                        currentPluginPtr -> frameQueueSize()
+                        );
+            }
+
+            RtnStatus pluginNameStatus;
+            QString pluginName = getCurrentPluginName(pluginNameStatus);
+            if (pluginNameStatus.success)
+            {
+                imageDispatcherPtr_ -> setPluginRoi(pluginRoiParamsMap_.value(pluginName));
+            }
+        }
 
         connect(
                 imageGrabberPtr_, 
@@ -622,6 +691,27 @@ namespace bias
         pluginImageQueuePtr_ -> clear();
         pluginImageQueuePtr_ -> releaseLock();
 
+        // Mark the shared memory segment closed so attached readers detach
+        if (frameExportPtr_)
+        {
+            frameExportPtr_ -> close();
+            frameExportPtr_.reset();
+        }
+
+        // Release pre-trigger frames - can hold up to maxMegaBytes of images
+        pretriggerBufferPtr_ -> acquireLock();
+        pretriggerBufferPtr_ -> clear();
+        pretriggerBufferPtr_ -> releaseLock();
+
+        // Close the last activity clip and write the clip index
+        bool activityIndexOk = true;
+        if (logging_ && videoWriterParams_.activity.activityFlag)
+        {
+            activityGatePtr_ -> acquireLock();
+            activityIndexOk = activityGatePtr_ -> finish();
+            activityGatePtr_ -> clear();
+            activityGatePtr_ -> releaseLock();
+        }
         
         if (isPluginEnabled())
         {
@@ -652,6 +742,18 @@ namespace bias
         delete imageDispatcherPtr_;
         delete imageLoggerPtr_;
 
+        if (!activityIndexOk)
+        {
+            QString errorMsg("unable to write activity clip index");
+            if (showErrorDlg)
+            {
+                imageLoggingError(ERROR_VIDEO_WRITER_FINISH, errorMsg);
+            }
+            rtnStatus.success = false;
+            rtnStatus.message = errorMsg;
+            return rtnStatus;
+        }
+
         rtnStatus.success = true;
         rtnStatus.message = QString("");
         return rtnStatus;
@@ -928,12 +1030,17 @@ namespace bias
         
         QVariantMap bmpSettingsMap;
         bmpSettingsMap.insert("frameSkip", videoWriterParams_.bmp.frameSkip);
+        bmpSettingsMap.insert("imageFormat", videoWriterParams_.bmp.imageFormat);
+        bmpSettingsMap.insert("compressionLevel", videoWriterParams_.bmp.compressionLevel);
+        bmpSettingsMap.insert("writerThreads", videoWriterParams_.bmp.numberOfWriters);
+        bmpSettingsMap.insert("framesPerDirectory", videoWriterParams_.bmp.framesPerDirectory);
         loggingSettingsMap.insert("bmp", bmpSettingsMap);
 
         QVariantMap jpgSettingsMap;
         jpgSettingsMap.insert("frameSkip", videoWriterParams_.jpg.frameSkip);
         jpgSettingsMap.insert("quality", videoWriterParams_.jpg.quality);
         jpgSettingsMap.insert("compressionThreads", videoWriterParams_.jpg.numberOfCompressors);
+        jpgSettingsMap.insert("slices", videoWriterParams_.jpg.numberOfSlices);
         jpgSettingsMap.insert("mjpg", videoWriterParams_.jpg.mjpgFlag);
         jpgSettingsMap.insert("mjpgMaxFramePerFileFlag", videoWriterParams_.jpg.mjpgMaxFramePerFileFlag);
         jpgSettingsMap.insert("mjpgMaxFramePerFile", (unsigned long long)(videoWriterParams_.jpg.mjpgMaxFramePerFile));
@@ -942,6 +1049,8 @@ namespace bias
         QVariantMap aviSettingsMap;
         aviSettingsMap.insert("frameSkip", videoWriterParams_.avi.frameSkip);
         aviSettingsMap.insert("codec", videoWriterParams_.avi.codec);
+        aviSettingsMap.insert("encoderThreads", videoWriterParams_.avi.numberOfEncoders);
+        aviSettingsMap.insert("segmentFrames", (unsigned long long)(videoWriterParams_.avi.segmentFrames));
         loggingSettingsMap.insert("avi", aviSettingsMap);
 
         QVariantMap fmfSettingsMap;
@@ -955,13 +1064,68 @@ namespace bias
         ufmfSettingsMap.insert("medianUpdateCount", videoWriterParams_.ufmf.medianUpdateCount);
         ufmfSettingsMap.insert("medianUpdateInterval", videoWriterParams_.ufmf.medianUpdateInterval);
         ufmfSettingsMap.insert("compressionThreads", videoWriterParams_.ufmf.numberOfCompressors);
+        ufmfSettingsMap.insert("backgroundModel", videoWriterParams_.ufmf.backgroundModel);
 
         QVariantMap ufmfDilateMap;
         ufmfDilateMap.insert("on", videoWriterParams_.ufmf.dilateState);
         ufmfDilateMap.insert("windowSize", videoWriterParams_.ufmf.dilateWindowSize);
         ufmfSettingsMap.insert("dilate", ufmfDilateMap);
+
+        QVariantMap ufmfKeyFrameDeltaMap;
+        ufmfKeyFrameDeltaMap.insert("on", videoWriterParams_.ufmf.keyFrameDeltaFlag);
+        ufmfKeyFrameDeltaMap.insert("tileSize", videoWriterParams_.ufmf.keyFrameTileSize);
+        ufmfKeyFrameDeltaMap.insert("fullInterval", videoWriterParams_.ufmf.keyFrameFullInterval);
+        ufmfSettingsMap.insert("keyFrameDelta", ufmfKeyFrameDeltaMap);
+
+        QVariantMap ufmfCompressPayloadMap;
+        ufmfCompressPayloadMap.insert("on", videoWriterParams_.ufmf.compressPayloadFlag);
+        ufmfCompressPayloadMap.insert("level", videoWriterParams_.ufmf.compressPayloadLevel);
+        ufmfSettingsMap.insert("compressPayload", ufmfCompressPayloadMap);
         
         loggingSettingsMap.insert("ufmf", ufmfSettingsMap);
+
+        QVariantMap zfmfSettingsMap;
+        zfmfSettingsMap.insert("frameSkip", videoWriterParams_.zfmf.frameSkip);
+        zfmfSettingsMap.insert("compressionThreads", videoWriterParams_.zfmf.numberOfCompressors);
+        zfmfSettingsMap.insert("compressionLevel", videoWriterParams_.zfmf.compressionLevel);
+        zfmfSettingsMap.insert("tileRows", videoWriterParams_.zfmf.tileRows);
+
+        QVariantMap zfmfDeltaMap;
+        zfmfDeltaMap.insert("on", videoWriterParams_.zfmf.deltaFlag);
+        zfmfDeltaMap.insert("keyFrameInterval", videoWriterParams_.zfmf.keyFrameInterval);
+        zfmfSettingsMap.insert("delta", zfmfDeltaMap);
+
+        loggingSettingsMap.insert("zfmf", zfmfSettingsMap);
+
+        QVariantMap segmentSettingsMap;
+        segmentSettingsMap.insert("on", videoWriterParams_.segment.segmentFlag);
+        segmentSettingsMap.insert("maxFrames", (unsigned long long)(videoWriterParams_.segment.maxFrames));
+        segmentSettingsMap.insert("maxMegaBytes", (unsigned long long)(videoWriterParams_.segment.maxMegaBytes));
+        segmentSettingsMap.insert("maxSeconds", videoWriterParams_.segment.maxSeconds);
+        loggingSettingsMap.insert("segment", segmentSettingsMap);
+
+        QVariantMap pretriggerSettingsMap;
+        pretriggerSettingsMap.insert("on", videoWriterParams_.pretrigger.pretriggerFlag);
+        pretriggerSettingsMap.insert("preSeconds", videoWriterParams_.pretrigger.preSeconds);
+        pretriggerSettingsMap.insert("postSeconds", videoWriterParams_.pretrigger.postSeconds);
+        pretriggerSettingsMap.insert("maxMegaBytes", (unsigned long long)(videoWriterParams_.pretrigger.maxMegaBytes));
+        loggingSettingsMap.insert("pretrigger", pretriggerSettingsMap);
+
+        QVariantMap activitySettingsMap;
+        activitySettingsMap.insert("on", videoWriterParams_.activity.activityFlag);
+        activitySettingsMap.insert("threshold", videoWriterParams_.activity.threshold);
+        activitySettingsMap.insert("startFraction", videoWriterParams_.activity.startFraction);
+        activitySettingsMap.insert("stopFraction", videoWriterParams_.activity.stopFraction);
+        activitySettingsMap.insert("downsample", videoWriterParams_.activity.downsample);
+        activitySettingsMap.insert("backgroundSeconds", videoWriterParams_.activity.backgroundSeconds);
+        activitySettingsMap.insert("preSeconds", videoWriterParams_.activity.preSeconds);
+        activitySettingsMap.insert("holdSeconds", videoWriterParams_.activity.holdSeconds);
+        activitySettingsMap.insert("minClipSeconds", videoWriterParams_.activity.minClipSeconds);
+        activitySettingsMap.insert("maxMegaBytes", (unsigned long long)(videoWriterParams_.activity.maxMegaBytes));
+        loggingSettingsMap.insert("activity", activitySettingsMap);
+        loggingSettingsMap.insert("roi", videoWriterParams_.roi.toMap());
+        loggingSettingsMap.insert("rawBayer", videoWriterParams_.rawBayerFlag);
+        loggingSettingsMap.insert("finishTimeout", videoWriterParams_.finishTimeout);
         loggingMap.insert("settings", loggingSettingsMap);
 
         // Add logging auto-naming options
@@ -997,6 +1161,11 @@ namespace bias
         QVariantMap serverMap;
         serverMap.insert("enabled",actionServerEnabledPtr_ -> isChecked());
         serverMap.insert("port", httpServerPort_);
+        QVariantMap frameExportMap;
+        frameExportMap.insert("enabled", frameExportEnabled_);
+        frameExportMap.insert("name", frameExportName_);
+        frameExportMap.insert("numSlots", frameExportSlots_);
+        serverMap.insert("frameExport", frameExportMap);
         configurationMap.insert("server", serverMap);
 
         // Add configuration configuration
@@ -1016,6 +1185,11 @@ namespace bias
                 pluginMap.insert("name", pluginName);
                 QVariantMap pluginConfigMap = getCurrentPlugin() -> getConfigAsMap();;
                 pluginMap.insert("config", pluginConfigMap);
+                pluginMap.insert("roi", pluginRoiParamsMap_[pluginName].toMap());
+                if (getCurrentPlugin() -> isReentrant())
+                {
+                    pluginMap.insert("maxInFlight", getCurrentPlugin() -> maxInFlight());
+                }
                 configurationMap.insert("plugin", pluginMap);
             }
         } 
@@ -1275,6 +1449,42 @@ namespace bias
         return rtnStatus;
     }
 
+
+    RtnStatus CameraWindow::triggerLogging(bool showErrorDlg)
+    {
+        RtnStatus rtnStatus;
+        QString msgTitle("Logging Trigger Error");
+        QString msgText;
+
+        if (!videoWriterParams_.pretrigger.pretriggerFlag)
+        {
+            msgText = QString("Unable to trigger logging: pre-trigger buffer not enabled");
+        }
+        else if (!(capturing_ && logging_))
+        {
+            msgText = QString("Unable to trigger logging: not capturing with logging enabled");
+        }
+
+        if (!msgText.isEmpty())
+        {
+            if (showErrorDlg)
+            {
+                QMessageBox::critical(this, msgTitle, msgText);
+            }
+            rtnStatus.success = false;
+            rtnStatus.message = msgText;
+            return rtnStatus;
+        }
+
+        pretriggerBufferPtr_ -> acquireLock();
+        pretriggerBufferPtr_ -> trigger();
+        pretriggerBufferPtr_ -> releaseLock();
+
+        rtnStatus.success = true;
+        rtnStatus.message = QString("");
+        return rtnStatus;
+    }
+
     
     QString CameraWindow::getCameraGuidString(RtnStatus &rtnStatus)
     {
@@ -1672,6 +1882,12 @@ namespace bias
     }
 
 
+    unsigned long CameraWindow::getPluginDropCount()
+    {
+        return pluginDropCount_;
+    }
+
+
     float CameraWindow::getFormat7PercentSpeed()
     {
         return format7PercentSpeed_;
@@ -1780,6 +1996,7 @@ namespace bias
         {
             bool haveNewImage = false;
             cv::Mat cameraImageMat;
+            BayerPattern bayerPattern = BAYER_PATTERN_NONE;
 
             // Get information from image dispatcher
             // -------------------------------------------------------------------
@@ -1787,9 +2004,11 @@ namespace bias
             if (imageDispatcherPtr_ -> tryLock(IMAGE_DISPLAY_CAMERA_LOCK_TRY_DT))
             {
                 cameraImageMat = imageDispatcherPtr_ -> getImage();
+                bayerPattern = imageDispatcherPtr_ -> getBayerPattern();
                 framesPerSec_ = imageDispatcherPtr_ -> getFPS();
                 timeStamp_ = imageDispatcherPtr_ -> getTimeStamp();
                 frameCount_ = imageDispatcherPtr_ -> getFrameCount();
+                pluginDropCount_ = imageDispatcherPtr_ -> getPluginDropCount();
                 imageDispatcherPtr_ -> releaseLock();
                 haveNewImage = true;
             }
@@ -1797,11 +2016,19 @@ namespace bias
 
             if (haveNewImage)
             {
+                if ((bayerPattern != BAYER_PATTERN_NONE) && (cameraImageMat.channels() == 1))
+                {
+                    // Demosaic at display rate, after the dispatcher is unlocked
+                    cameraImageMat = demosaicBayer(cameraImageMat, bayerPattern);
+                }
                 cv::Mat histMat = calcHistogram(cameraImageMat);
                 cv::Size imgSize = cameraImageMat.size();
                 if (colorMapNumber_ != COLORMAP_NONE)
                 {
-                    cv::applyColorMap(cameraImageMat,cameraImageMat, colorMapNumber_);
+                    // Not in place - the image is shared with the dispatcher
+                    cv::Mat colorMapImageMat;
+                    cv::applyColorMap(cameraImageMat, colorMapImageMat, colorMapNumber_);
+                    cameraImageMat = colorMapImageMat;
                 }
                 QImage img = matToQImage(cameraImageMat);
 
@@ -1823,6 +2050,10 @@ namespace bias
                     imageLoggerPtr_ -> releaseLock();
                     statusMsg += QString(",  log queue size = %1").arg(logQueueSize);
                 }
+                if (isPluginEnabled() && (pluginDropCount_ > 0))
+                {
+                    statusMsg += QString(",  plugin drops = %1").arg(pluginDropCount_);
+                }
                 updateStatusLabel(statusMsg);
 
                 // Set update capture time 
@@ -1847,13 +2078,19 @@ namespace bias
         if ((isPluginEnabled()) && (tabWidgetPtr_ -> currentWidget() == pluginPreviewTabPtr_))
         {
             bool haveNewImage = false;
-            cv::Mat pluginImageMat;
+            PluginPreview pluginPreview;
+
+            // Plugins may downscale to the label size, square so rotation 
+            // doesn't matter.
+            QSize labelSize = pluginImageLabelPtr_ -> size();
+            int maxDim = std::max(labelSize.width(), labelSize.height());
+            QSize previewMaxSize(maxDim, maxDim);
 
             if (!pluginHandlerPtr_.isNull())
             {
                 if (pluginHandlerPtr_ -> tryLock(IMAGE_DISPLAY_CAMERA_LOCK_TRY_DT))
                 {
-                    pluginImageMat = pluginHandlerPtr_ -> getImage();
+                    pluginPreview = pluginHandlerPtr_ -> getPreview(previewMaxSize);
                     pluginHandlerPtr_ -> releaseLock();
                     haveNewImage = true;
                 }
@@ -1861,13 +2098,13 @@ namespace bias
 
             if (haveNewImage)
             {
-
-                cv::Size pluginImageSize = pluginImageMat.size();
-                QImage pluginImage  = matToQImage(pluginImageMat);
+                QImage pluginImage  = matToQImage(pluginPreview.image);
 
                 if (!pluginImage.isNull())
                 {
                     pluginPixmapOriginal_ = QPixmap::fromImage(pluginImage);
+                    pluginPreviewScale_ = pluginPreview.scale;
+                    pluginOverlay_ = pluginPreview.overlay;
                 }
             }
         }
@@ -1929,13 +2166,20 @@ namespace bias
 
     void CameraWindow::imageLoggingError(unsigned int errorId, QString errorMsg)
     {
-        if ((errorId == ERROR_FRAMES_TODO_MAX_QUEUE_SIZE) || (errorId == ERROR_FRAMES_FINISHED_MAX_SET_SIZE))
+        bool isWarning = false;
+        isWarning |= (errorId == ERROR_FRAMES_TODO_MAX_QUEUE_SIZE);
+        isWarning |= (errorId == ERROR_FRAMES_FINISHED_MAX_SET_SIZE);
+        isWarning |= (errorId == ERROR_FRAMES_DROPPED_AT_FINISH);
+        if (isWarning)
         {
             skippedFramesWarning_ = true;
         }
         else
         {
-            stopImageCapture();
+            if (capturing_)
+            {
+                stopImageCapture();
+            }
             QString msgTitle("Image Logging Error");
             QString msgText("image logging has failed\n\nError ID: ");
             msgText += QString::number(errorId);
@@ -2196,6 +2440,10 @@ namespace bias
                 dialogTabWidgetPtr -> setCurrentWidget(loggingSettingsDialogPtr_ -> ufmfTabPtr_);
                 break;
 
+            case VIDEOFILE_FORMAT_ZFMF:
+                dialogTabWidgetPtr -> setCurrentWidget(loggingSettingsDialogPtr_ -> zfmfTabPtr_);
+                break;
+
             default:
                 break;
         }
@@ -2254,6 +2502,19 @@ namespace bias
     }
 
 
+    void CameraWindow::pluginRecordTriggerRequest(double timeStamp)
+    {
+        // Direct connection - may be called from the plugin thread. Stale 
+        // triggers are cleared when the next capture starts.
+        pretriggerBufferPtr_ -> acquireLock();
+        if (pretriggerBufferPtr_ -> isEnabled())
+        {
+            pretriggerBufferPtr_ -> trigger(timeStamp);
+        }
+        pretriggerBufferPtr_ -> releaseLock();
+    }
+
+
     void CameraWindow::actionTimerEnabledTriggered()
     {
         setCaptureTimeLabel(0.0);
@@ -2547,6 +2808,8 @@ namespace bias
         timeStamp_ = 0.0;
         framesPerSec_ = 0.0;
         frameCount_ = 0;
+        pluginDropCount_ = 0;
+        pluginPreviewScale_ = 1.0;
         userCameraName_ = QString("");
         format7PercentSpeed_ = DEFAULT_FORMAT7_PERCENT_SPEED;
         showCameraLockFailMsg_ = true;
@@ -2568,6 +2831,8 @@ namespace bias
         newImageQueuePtr_ = std::make_shared<LockableQueue<StampedImage>>();
         logImageQueuePtr_ = std::make_shared<LockableQueue<StampedImage>>();
         pluginImageQueuePtr_ = std::make_shared<LockableQueue<StampedImage>>();
+        pretriggerBufferPtr_ = std::make_shared<PretriggerBuffer>();
+        activityGatePtr_ = std::make_shared<ActivityGate>();
 
         setDefaultFileDirs();
         currentVideoFileDir_ = defaultVideoFileDir_;
@@ -2580,6 +2845,17 @@ namespace bias
         pluginHandlerPtr_  = new PluginHandler(this);
         pluginMap_[StampedePlugin::PLUGIN_NAME] = new StampedePlugin(this);
         pluginMap_[GrabDetectorPlugin::PLUGIN_NAME] = new GrabDetectorPlugin(pluginImageLabelPtr_,this);
+
+        for (QPointer<BiasPlugin> pluginPtr : pluginMap_)
+        {
+            connect(
+                    pluginPtr,
+                    SIGNAL(recordTriggerRequest(double)),
+                    this,
+                    SLOT(pluginRecordTriggerRequest(double)),
+                    Qt::DirectConnection
+                   );
+        }
         // -------------------------------------------------------------------------------
 
         setupStatusLabel();
@@ -2615,6 +2891,10 @@ namespace bias
 
         httpServerPort_  = HTTP_SERVER_PORT_BEGIN; 
         httpServerPort_ += HTTP_SERVER_PORT_STEP*(cameraNumber_ + 1);
+
+        frameExportEnabled_ = false;
+        frameExportName_ = FrameShmPublisher::getDefaultName(cameraNumber_);
+        frameExportSlots_ = FrameShmPublisher::DEFAULT_NUMBER_OF_SLOTS;
         httpServerPtr_ = new ExtCtlHttpServer(this,this);
         setServerPortText();
         if (DEFAULT_HTTP_SERVER_ENABLED)
@@ -2645,6 +2925,8 @@ namespace bias
         if (pluginPreview)
         {
             pluginPixmapOriginal_ = QPixmap::fromImage(dummyImage);
+            pluginPreviewScale_ = 1.0;
+            pluginOverlay_.clear();
         }
 
         if (histogram)
@@ -2787,6 +3069,13 @@ namespace bias
                 SLOT(actionLoggingFormatTriggered())
                );
 
+        connect(
+                actionLoggingFormatZFMFPtr_,
+                SIGNAL(triggered()),
+                this,
+                SLOT(actionLoggingFormatTriggered())
+               );
+
         connect(
                 actionLoggingFormatIFMFPtr_,
                 SIGNAL(triggered()),
@@ -3126,12 +3415,14 @@ namespace bias
         loggingFormatActionGroupPtr_ -> addAction(actionLoggingFormatAVIPtr_);
         loggingFormatActionGroupPtr_ -> addAction(actionLoggingFormatFMFPtr_);
         loggingFormatActionGroupPtr_ -> addAction(actionLoggingFormatUFMFPtr_);
+        loggingFormatActionGroupPtr_ -> addAction(actionLoggingFormatZFMFPtr_);
         loggingFormatActionGroupPtr_ -> addAction(actionLoggingFormatIFMFPtr_);
         actionToVideoFileFormatMap_[actionLoggingFormatBMPPtr_] = VIDEOFILE_FORMAT_BMP;
         actionToVideoFileFormatMap_[actionLoggingFormatJPGPtr_] = VIDEOFILE_FORMAT_JPG;
         actionToVideoFileFormatMap_[actionLoggingFormatAVIPtr_] = VIDEOFILE_FORMAT_AVI;
         actionToVideoFileFormatMap_[actionLoggingFormatFMFPtr_] = VIDEOFILE_FORMAT_FMF;
         actionToVideoFileFormatMap_[actionLoggingFormatUFMFPtr_] = VIDEOFILE_FORMAT_UFMF;
+        actionToVideoFileFormatMap_[actionLoggingFormatZFMFPtr_] = VIDEOFILE_FORMAT_ZFMF;
 
         if (logging_)
         {
@@ -3229,7 +3520,8 @@ namespace bias
             bool flipAndRotate,
             bool addFrameCount,
             bool addRoiBoundary,
-            bool addAlignmentObjs
+            bool addAlignmentObjs,
+            bool addPluginOverlay
             )
     {
         // Draw ROI
@@ -3260,8 +3552,44 @@ namespace bias
                 );
 
         float scaleFactor = float(pixmapScaled.width())/float(pixmapCopy.width());
+        if (addPluginOverlay)
+        {
+            // Plugin preview may be downscaled - keep the label's scale 
+            // factor relative to frame pixels.
+            scaleFactor *= float(pluginPreviewScale_);
+        }
         imageLabelPtr -> setScaleFactor(scaleFactor);
 
+        // Draw plugin overlay at display resolution
+        if (addPluginOverlay && !pluginOverlay_.isEmpty())
+        {
+            QPainter overlayPainter(&pixmapScaled);
+            for (const PluginOverlayBox &box : pluginOverlay_.boxList)
+            {
+                QPen boxPen = QPen(box.color);
+                boxPen.setWidth(box.lineWidth);
+                overlayPainter.setPen(boxPen);
+                overlayPainter.drawRect(
+                        int(scaleFactor*box.rect.x()),
+                        int(scaleFactor*box.rect.y()),
+                        int(scaleFactor*box.rect.width()),
+                        int(scaleFactor*box.rect.height())
+                        );
+            }
+            for (const PluginOverlayText &text : pluginOverlay_.textList)
+            {
+                QFont textFont = overlayPainter.font();
+                textFont.setPointSize(text.pointSize);
+                overlayPainter.setFont(textFont);
+                overlayPainter.setPen(text.color);
+                QFontMetrics textMetrics(textFont);
+                int textX = int(scaleFactor*text.position.x()) - textMetrics.width(text.text)/2;
+                int textY = int(scaleFactor*text.position.y()) + textMetrics.ascent();
+                overlayPainter.drawText(textX, textY, text.text);
+            }
+            overlayPainter.end();
+        }
+
         // Add alignment objects
         if (haveImagePixmap_ && addAlignmentObjs)
         { 
@@ -3375,7 +3703,8 @@ namespace bias
                 true,  
                 false, 
                 false,
-                false
+                false,
+                true
                 );
 
         updateImageLabel(
@@ -3395,7 +3724,8 @@ namespace bias
             bool flipAndRotate,
             bool addFrameCount,
             bool addRoiBoundary,
-            bool addAlignmentObjs
+            bool addAlignmentObjs,
+            bool addPluginOverlay
             )
     {
         // Determines if resize of pixmap of image on Qlabel is required and 
@@ -3418,7 +3748,8 @@ namespace bias
                     flipAndRotate,
                     addFrameCount,
                     addRoiBoundary,
-                    addAlignmentObjs
+                    addAlignmentObjs,
+                    addPluginOverlay
                     );
         }
     }
@@ -3441,7 +3772,8 @@ namespace bias
                 true, 
                 false, 
                 false, 
-                false
+                false,
+                true
                 );
 
         resizeImageLabel(
@@ -5092,7 +5424,67 @@ namespace bias
             rtnStatus.message = errMsgText;
             return rtnStatus;
         }
+
+        // Get optional "frameExport" settings - shared memory frame export
+        // -----------------------------------------------------------------
+        bool frameExportEnabled = frameExportEnabled_;
+        QString frameExportName = frameExportName_;
+        unsigned int frameExportSlots = frameExportSlots_;
+        if (serverMap.contains("frameExport"))
+        {
+            QVariantMap frameExportMap = serverMap["frameExport"].toMap();
+            QString errMsgText;
+            if (frameExportMap.contains("enabled"))
+            {
+                if (frameExportMap["enabled"].canConvert<bool>())
+                {
+                    frameExportEnabled = frameExportMap["enabled"].toBool();
+                }
+                else
+                {
+                    errMsgText = QString("Server configuration: unable to convert frameExport enabled to bool");
+                }
+            }
+            if (errMsgText.isEmpty() && frameExportMap.contains("name"))
+            {
+                frameExportName = frameExportMap["name"].toString();
+                if (!frameExportName.startsWith("/") || (frameExportName.indexOf("/",1) != -1) 
+                        || (frameExportName.length() < 2))
+                {
+                    errMsgText = QString("Server configuration: frameExport name must be of the form /name");
+                }
+            }
+            if (errMsgText.isEmpty() && frameExportMap.contains("numSlots"))
+            {
+                bool ok = false;
+                frameExportSlots = frameExportMap["numSlots"].toUInt(&ok);
+                if (!ok || (frameExportSlots < 2) 
+                        || (frameExportSlots > FrameShmPublisher::MAXIMUM_NUMBER_OF_SLOTS))
+                {
+                    errMsgText = QString("Server configuration: frameExport numSlots must be in range [2, %1]").arg(
+                            FrameShmPublisher::MAXIMUM_NUMBER_OF_SLOTS
+                            );
+                }
+            }
+            if (errMsgText.isEmpty() && frameExportEnabled && !FrameShmPublisher::isSupported())
+            {
+                errMsgText = QString("Server configuration: frameExport is not supported on this platform");
+            }
+            if (!errMsgText.isEmpty())
+            {
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+        }
         httpServerPort_ = port;
+        frameExportEnabled_ = frameExportEnabled;
+        frameExportName_ = frameExportName;
+        frameExportSlots_ = frameExportSlots;
 
         if (serverEnabled)
         {
@@ -5292,6 +5684,46 @@ namespace bias
             return rtnStatus;
         }
 
+        // Software roi crop/binning of the plugin's frames - optional
+        QVariantMap pluginRoiMap = pluginMap["roi"].toMap();
+        if (!pluginRoiMap.isEmpty())
+        {
+            ImageRoiParams roiParams = pluginRoiParamsMap_[configPluginName];
+            RtnStatus roiStatus = roiParams.fromMap(pluginRoiMap);
+            if (!roiStatus.success)
+            {
+                QString errMsgText("Plugin: error setting roi - ");
+                errMsgText += roiStatus.message;
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            pluginRoiParamsMap_[configPluginName] = roiParams;
+        }
+
+        // Frames processed concurrently by reentrant plugins - optional
+        if (pluginMap.contains("maxInFlight"))
+        {
+            bool ok = false;
+            unsigned int maxInFlight = pluginMap["maxInFlight"].toUInt(&ok);
+            if (!ok || (maxInFlight == 0))
+            {
+                QString errMsgText("Plugin: maxInFlight must be an integer > 0");
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            getCurrentPlugin() -> setMaxInFlight(maxInFlight);
+        }
+
         setPluginEnabled(true);
 
         return rtnStatus;
@@ -6159,39 +6591,97 @@ namespace bias
         }
         videoWriterParams_.avi.codec = aviCodec;
 
-
-        // Get bmp values
-        // --------------
-        QVariantMap bmpMap = formatMap["bmp"].toMap();
-        if (bmpMap.isEmpty())
+        if (aviMap.contains("encoderThreads"))
         {
-            QString errMsgText("Logging Settings: bmp settings not present");
-            if (showErrorDlg)
+            if (!aviMap["encoderThreads"].canConvert<unsigned int>())
             {
-                QMessageBox::critical(this,errMsgTitle,errMsgText);
+                QString errMsgText("Logging Settings: avi unable to convert encoderThreads to unsigned int");
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
             }
-            rtnStatus.success = false;
-            rtnStatus.message = errMsgText;
-            return rtnStatus;
-        }
-        if (!bmpMap.contains("frameSkip"))
-        {
-            QString errMsgText("Logging Settings: bmp frameSkip not present");
-            if (showErrorDlg)
+            unsigned int aviEncoders = aviMap["encoderThreads"].toUInt();
+            if ((aviEncoders < 1) || (aviEncoders > VideoWriter_avi::MAX_NUMBER_OF_ENCODERS))
             {
-                QMessageBox::critical(this,errMsgTitle,errMsgText);
+                QString errMsgText = QString("Logging Settings: avi encoderThreads must be in range [1,%1]").arg(
+                        VideoWriter_avi::MAX_NUMBER_OF_ENCODERS);
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
             }
-            rtnStatus.success = false;
-            rtnStatus.message = errMsgText;
-            return rtnStatus;
+            videoWriterParams_.avi.numberOfEncoders = aviEncoders;
         }
-        if (!bmpMap["frameSkip"].canConvert<unsigned int>())
+
+        if (aviMap.contains("segmentFrames"))
         {
-            QString errMsgText("Logging Settings: bmp unable to convert");
-            errMsgText += " frameSkip to unsigned int";
-            if (showErrorDlg)
+            if (!aviMap["segmentFrames"].canConvert<unsigned long long>())
             {
-                QMessageBox::critical(this,errMsgTitle,errMsgText);
+                QString errMsgText("Logging Settings: avi unable to convert segmentFrames to unsigned long");
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            unsigned long aviSegmentFrames = (unsigned long)(aviMap["segmentFrames"].toULongLong());
+            if (aviSegmentFrames < VideoWriter_avi::MIN_SEGMENT_FRAMES)
+            {
+                QString errMsgText = QString("Logging Settings: avi segmentFrames must be >= %1").arg(
+                        VideoWriter_avi::MIN_SEGMENT_FRAMES);
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.avi.segmentFrames = aviSegmentFrames;
+        }
+
+
+        // Get bmp values
+        // --------------
+        QVariantMap bmpMap = formatMap["bmp"].toMap();
+        if (bmpMap.isEmpty())
+        {
+            QString errMsgText("Logging Settings: bmp settings not present");
+            if (showErrorDlg)
+            {
+                QMessageBox::critical(this,errMsgTitle,errMsgText);
+            }
+            rtnStatus.success = false;
+            rtnStatus.message = errMsgText;
+            return rtnStatus;
+        }
+        if (!bmpMap.contains("frameSkip"))
+        {
+            QString errMsgText("Logging Settings: bmp frameSkip not present");
+            if (showErrorDlg)
+            {
+                QMessageBox::critical(this,errMsgTitle,errMsgText);
+            }
+            rtnStatus.success = false;
+            rtnStatus.message = errMsgText;
+            return rtnStatus;
+        }
+        if (!bmpMap["frameSkip"].canConvert<unsigned int>())
+        {
+            QString errMsgText("Logging Settings: bmp unable to convert");
+            errMsgText += " frameSkip to unsigned int";
+            if (showErrorDlg)
+            {
+                QMessageBox::critical(this,errMsgTitle,errMsgText);
             }
             rtnStatus.success = false;
             rtnStatus.message = errMsgText;
@@ -6212,6 +6702,102 @@ namespace bias
         }
         videoWriterParams_.bmp.frameSkip = bmpFrameSkip;
 
+        // bmp image sequence settings - new optional parameters
+        if (bmpMap.contains("imageFormat"))
+        {
+            QString bmpImageFormat = bmpMap["imageFormat"].toString();
+            if (!VideoWriter_bmp::isAllowedImageFormat(bmpImageFormat))
+            {
+                QString errMsgText = QString("Logging Settings: bmp imageFormat, %1, is not allowed").arg(bmpImageFormat);
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.bmp.imageFormat = bmpImageFormat;
+        }
+        if (bmpMap.contains("compressionLevel"))
+        {
+            int bmpCompressionLevel = bmpMap["compressionLevel"].toInt();
+            if (
+                    (bmpCompressionLevel < VideoWriter_bmp::MIN_COMPRESSION_LEVEL) || 
+                    (bmpCompressionLevel > VideoWriter_bmp::MAX_COMPRESSION_LEVEL)
+               )
+            {
+                QString errMsgText = QString("Logging Settings: bmp compressionLevel must be in range (%1, %2)").arg(
+                        VideoWriter_bmp::MIN_COMPRESSION_LEVEL).arg(VideoWriter_bmp::MAX_COMPRESSION_LEVEL);
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.bmp.compressionLevel = bmpCompressionLevel;
+        }
+        if (bmpMap.contains("writerThreads"))
+        {
+            if (!bmpMap["writerThreads"].canConvert<int>())
+            {
+                QString errMsgText("Logging Settings: bmp unable to convert");
+                errMsgText += " writerThreads to int";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            int bmpWriterThreads = bmpMap["writerThreads"].toInt();
+            if ((bmpWriterThreads < 0) || (bmpWriterThreads > int(VideoWriter_bmp::MAX_NUMBER_OF_WRITERS)))
+            {
+                QString errMsgText = QString("Logging Settings: bmp writerThreads must be in range (0, %1)").arg(
+                        VideoWriter_bmp::MAX_NUMBER_OF_WRITERS);
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.bmp.numberOfWriters = (unsigned int)(bmpWriterThreads);
+        }
+        if (bmpMap.contains("framesPerDirectory"))
+        {
+            if (!bmpMap["framesPerDirectory"].canConvert<int>())
+            {
+                QString errMsgText("Logging Settings: bmp unable to convert");
+                errMsgText += " framesPerDirectory to int";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            int bmpFramesPerDirectory = bmpMap["framesPerDirectory"].toInt();
+            if (bmpFramesPerDirectory < 0)
+            {
+                QString errMsgText("Logging Settings: bmp framesPerDirectory must");
+                errMsgText += " be >= 0 (0 = single directory)";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.bmp.framesPerDirectory = (unsigned int)(bmpFramesPerDirectory);
+        }
+
         // Get jpg values - ignore if not there
         // --------------
         QVariantMap jpgMap = formatMap["jpg"].toMap();
@@ -6407,6 +6993,35 @@ namespace bias
                 videoWriterParams_.jpg.mjpgMaxFramePerFile = maxFramePerFile;
                 }
             }
+
+            if (jpgMap.contains("slices"))
+            {
+                if (!jpgMap["slices"].canConvert<unsigned int>())
+                {
+                    QString errMsgText("Logging Settings: jpg unable to convert slices to unsigned int");
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                unsigned int jpgSlices = jpgMap["slices"].toUInt();
+                if ((jpgSlices < VideoWriter_jpg::MIN_NUMBER_OF_SLICES) || (jpgSlices > VideoWriter_jpg::MAX_NUMBER_OF_SLICES))
+                {
+                    QString errMsgText = QString("Logging Settings: jpg slices must be in range [%1,%2]").arg(
+                            VideoWriter_jpg::MIN_NUMBER_OF_SLICES).arg(VideoWriter_jpg::MAX_NUMBER_OF_SLICES);
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.jpg.numberOfSlices = jpgSlices;
+            }
         }
 
         // Get fmf values
@@ -6827,6 +7442,544 @@ namespace bias
         // ----------------------------------------------------------------------
         videoWriterParams_.ufmf.dilateWindowSize = ufmfDilateWindowSize;
 
+        // ufmf background model - new optional parameter
+        if (ufmfMap.contains("backgroundModel"))
+        {
+            if (!ufmfMap["backgroundModel"].canConvert<QString>())
+            {
+                QString errMsgText("Logging Settings: unable to convert");
+                errMsgText += " ufmf backgroundModel to string";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            QString ufmfBackgroundModel = ufmfMap["backgroundModel"].toString();
+            if (!VideoWriter_ufmf::isAllowedBackgroundModel(ufmfBackgroundModel))
+            {
+                QString errMsgText = QString("Logging Settings: ufmf backgroundModel %1").arg(ufmfBackgroundModel);
+                errMsgText += " is not allowed";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.ufmf.backgroundModel = ufmfBackgroundModel;
+        }
+
+        // ufmf delta keyframes - new optional parameter
+        if (ufmfMap.contains("keyFrameDelta"))
+        {
+            QVariantMap ufmfKeyFrameDeltaMap = ufmfMap["keyFrameDelta"].toMap();
+
+            if (!ufmfKeyFrameDeltaMap["on"].canConvert<bool>())
+            {
+                QString errMsgText("Logging Settings: unable to convert");
+                errMsgText += " ufmf keyFrameDelta on to bool";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.ufmf.keyFrameDeltaFlag = ufmfKeyFrameDeltaMap["on"].toBool();
+
+            if (ufmfKeyFrameDeltaMap.contains("tileSize"))
+            {
+                unsigned int tileSize = ufmfKeyFrameDeltaMap["tileSize"].toUInt();
+                if ( 
+                        (tileSize < VideoWriter_ufmf::MIN_KEYFRAME_TILE_SIZE) || 
+                        (tileSize > VideoWriter_ufmf::MAX_KEYFRAME_TILE_SIZE)
+                   )
+                {
+                    QString errMsgText = QString("Logging Settings: ufmf keyFrameDelta tileSize must be in range (%1, %2)").arg(
+                            VideoWriter_ufmf::MIN_KEYFRAME_TILE_SIZE).arg(VideoWriter_ufmf::MAX_KEYFRAME_TILE_SIZE);
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.ufmf.keyFrameTileSize = tileSize;
+            }
+
+            if (ufmfKeyFrameDeltaMap.contains("fullInterval"))
+            {
+                unsigned int fullInterval = ufmfKeyFrameDeltaMap["fullInterval"].toUInt();
+                if (fullInterval < VideoWriter_ufmf::MIN_KEYFRAME_FULL_INTERVAL)
+                {
+                    QString errMsgText = QString("Logging Settings: ufmf keyFrameDelta fullInterval must be >= %1").arg(
+                            VideoWriter_ufmf::MIN_KEYFRAME_FULL_INTERVAL);
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.ufmf.keyFrameFullInterval = fullInterval;
+            }
+        }
+
+        // ufmf compressed frame payload - new optional parameter
+        if (ufmfMap.contains("compressPayload"))
+        {
+            QVariantMap ufmfCompressPayloadMap = ufmfMap["compressPayload"].toMap();
+
+            if (!ufmfCompressPayloadMap["on"].canConvert<bool>())
+            {
+                QString errMsgText("Logging Settings: unable to convert");
+                errMsgText += " ufmf compressPayload on to bool";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.ufmf.compressPayloadFlag = ufmfCompressPayloadMap["on"].toBool();
+
+            if (ufmfCompressPayloadMap.contains("level"))
+            {
+                int level = ufmfCompressPayloadMap["level"].toInt();
+                if (
+                        (level < VideoWriter_ufmf::MIN_COMPRESS_PAYLOAD_LEVEL) || 
+                        (level > VideoWriter_ufmf::MAX_COMPRESS_PAYLOAD_LEVEL)
+                   )
+                {
+                    QString errMsgText = QString("Logging Settings: ufmf compressPayload level must be in range (%1, %2)").arg(
+                            VideoWriter_ufmf::MIN_COMPRESS_PAYLOAD_LEVEL).arg(VideoWriter_ufmf::MAX_COMPRESS_PAYLOAD_LEVEL);
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.ufmf.compressPayloadLevel = level;
+            }
+        }
+
+        // Get zfmf values - new optional format
+        // ------------------------------------------------------------------------------
+        QVariantMap zfmfMap = formatMap["zfmf"].toMap();
+        if (!zfmfMap.isEmpty())
+        {
+            // zfmf Frame Skip
+            if (zfmfMap.contains("frameSkip"))
+            {
+                unsigned int zfmfFrameSkip = zfmfMap["frameSkip"].toUInt();
+                if (zfmfFrameSkip == 0)
+                {
+                    QString errMsgText("Logging Settings: zfmf frameSkip must");
+                    errMsgText += " be greater than zero";
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.zfmf.frameSkip = zfmfFrameSkip;
+            }
+
+            // zfmf Compression Threads
+            if (zfmfMap.contains("compressionThreads"))
+            {
+                unsigned int zfmfCompressionThreads = zfmfMap["compressionThreads"].toUInt();
+                if (zfmfCompressionThreads == 0)
+                {
+                    QString errMsgText("Logging Settings: zfmf compressionThreads must");
+                    errMsgText += " be greater than zero";
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.zfmf.numberOfCompressors = zfmfCompressionThreads;
+            }
+
+            // zfmf Compression Level
+            if (zfmfMap.contains("compressionLevel"))
+            {
+                int zfmfCompressionLevel = zfmfMap["compressionLevel"].toInt();
+                if (
+                        (zfmfCompressionLevel < VideoWriter_zfmf::MIN_COMPRESSION_LEVEL) || 
+                        (zfmfCompressionLevel > VideoWriter_zfmf::MAX_COMPRESSION_LEVEL)
+                   )
+                {
+                    QString errMsgText = QString("Logging Settings: zfmf compressionLevel must be in range (%1, %2)").arg(
+                            VideoWriter_zfmf::MIN_COMPRESSION_LEVEL).arg(VideoWriter_zfmf::MAX_COMPRESSION_LEVEL);
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.zfmf.compressionLevel = zfmfCompressionLevel;
+            }
+
+            // zfmf Tile Rows
+            if (zfmfMap.contains("tileRows"))
+            {
+                unsigned int zfmfTileRows = zfmfMap["tileRows"].toUInt();
+                if (
+                        (zfmfTileRows < VideoWriter_zfmf::MIN_TILE_ROWS) || 
+                        (zfmfTileRows > VideoWriter_zfmf::MAX_TILE_ROWS)
+                   )
+                {
+                    QString errMsgText = QString("Logging Settings: zfmf tileRows must be in range (%1, %2)").arg(
+                            VideoWriter_zfmf::MIN_TILE_ROWS).arg(VideoWriter_zfmf::MAX_TILE_ROWS);
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.zfmf.tileRows = zfmfTileRows;
+            }
+
+            // zfmf Delta frames
+            if (zfmfMap.contains("delta"))
+            {
+                QVariantMap zfmfDeltaMap = zfmfMap["delta"].toMap();
+                if (!zfmfDeltaMap["on"].canConvert<bool>())
+                {
+                    QString errMsgText("Logging Settings: unable to convert");
+                    errMsgText += " zfmf delta on to bool";
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.zfmf.deltaFlag = zfmfDeltaMap["on"].toBool();
+
+                if (zfmfDeltaMap.contains("keyFrameInterval"))
+                {
+                    unsigned int keyFrameInterval = zfmfDeltaMap["keyFrameInterval"].toUInt();
+                    if (keyFrameInterval < VideoWriter_zfmf::MIN_KEYFRAME_INTERVAL)
+                    {
+                        QString errMsgText = QString("Logging Settings: zfmf delta keyFrameInterval must be >= %1").arg(
+                                VideoWriter_zfmf::MIN_KEYFRAME_INTERVAL);
+                        if (showErrorDlg)
+                        {
+                            QMessageBox::critical(this,errMsgTitle,errMsgText);
+                        }
+                        rtnStatus.success = false;
+                        rtnStatus.message = errMsgText;
+                        return rtnStatus;
+                    }
+                    videoWriterParams_.zfmf.keyFrameInterval = keyFrameInterval;
+                }
+            }
+        }
+
+        // Get file segment (rotation) values - new optional parameter
+        // ------------------------------------------------------------------------------
+        QVariantMap segmentMap = formatMap["segment"].toMap();
+        if (!segmentMap.isEmpty())
+        {
+            if (!segmentMap["on"].canConvert<bool>())
+            {
+                QString errMsgText("Logging Settings: unable to convert");
+                errMsgText += " segment on to bool";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.segment.segmentFlag = segmentMap["on"].toBool();
+
+            if (segmentMap.contains("maxFrames"))
+            {
+                videoWriterParams_.segment.maxFrames = (unsigned long)(segmentMap["maxFrames"].toULongLong());
+            }
+            if (segmentMap.contains("maxMegaBytes"))
+            {
+                videoWriterParams_.segment.maxMegaBytes = (unsigned long)(segmentMap["maxMegaBytes"].toULongLong());
+            }
+            if (segmentMap.contains("maxSeconds"))
+            {
+                double maxSeconds = segmentMap["maxSeconds"].toDouble();
+                if (maxSeconds < 0.0)
+                {
+                    QString errMsgText("Logging Settings: segment maxSeconds must be >= 0");
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.segment.maxSeconds = maxSeconds;
+            }
+        }
+
+        // Get pre-trigger buffer (event triggered logging) values - new optional parameter
+        // ------------------------------------------------------------------------------
+        VideoWriterParams_pretrigger pretriggerParamsOrig = videoWriterParams_.pretrigger;
+        VideoWriterParams_activity activityParamsOrig = videoWriterParams_.activity;
+        QVariantMap pretriggerMap = formatMap["pretrigger"].toMap();
+        if (!pretriggerMap.isEmpty())
+        {
+            if (!pretriggerMap["on"].canConvert<bool>())
+            {
+                QString errMsgText("Logging Settings: unable to convert");
+                errMsgText += " pretrigger on to bool";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.pretrigger.pretriggerFlag = pretriggerMap["on"].toBool();
+
+            QStringList secondsKeyList = {"preSeconds", "postSeconds"};
+            for (QString secondsKey : secondsKeyList)
+            {
+                if (!pretriggerMap.contains(secondsKey))
+                {
+                    continue;
+                }
+                double seconds = pretriggerMap[secondsKey].toDouble();
+                if (seconds < 0.0)
+                {
+                    QString errMsgText = QString("Logging Settings: pretrigger %1 must be >= 0").arg(secondsKey);
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                if (secondsKey == QString("preSeconds"))
+                {
+                    videoWriterParams_.pretrigger.preSeconds = seconds;
+                }
+                else
+                {
+                    videoWriterParams_.pretrigger.postSeconds = seconds;
+                }
+            }
+
+            if (pretriggerMap.contains("maxMegaBytes"))
+            {
+                unsigned long maxMegaBytes = (unsigned long)(pretriggerMap["maxMegaBytes"].toULongLong());
+                if (maxMegaBytes == 0)
+                {
+                    QString errMsgText("Logging Settings: pretrigger maxMegaBytes must be > 0");
+                    if (showErrorDlg)
+                    {
+                        QMessageBox::critical(this,errMsgTitle,errMsgText);
+                    }
+                    rtnStatus.success = false;
+                    rtnStatus.message = errMsgText;
+                    return rtnStatus;
+                }
+                videoWriterParams_.pretrigger.maxMegaBytes = maxMegaBytes;
+            }
+        }
+
+        // Get activity gate (activity gated logging) values - new optional parameter
+        // ------------------------------------------------------------------------------
+        QVariantMap activityMap = formatMap["activity"].toMap();
+        if (!activityMap.isEmpty())
+        {
+            VideoWriterParams_activity activityParams = videoWriterParams_.activity;
+            if (!activityMap["on"].canConvert<bool>())
+            {
+                QString errMsgText("Logging Settings: unable to convert");
+                errMsgText += " activity on to bool";
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            activityParams.activityFlag = activityMap["on"].toBool();
+
+            if (activityMap.contains("threshold"))
+            {
+                activityParams.threshold = activityMap["threshold"].toUInt();
+            }
+            if (activityMap.contains("startFraction"))
+            {
+                activityParams.startFraction = activityMap["startFraction"].toDouble();
+            }
+            if (activityMap.contains("stopFraction"))
+            {
+                activityParams.stopFraction = activityMap["stopFraction"].toDouble();
+            }
+            if (activityMap.contains("downsample"))
+            {
+                activityParams.downsample = activityMap["downsample"].toUInt();
+            }
+            if (activityMap.contains("backgroundSeconds"))
+            {
+                activityParams.backgroundSeconds = activityMap["backgroundSeconds"].toDouble();
+            }
+            if (activityMap.contains("preSeconds"))
+            {
+                activityParams.preSeconds = activityMap["preSeconds"].toDouble();
+            }
+            if (activityMap.contains("holdSeconds"))
+            {
+                activityParams.holdSeconds = activityMap["holdSeconds"].toDouble();
+            }
+            if (activityMap.contains("minClipSeconds"))
+            {
+                activityParams.minClipSeconds = activityMap["minClipSeconds"].toDouble();
+            }
+            if (activityMap.contains("maxMegaBytes"))
+            {
+                activityParams.maxMegaBytes = (unsigned long)(activityMap["maxMegaBytes"].toULongLong());
+            }
+
+            QString errMsgText;
+            if ((activityParams.startFraction <= 0.0) || (activityParams.startFraction > 1.0))
+            {
+                errMsgText = QString("Logging Settings: activity startFraction must be in (0, 1]");
+            }
+            else if ((activityParams.stopFraction < 0.0) || (activityParams.stopFraction > activityParams.startFraction))
+            {
+                errMsgText = QString("Logging Settings: activity stopFraction must be in [0, startFraction]");
+            }
+            else if (activityParams.downsample == 0)
+            {
+                errMsgText = QString("Logging Settings: activity downsample must be > 0");
+            }
+            else if (
+                    (activityParams.backgroundSeconds < 0.0) || (activityParams.preSeconds < 0.0) || 
+                    (activityParams.holdSeconds < 0.0) || (activityParams.minClipSeconds < 0.0)
+                    )
+            {
+                errMsgText = QString("Logging Settings: activity times must be >= 0");
+            }
+            if (!errMsgText.isEmpty())
+            {
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.activity = activityParams;
+        }
+
+        // Pre-trigger and activity gating both gate the logged frames - only one at a time
+        if (videoWriterParams_.pretrigger.pretriggerFlag && videoWriterParams_.activity.activityFlag)
+        {
+            videoWriterParams_.pretrigger = pretriggerParamsOrig;
+            videoWriterParams_.activity = activityParamsOrig;
+            QString errMsgText("Logging Settings: pretrigger and activity can not both be on");
+            if (showErrorDlg)
+            {
+                QMessageBox::critical(this,errMsgTitle,errMsgText);
+            }
+            rtnStatus.success = false;
+            rtnStatus.message = errMsgText;
+            return rtnStatus;
+        }
+
+        // Get software roi crop/binning for logged frames - new optional parameter
+        // ------------------------------------------------------------------------------
+        ImageRoiParams roiParamsOrig = videoWriterParams_.roi;
+        bool rawBayerFlagOrig = videoWriterParams_.rawBayerFlag;
+        QVariantMap roiMap = formatMap["roi"].toMap();
+        if (!roiMap.isEmpty())
+        {
+            RtnStatus roiStatus = videoWriterParams_.roi.fromMap(roiMap);
+            if (!roiStatus.success)
+            {
+                QString errMsgText = QString("Logging Settings: ") + roiStatus.message;
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+        }
+
+        // Get video writer finish timeout (sec) - new optional parameter
+        // ------------------------------------------------------------------------------
+        if (formatMap.contains("finishTimeout"))
+        {
+            double finishTimeout = formatMap["finishTimeout"].toDouble();
+            if (finishTimeout < 0.0)
+            {
+                QString errMsgText("Logging Settings: finishTimeout must be >= 0");
+                if (showErrorDlg)
+                {
+                    QMessageBox::critical(this,errMsgTitle,errMsgText);
+                }
+                rtnStatus.success = false;
+                rtnStatus.message = errMsgText;
+                return rtnStatus;
+            }
+            videoWriterParams_.finishTimeout = finishTimeout;
+        }
+
+        // Get raw Bayer logging flag - new optional parameter
+        // ------------------------------------------------------------------------------
+        if (formatMap.contains("rawBayer"))
+        {
+            videoWriterParams_.rawBayerFlag = formatMap["rawBayer"].toBool();
+        }
+
+        // Check the combination once all settings are loaded. Binning would mix
+        // the colors of the mosaic so it isn't allowed with raw logging.
+        // ------------------------------------------------------------------------------
+        if (videoWriterParams_.rawBayerFlag && videoWriterParams_.roi.roiFlag && (videoWriterParams_.roi.binning > 1))
+        {
+            videoWriterParams_.roi = roiParamsOrig;
+            videoWriterParams_.rawBayerFlag = rawBayerFlagOrig;
+            QString errMsgText("Logging Settings: rawBayer can't be used with roi binning > 1");
+            if (showErrorDlg)
+            {
+                QMessageBox::critical(this,errMsgTitle,errMsgText);
+            }
+            rtnStatus.success = false;
+            rtnStatus.message = errMsgText;
+            return rtnStatus;
+        }
+
         rtnStatus.success = true;
         rtnStatus.message = QString("");
         return rtnStatus;
@@ -36,6 +36,9 @@ namespace bias
     class ImageDispatcher;
     class ImageLogger; 
     class PluginHandler;
+    class PretriggerBuffer;
+    class ActivityGate;
+    class FrameShmPublisher;
     class TimerSettingsDialog;
     class LoggingSettingsDialog;
     class AutoNamingDialog;
@@ -81,6 +84,7 @@ namespace bias
 
             RtnStatus enableLogging(bool showErrorDlg=true);
             RtnStatus disableLogging(bool showErrorDlg=true);
+            RtnStatus triggerLogging(bool showErrorDlg=true);
 
             RtnStatus saveConfiguration(
                     QString filename, 
@@ -110,6 +114,7 @@ namespace bias
             RtnStatus setPluginEnabled(bool enabled);
             RtnStatus setCurrentPlugin(QString pluginName);
             QString getCurrentPluginName(RtnStatus &rtnStatus);
+            QPointer<BiasPlugin> getCurrentPlugin();
             RtnStatus runPluginCmd(
                     QByteArray jsonPluginCmdArray, 
                     bool showErrorDlg=true
@@ -127,6 +132,7 @@ namespace bias
             double getTimeStamp();
             double getFramesPerSec();
             unsigned long getFrameCount();
+            unsigned long getPluginDropCount();
             float getFormat7PercentSpeed();
 
         signals:
@@ -209,6 +215,9 @@ namespace bias
             void alignmentSettingsChanged(AlignmentSettings);
             void autoNamingOptionsChanged(AutoNamingOptions options);
 
+            // Plugin requests
+            void pluginRecordTriggerRequest(double timeStamp);
+
         private:
 
             bool connected_;
@@ -243,6 +252,7 @@ namespace bias
             ImageRotationType imageRotation_;
             VideoFileFormat videoFileFormat_;
             unsigned long frameCount_;
+            unsigned long pluginDropCount_;
             unsigned long captureDurationSec_;
             AutoNamingOptions autoNamingOptions_;
 
@@ -250,6 +260,8 @@ namespace bias
 
             QPixmap previewPixmapOriginal_;
             QPixmap pluginPixmapOriginal_;
+            double pluginPreviewScale_;
+            PluginOverlay pluginOverlay_;
             QPixmap histogramPixmapOriginal_;
 
             QPointer<QActionGroup> videoModeActionGroupPtr_; 
@@ -274,6 +286,9 @@ namespace bias
             std::shared_ptr<LockableQueue<StampedImage>> newImageQueuePtr_;
             std::shared_ptr<LockableQueue<StampedImage>> logImageQueuePtr_;
             std::shared_ptr<LockableQueue<StampedImage>> pluginImageQueuePtr_;
+            std::shared_ptr<PretriggerBuffer> pretriggerBufferPtr_;
+            std::shared_ptr<ActivityGate> activityGatePtr_;
+            std::shared_ptr<FrameShmPublisher> frameExportPtr_;
 
             QPointer<QThreadPool> threadPoolPtr_;
 
@@ -295,10 +310,15 @@ namespace bias
             QPointer<AlignmentSettingsDialog> alignmentSettingsDialogPtr_;
 
             VideoWriterParams videoWriterParams_;
+            QMap<QString, ImageRoiParams> pluginRoiParamsMap_;
 
             QPointer<ExtCtlHttpServer> httpServerPtr_;
             unsigned int httpServerPort_;
 
+            bool frameExportEnabled_;
+            QString frameExportName_;
+            unsigned int frameExportSlots_;
+
             void connectWidgets();
             void initialize(
                     Guid guid, 
@@ -312,8 +332,6 @@ namespace bias
             void setupCaptureDurationTimer();
             void updateWindowTitle();
             
-            QPointer<BiasPlugin> getCurrentPlugin();
-            
             // Menu and statusbar setup methods
             void setupCameraMenu();
             void setupLoggingMenu();
@@ -356,7 +374,8 @@ namespace bias
                     bool flipAndRotate=true,
                     bool addFrameCount=true,
                     bool addRoiBoundary=true,
-                    bool addAlignmentObjs=true
+                    bool addAlignmentObjs=true,
+                    bool addPluginOverlay=false
                     );
             void updateAllImageLabels();
 
@@ -366,7 +385,8 @@ namespace bias
                     bool flipAndRotate=true,
                     bool addFrameCount=true,
                     bool addRoiBoundary=true,
-                    bool addAlignmentObjs=true
+                    bool addAlignmentObjs=true,
+                    bool addPluginOverlay=false
                     );
 
             void resizeAllImageLabels();
@@ -183,6 +183,27 @@ namespace bias
         haveEncoding_ = true;
     }
 
+    void CompressedFrame_jpg::write(SliceEncoder_jpg &sliceEncoder)
+    {
+        try
+        {
+            sliceEncoder.write(stampedImg_.image, quality_, fileName_.toStdString());
+        }
+        catch (cv::Exception &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+            std::string errorMsg("writing jpg frame failed - "); 
+            errorMsg += exc.what();
+            throw RuntimeError(errorId, errorMsg);
+        }
+    }
+
+    void CompressedFrame_jpg::encode(SliceEncoder_jpg &sliceEncoder)
+    {
+        sliceEncoder.encode(stampedImg_.image, quality_, encodedJpgBuffer_);
+        haveEncoding_ = true;
+    }
+
     // Compressed frame comparison operator
     // ----------------------------------------------------------------------------------------
     bool CompressedFrameCmp_jpg::operator() (
@@ -6,6 +6,7 @@
 #include <vector>
 #include "stamped_image.hpp"
 #include "lockable.hpp"
+#include "slice_encoder_jpg.hpp"
 
 
 
@@ -46,6 +47,10 @@ namespace bias
             void write();
             void encode();
 
+            // Same as above using a reusable per thread encoder context
+            void write(SliceEncoder_jpg &sliceEncoder);
+            void encode(SliceEncoder_jpg &sliceEncoder);
+
             static const QString DEFAULT_FILENAME;
             static const unsigned int DEFAULT_QUALITY;
             static const bool DEFAULT_MJPG_FLAG;
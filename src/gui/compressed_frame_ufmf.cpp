@@ -12,6 +12,7 @@ namespace bias
     const uchar CompressedFrame_ufmf::FOREGROUND_MEMBER_VALUE = 0;
     const unsigned int CompressedFrame_ufmf::DEFAULT_BOX_LENGTH = 30; 
     const double CompressedFrame_ufmf::DEFAULT_FG_MAX_FRAC_COMPRESS = 0.2;
+    const int CompressedFrame_ufmf::DEFAULT_PAYLOAD_COMPRESS_LEVEL = 1;
 
 
     // Methods
@@ -41,6 +42,12 @@ namespace bias
         boxLength_ = boxLength;
         boxArea_ = boxLength*boxLength;
         fgMaxFracCompress_ = fgMaxFracCompress;
+        payloadCompressEnabled_ = false;
+        payloadCompressLevel_ = DEFAULT_PAYLOAD_COMPRESS_LEVEL;
+        payloadCompressed_ = false;
+        payloadRawSize_ = 0;
+        payloadRawBufPtr_ = std::make_shared<std::vector<uint8_t>>();
+        payloadPtr_ = std::make_shared<QByteArray>();
     }
 
 
@@ -107,6 +114,31 @@ namespace bias
     }
 
 
+    void CompressedFrame_ufmf::setPayloadCompression(bool enabled, int level)
+    {
+        payloadCompressEnabled_ = enabled;
+        payloadCompressLevel_ = std::min(std::max(level,0),9);
+    }
+
+
+    bool CompressedFrame_ufmf::isPayloadCompressed() const
+    {
+        return payloadCompressed_;
+    }
+
+
+    unsigned int CompressedFrame_ufmf::getPayloadRawSize() const
+    {
+        return payloadRawSize_;
+    }
+
+
+    std::shared_ptr<QByteArray> CompressedFrame_ufmf::getPayloadPtr()
+    {
+        return payloadPtr_;
+    }
+
+
     std::shared_ptr<std::vector<uint16_t>> CompressedFrame_ufmf::getWriteRowBufPtr()
     {
         return writeRowBufPtr_;
@@ -198,6 +230,12 @@ namespace bias
         {
             createCompressedFrame();
         }
+
+        payloadCompressed_ = false;
+        if (payloadCompressEnabled_)
+        {
+            createCompressedPayload();
+        }
         ready_ = true;
 
     } // CompressedFrame_ufmf::compress
@@ -333,6 +371,54 @@ namespace bias
     } // CompressedFrame_ufmf::createCompressedFrame
 
 
+    void CompressedFrame_ufmf::createCompressedPayload()
+    {
+        // Payload layout (before compression) - box coordinates as planar uint16 
+        // arrays: col deltas, row deltas, widths and heights, followed by the box 
+        // pixel data. Boxes are found in raster order, so row deltas are small and
+        // non-negative; col deltas wrap modulo 2^16.
+        unsigned int coordBytes = 4*numConnectedComp_*sizeof(uint16_t);
+        payloadRawSize_ = coordBytes + numPixWritten_;
+        if (payloadRawBufPtr_ -> size() < payloadRawSize_)
+        {
+            payloadRawBufPtr_ -> resize(payloadRawSize_);
+        }
+
+        uint16_t *colDeltaPtr = reinterpret_cast<uint16_t*>(payloadRawBufPtr_ -> data());
+        uint16_t *rowDeltaPtr = colDeltaPtr + numConnectedComp_;
+        uint16_t *wdtPtr = rowDeltaPtr + numConnectedComp_;
+        uint16_t *hgtPtr = wdtPtr + numConnectedComp_;
+
+        uint16_t colLast = 0;
+        uint16_t rowLast = 0;
+        for (unsigned int cc=0; cc<numConnectedComp_; cc++)
+        {
+            uint16_t col = (*writeColBufPtr_)[cc];
+            uint16_t row = (*writeRowBufPtr_)[cc];
+            colDeltaPtr[cc] = uint16_t(col - colLast);
+            rowDeltaPtr[cc] = uint16_t(row - rowLast);
+            wdtPtr[cc] = (*writeWdtBufPtr_)[cc];
+            hgtPtr[cc] = (*writeHgtBufPtr_)[cc];
+            colLast = col;
+            rowLast = row;
+        }
+
+        if (numPixWritten_ > 0)
+        {
+            std::copy(
+                    imageDatBufPtr_ -> begin(), 
+                    imageDatBufPtr_ -> begin() + numPixWritten_, 
+                    payloadRawBufPtr_ -> begin() + coordBytes
+                    );
+        }
+
+        // qCompress prepends the uncompressed size (4 bytes, big endian) to a 
+        // standard zlib stream. 
+        *payloadPtr_ = qCompress(payloadRawBufPtr_ -> data(), int(payloadRawSize_), payloadCompressLevel_);
+        payloadCompressed_ = true;
+    }
+
+
     //cv::Mat CompressedFrame_ufmf::getMembershipImage()
     //{
     //    return membershipImage_;
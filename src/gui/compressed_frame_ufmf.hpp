@@ -5,6 +5,7 @@
 #include <memory>
 #include <functional>
 #include <opencv2/core/core.hpp>
+#include <QByteArray>
 #include "stamped_image.hpp"
 #include "lockable.hpp"
 
@@ -42,6 +43,11 @@ namespace bias
 
             void dilateEnabled(bool value);
             void setDilateWindowSize(unsigned int value);
+            void setPayloadCompression(bool enabled, int level);
+
+            bool isPayloadCompressed() const;
+            unsigned int getPayloadRawSize() const;
+            std::shared_ptr<QByteArray> getPayloadPtr();
 
             std::shared_ptr<std::vector<uint16_t>> getWriteRowBufPtr();
             std::shared_ptr<std::vector<uint16_t>> getWriteColBufPtr();
@@ -53,6 +59,7 @@ namespace bias
             static const uchar FOREGROUND_MEMBER_VALUE;
             static const unsigned int DEFAULT_BOX_LENGTH; 
             static const double DEFAULT_FG_MAX_FRAC_COMPRESS;
+            static const int DEFAULT_PAYLOAD_COMPRESS_LEVEL;
 
             // TEMPORARY REMOVE THIS ???
             // -------------------------------------------------------------
@@ -90,11 +97,19 @@ namespace bias
             bool dilateEnabled_;
             unsigned int dilateWindowSize_;
 
+            bool payloadCompressEnabled_;     // True if box payload should be zlib compressed
+            int payloadCompressLevel_;        // zlib compression level
+            bool payloadCompressed_;          // True if payload of current frame is compressed
+            unsigned int payloadRawSize_;     // Size of payload before compression
+            std::shared_ptr<std::vector<uint8_t>> payloadRawBufPtr_; // Delta coded boxes + pixels
+            std::shared_ptr<QByteArray> payloadPtr_;                 // Compressed payload
+
 
             void allocateBuffers();          
             void resetBuffers(); 
             void createUncompressedFrame();
             void createCompressedFrame();
+            void createCompressedPayload();
                                       
     };
 
@@ -0,0 +1,227 @@
+#include "compressed_frame_zfmf.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace bias
+{
+    // Constants
+    // -------------------------------------------------------------------------------------------------------
+    const unsigned int CompressedFrame_zfmf::DEFAULT_TILE_ROWS = 64;
+    const int CompressedFrame_zfmf::DEFAULT_COMPRESSION_LEVEL = 1;
+
+
+    // Helper functions
+    // -------------------------------------------------------------------------------------------------------
+    template <class T>
+    void computeResidual(const cv::Mat &image, const cv::Mat &refImage, cv::Mat &residual)
+    {
+        // Modular (wrap around) difference so that the residual is exactly
+        // invertible: image = refImage + residual.
+        int numRows = image.rows;
+        int numVals = image.cols*image.channels();
+        for (int row=0; row<numRows; row++)
+        {
+            const T *imagePtr = image.ptr<T>(row);
+            const T *refPtr = refImage.ptr<T>(row);
+            T *resPtr = residual.ptr<T>(row);
+            for (int i=0; i<numVals; i++)
+            {
+                resPtr[i] = T(imagePtr[i] - refPtr[i]);
+            }
+        }
+    }
+
+
+    // Public methods
+    // -------------------------------------------------------------------------------------------------------
+    CompressedFrame_zfmf::CompressedFrame_zfmf()
+    {
+        haveStampedImg_ = false;
+        haveEncoding_ = false;
+        haveReference_ = false;
+        tileRows_ = DEFAULT_TILE_ROWS;
+        compressionLevel_ = DEFAULT_COMPRESSION_LEVEL;
+        refFrameCount_ = 0;
+    }
+
+
+    CompressedFrame_zfmf::CompressedFrame_zfmf(
+            StampedImage stampedImg,
+            unsigned int tileRows,
+            int compressionLevel
+            ) : CompressedFrame_zfmf()
+    {
+        stampedImg_ = stampedImg;
+        haveStampedImg_ = true;
+        tileRows_ = std::max(tileRows, 1u);
+        compressionLevel_ = std::min(std::max(compressionLevel,0),9);
+    }
+
+
+    void CompressedFrame_zfmf::setReference(cv::Mat refImage, unsigned long refFrameCount)
+    {
+        refImage_ = refImage;
+        refFrameCount_ = refFrameCount;
+        haveReference_ = true;
+        haveEncoding_ = false;
+    }
+
+
+    void CompressedFrame_zfmf::clearReference()
+    {
+        refImage_ = cv::Mat();
+        refFrameCount_ = 0;
+        haveReference_ = false;
+        haveEncoding_ = false;
+    }
+
+
+    bool CompressedFrame_zfmf::haveStampedImage() const
+    {
+        return haveStampedImg_;
+    }
+
+
+    bool CompressedFrame_zfmf::haveEncoding() const
+    {
+        return haveEncoding_;
+    }
+
+
+    bool CompressedFrame_zfmf::isDelta() const
+    {
+        return haveReference_;
+    }
+
+
+    unsigned long CompressedFrame_zfmf::getFrameCount() const
+    {
+        if (haveStampedImg_)
+        {
+            return stampedImg_.frameCount;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+
+    unsigned long CompressedFrame_zfmf::getRefFrameCount() const
+    {
+        return refFrameCount_;
+    }
+
+
+    double CompressedFrame_zfmf::getTimeStamp() const
+    {
+        if (haveStampedImg_)
+        {
+            return stampedImg_.timeStamp;
+        }
+        else
+        {
+            return 0.0;
+        }
+    }
+
+
+    unsigned int CompressedFrame_zfmf::getNumberOfTiles() const
+    {
+        return (stampedImg_.image.rows + tileRows_ - 1)/tileRows_;
+    }
+
+
+    std::vector<QByteArray> &CompressedFrame_zfmf::getEncodedTileVec()
+    {
+        return encodedTileVec_;
+    }
+
+
+    void CompressedFrame_zfmf::encode()
+    {
+        if (!haveStampedImg_) { return; }
+
+        cv::Mat image = stampedImg_.image;
+
+        // Reference must match the image exactly - otherwise encode as keyframe
+        if (haveReference_)
+        {
+            bool refOk = (refImage_.size() == image.size()) && (refImage_.type() == image.type());
+            if (!refOk)
+            {
+                clearReference();
+            }
+        }
+
+        cv::Mat source;
+        if (haveReference_)
+        {
+            source.create(image.size(), image.type());
+            if (image.depth() == CV_16U)
+            {
+                computeResidual<uint16_t>(image, refImage_, source);
+            }
+            else
+            {
+                computeResidual<uint8_t>(image, refImage_, source);
+            }
+        }
+        else
+        {
+            source = image;
+        }
+
+        unsigned int numTiles = getNumberOfTiles();
+        encodedTileVec_.resize(numTiles);
+
+        for (unsigned int i=0; i<numTiles; i++)
+        {
+            int rowBeg = int(i*tileRows_);
+            int rowEnd = std::min(rowBeg + int(tileRows_), source.rows);
+            cv::Mat band = source.rowRange(rowBeg, rowEnd);
+            if (!band.isContinuous())
+            {
+                band = band.clone();
+            }
+            int numBytes = int(band.total()*band.elemSize());
+            encodedTileVec_[i] = qCompress(band.data, numBytes, compressionLevel_);
+        }
+
+        // Release the reference as soon as possible - it pins the previous frame
+        refImage_ = cv::Mat();
+        haveEncoding_ = true;
+    }
+
+
+    // Compressed frame comparison operator
+    // ----------------------------------------------------------------------------------------
+    bool CompressedFrameCmp_zfmf::operator() (
+            const CompressedFrame_zfmf &cmpFrame0,
+            const CompressedFrame_zfmf &cmpFrame1
+            )
+    {
+        bool haveImage0 = cmpFrame0.haveStampedImage();
+        bool haveImage1 = cmpFrame1.haveStampedImage();
+
+        if ((haveImage0 == false) && (haveImage1 == false))
+        {
+            return false;
+        }
+        else if ((haveImage0 == false) && (haveImage1 == true))
+        {
+            return false;
+        }
+        else if ((haveImage0 == true) && (haveImage1 == false))
+        {
+            return true;
+        }
+        else
+        {
+            unsigned long frameCount0 = cmpFrame0.getFrameCount();
+            unsigned long frameCount1 = cmpFrame1.getFrameCount();
+            return (frameCount0 < frameCount1);
+        }
+    }
+
+} // namespace bias
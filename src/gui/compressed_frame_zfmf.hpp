@@ -0,0 +1,84 @@
+#ifndef BIAS_COMPRESSED_FRAME_ZFMF_HPP
+#define BIAS_COMPRESSED_FRAME_ZFMF_HPP
+#include <opencv2/core/core.hpp>
+#include <QByteArray>
+#include <memory>
+#include <vector>
+#include "stamped_image.hpp"
+#include "lockable.hpp"
+
+namespace bias
+{
+
+    class CompressedFrame_zfmf
+    {
+        // Full frame, lossless compressed frame. The image (or its difference
+        // w.r.t. a reference image - typically the previous frame) is split into
+        // horizontal bands of tileRows rows and each band is zlib compressed
+        // independently.
+
+        public:
+
+            CompressedFrame_zfmf();
+            CompressedFrame_zfmf(
+                    StampedImage stampedImg,
+                    unsigned int tileRows,
+                    int compressionLevel
+                    );
+
+            void setReference(cv::Mat refImage, unsigned long refFrameCount);
+            void clearReference();
+
+            bool haveStampedImage() const;
+            bool haveEncoding() const;
+            bool isDelta() const;
+            unsigned long getFrameCount() const;
+            unsigned long getRefFrameCount() const;
+            double getTimeStamp() const;
+            unsigned int getNumberOfTiles() const;
+
+            std::vector<QByteArray> &getEncodedTileVec();
+
+            void encode();
+
+            static const unsigned int DEFAULT_TILE_ROWS;
+            static const int DEFAULT_COMPRESSION_LEVEL;
+
+        protected:
+
+            bool haveStampedImg_;
+            bool haveEncoding_;
+            bool haveReference_;
+
+            unsigned int tileRows_;
+            int compressionLevel_;
+
+            StampedImage stampedImg_;
+            cv::Mat refImage_;
+            unsigned long refFrameCount_;
+
+            std::vector<QByteArray> encodedTileVec_;
+
+    };
+
+
+    class CompressedFrameCmp_zfmf
+        : public std::binary_function<CompressedFrame_zfmf, CompressedFrame_zfmf, bool>
+    {
+        // Comparison object for Compressed frames
+        public:
+            bool operator() (
+                    const CompressedFrame_zfmf &cmpFrame0,
+                    const CompressedFrame_zfmf &cmpFrame1
+                    );
+    };
+
+    typedef LockableQueue<CompressedFrame_zfmf> CompressedFrameQueue_zfmf;
+    typedef std::shared_ptr<CompressedFrameQueue_zfmf> CompressedFrameQueuePtr_zfmf;
+
+    typedef LockableSet<CompressedFrame_zfmf, CompressedFrameCmp_zfmf> CompressedFrameSet_zfmf;
+    typedef std::shared_ptr<CompressedFrameSet_zfmf> CompressedFrameSetPtr_zfmf;
+
+} // namespace bias
+
+#endif // #ifndef BIAS_COMPRESSED_FRAME_ZFMF_HPP
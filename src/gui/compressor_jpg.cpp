@@ -2,6 +2,7 @@
 #include "affinity.hpp"
 #include <iostream>
 #include <QThread>
+#include <QFileInfo>
 #include "basic_types.hpp"
 #include "video_writer_jpg.hpp"
 
@@ -9,7 +10,7 @@ namespace bias
 {
     Compressor_jpg::Compressor_jpg(QObject *parent) : QObject(parent)
     { 
-        initialize(nullptr,nullptr,nullptr,0);
+        initialize(nullptr,nullptr,nullptr,nullptr,0);
         ready_ = false;
     }
 
@@ -17,11 +18,12 @@ namespace bias
             CompressedFrameQueuePtr_jpg framesToDoQueuePtr, 
             CompressedFrameSetPtr_jpg framesFinishedSetPtr, 
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+            FrameDrainPtr frameDrainPtr,
             unsigned int cameraNumber, 
             QObject *parent
             )  : QObject(parent)
     {
-        initialize(framesToDoQueuePtr,framesFinishedSetPtr,framesSkippedIndexListPtr,cameraNumber);
+        initialize(framesToDoQueuePtr,framesFinishedSetPtr,framesSkippedIndexListPtr,frameDrainPtr,cameraNumber);
     }
 
     
@@ -29,6 +31,7 @@ namespace bias
             CompressedFrameQueuePtr_jpg framesToDoQueuePtr, 
             CompressedFrameSetPtr_jpg framesFinishedSetPtr, 
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+            FrameDrainPtr frameDrainPtr,
             unsigned int cameraNumber
             )
     {
@@ -38,7 +41,8 @@ namespace bias
         framesToDoQueuePtr_ = framesToDoQueuePtr;
         framesFinishedSetPtr_ = framesFinishedSetPtr;
         framesSkippedIndexListPtr_ = framesSkippedIndexListPtr;
-        if (framesToDoQueuePtr_ != nullptr) 
+        frameDrainPtr_ = frameDrainPtr;
+        if ((framesToDoQueuePtr_ != nullptr) && (frameDrainPtr_ != nullptr))
         {
             ready_ = true;
         }
@@ -52,6 +56,12 @@ namespace bias
     }
 
 
+    void Compressor_jpg::setNumberOfSlices(unsigned int numberOfSlices)
+    {
+        sliceEncoder_.setNumberOfSlices(numberOfSlices);
+    }
+
+
     void Compressor_jpg::run()
     {
         bool done = false;
@@ -106,17 +116,19 @@ namespace bias
                 {
                     if (framesFinishedSetSize < VideoWriter_jpg::FRAMES_FINISHED_MAX_SET_SIZE)
                     {
-                        compressedFrame.encode();
+                        compressedFrame.encode(sliceEncoder_);
                         framesFinishedSetPtr_ -> acquireLock();
                         framesFinishedSetPtr_ -> insert(compressedFrame);
                         framesFinishedSetSize = framesFinishedSetPtr_ -> size();
                         framesFinishedSetPtr_ -> releaseLock();
+                        frameDrainPtr_ -> frameDone();
                     }
                     else
                     {
                         framesSkippedIndexListPtr_ -> acquireLock(); 
                         framesSkippedIndexListPtr_ -> push_back(compressedFrame.getFrameCount());
                         framesSkippedIndexListPtr_ -> releaseLock();
+                        frameDrainPtr_ -> frameDropped();
                         if (!skipReported_)
                         {
                             unsigned int errorId = ERROR_FRAMES_TODO_MAX_QUEUE_SIZE;
@@ -128,10 +140,21 @@ namespace bias
                 }
                 else
                 {
-                    compressedFrame.write();
+                    compressedFrame.write(sliceEncoder_);
+                    QFileInfo fileInfo(compressedFrame.getFileName());
+                    frameDrainPtr_ -> addBytesWritten((unsigned long long)(fileInfo.size()));
+                    frameDrainPtr_ -> frameDone();
                 }
 
             }
+            else if (haveNewFrame)
+            {
+                // Stopped with a frame in hand - account for it as skipped
+                framesSkippedIndexListPtr_ -> acquireLock();
+                framesSkippedIndexListPtr_ -> push_back(compressedFrame.getFrameCount());
+                framesSkippedIndexListPtr_ -> releaseLock();
+                frameDrainPtr_ -> frameDropped();
+            }
         }
     }
 } // namespace bias
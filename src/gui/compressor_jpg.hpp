@@ -6,6 +6,8 @@
 #include <memory>
 #include "lockable.hpp"
 #include "compressed_frame_jpg.hpp"
+#include "frame_drain.hpp"
+#include "slice_encoder_jpg.hpp"
 
 namespace bias
 {
@@ -20,11 +22,13 @@ namespace bias
                     CompressedFrameQueuePtr_jpg framesToDoQueuePtr, 
                     CompressedFrameSetPtr_jpg framesFinishedSetPtr,
                     std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+                    FrameDrainPtr frameDrainPtr,
                     unsigned int cameraNumber, 
                     QObject *parent=0
                     );
 
             void stop();
+            void setNumberOfSlices(unsigned int numberOfSlices);
 
         signals:
             void imageLoggingError(unsigned int errorId, QString errorMsg);
@@ -38,11 +42,14 @@ namespace bias
             CompressedFrameQueuePtr_jpg framesToDoQueuePtr_;
             CompressedFrameSetPtr_jpg framesFinishedSetPtr_;
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr_;
+            FrameDrainPtr frameDrainPtr_;
+            SliceEncoder_jpg sliceEncoder_;
 
             void initialize(
                     CompressedFrameQueuePtr_jpg framesToDoQueuePtr, 
                     CompressedFrameSetPtr_jpg framesFinishedSetPtr, 
                     std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+                    FrameDrainPtr frameDrainPtr,
                     unsigned int cameraNumber
                     );
             void run();
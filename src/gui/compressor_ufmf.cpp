@@ -10,7 +10,7 @@ namespace bias
     Compressor_ufmf::Compressor_ufmf(QObject *parent)
         : QObject(parent)
     { 
-        initialize(nullptr,nullptr,nullptr,0);
+        initialize(nullptr,nullptr,nullptr,nullptr,0);
         ready_ = false;
     }
 
@@ -18,12 +18,13 @@ namespace bias
             CompressedFrameQueuePtr_ufmf framesToDoQueuePtr, 
             CompressedFrameSetPtr_ufmf framesFinishedSetPtr, 
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+            FrameDrainPtr frameDrainPtr,
             unsigned int cameraNumber,
             QObject *parent
             )  
         : QObject(parent)
     {
-        initialize(framesToDoQueuePtr,framesFinishedSetPtr,framesSkippedIndexListPtr,cameraNumber);
+        initialize(framesToDoQueuePtr,framesFinishedSetPtr,framesSkippedIndexListPtr,frameDrainPtr,cameraNumber);
     }
 
     
@@ -31,6 +32,7 @@ namespace bias
             CompressedFrameQueuePtr_ufmf framesToDoQueuePtr, 
             CompressedFrameSetPtr_ufmf framesFinishedSetPtr,
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+            FrameDrainPtr frameDrainPtr,
             unsigned int cameraNumber
             )
     {
@@ -40,7 +42,8 @@ namespace bias
         framesToDoQueuePtr_ = framesToDoQueuePtr;
         framesFinishedSetPtr_ = framesFinishedSetPtr;
         framesSkippedIndexListPtr_ = framesSkippedIndexListPtr;
-        if ((framesToDoQueuePtr_ != NULL) && (framesFinishedSetPtr_ != NULL))
+        frameDrainPtr_ = frameDrainPtr;
+        if ((framesToDoQueuePtr_ != NULL) && (framesFinishedSetPtr_ != NULL) && (frameDrainPtr_ != NULL))
         {
             ready_ = true;
         }
@@ -112,6 +115,7 @@ namespace bias
                     framesFinishedSetPtr_ -> insert(compressedFrame);
                     framesFinishedSetSize = framesFinishedSetPtr_ -> size();
                     framesFinishedSetPtr_ -> releaseLock();
+                    frameDrainPtr_ -> frameDone();
                 }
                 else
                 {
@@ -119,6 +123,7 @@ namespace bias
                     framesSkippedIndexListPtr_ -> acquireLock();
                     framesSkippedIndexListPtr_ -> push_back(compressedFrame.getFrameCount());
                     framesSkippedIndexListPtr_ -> releaseLock();
+                    frameDrainPtr_ -> frameDropped();
                     if (!skipReported_)
                     {
                         unsigned int errorId = ERROR_FRAMES_TODO_MAX_QUEUE_SIZE;
@@ -129,6 +134,14 @@ namespace bias
                 }
 
             } // if (haveNewFrame) 
+            else if (haveNewFrame)
+            {
+                // Stopped with a frame in hand - account for it as skipped
+                framesSkippedIndexListPtr_ -> acquireLock();
+                framesSkippedIndexListPtr_ -> push_back(compressedFrame.getFrameCount());
+                framesSkippedIndexListPtr_ -> releaseLock();
+                frameDrainPtr_ -> frameDropped();
+            }
 
         } // while (!done)  
 
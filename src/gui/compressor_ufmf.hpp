@@ -6,6 +6,7 @@
 #include <memory>
 #include "lockable.hpp"
 #include "compressed_frame_ufmf.hpp"
+#include "frame_drain.hpp"
 
 namespace bias
 {
@@ -22,6 +23,7 @@ namespace bias
                     CompressedFrameQueuePtr_ufmf framesToDoQueuePtr,
                     CompressedFrameSetPtr_ufmf framesFinishedSetPtr,
                     std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+                    FrameDrainPtr frameDrainPtr,
                     unsigned int cameraNumber,
                     QObject *parent=0
                     );
@@ -43,11 +45,13 @@ namespace bias
             CompressedFrameQueuePtr_ufmf framesToDoQueuePtr_;
             CompressedFrameSetPtr_ufmf framesFinishedSetPtr_;
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr_;
+            FrameDrainPtr frameDrainPtr_;
 
             void initialize(
                     CompressedFrameQueuePtr_ufmf framesToDoQueuePtr,
                     CompressedFrameSetPtr_ufmf framesFinishedSetPtr,
                     std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+                    FrameDrainPtr frameDrainPtr,
                     unsigned int cameraNumber
                     );
 
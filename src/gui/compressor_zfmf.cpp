@@ -0,0 +1,141 @@
+#include "compressor_zfmf.hpp"
+#include "affinity.hpp"
+#include <iostream>
+#include <QThread>
+#include "basic_types.hpp"
+#include "video_writer_zfmf.hpp"
+
+namespace bias
+{
+    Compressor_zfmf::Compressor_zfmf(QObject *parent) : QObject(parent)
+    {
+        initialize(nullptr,nullptr,nullptr,nullptr,0);
+        ready_ = false;
+    }
+
+    Compressor_zfmf::Compressor_zfmf(
+            CompressedFrameQueuePtr_zfmf framesToDoQueuePtr,
+            CompressedFrameSetPtr_zfmf framesFinishedSetPtr,
+            std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+            FrameDrainPtr frameDrainPtr,
+            unsigned int cameraNumber,
+            QObject *parent
+            )  : QObject(parent)
+    {
+        initialize(framesToDoQueuePtr,framesFinishedSetPtr,framesSkippedIndexListPtr,frameDrainPtr,cameraNumber);
+    }
+
+
+    void Compressor_zfmf::initialize(
+            CompressedFrameQueuePtr_zfmf framesToDoQueuePtr,
+            CompressedFrameSetPtr_zfmf framesFinishedSetPtr,
+            std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+            FrameDrainPtr frameDrainPtr,
+            unsigned int cameraNumber
+            )
+    {
+        ready_ = false;
+        stopped_ = true;
+        skipReported_ = false;
+        framesToDoQueuePtr_ = framesToDoQueuePtr;
+        framesFinishedSetPtr_ = framesFinishedSetPtr;
+        framesSkippedIndexListPtr_ = framesSkippedIndexListPtr;
+        frameDrainPtr_ = frameDrainPtr;
+        if ((framesToDoQueuePtr_ != nullptr) && (frameDrainPtr_ != nullptr))
+        {
+            ready_ = true;
+        }
+        cameraNumber_ = cameraNumber;
+    }
+
+
+    void Compressor_zfmf::stop()
+    {
+        stopped_ = true;
+    }
+
+
+    void Compressor_zfmf::run()
+    {
+        bool done = false;
+
+        CompressedFrame_zfmf compressedFrame;
+
+        if (!ready_)
+        {
+            return;
+        }
+
+        QThread *thisThread = QThread::currentThread();
+        thisThread -> setPriority(QThread::NormalPriority);
+        ThreadAffinityService::assignThreadAffinity(false,cameraNumber_);
+
+        acquireLock();
+        stopped_ = false;
+        releaseLock();
+
+        while (!done)
+        {
+            bool haveNewFrame = false;
+
+            // Get next frame from in waiting queue
+            framesToDoQueuePtr_ -> acquireLock();
+            framesToDoQueuePtr_ -> waitIfEmpty();
+            if (framesToDoQueuePtr_ -> empty())
+            {
+                haveNewFrame = false;
+            }
+            else
+            {
+                haveNewFrame = true;
+                compressedFrame = framesToDoQueuePtr_ -> front();
+                framesToDoQueuePtr_ -> pop();
+            }
+            framesToDoQueuePtr_ -> releaseLock();
+
+            // Check to see if stop has been called
+            acquireLock();
+            done = stopped_;
+            releaseLock();
+
+            if ((haveNewFrame) && (!done))
+            {
+                // Size is re-read for every frame as the writer drains the set
+                framesFinishedSetPtr_ -> acquireLock();
+                unsigned int framesFinishedSetSize = framesFinishedSetPtr_ -> size();
+                framesFinishedSetPtr_ -> releaseLock();
+
+                if (framesFinishedSetSize < VideoWriter_zfmf::FRAMES_FINISHED_MAX_SET_SIZE)
+                {
+                    compressedFrame.encode();
+                    framesFinishedSetPtr_ -> acquireLock();
+                    framesFinishedSetPtr_ -> insert(compressedFrame);
+                    framesFinishedSetPtr_ -> releaseLock();
+                    frameDrainPtr_ -> frameDone();
+                }
+                else
+                {
+                    framesSkippedIndexListPtr_ -> acquireLock();
+                    framesSkippedIndexListPtr_ -> push_back(compressedFrame.getFrameCount());
+                    framesSkippedIndexListPtr_ -> releaseLock();
+                    frameDrainPtr_ -> frameDropped();
+                    if (!skipReported_)
+                    {
+                        unsigned int errorId = ERROR_FRAMES_TODO_MAX_QUEUE_SIZE;
+                        QString errorMsg("zfmf compressor frames finished set has exceeded the maximum allowed size");
+                        emit imageLoggingError(errorId, errorMsg);
+                        skipReported_ = true;
+                    }
+                }
+            }
+            else if (haveNewFrame)
+            {
+                // Stopped with a frame in hand - account for it as skipped
+                framesSkippedIndexListPtr_ -> acquireLock();
+                framesSkippedIndexListPtr_ -> push_back(compressedFrame.getFrameCount());
+                framesSkippedIndexListPtr_ -> releaseLock();
+                frameDrainPtr_ -> frameDropped();
+            }
+        }
+    }
+} // namespace bias
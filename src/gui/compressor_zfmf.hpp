@@ -0,0 +1,57 @@
+#ifndef BIAS_COMPRESSOR_ZFMF_HPP
+#define BIAS_COMPRESSOR_ZFMF_HPP
+
+#include <QObject>
+#include <QRunnable>
+#include <memory>
+#include <list>
+#include "lockable.hpp"
+#include "compressed_frame_zfmf.hpp"
+#include "frame_drain.hpp"
+
+namespace bias
+{
+    class Compressor_zfmf : public QObject, public QRunnable, public Lockable<Empty>
+    {
+        Q_OBJECT
+
+        public:
+
+            Compressor_zfmf(QObject *parent=0);
+            Compressor_zfmf(
+                    CompressedFrameQueuePtr_zfmf framesToDoQueuePtr,
+                    CompressedFrameSetPtr_zfmf framesFinishedSetPtr,
+                    std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+                    FrameDrainPtr frameDrainPtr,
+                    unsigned int cameraNumber,
+                    QObject *parent=0
+                    );
+
+            void stop();
+
+        signals:
+            void imageLoggingError(unsigned int errorId, QString errorMsg);
+
+        private:
+
+            bool ready_;
+            bool stopped_;
+            bool skipReported_;
+            unsigned int cameraNumber_;
+            CompressedFrameQueuePtr_zfmf framesToDoQueuePtr_;
+            CompressedFrameSetPtr_zfmf framesFinishedSetPtr_;
+            std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr_;
+            FrameDrainPtr frameDrainPtr_;
+
+            void initialize(
+                    CompressedFrameQueuePtr_zfmf framesToDoQueuePtr,
+                    CompressedFrameSetPtr_zfmf framesFinishedSetPtr,
+                    std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr,
+                    FrameDrainPtr frameDrainPtr,
+                    unsigned int cameraNumber
+                    );
+            void run();
+    };
+
+}
+#endif
@@ -1,9 +1,16 @@
 #include "ext_ctl_http_server.hpp"
 #include "camera_window.hpp"
+#include "bias_plugin.hpp"
+#include "frame_result_ring.hpp"
+#include "json.hpp"
+#include <QTcpSocket>
 #include <QtDebug>
 
 namespace bias
 {
+    const unsigned int ExtCtlHttpServer::MAX_RESULTS_PER_REQUEST = 1000;
+    const qint64 ExtCtlHttpServer::MAX_STREAM_BYTES_TO_WRITE = 4*1024*1024;
+
     ExtCtlHttpServer::ExtCtlHttpServer(CameraWindow *cameraWindow, QObject *parent)
         : BasicHttpServer(parent)
     { 
@@ -22,6 +29,105 @@ namespace bias
         }
     }
 
+
+    void ExtCtlHttpServer::onPluginResultPublished()
+    {
+        // Sends everything published since the last call to each stream. 
+        // The plugins queue one signal at a time - acknowledge before reading
+        // so results published while sending queue the next one.
+        for (PluginResultStream &stream : resultStreamList_)
+        {
+            if (!stream.pluginPtr.isNull())
+            {
+                stream.pluginPtr -> acknowledgeResultPublished();
+            }
+        }
+
+        QList<QPointer<BiasPlugin>> removedPluginList;
+        QList<PluginResultStream>::iterator it = resultStreamList_.begin();
+        while (it != resultStreamList_.end())
+        {
+            PluginResultStream &stream = *it;
+            bool isConnected = !stream.socketPtr.isNull() && 
+                (stream.socketPtr -> state() == QAbstractSocket::ConnectedState);
+            if (!isConnected || stream.pluginPtr.isNull())
+            {
+                if (!stream.socketPtr.isNull())
+                {
+                    endStream(stream.socketPtr);
+                }
+                removedPluginList.append(stream.pluginPtr);
+                it = resultStreamList_.erase(it);
+                continue;
+            }
+
+            // Slow client - leave results in the ring, any overwritten 
+            // before the client catches up are reported as dropped.
+            if (stream.socketPtr -> bytesToWrite() > MAX_STREAM_BYTES_TO_WRITE)
+            {
+                it++;
+                continue;
+            }
+
+            FrameResultRing *ringPtr = stream.pluginPtr -> getResultRing();
+            QByteArray data;
+            if (stream.generation != ringPtr -> generation())
+            {
+                // Capture restarted, the fields may have changed too
+                stream.generation = ringPtr -> generation();
+                stream.nextSeq = 0;
+                data.append(getStreamInfoLine(stream));
+            }
+
+            QVariantList resultList;
+            do
+            {
+                unsigned long long numDropped = 0;
+                stream.nextSeq = ringPtr -> getSince(
+                        stream.nextSeq, 
+                        MAX_RESULTS_PER_REQUEST, 
+                        resultList, 
+                        numDropped
+                        );
+                bool ok;
+                if (numDropped > 0)
+                {
+                    QVariantMap droppedMap;
+                    droppedMap.insert("dropped", qulonglong(numDropped));
+                    data.append(QtJson::serialize(droppedMap, ok));
+                    data.append('\n');
+                }
+                for (QVariant result : resultList)
+                {
+                    data.append(QtJson::serialize(result, ok));
+                    data.append('\n');
+                }
+            } 
+            while (resultList.size() == int(MAX_RESULTS_PER_REQUEST));
+
+            writeStreamChunk(stream.socketPtr, data);
+            it++;
+        }
+
+        // Stop listening to plugins nobody is streaming from
+        for (QPointer<BiasPlugin> pluginPtr : removedPluginList)
+        {
+            if (pluginPtr.isNull())
+            {
+                continue;
+            }
+            bool inUse = false;
+            for (PluginResultStream &stream : resultStreamList_)
+            {
+                inUse = inUse || (stream.pluginPtr == pluginPtr);
+            }
+            if (!inUse)
+            {
+                disconnect(pluginPtr, SIGNAL(resultPublished()), this, SLOT(onPluginResultPublished()));
+            }
+        }
+    }
+
     // Protected methods
     // ------------------------------------------------------------------------------
     QVariantMap ExtCtlHttpServer::paramsRequestSwitchYard(QString name, QString value)
@@ -60,6 +166,10 @@ namespace bias
         {
             cmdMap = handleLoggingDisable();
         }
+        else if (name == QString("trigger-logging"))
+        {
+            cmdMap = handleLoggingTrigger();
+        }
         else if (name == QString("load-configuration"))
         {
             cmdMap = handleLoadConfiguration(value);
@@ -116,6 +226,10 @@ namespace bias
         {
             cmdMap = handlePluginCmd(value);
         }
+        else if (name == QString("get-plugin-results"))
+        {
+            cmdMap = handleGetPluginResults(value);
+        }
         else 
         {
             cmdMap.insert("success", false);
@@ -127,6 +241,60 @@ namespace bias
     }
 
 
+    bool ExtCtlHttpServer::isStreamRequest(QString name)
+    {
+        return name == QString("stream-plugin-results");
+    }
+
+
+    bool ExtCtlHttpServer::handleStreamRequest(QTcpSocket *socketPtr, QString name, QString value)
+    {
+        // stream-plugin-results[=since] - the current plugin's per-frame 
+        // results as json lines, starting from sequence number since or, 
+        // without it, from the next result published. The first line (and 
+        // the first after each capture restart) gives the field names.
+        QTextStream os(socketPtr);
+        QPointer<BiasPlugin> pluginPtr = cameraWindowPtr_ -> getCurrentPlugin();
+        if (pluginPtr.isNull())
+        {
+            sendBadRequestResp(os, "no plugin selected");
+            return false;
+        }
+
+        PluginResultStream stream;
+        stream.socketPtr = QPointer<QTcpSocket>(socketPtr);
+        stream.pluginPtr = pluginPtr;
+        stream.generation = pluginPtr -> getResultRing() -> generation();
+        stream.nextSeq = pluginPtr -> getResultRing() -> numberWritten();
+        if (!value.isEmpty())
+        {
+            bool ok;
+            stream.nextSeq = value.toULongLong(&ok);
+            if (!ok)
+            {
+                sendBadRequestResp(os, "unable to parse sequence number");
+                return false;
+            }
+        }
+
+        writeStreamHeader(socketPtr);
+        writeStreamChunk(socketPtr, getStreamInfoLine(stream));
+        resultStreamList_.append(stream);
+
+        connect(
+                pluginPtr, 
+                SIGNAL(resultPublished()), 
+                this, 
+                SLOT(onPluginResultPublished()),
+                Qt::UniqueConnection
+                );
+
+        // Send any backlog without waiting for the next frame
+        onPluginResultPublished();
+        return true;
+    }
+
+
     // Private Methods
     // ------------------------------------------------------------------------
     QVariantMap ExtCtlHttpServer::handleConnectRequest()
@@ -219,6 +387,17 @@ namespace bias
     }
 
 
+    QVariantMap ExtCtlHttpServer::handleLoggingTrigger()
+    {
+        QVariantMap cmdMap;
+        RtnStatus status = cameraWindowPtr_ -> triggerLogging(false);
+        cmdMap.insert("success", status.success);
+        cmdMap.insert("message", status.message);
+        cmdMap.insert("value", "");
+        return cmdMap;
+    }
+
+
     QVariantMap ExtCtlHttpServer::handleSaveConfiguration(QString fileName)
     {
         QVariantMap cmdMap;
@@ -285,6 +464,7 @@ namespace bias
         statusMap.insert("capturing", capturing);
         statusMap.insert("logging", logging);
         statusMap.insert("frameCount", qulonglong(frameCount));
+        statusMap.insert("pluginDropCount", qulonglong(cameraWindowPtr_ -> getPluginDropCount()));
         statusMap.insert("framesPerSec", framesPerSec);
         statusMap.insert("timeStamp", timeStamp);
         cmdMap.insert("success", true);
@@ -387,6 +567,73 @@ namespace bias
     }
 
 
+    QVariantMap ExtCtlHttpServer::handleGetPluginResults(QString since)
+    {
+        // Polling alternative to stream-plugin-results. Pass back the 
+        // returned "next" as since to get only new results.
+        QVariantMap cmdMap;
+        QPointer<BiasPlugin> pluginPtr = cameraWindowPtr_ -> getCurrentPlugin();
+        if (pluginPtr.isNull())
+        {
+            cmdMap.insert("success", false);
+            cmdMap.insert("message", "no plugin selected");
+            cmdMap.insert("value", "");
+            return cmdMap;
+        }
+
+        unsigned long long sinceSeq = 0;
+        if (!since.isEmpty())
+        {
+            bool ok;
+            sinceSeq = since.toULongLong(&ok);
+            if (!ok)
+            {
+                cmdMap.insert("success", false);
+                cmdMap.insert("message", "unable to parse sequence number");
+                cmdMap.insert("value", "");
+                return cmdMap;
+            }
+        }
+
+        FrameResultRing *ringPtr = pluginPtr -> getResultRing();
+        QVariantList resultList;
+        unsigned long long numDropped = 0;
+        unsigned long long nextSeq = ringPtr -> getSince(
+                sinceSeq, 
+                MAX_RESULTS_PER_REQUEST, 
+                resultList, 
+                numDropped
+                );
+
+        QVariantMap valueMap;
+        valueMap.insert("plugin", pluginPtr -> getName());
+        valueMap.insert("generation", ringPtr -> generation());
+        valueMap.insert("fields", ringPtr -> fieldNames());
+        valueMap.insert("next", qulonglong(nextSeq));
+        valueMap.insert("dropped", qulonglong(numDropped));
+        valueMap.insert("results", resultList);
+        cmdMap.insert("success", true);
+        cmdMap.insert("message", "");
+        cmdMap.insert("value", valueMap);
+        return cmdMap;
+    }
+
+
+    QByteArray ExtCtlHttpServer::getStreamInfoLine(const PluginResultStream &stream)
+    {
+        FrameResultRing *ringPtr = stream.pluginPtr -> getResultRing();
+        QVariantMap infoMap;
+        infoMap.insert("plugin", stream.pluginPtr -> getName());
+        infoMap.insert("generation", stream.generation);
+        infoMap.insert("fields", ringPtr -> fieldNames());
+        infoMap.insert("next", qulonglong(stream.nextSeq));
+        bool ok;
+        QByteArray line = QtJson::serialize(infoMap, ok);
+        line.append('\n');
+        return line;
+    }
+
+
     QVariantMap ExtCtlHttpServer::handleClose()
     {
         QVariantMap cmdMap;
@@ -1,28 +1,50 @@
 #ifndef EXT_CTL_HTTP_SERVER_HPP
 #define EXT_CTL_HTTP_SERVER_HPP
 #include<QVariantMap>
+#include<QList>
+#include<QPointer>
 #include "basic_http_server.hpp"
 
+class QTcpSocket;
+
 namespace bias
 {
     class CameraWindow;
+    class BiasPlugin;
+
+    // Client of the plugin result stream - nextSeq is the sequence number
+    // of the next result to send from the given ring generation
+    struct PluginResultStream
+    {
+        QPointer<QTcpSocket> socketPtr;
+        QPointer<BiasPlugin> pluginPtr;
+        unsigned int generation;
+        unsigned long long nextSeq;
+    };
 
     class ExtCtlHttpServer : public BasicHttpServer
     {
         Q_OBJECT
 
         public:
+            static const unsigned int MAX_RESULTS_PER_REQUEST;
+            static const qint64 MAX_STREAM_BYTES_TO_WRITE;
+
             ExtCtlHttpServer(CameraWindow *cameraWindow, QObject *parent=0);
 
         protected:
             virtual QVariantMap paramsRequestSwitchYard(QString name, QString value);
+            virtual bool isStreamRequest(QString name);
+            virtual bool handleStreamRequest(QTcpSocket *socket, QString name, QString value);
 
         protected slots:
             virtual void readClient();
+            void onPluginResultPublished();
 
         private:
             bool closeFlag_;
             QPointer<CameraWindow> cameraWindowPtr_;
+            QList<PluginResultStream> resultStreamList_;
             QVariantMap handleConnectRequest();
             QVariantMap handleDisconnectRequest();
             QVariantMap handleStartCaptureRequest();
@@ -31,6 +53,7 @@ namespace bias
             QVariantMap handleSetConfiguration(QString jsonConfig);
             QVariantMap handleLoggingEnable();
             QVariantMap handleLoggingDisable();
+            QVariantMap handleLoggingTrigger();
             QVariantMap handleSaveConfiguration(QString fileName);
             QVariantMap handleLoadConfiguration(QString fileName);
             QVariantMap handleGetCameraGuid();
@@ -44,6 +67,8 @@ namespace bias
             QVariantMap handleSetWindowGeometry(QString jsonGeom);
             QVariantMap handleGetWindowGeometry();
             QVariantMap handlePluginCmd(QString jsonPluginCmd);
+            QVariantMap handleGetPluginResults(QString since);
+            QByteArray getStreamInfoLine(const PluginResultStream &stream);
             QVariantMap handleClose();
     };
 
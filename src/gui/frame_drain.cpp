@@ -0,0 +1,156 @@
+#include "frame_drain.hpp"
+#include <algorithm>
+
+namespace bias
+{
+    // Constants
+    // -------------------------------------------------------------------------------------------------------
+    const unsigned long FrameDrain::WAIT_INTERVAL = 100;        // msec
+    const unsigned long FrameDrain::PROGRESS_INTERVAL = 1000;   // msec
+
+
+    // Public methods
+    // -------------------------------------------------------------------------------------------------------
+    FrameDrain::FrameDrain()
+    {
+        numberQueued_ = 0;
+        numberDone_ = 0;
+        numberDropped_ = 0;
+        numberSkipped_ = 0;
+        maxNumberPending_ = 0;
+        numberBytesWritten_ = 0;
+    }
+
+
+    void FrameDrain::reset()
+    {
+        acquireLock();
+        numberQueued_ = 0;
+        numberDone_ = 0;
+        numberDropped_ = 0;
+        numberSkipped_ = 0;
+        maxNumberPending_ = 0;
+        numberBytesWritten_ = 0;
+        releaseLock();
+    }
+
+
+    void FrameDrain::frameQueued()
+    {
+        acquireLock();
+        numberQueued_++;
+        maxNumberPending_ = std::max(maxNumberPending_, numberQueued_ - numberDone_ - numberDropped_);
+        releaseLock();
+    }
+
+
+    void FrameDrain::frameDone()
+    {
+        acquireLock();
+        numberDone_++;
+        progressWaitCond_.wakeAll();
+        releaseLock();
+    }
+
+
+    void FrameDrain::frameDropped(unsigned long number)
+    {
+        acquireLock();
+        numberDropped_ += number;
+        progressWaitCond_.wakeAll();
+        releaseLock();
+    }
+
+
+    void FrameDrain::frameSkipped()
+    {
+        acquireLock();
+        numberSkipped_++;
+        releaseLock();
+    }
+
+
+    void FrameDrain::addBytesWritten(unsigned long long number)
+    {
+        acquireLock();
+        numberBytesWritten_ += number;
+        releaseLock();
+    }
+
+
+    unsigned long FrameDrain::numberQueued()
+    {
+        acquireLock();
+        unsigned long number = numberQueued_;
+        releaseLock();
+        return number;
+    }
+
+
+    unsigned long FrameDrain::numberDone()
+    {
+        acquireLock();
+        unsigned long number = numberDone_;
+        releaseLock();
+        return number;
+    }
+
+
+    unsigned long FrameDrain::numberDropped()
+    {
+        acquireLock();
+        unsigned long number = numberDropped_;
+        releaseLock();
+        return number;
+    }
+
+
+    unsigned long FrameDrain::numberPending()
+    {
+        acquireLock();
+        unsigned long number = numberQueued_ - numberDone_ - numberDropped_;
+        releaseLock();
+        return number;
+    }
+
+
+    unsigned long FrameDrain::numberSkipped()
+    {
+        acquireLock();
+        unsigned long number = numberSkipped_;
+        releaseLock();
+        return number;
+    }
+
+
+    unsigned long FrameDrain::maxNumberPending()
+    {
+        acquireLock();
+        unsigned long number = maxNumberPending_;
+        releaseLock();
+        return number;
+    }
+
+
+    unsigned long long FrameDrain::numberBytesWritten()
+    {
+        acquireLock();
+        unsigned long long number = numberBytesWritten_;
+        releaseLock();
+        return number;
+    }
+
+
+    bool FrameDrain::waitForProgress(unsigned long timeout)
+    {
+        acquireLock();
+        if (numberQueued_ > numberDone_ + numberDropped_)
+        {
+            progressWaitCond_.wait(&mutex_, timeout);
+        }
+        bool drained = (numberQueued_ == numberDone_ + numberDropped_);
+        releaseLock();
+        return drained;
+    }
+
+} // namespace bias
@@ -0,0 +1,65 @@
+#ifndef BIAS_FRAME_DRAIN_HPP
+#define BIAS_FRAME_DRAIN_HPP
+#include <QWaitCondition>
+#include <memory>
+#include "lockable.hpp"
+
+namespace bias
+{
+
+    class FrameDrain : public Lockable<Empty>
+    {
+        // Book keeping for frames handed from a video writer to its worker
+        // threads (compressors, file writers). The writer counts frames as
+        // they are queued and the workers count them off again - once per 
+        // frame, whether it was finished or dropped. At shutdown the writer
+        // blocks in waitForProgress instead of polling the queues. Frames
+        // the writer refused because its queues were full are counted as 
+        // skipped, they are never queued.
+
+        public:
+
+            FrameDrain();
+
+            void reset();
+            void frameQueued();
+            void frameDone();
+            void frameDropped(unsigned long number=1);
+            void frameSkipped();
+
+            // Running total of bytes written to the output by the workers 
+            // (and the writer) - lets size limited segments avoid stat'ing 
+            // every file of an image sequence.
+            void addBytesWritten(unsigned long long number);
+            unsigned long long numberBytesWritten();
+
+            unsigned long numberQueued();
+            unsigned long numberDone();
+            unsigned long numberDropped();
+            unsigned long numberPending();
+            unsigned long numberSkipped();
+            unsigned long maxNumberPending();
+
+            // Blocks until a worker reports progress, nothing is pending or
+            // timeout (msec) expires. Returns true if nothing is pending.
+            bool waitForProgress(unsigned long timeout);
+
+            static const unsigned long WAIT_INTERVAL;
+            static const unsigned long PROGRESS_INTERVAL;
+
+        protected:
+
+            unsigned long numberQueued_;
+            unsigned long numberDone_;
+            unsigned long numberDropped_;
+            unsigned long numberSkipped_;
+            unsigned long maxNumberPending_;
+            unsigned long long numberBytesWritten_;
+            QWaitCondition progressWaitCond_;
+    };
+
+    typedef std::shared_ptr<FrameDrain> FrameDrainPtr;
+
+} // namespace bias
+
+#endif // #ifndef BIAS_FRAME_DRAIN_HPP
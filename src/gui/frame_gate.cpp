@@ -0,0 +1,46 @@
+#include "frame_gate.hpp"
+
+namespace bias
+{
+
+    FrameGate::FrameGate() 
+    {
+        numberReleased_ = 0;
+    }
+
+
+    FrameGate::~FrameGate() {}
+
+
+    void FrameGate::clear() 
+    {
+        numberReleased_ = 0;
+    }
+
+
+    bool FrameGate::isEnabled() const
+    {
+        return false;
+    }
+
+
+    void FrameGate::addFrame(StampedImage stampedImg, std::vector<StampedImage> &releaseVec)
+    {
+        releaseVec.push_back(stampedImg);
+    }
+
+
+    unsigned long FrameGate::numberReleased() const
+    {
+        return numberReleased_;
+    }
+
+
+    void FrameGate::release(StampedImage stampedImg, std::vector<StampedImage> &releaseVec)
+    {
+        stampedImg.frameCount = numberReleased_;
+        numberReleased_++;
+        releaseVec.push_back(stampedImg);
+    }
+
+} // namespace bias
@@ -0,0 +1,43 @@
+#ifndef BIAS_FRAME_GATE_HPP
+#define BIAS_FRAME_GATE_HPP
+#include "lockable.hpp"
+#include "stamped_image.hpp"
+#include <vector>
+
+namespace bias
+{
+
+    class FrameGate : public Lockable<Empty>
+    {
+        // Decides which frames the image logger hands to the video writer.
+        // Frames passed to addFrame are either held back, dropped or 
+        // returned in releaseVec (possibly together with earlier held 
+        // frames).  The base class passes every frame straight through.
+        //
+        // Gating frames go through release which renumbers them 0, 1, 2, ...
+        // in release order - the writers expect gap free frame counts 
+        // starting from zero, not the camera's frame counts.
+
+        public:
+
+            FrameGate();
+            virtual ~FrameGate();
+
+            // Use lock when calling these methods
+            // ----------------------------------
+            virtual void clear();
+            virtual bool isEnabled() const;
+            virtual void addFrame(StampedImage stampedImg, std::vector<StampedImage> &releaseVec);
+            unsigned long numberReleased() const;
+            // ----------------------------------
+
+        protected:
+
+            unsigned long numberReleased_;
+
+            void release(StampedImage stampedImg, std::vector<StampedImage> &releaseVec);
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_FRAME_GATE_HPP
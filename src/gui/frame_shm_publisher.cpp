@@ -0,0 +1,278 @@
+#include "frame_shm_publisher.hpp"
+#include "stamped_image.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+
+#ifndef _WIN32
+#include "bias_frame_shm.h"
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace bias
+{
+    // Constants
+    // ----------------------------------------------------------------------------------
+    const unsigned int FrameShmPublisher::DEFAULT_NUMBER_OF_SLOTS = 8;
+    const unsigned int FrameShmPublisher::MAXIMUM_NUMBER_OF_SLOTS = 256;
+
+
+    // Public methods
+    // ----------------------------------------------------------------------------------
+    FrameShmPublisher::FrameShmPublisher() 
+        : FrameShmPublisher(getDefaultName(0), DEFAULT_NUMBER_OF_SLOTS)
+    {}
+
+
+    FrameShmPublisher::FrameShmPublisher(QString name, unsigned int numSlots)
+    {
+        name_ = name;
+        numSlots_ = std::min(std::max(numSlots, 2u), MAXIMUM_NUMBER_OF_SLOTS);
+        isOpen_ = false;
+        haveError_ = false;
+        fd_ = -1;
+        base_ = nullptr;
+        mapSize_ = 0;
+        sessionId_ = 0;
+        numberPublished_ = 0;
+    }
+
+
+    FrameShmPublisher::~FrameShmPublisher()
+    {
+        close();
+    }
+
+
+    QString FrameShmPublisher::getDefaultName(unsigned int cameraNumber)
+    {
+        return QString("/bias_frames_cam%1").arg(cameraNumber);
+    }
+
+
+    bool FrameShmPublisher::isSupported()
+    {
+#ifdef _WIN32
+        return false;
+#else
+        return true;
+#endif
+    }
+
+
+    RtnStatus FrameShmPublisher::open()
+    {
+        RtnStatus rtnStatus;
+        if (!isSupported())
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("frame export: shared memory is not supported on this platform");
+            return rtnStatus;
+        }
+        if (!name_.startsWith("/") || (name_.indexOf("/",1) != -1) || (name_.length() < 2))
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("frame export: name must be of the form /name, got %1").arg(name_);
+            return rtnStatus;
+        }
+        close();
+        isOpen_ = true;
+        haveError_ = false;
+        numberPublished_ = 0;
+        rtnStatus.success = true;
+        rtnStatus.message = QString("");
+        return rtnStatus;
+    }
+
+
+    void FrameShmPublisher::close()
+    {
+        if (isOpen_)
+        {
+            releaseSegment();
+            isOpen_ = false;
+        }
+    }
+
+
+    bool FrameShmPublisher::isOpen() const
+    {
+        return isOpen_;
+    }
+
+
+    unsigned long FrameShmPublisher::getNumberPublished() const
+    {
+        return numberPublished_;
+    }
+
+
+#ifdef _WIN32
+
+    bool FrameShmPublisher::publish(const StampedImage &stampedImg)
+    {
+        return false;
+    }
+
+
+    bool FrameShmPublisher::createSegment(size_t frameDataSize)
+    {
+        return false;
+    }
+
+
+    void FrameShmPublisher::releaseSegment()
+    {}
+
+#else
+
+    bool FrameShmPublisher::publish(const StampedImage &stampedImg)
+    {
+        if (!isOpen_ || haveError_ || stampedImg.image.empty())
+        {
+            return false;
+        }
+
+        const cv::Mat &image = stampedImg.image;
+        size_t rowSize = image.cols*image.elemSize();
+        size_t dataSize = rowSize*image.rows;
+
+        BiasFrameShmHeader *header = static_cast<BiasFrameShmHeader*>(base_);
+        if ((header == nullptr) || (dataSize > header -> slotDataSize))
+        {
+            if (!createSegment(dataSize))
+            {
+                std::cerr << "warning: frame export disabled, unable to create ";
+                std::cerr << name_.toStdString() << std::endl;
+                haveError_ = true;
+                return false;
+            }
+            header = static_cast<BiasFrameShmHeader*>(base_);
+        }
+
+        // Slot sequence number is odd while the slot is being written 
+        uint64_t index = __atomic_load_n(&header -> writeCount, __ATOMIC_RELAXED);
+        uint64_t slotNum = index % header -> numSlots;
+        char *slotPtr = static_cast<char*>(base_) + bias_frame_shm_slot_offset(header, slotNum);
+        BiasFrameShmSlotHeader *slot = reinterpret_cast<BiasFrameShmSlotHeader*>(slotPtr);
+
+        __atomic_store_n(&slot -> seq, 2*index + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        slot -> frameCount = stampedImg.frameCount;
+        slot -> timeStamp = stampedImg.timeStamp;
+        slot -> width = uint32_t(image.cols);
+        slot -> height = uint32_t(image.rows);
+        slot -> stride = uint32_t(rowSize);
+        slot -> type = uint32_t(image.type());
+        slot -> dataSize = dataSize;
+
+        char *dataPtr = slotPtr + bias_frame_shm_slot_header_size();
+        if (image.isContinuous())
+        {
+            std::memcpy(dataPtr, image.data, dataSize);
+        }
+        else
+        {
+            for (int row=0; row<image.rows; row++)
+            {
+                std::memcpy(dataPtr + row*rowSize, image.ptr(row), rowSize);
+            }
+        }
+
+        __atomic_store_n(&slot -> seq, 2*index + 2, __ATOMIC_RELEASE);
+        __atomic_store_n(&header -> writeCount, index + 1, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&header -> wakeCount, 1, __ATOMIC_RELEASE);
+#if defined(__linux__)
+        syscall(SYS_futex, &header -> wakeCount, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+        numberPublished_++;
+        return true;
+    }
+
+
+    bool FrameShmPublisher::createSegment(size_t frameDataSize)
+    {
+        // Readers attached to an older segment see it closed and reattach
+        releaseSegment();
+
+        size_t align = BIAS_FRAME_SHM_ALIGN;
+        size_t headerSize = (sizeof(BiasFrameShmHeader) + align - 1)/align*align;
+        size_t slotDataSize = (frameDataSize + align - 1)/align*align;
+        size_t slotSize = bias_frame_shm_slot_header_size() + slotDataSize;
+        size_t mapSize = headerSize + numSlots_*slotSize;
+
+        std::string name = name_.toStdString();
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+        if (ftruncate(fd_, off_t(mapSize)) != 0)
+        {
+            releaseSegment();
+            return false;
+        }
+        base_ = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base_ == MAP_FAILED)
+        {
+            base_ = nullptr;
+            releaseSegment();
+            return false;
+        }
+        mapSize_ = mapSize;
+
+        // New segment is zero filled - all slots start with seq = 0 
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        sessionId_ = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+
+        BiasFrameShmHeader *header = static_cast<BiasFrameShmHeader*>(base_);
+        header -> magic = BIAS_FRAME_SHM_MAGIC;
+        header -> version = BIAS_FRAME_SHM_VERSION;
+        header -> numSlots = numSlots_;
+        header -> headerSize = headerSize;
+        header -> slotSize = slotSize;
+        header -> slotDataSize = slotDataSize;
+        header -> writeCount = 0;
+        header -> wakeCount = 0;
+        __atomic_store_n(&header -> sessionId, sessionId_, __ATOMIC_RELEASE);
+        __atomic_store_n(&header -> state, BIAS_FRAME_SHM_STATE_OPEN, __ATOMIC_RELEASE);
+        return true;
+    }
+
+
+    void FrameShmPublisher::releaseSegment()
+    {
+        if (base_ != nullptr)
+        {
+            BiasFrameShmHeader *header = static_cast<BiasFrameShmHeader*>(base_);
+            __atomic_store_n(&header -> state, BIAS_FRAME_SHM_STATE_CLOSED, __ATOMIC_RELEASE);
+            __atomic_add_fetch(&header -> wakeCount, 1, __ATOMIC_RELEASE);
+#if defined(__linux__)
+            syscall(SYS_futex, &header -> wakeCount, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+            munmap(base_, mapSize_);
+            base_ = nullptr;
+            mapSize_ = 0;
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+            shm_unlink(name_.toStdString().c_str());
+        }
+    }
+
+#endif
+
+} // namespace bias
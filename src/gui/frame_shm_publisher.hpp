@@ -0,0 +1,57 @@
+#ifndef BIAS_FRAME_SHM_PUBLISHER_HPP
+#define BIAS_FRAME_SHM_PUBLISHER_HPP
+#include "rtn_status.hpp"
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+
+namespace bias
+{
+
+    struct StampedImage;
+
+    class FrameShmPublisher
+    {
+        // Publishes frames to a POSIX shared memory ring (see bias_frame_shm.h)
+        // so out-of-process consumers can read them without copying.  The 
+        // segment is created on the first frame, when the frame size is known,
+        // and recreated if a larger frame arrives. Only called from the image
+        // dispatcher thread between open and close.
+
+        public:
+
+            static const unsigned int DEFAULT_NUMBER_OF_SLOTS;
+            static const unsigned int MAXIMUM_NUMBER_OF_SLOTS;
+
+            FrameShmPublisher();
+            FrameShmPublisher(QString name, unsigned int numSlots);
+            ~FrameShmPublisher();
+
+            static QString getDefaultName(unsigned int cameraNumber);
+            static bool isSupported();
+
+            RtnStatus open();
+            void close();
+            bool isOpen() const;
+            bool publish(const StampedImage &stampedImg);
+            unsigned long getNumberPublished() const;
+
+        private:
+
+            QString name_;
+            unsigned int numSlots_;
+            bool isOpen_;
+            bool haveError_;
+            int fd_;
+            void *base_;
+            size_t mapSize_;
+            uint64_t sessionId_;
+            unsigned long numberPublished_;
+
+            bool createSegment(size_t frameDataSize);
+            void releaseSegment();
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_FRAME_SHM_PUBLISHER_HPP
@@ -1,7 +1,11 @@
 #include "image_dispatcher.hpp"
 #include "stamped_image.hpp"
+#include "frame_shm_publisher.hpp"
 #include "affinity.hpp"
+#include "basic_image_proc.hpp"
 #include <iostream>
+#include <vector>
+#include <algorithm>
 #include <QThread>
 
 // DEVEL
@@ -72,14 +76,65 @@ namespace bias
         cameraNumber_ = cameraNumber;
         pluginEnabled_ = pluginEnabled;
 
+        bayerPattern_ = BAYER_PATTERN_NONE;
+        pluginDemosaic_ = false;
+        pluginMode_ = PLUGIN_SUBSCRIBE_EVERY_FRAME;
+        pluginInterval_ = 1;
+        pluginQueueSize_ = BiasPlugin::DEFAULT_FRAME_QUEUE_SIZE;
+        pluginDropCount_ = 0;
+
         frameCount_ = 0;
         currentTimeStamp_ = 0.0;
     }
 
+    void ImageDispatcher::setFrameExport(std::shared_ptr<FrameShmPublisher> frameExportPtr)
+    {
+        frameExportPtr_ = frameExportPtr;
+    }
+
+    void ImageDispatcher::setLogRoi(ImageRoiParams roiParams)
+    {
+        logRoi_.setParams(roiParams);
+    }
+
+    void ImageDispatcher::setPluginRoi(ImageRoiParams roiParams)
+    {
+        pluginRoi_.setParams(roiParams);
+    }
+
+    void ImageDispatcher::setBayerPattern(BayerPattern pattern)
+    {
+        bayerPattern_ = pattern;
+        logRoi_.setBayerAligned(pattern != BAYER_PATTERN_NONE);
+    }
+
+    void ImageDispatcher::setPluginDemosaic(bool value)
+    {
+        pluginDemosaic_ = value;
+    }
+
+    void ImageDispatcher::setPluginSubscription(
+            PluginSubscriptionMode mode, 
+            unsigned int interval, 
+            unsigned int queueSize
+            )
+    {
+        pluginMode_ = mode;
+        pluginInterval_ = std::max(interval, 1u);
+        pluginQueueSize_ = std::max(queueSize, 1u);
+    }
+
     cv::Mat ImageDispatcher::getImage() const
     {
-        cv::Mat currentImageCopy = currentImage_.clone();
-        return currentImageCopy;
+        // Frames aren't modified once dispatched - share rather than copy.
+        // Callers mustn't draw into the returned image. Raw Bayer frames are
+        // returned as is, see getBayerPattern.
+        return currentImage_;
+    }
+
+    BayerPattern ImageDispatcher::getBayerPattern() const
+    {
+        return bayerPattern_;
     }
 
     double ImageDispatcher::getTimeStamp() const
@@ -97,6 +152,11 @@ namespace bias
         return frameCount_;
     }
 
+    unsigned long ImageDispatcher::getPluginDropCount() const
+    {
+        return pluginDropCount_;
+    }
+
     void ImageDispatcher::stop()
     {
         stopped_ = true;
@@ -107,6 +167,9 @@ namespace bias
     {
         bool done = false;
         StampedImage newStampImage;
+        StampedImage logStampImage;
+        StampedImage pluginStampImage;
+        unsigned long pluginDropCount = 0;
 
         if (!ready_) 
         { 
@@ -121,6 +184,7 @@ namespace bias
         // Initiaiize values
         acquireLock();
         frameCount_ = 0;
+        pluginDropCount_ = 0;
         stopped_ = false;
         fpsEstimator_.reset();
         releaseLock();
@@ -150,26 +214,64 @@ namespace bias
             newImageQueuePtr_ -> pop();
             newImageQueuePtr_ -> releaseLock();
 
-            if (logging_ )
+            if (logging_)
             {
+                logStampImage = logRoi_.apply(newStampImage, true);
                 logImageQueuePtr_ -> acquireLock();
-                logImageQueuePtr_ -> push(newStampImage);
+                logImageQueuePtr_ -> push(logStampImage);
                 logImageQueuePtr_ -> signalNotEmpty();
                 logImageQueuePtr_ -> releaseLock();
             }
 
-            if (pluginEnabled_)
+            bool pluginFrame = pluginEnabled_;
+            if (pluginFrame && (pluginMode_ == PLUGIN_SUBSCRIBE_EVERY_NTH_FRAME))
+            {
+                pluginFrame = (newStampImage.frameCount%pluginInterval_ == 0);
+            }
+
+            if (pluginFrame)
             {
+                if (pluginDemosaic_ && (bayerPattern_ != BAYER_PATTERN_NONE))
+                {
+                    // Demosaic before the crop so odd ROI offsets keep their colors
+                    pluginStampImage = newStampImage;
+                    pluginStampImage.image = demosaicBayer(newStampImage.image, bayerPattern_);
+                    pluginStampImage = pluginRoi_.apply(pluginStampImage, false);
+                }
+                else
+                {
+                    pluginStampImage = pluginRoi_.apply(newStampImage, false);
+                }
                 pluginImageQueuePtr_ -> acquireLock();
-                pluginImageQueuePtr_ -> push(newStampImage);
+                if (pluginMode_ == PLUGIN_SUBSCRIBE_LATEST_FRAME)
+                {
+                    // Conflate - only the newest frame is kept for the plugin
+                    pluginDropCount += pluginImageQueuePtr_ -> size();
+                    pluginImageQueuePtr_ -> clear();
+                }
+                else
+                {
+                    while (pluginImageQueuePtr_ -> size() >= pluginQueueSize_)
+                    {
+                        pluginImageQueuePtr_ -> pop();
+                        pluginDropCount++;
+                    }
+                }
+                pluginImageQueuePtr_ -> push(pluginStampImage);
                 pluginImageQueuePtr_ -> signalNotEmpty();
                 pluginImageQueuePtr_ -> releaseLock();
             }
 
+            if (frameExportPtr_)
+            {
+                frameExportPtr_ -> publish(newStampImage);
+            }
+
             acquireLock();
             currentImage_ = newStampImage.image;
             currentTimeStamp_ = newStampImage.timeStamp;
             frameCount_ = newStampImage.frameCount;
+            pluginDropCount_ = pluginDropCount;
             fpsEstimator_.update(newStampImage.timeStamp);
             done = stopped_;
             releaseLock();
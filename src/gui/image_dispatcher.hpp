@@ -7,12 +7,16 @@
 #include <QRunnable>
 #include <opencv2/core/core.hpp>
 #include "fps_estimator.hpp"
+#include "image_roi.hpp"
 #include "lockable.hpp"
+#include "basic_types.hpp"
+#include "bias_plugin.hpp"
 
 namespace bias
 {
 
     struct StampedImage;
+    class FrameShmPublisher;
 
     class ImageDispatcher : public QObject, public QRunnable, public Lockable<Empty>
     {
@@ -40,13 +44,38 @@ namespace bias
                     std::shared_ptr<LockableQueue<StampedImage>> pluginImageQueuePtr
                     );
 
+            // Optional software ROI crop/binning for the logger and plugin. 
+            // The display always gets the full frame.
+            void setLogRoi(ImageRoiParams roiParams);
+            void setPluginRoi(ImageRoiParams roiParams);
+
+            // Raw Bayer frames are logged as is and only demosaiced for the
+            // display (by the caller of getImage, outside the lock) and for 
+            // plugins which require color.
+            void setBayerPattern(BayerPattern pattern);
+            void setPluginDemosaic(bool value);
+
+            // How frames are delivered to the plugin - frames the plugin won't
+            // use are dropped here rather than held in the plugin queue.
+            void setPluginSubscription(
+                    PluginSubscriptionMode mode, 
+                    unsigned int interval, 
+                    unsigned int queueSize
+                    );
+
+            // Optional - every frame is also published to shared memory for
+            // out-of-process consumers.
+            void setFrameExport(std::shared_ptr<FrameShmPublisher> frameExportPtr);
+
             // Use lock when calling these methods
             // ----------------------------------
             void stop();
             cv::Mat getImage() const;     // Note, might want to change so that we return 
             double getTimeStamp() const;  // the stampedImage.
             double getFPS() const;
+            BayerPattern getBayerPattern() const;
             unsigned long getFrameCount() const;
+            unsigned long getPluginDropCount() const;
             // -----------------------------------
 
         private:
@@ -57,6 +86,14 @@ namespace bias
             std::shared_ptr<LockableQueue<StampedImage>> newImageQueuePtr_;
             std::shared_ptr<LockableQueue<StampedImage>> logImageQueuePtr_;
             std::shared_ptr<LockableQueue<StampedImage>> pluginImageQueuePtr_;
+            std::shared_ptr<FrameShmPublisher> frameExportPtr_;
+            ImageRoi logRoi_;
+            ImageRoi pluginRoi_;
+            BayerPattern bayerPattern_;
+            bool pluginDemosaic_;
+            PluginSubscriptionMode pluginMode_;
+            unsigned int pluginInterval_;
+            unsigned int pluginQueueSize_;
 
             // use lock when setting these values
             // -----------------------------------
@@ -65,6 +102,7 @@ namespace bias
             double currentTimeStamp_;     // the stampedImage. 
             FPS_Estimator fpsEstimator_;
             unsigned long frameCount_;
+            unsigned long pluginDropCount_;
             // ------------------------------------
 
             void run();
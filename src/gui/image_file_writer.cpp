@@ -0,0 +1,118 @@
+#include "image_file_writer.hpp"
+#include "basic_types.hpp"
+#include "affinity.hpp"
+#include <QThread>
+#include <QFileInfo>
+#include <iostream>
+#include <opencv2/highgui/highgui.hpp>
+
+namespace bias
+{
+
+    ImageFileWriter::ImageFileWriter(QObject *parent) : QObject(parent)
+    {
+        initialize(nullptr, nullptr, std::vector<int>(), 0);
+    }
+
+
+    ImageFileWriter::ImageFileWriter(
+            ImageFileJobQueuePtr jobQueuePtr,
+            FrameDrainPtr frameDrainPtr,
+            std::vector<int> imwriteParams,
+            unsigned int cameraNumber,
+            QObject *parent
+            ) : QObject(parent)
+    {
+        initialize(jobQueuePtr, frameDrainPtr, imwriteParams, cameraNumber);
+    }
+
+
+    void ImageFileWriter::initialize(
+            ImageFileJobQueuePtr jobQueuePtr,
+            FrameDrainPtr frameDrainPtr,
+            std::vector<int> imwriteParams,
+            unsigned int cameraNumber
+            )
+    {
+        ready_ = false;
+        stopped_ = false;
+        errorReported_ = false;
+        jobQueuePtr_ = jobQueuePtr;
+        frameDrainPtr_ = frameDrainPtr;
+        imwriteParams_ = imwriteParams;
+        cameraNumber_ = cameraNumber;
+        if ((jobQueuePtr_ != nullptr) && (frameDrainPtr_ != nullptr))
+        {
+            ready_ = true;
+        }
+    }
+
+
+    void ImageFileWriter::stop()
+    {
+        stopped_ = true;
+    }
+
+
+    void ImageFileWriter::run()
+    {
+        bool done = false;
+        ImageFileJob job;
+
+        if (!ready_)
+        {
+            return;
+        }
+
+        QThread *thisThread = QThread::currentThread();
+        thisThread -> setPriority(QThread::NormalPriority);
+        ThreadAffinityService::assignThreadAffinity(false,cameraNumber_);
+
+        while (!done)
+        {
+            bool haveJob = false;
+
+            jobQueuePtr_ -> acquireLock();
+            jobQueuePtr_ -> waitIfEmpty();
+            if (!(jobQueuePtr_ -> empty()))
+            {
+                job = jobQueuePtr_ -> front();
+                jobQueuePtr_ -> pop();
+                haveJob = true;
+            }
+            jobQueuePtr_ -> releaseLock();
+
+            if (haveJob)
+            {
+                try
+                {
+                    cv::imwrite(job.fileName, job.stampedImg.image, imwriteParams_);
+                    QFileInfo fileInfo(QString::fromStdString(job.fileName));
+                    frameDrainPtr_ -> addBytesWritten((unsigned long long)(fileInfo.size()));
+                }
+                catch (cv::Exception &exc)
+                {
+                    if (!errorReported_)
+                    {
+                        unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+                        QString errorMsg("adding frame failed - ");
+                        errorMsg += QString::fromStdString(exc.what());
+                        emit imageLoggingError(errorId, errorMsg);
+                        errorReported_ = true;
+                    }
+                }
+                // Release image data as soon as it has been written
+                job.stampedImg.image.release();
+                frameDrainPtr_ -> frameDone();
+            }
+            else
+            {
+                // Queue is empty - only exit once asked to
+                acquireLock();
+                done = stopped_;
+                releaseLock();
+            }
+        }
+    }
+
+} // namespace bias
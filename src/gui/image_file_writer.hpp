@@ -0,0 +1,71 @@
+#ifndef BIAS_IMAGE_FILE_WRITER_HPP
+#define BIAS_IMAGE_FILE_WRITER_HPP
+
+#include <QObject>
+#include <QRunnable>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lockable.hpp"
+#include "stamped_image.hpp"
+#include "frame_drain.hpp"
+
+namespace bias
+{
+
+    struct ImageFileJob
+    {
+        std::string fileName;
+        StampedImage stampedImg;
+    };
+
+    typedef LockableQueue<ImageFileJob> ImageFileJobQueue;
+    typedef std::shared_ptr<ImageFileJobQueue> ImageFileJobQueuePtr;
+
+
+    class ImageFileWriter : public QObject, public QRunnable, public Lockable<Empty>
+    {
+        // Worker for image sequence logging - writes each job's image to its 
+        // (precomputed) file name with cv::imwrite. After stop() is called 
+        // the worker keeps going until the job queue is empty. 
+
+        Q_OBJECT
+
+        public:
+
+            ImageFileWriter(QObject *parent=0);
+            ImageFileWriter(
+                    ImageFileJobQueuePtr jobQueuePtr,
+                    FrameDrainPtr frameDrainPtr,
+                    std::vector<int> imwriteParams,
+                    unsigned int cameraNumber,
+                    QObject *parent=0
+                    );
+
+            void stop();
+
+        signals:
+            void imageLoggingError(unsigned int errorId, QString errorMsg);
+
+        private:
+
+            bool ready_;
+            bool stopped_;
+            bool errorReported_;
+            unsigned int cameraNumber_;
+            std::vector<int> imwriteParams_;
+            ImageFileJobQueuePtr jobQueuePtr_;
+            FrameDrainPtr frameDrainPtr_;
+
+            void initialize(
+                    ImageFileJobQueuePtr jobQueuePtr,
+                    FrameDrainPtr frameDrainPtr,
+                    std::vector<int> imwriteParams,
+                    unsigned int cameraNumber
+                    );
+            void run();
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_IMAGE_FILE_WRITER_HPP
@@ -3,15 +3,17 @@
 #include "exception.hpp"
 #include "stamped_image.hpp"
 #include "video_writer.hpp"
+#include "frame_gate.hpp"
 #include "affinity.hpp"
 #include <QThread>
 #include <queue>
+#include <vector>
 #include <iostream>
 #include <opencv2/core/core.hpp>
 
 namespace bias
 {
-    const unsigned int MAX_LOG_QUEUE_SIZE = 1000;
+    const unsigned int ImageLogger::MAX_LOG_QUEUE_SIZE = 1000;
 
     ImageLogger::ImageLogger(QObject *parent) : QObject(parent) 
     {
@@ -55,6 +57,13 @@ namespace bias
         stopped_ = true;
     }
 
+    void ImageLogger::setLogGate(std::shared_ptr<FrameGate> logGatePtr)
+    {
+        acquireLock();
+        logGatePtr_ = logGatePtr;
+        releaseLock();
+    }
+
     unsigned int ImageLogger::getLogQueueSize()
     {
         return logQueueSize_;
@@ -65,6 +74,8 @@ namespace bias
         bool done = false;
         bool errorFlag = false;
         StampedImage newStampedImage;
+        std::vector<StampedImage> releaseVec;
+        std::shared_ptr<FrameGate> logGatePtr;
         unsigned int logQueueSize;
 
         if (!ready_) 
@@ -80,6 +91,7 @@ namespace bias
         acquireLock();
         stopped_ = false;
         frameCount_ = 0;
+        logGatePtr = logGatePtr_;
         releaseLock();
 
         while (!done)
@@ -112,10 +124,25 @@ namespace bias
                 //std::cout << "cam: " << cameraNumber_ << ", queue size: " << logQueueSize;
                 //std::cout << "/" << MAX_LOG_QUEUE_SIZE << std::endl;
 
-                // Add frame to video writer
+                // Add frame to video writer - gated frames are held back or 
+                // released in batches by the gate (activity detection etc.)
                 try 
                 {
-                    videoWriterPtr_ -> addFrame(newStampedImage);
+                    if (logGatePtr)
+                    {
+                        releaseVec.clear();
+                        logGatePtr -> acquireLock();
+                        logGatePtr -> addFrame(newStampedImage, releaseVec);
+                        logGatePtr -> releaseLock();
+                        for (StampedImage &releaseImage : releaseVec)
+                        {
+                            videoWriterPtr_ -> addFrame(releaseImage);
+                        }
+                    }
+                    else
+                    {
+                        videoWriterPtr_ -> addFrame(newStampedImage);
+                    }
                 }
                 catch (RuntimeError &runtimeError)
                 {
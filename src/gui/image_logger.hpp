@@ -19,6 +19,7 @@ namespace bias
 {
 
     class VideoWriter;
+    class FrameGate;
 
     struct StampedImage;
 
@@ -44,8 +45,13 @@ namespace bias
 
             void stop();
 
+            // Optional - when set, logged frames pass through the gate
+            // (pre-trigger buffer, activity detector) before the video writer.
+            void setLogGate(std::shared_ptr<FrameGate> logGatePtr);
+
             unsigned int getLogQueueSize();
 
+            static const unsigned int MAX_LOG_QUEUE_SIZE;
 
             // Debugging --------------------------
             //cv::Mat getBackgroundMembershipImage();
@@ -63,6 +69,7 @@ namespace bias
 
             std::shared_ptr<VideoWriter> videoWriterPtr_;
             std::shared_ptr<LockableQueue<StampedImage>> logImageQueuePtr_;
+            std::shared_ptr<FrameGate> logGatePtr_;
 
             void run();
     };
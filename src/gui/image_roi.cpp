@@ -0,0 +1,263 @@
+#include "image_roi.hpp"
+#include <algorithm>
+#include <sstream>
+#include <QVariantList>
+#include <opencv2/imgproc/imgproc.hpp>
+
+namespace bias
+{
+
+    // Constants
+    // ------------------------------------------------------------------------
+    const bool ImageRoi::DEFAULT_ROI_FLAG = false;
+    const unsigned int ImageRoi::DEFAULT_BINNING = 1;
+    const std::vector<unsigned int> ImageRoi::ALLOWED_BINNING_VEC = {1, 2, 4};
+
+
+    // ImageRoiParams
+    // ------------------------------------------------------------------------
+    ImageRoiParams::ImageRoiParams()
+    {
+        roiFlag = ImageRoi::DEFAULT_ROI_FLAG;
+        binning = ImageRoi::DEFAULT_BINNING;
+    }
+
+
+    std::string ImageRoiParams::toString()
+    {
+        std::stringstream ss;
+        ss << "roiFlag: " << std::boolalpha << roiFlag << std::noboolalpha << std::endl;
+        ss << "binning: " << binning << std::endl;
+        for (unsigned int i=0; i<rectVec.size(); i++)
+        {
+            cv::Rect &rect = rectVec[i];
+            ss << "rect " << i << ": " << rect.x << ", " << rect.y << ", ";
+            ss << rect.width << ", " << rect.height << std::endl;
+        }
+        return ss.str();
+    }
+
+
+    QVariantMap ImageRoiParams::toMap()
+    {
+        QVariantList rectList;
+        for (cv::Rect &rect : rectVec)
+        {
+            QVariantMap rectMap;
+            rectMap.insert("xPos", rect.x);
+            rectMap.insert("yPos", rect.y);
+            rectMap.insert("width", rect.width);
+            rectMap.insert("height", rect.height);
+            rectList.append(rectMap);
+        }
+
+        QVariantMap roiMap;
+        roiMap.insert("on", roiFlag);
+        roiMap.insert("binning", binning);
+        roiMap.insert("rects", rectList);
+        return roiMap;
+    }
+
+
+    RtnStatus ImageRoiParams::fromMap(QVariantMap roiMap)
+    {
+        RtnStatus rtnStatus;
+        ImageRoiParams newParams = *this;
+
+        if (roiMap.contains("on"))
+        {
+            if (roiMap["on"].canConvert<bool>())
+            {
+                newParams.roiFlag = roiMap["on"].toBool();
+            }
+            else
+            {
+                rtnStatus.success = false;
+                rtnStatus.appendMessage("unable to convert roi on to bool");
+            }
+        }
+
+        if (roiMap.contains("binning"))
+        {
+            unsigned int binning = roiMap["binning"].toUInt();
+            if (ImageRoi::isAllowedBinning(binning))
+            {
+                newParams.binning = binning;
+            }
+            else
+            {
+                rtnStatus.success = false;
+                rtnStatus.appendMessage("roi binning must be 1, 2 or 4");
+            }
+        }
+
+        if (roiMap.contains("rects"))
+        {
+            newParams.rectVec.clear();
+            for (QVariant rectVar : roiMap["rects"].toList())
+            {
+                QVariantMap rectMap = rectVar.toMap();
+                bool ok = rectMap.contains("xPos") && rectMap.contains("yPos");
+                ok = ok && rectMap.contains("width") && rectMap.contains("height");
+                cv::Rect rect;
+                if (ok)
+                {
+                    rect.x = rectMap["xPos"].toInt();
+                    rect.y = rectMap["yPos"].toInt();
+                    rect.width = rectMap["width"].toInt();
+                    rect.height = rectMap["height"].toInt();
+                    ok = (rect.x >= 0) && (rect.y >= 0) && (rect.width > 0) && (rect.height > 0);
+                }
+                if (!ok)
+                {
+                    rtnStatus.success = false;
+                    rtnStatus.appendMessage("roi rects require xPos >= 0, yPos >= 0, width > 0 and height > 0");
+                    break;
+                }
+                newParams.rectVec.push_back(rect);
+            }
+        }
+
+        if (rtnStatus.success)
+        {
+            *this = newParams;
+        }
+        return rtnStatus;
+    }
+
+
+    // ImageRoi public methods
+    // ------------------------------------------------------------------------
+    ImageRoi::ImageRoi() 
+    {
+        bayerAligned_ = false;
+    }
+
+
+    ImageRoi::ImageRoi(ImageRoiParams params)
+    {
+        bayerAligned_ = false;
+        setParams(params);
+    }
+
+
+    void ImageRoi::setParams(ImageRoiParams params)
+    {
+        params_ = params;
+        if (!isAllowedBinning(params_.binning))
+        {
+            params_.binning = DEFAULT_BINNING;
+        }
+    }
+
+
+    ImageRoiParams ImageRoi::getParams() const
+    {
+        return params_;
+    }
+
+
+    void ImageRoi::setBayerAligned(bool value)
+    {
+        bayerAligned_ = value;
+    }
+
+
+    bool ImageRoi::isEnabled() const
+    {
+        return params_.roiFlag && (!params_.rectVec.empty() || (params_.binning > 1));
+    }
+
+
+    StampedImage ImageRoi::apply(const StampedImage &stampedImg, bool compact) const
+    {
+        if (!isEnabled() || stampedImg.image.empty())
+        {
+            return stampedImg;
+        }
+
+        const cv::Mat &image = stampedImg.image;
+        cv::Rect imageRect(0, 0, image.cols, image.rows);
+        std::vector<cv::Rect> rectVec = params_.rectVec;
+        if (rectVec.empty())
+        {
+            rectVec.push_back(imageRect);
+        }
+
+        int binning = int(params_.binning);
+        std::vector<cv::Mat> partVec;
+        for (cv::Rect rect : rectVec)
+        {
+            if (bayerAligned_)
+            {
+                // Round the offset down to keep the 2x2 filter phase, the size
+                // is made even below
+                rect.width += rect.x % 2;
+                rect.height += rect.y % 2;
+                rect.x -= rect.x % 2;
+                rect.y -= rect.y % 2;
+            }
+            rect &= imageRect;
+            if (bayerAligned_)
+            {
+                rect.width -= rect.width % 2;
+                rect.height -= rect.height % 2;
+            }
+            rect.width -= rect.width % binning;
+            rect.height -= rect.height % binning;
+            if ((rect.width <= 0) || (rect.height <= 0))
+            {
+                continue;
+            }
+            cv::Mat part = image(rect);
+            if (binning > 1)
+            {
+                // Area interpolation with an integer factor is a block average
+                cv::Mat binnedPart;
+                cv::Size binnedSize(rect.width/binning, rect.height/binning);
+                cv::resize(part, binnedPart, binnedSize, 0, 0, cv::INTER_AREA);
+                part = binnedPart;
+            }
+            partVec.push_back(part);
+        }
+
+        if (partVec.empty())
+        {
+            // All rectangles outside of the image - pass frame through unchanged
+            return stampedImg;
+        }
+
+        StampedImage roiStampedImg = stampedImg;
+        if (partVec.size() == 1)
+        {
+            cv::Mat part = partVec[0];
+            roiStampedImg.image = (compact && !part.isContinuous()) ? part.clone() : part;
+        }
+        else
+        {
+            int mosaicWidth = 0;
+            int mosaicHeight = 0;
+            for (cv::Mat &part : partVec)
+            {
+                mosaicWidth += part.cols;
+                mosaicHeight = std::max(mosaicHeight, part.rows);
+            }
+            cv::Mat mosaic = cv::Mat::zeros(mosaicHeight, mosaicWidth, image.type());
+            int xPos = 0;
+            for (cv::Mat &part : partVec)
+            {
+                part.copyTo(mosaic(cv::Rect(xPos, 0, part.cols, part.rows)));
+                xPos += part.cols;
+            }
+            roiStampedImg.image = mosaic;
+        }
+        return roiStampedImg;
+    }
+
+
+    bool ImageRoi::isAllowedBinning(unsigned int binning)
+    {
+        return std::find(ALLOWED_BINNING_VEC.begin(), ALLOWED_BINNING_VEC.end(), binning) != ALLOWED_BINNING_VEC.end();
+    }
+
+} // namespace bias
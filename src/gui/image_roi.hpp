@@ -0,0 +1,64 @@
+#ifndef BIAS_IMAGE_ROI_HPP
+#define BIAS_IMAGE_ROI_HPP
+#include "stamped_image.hpp"
+#include "rtn_status.hpp"
+#include <string>
+#include <vector>
+#include <QVariantMap>
+#include <opencv2/core/core.hpp>
+
+namespace bias
+{
+
+    struct ImageRoiParams
+    {
+        bool roiFlag;
+        unsigned int binning;
+        std::vector<cv::Rect> rectVec;
+        ImageRoiParams();
+        std::string toString();
+        QVariantMap toMap();
+        RtnStatus fromMap(QVariantMap roiMap);
+    };
+
+
+    class ImageRoi
+    {
+        // Software ROI crop and binning stage applied by the image dispatcher
+        // separately for the logger and for the plugin. Each rectangle is 
+        // clipped to the image and trimmed to a multiple of the binning 
+        // factor, binned by block averaging (1x1, 2x2 or 4x4), and the 
+        // results are packed left to right into one image (top aligned, 
+        // zero filled). A single rectangle without binning is returned as a
+        // view of the original frame unless a compact copy is requested, 
+        // which writers need as they expect continuous image data. For raw 
+        // Bayer frames the rectangles are aligned to even offsets and sizes 
+        // so that the crop keeps the color filter phase of the mosaic.
+
+        public:
+
+            static const bool DEFAULT_ROI_FLAG;
+            static const unsigned int DEFAULT_BINNING;
+            static const std::vector<unsigned int> ALLOWED_BINNING_VEC;
+
+            ImageRoi();
+            explicit ImageRoi(ImageRoiParams params);
+
+            void setParams(ImageRoiParams params);
+            ImageRoiParams getParams() const;
+            bool isEnabled() const;
+            void setBayerAligned(bool value);
+
+            StampedImage apply(const StampedImage &stampedImg, bool compact) const;
+
+            static bool isAllowedBinning(unsigned int binning);
+
+        private:
+
+            ImageRoiParams params_;
+            bool bayerAligned_;
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_IMAGE_ROI_HPP
@@ -3,6 +3,7 @@
 #include "video_writer_jpg.hpp"
 #include "video_writer_ufmf.hpp"
 #include "video_writer_avi.hpp"
+#include "video_writer_zfmf.hpp"
 #include "background_histogram_ufmf.hpp"
 #include "validators.hpp"
 #include <iostream>
@@ -52,6 +53,37 @@ namespace bias
         bmpFrameSkipLineEditPtr_ -> setText(tmpString);
         bmpFrameSkipRangeLabelPtr_ -> setText(QString(" >= 1 "));
 
+        // bmp tab - image format
+        QStringList allowedImageFormatList = VideoWriter_bmp::getListOfAllowedImageFormats();
+        for (unsigned int i=0; i<allowedImageFormatList.size(); i++)
+        {
+            QString imageFormatString = allowedImageFormatList.at(i);
+            bmpImageFormatComboBoxPtr_ -> addItem(imageFormatString);
+            if (imageFormatString == params_.bmp.imageFormat)
+            {
+                bmpImageFormatComboBoxPtr_ -> setCurrentIndex(i);
+            }
+        }
+
+        // bmp tab - compression level (png, tif)
+        tmpString = QString::number(params_.bmp.compressionLevel);
+        bmpCompressionLevelLineEditPtr_ -> setText(tmpString);
+        tmpString = QString("(%1, %2)").arg(
+                QString::number(VideoWriter_bmp::MIN_COMPRESSION_LEVEL),
+                QString::number(VideoWriter_bmp::MAX_COMPRESSION_LEVEL)
+                );
+        bmpCompressionLevelRangeLabelPtr_ -> setText(tmpString);
+
+        // bmp tab - writer threads (0 = write on logging thread)
+        tmpString = QString::number(params_.bmp.numberOfWriters);
+        bmpWriterThreadsLineEditPtr_ -> setText(tmpString);
+        bmpWriterThreadsRangeLabelPtr_ -> setText(QString(" >= 0"));
+
+        // bmp tab - frames per directory (0 = single directory)
+        tmpString = QString::number(params_.bmp.framesPerDirectory);
+        bmpFramesPerDirectoryLineEditPtr_ -> setText(tmpString);
+        bmpFramesPerDirectoryRangeLabelPtr_ -> setText(QString(" >= 0"));
+
         // jpg tab - frame skip
         tmpString = QString::number(params_.jpg.frameSkip);
         jpgFrameSkipLineEditPtr_ -> setText(tmpString);
@@ -114,6 +146,18 @@ namespace bias
             }
         }
 
+        // avi tab - number of encoder threads
+        tmpString = QString::number(params_.avi.numberOfEncoders);
+        aviEncoderThreadsLineEditPtr_ -> setText(tmpString);
+        tmpString = QString("(1, %1)").arg(QString::number(VideoWriter_avi::MAX_NUMBER_OF_ENCODERS));
+        aviEncoderThreadsRangeLabelPtr_ -> setText(tmpString);
+
+        // avi tab - frames per segment (used with more than one encoder)
+        tmpString = QString::number(params_.avi.segmentFrames);
+        aviSegmentFramesLineEditPtr_ -> setText(tmpString);
+        tmpString = QString(" >= %1").arg(QString::number(VideoWriter_avi::MIN_SEGMENT_FRAMES));
+        aviSegmentFramesRangeLabelPtr_ -> setText(tmpString);
+
         // fmf tab - frame skip
         tmpString = QString::number(params_.fmf.frameSkip);
         fmfFrameSkipLineEditPtr_ -> setText(tmpString);
@@ -192,6 +236,49 @@ namespace bias
         ufmfDilateCheckBoxPtr_ -> setEnabled(true); 
         ufmfDilateLineEditPtr_ -> setEnabled(true); 
 
+        // zfmf tab - frame skip
+        tmpString = QString::number(params_.zfmf.frameSkip);
+        zfmfFrameSkipLineEditPtr_ -> setText(tmpString);
+        zfmfFrameSkipRangeLabelPtr_ -> setText(QString(" >= 1"));
+
+        // zfmf tab - number of compressor threads
+        tmpString = QString::number(params_.zfmf.numberOfCompressors);
+        zfmfCompressionThreadsLineEditPtr_ -> setText(tmpString);
+        zfmfCompressionThreadsRangeLabelPtr_ -> setText(QString(" >= 1"));
+
+        // zfmf tab - compression level
+        tmpString = QString::number(params_.zfmf.compressionLevel);
+        zfmfCompressionLevelLineEditPtr_ -> setText(tmpString);
+        tmpString = QString("(%1, %2)").arg(
+                QString::number(VideoWriter_zfmf::MIN_COMPRESSION_LEVEL),
+                QString::number(VideoWriter_zfmf::MAX_COMPRESSION_LEVEL)
+                );
+        zfmfCompressionLevelRangeLabelPtr_ -> setText(tmpString);
+
+        // zfmf tab - tile rows
+        tmpString = QString::number(params_.zfmf.tileRows);
+        zfmfTileRowsLineEditPtr_ -> setText(tmpString);
+        tmpString = QString("(%1, %2)").arg(
+                QString::number(VideoWriter_zfmf::MIN_TILE_ROWS),
+                QString::number(VideoWriter_zfmf::MAX_TILE_ROWS)
+                );
+        zfmfTileRowsRangeLabelPtr_ -> setText(tmpString);
+
+        // zfmf tab - delta frames and key frame interval
+        if (params_.zfmf.deltaFlag)
+        {
+            zfmfDeltaCheckBoxPtr_ -> setCheckState(Qt::Checked);
+        }
+        else
+        {
+            zfmfDeltaCheckBoxPtr_ -> setCheckState(Qt::Unchecked);
+        }
+        tmpString = QString::number(params_.zfmf.keyFrameInterval);
+        zfmfDeltaLineEditPtr_ -> setText(tmpString);
+        tmpString = QString(" >= %1").arg(VideoWriter_zfmf::MIN_KEYFRAME_INTERVAL);
+        zfmfDeltaRangeLabelPtr_ -> setText(tmpString);
+        zfmfDeltaLineEditPtr_ -> setEnabled(params_.zfmf.deltaFlag);
+
     }
 
 
@@ -204,6 +291,24 @@ namespace bias
         validatorPtr -> setBottom(1);
         bmpFrameSkipLineEditPtr_ -> setValidator(validatorPtr);
 
+        // bmp tab - compression level
+        validatorPtr = new IntValidatorWithFixup(bmpCompressionLevelLineEditPtr_);
+        validatorPtr -> setRange(
+                VideoWriter_bmp::MIN_COMPRESSION_LEVEL,
+                VideoWriter_bmp::MAX_COMPRESSION_LEVEL
+                );
+        bmpCompressionLevelLineEditPtr_ -> setValidator(validatorPtr);
+
+        // bmp tab - writer threads
+        validatorPtr = new IntValidatorWithFixup(bmpWriterThreadsLineEditPtr_);
+        validatorPtr -> setBottom(0);
+        bmpWriterThreadsLineEditPtr_ -> setValidator(validatorPtr);
+
+        // bmp tab - frames per directory
+        validatorPtr = new IntValidatorWithFixup(bmpFramesPerDirectoryLineEditPtr_);
+        validatorPtr -> setBottom(0);
+        bmpFramesPerDirectoryLineEditPtr_ -> setValidator(validatorPtr);
+
         // jpg tab - frame skip
         validatorPtr = new IntValidatorWithFixup(jpgFrameSkipLineEditPtr_);
         validatorPtr -> setBottom(1);
@@ -232,6 +337,16 @@ namespace bias
         validatorPtr -> setBottom(1);
         aviFrameSkipLineEditPtr_ -> setValidator(validatorPtr);
 
+        // avi tab - number of encoder threads
+        validatorPtr = new IntValidatorWithFixup(aviEncoderThreadsLineEditPtr_);
+        validatorPtr -> setRange(1, VideoWriter_avi::MAX_NUMBER_OF_ENCODERS);
+        aviEncoderThreadsLineEditPtr_ -> setValidator(validatorPtr);
+
+        // avi tab - frames per segment
+        validatorPtr = new IntValidatorWithFixup(aviSegmentFramesLineEditPtr_);
+        validatorPtr -> setBottom(VideoWriter_avi::MIN_SEGMENT_FRAMES);
+        aviSegmentFramesLineEditPtr_ -> setValidator(validatorPtr);
+
         // fmf tab - frame skip
         validatorPtr = new IntValidatorWithFixup(fmfFrameSkipLineEditPtr_);
         validatorPtr -> setBottom(1);
@@ -280,6 +395,37 @@ namespace bias
                 VideoWriter_ufmf::MAX_DILATE_WINDOW_SIZE
                 );
         ufmfDilateLineEditPtr_ -> setValidator(validatorPtr);
+
+        // zfmf tab - frame skip
+        validatorPtr = new IntValidatorWithFixup(zfmfFrameSkipLineEditPtr_);
+        validatorPtr -> setBottom(1);
+        zfmfFrameSkipLineEditPtr_ -> setValidator(validatorPtr);
+
+        // zfmf tab - number of compression threads
+        validatorPtr = new IntValidatorWithFixup(zfmfCompressionThreadsLineEditPtr_);
+        validatorPtr -> setBottom(1);
+        zfmfCompressionThreadsLineEditPtr_ -> setValidator(validatorPtr);
+
+        // zfmf tab - compression level
+        validatorPtr = new IntValidatorWithFixup(zfmfCompressionLevelLineEditPtr_);
+        validatorPtr -> setRange(
+                VideoWriter_zfmf::MIN_COMPRESSION_LEVEL,
+                VideoWriter_zfmf::MAX_COMPRESSION_LEVEL
+                );
+        zfmfCompressionLevelLineEditPtr_ -> setValidator(validatorPtr);
+
+        // zfmf tab - tile rows
+        validatorPtr = new IntValidatorWithFixup(zfmfTileRowsLineEditPtr_);
+        validatorPtr -> setRange(
+                VideoWriter_zfmf::MIN_TILE_ROWS,
+                VideoWriter_zfmf::MAX_TILE_ROWS
+                );
+        zfmfTileRowsLineEditPtr_ -> setValidator(validatorPtr);
+
+        // zfmf tab - key frame interval
+        validatorPtr = new IntValidatorWithFixup(zfmfDeltaLineEditPtr_);
+        validatorPtr -> setBottom(VideoWriter_zfmf::MIN_KEYFRAME_INTERVAL);
+        zfmfDeltaLineEditPtr_ -> setValidator(validatorPtr);
     }
 
 
@@ -292,6 +438,34 @@ namespace bias
                 SLOT(bmpFrameSkip_EditingFinished())
                );
 
+        connect(
+                bmpImageFormatComboBoxPtr_,
+                SIGNAL(currentIndexChanged(QString)),
+                this,
+                SLOT(bmpImageFormatComboBox_CurrentIndexChanged(QString))
+               );
+
+        connect(
+                bmpCompressionLevelLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(bmpCompressionLevel_EditingFinished())
+               );
+
+        connect(
+                bmpWriterThreadsLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(bmpWriterThreads_EditingFinished())
+               );
+
+        connect(
+                bmpFramesPerDirectoryLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(bmpFramesPerDirectory_EditingFinished())
+               );
+
         connect(
                 jpgFrameSkipLineEditPtr_,
                 SIGNAL(editingFinished()),
@@ -349,6 +523,20 @@ namespace bias
                 SLOT(aviCodecComboBox_CurrentIndexChanged(QString))
                );
 
+        connect(
+                aviEncoderThreadsLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(aviEncoderThreads_EditingFinished())
+               );
+
+        connect(
+                aviSegmentFramesLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(aviSegmentFrames_EditingFinished())
+               );
+
         connect(
                 fmfFrameSkipLineEditPtr_,
                 SIGNAL(editingFinished()),
@@ -412,6 +600,48 @@ namespace bias
                 SLOT(ufmfDilate_EditingFinished())
                );
 
+        connect(
+                zfmfFrameSkipLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(zfmfFrameSkip_EditingFinished())
+               );
+
+        connect(
+                zfmfCompressionThreadsLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(zfmfCompressionThreads_EditingFinished())
+               );
+
+        connect(
+                zfmfCompressionLevelLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(zfmfCompressionLevel_EditingFinished())
+               );
+
+        connect(
+                zfmfTileRowsLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(zfmfTileRows_EditingFinished())
+               );
+
+        connect(
+                zfmfDeltaCheckBoxPtr_,
+                SIGNAL(stateChanged(int)),
+                this,
+                SLOT(zfmfDeltaCheckBox_StateChanged(int))
+               );
+
+        connect(
+                zfmfDeltaLineEditPtr_,
+                SIGNAL(editingFinished()),
+                this,
+                SLOT(zfmfDelta_EditingFinished())
+               );
+
         connect(
                 parent(),
                 SIGNAL(imageCaptureStarted(bool)),
@@ -437,6 +667,40 @@ namespace bias
     }
 
 
+    void LoggingSettingsDialog::bmpImageFormatComboBox_CurrentIndexChanged(QString text)
+    {
+        params_.bmp.imageFormat = text;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::bmpCompressionLevel_EditingFinished()
+    {
+        QString levelString = bmpCompressionLevelLineEditPtr_ -> text();
+        int level = levelString.toInt();
+        params_.bmp.compressionLevel = level;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::bmpWriterThreads_EditingFinished()
+    {
+        QString numberString = bmpWriterThreadsLineEditPtr_ -> text();
+        unsigned int number = numberString.toUInt();
+        params_.bmp.numberOfWriters = number;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::bmpFramesPerDirectory_EditingFinished()
+    {
+        QString numberString = bmpFramesPerDirectoryLineEditPtr_ -> text();
+        unsigned int number = numberString.toUInt();
+        params_.bmp.framesPerDirectory = number;
+        emit parametersChanged(params_);
+    }
+
+
     void LoggingSettingsDialog::jpgFrameSkip_EditingFinished()
     {
         QString frameSkipString = jpgFrameSkipLineEditPtr_ -> text();
@@ -498,6 +762,24 @@ namespace bias
         emit parametersChanged(params_);
     }
 
+
+    void LoggingSettingsDialog::aviEncoderThreads_EditingFinished()
+    {
+        QString numberString = aviEncoderThreadsLineEditPtr_ -> text();
+        unsigned int number = numberString.toUInt();
+        params_.avi.numberOfEncoders = number;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::aviSegmentFrames_EditingFinished()
+    {
+        QString framesString = aviSegmentFramesLineEditPtr_ -> text();
+        unsigned long frames = framesString.toULong();
+        params_.avi.segmentFrames = frames;
+        emit parametersChanged(params_);
+    }
+
     void LoggingSettingsDialog::fmfFrameSkip_EditingFinished()
     {
         QString frameSkipString = fmfFrameSkipLineEditPtr_ -> text();
@@ -577,6 +859,59 @@ namespace bias
     }
 
 
+    void LoggingSettingsDialog::zfmfFrameSkip_EditingFinished()
+    {
+        QString frameSkipString = zfmfFrameSkipLineEditPtr_ -> text();
+        unsigned int frameSkip = frameSkipString.toUInt();
+        params_.zfmf.frameSkip = frameSkip;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::zfmfCompressionThreads_EditingFinished()
+    {
+        QString numberString = zfmfCompressionThreadsLineEditPtr_ -> text();
+        unsigned int number = numberString.toUInt();
+        params_.zfmf.numberOfCompressors = number;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::zfmfCompressionLevel_EditingFinished()
+    {
+        QString levelString = zfmfCompressionLevelLineEditPtr_ -> text();
+        int level = levelString.toInt();
+        params_.zfmf.compressionLevel = level;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::zfmfTileRows_EditingFinished()
+    {
+        QString tileRowsString = zfmfTileRowsLineEditPtr_ -> text();
+        unsigned int tileRows = tileRowsString.toUInt();
+        params_.zfmf.tileRows = tileRows;
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::zfmfDeltaCheckBox_StateChanged(int state)
+    {
+        params_.zfmf.deltaFlag = bool(state);
+        zfmfDeltaLineEditPtr_ -> setEnabled(params_.zfmf.deltaFlag);
+        emit parametersChanged(params_);
+    }
+
+
+    void LoggingSettingsDialog::zfmfDelta_EditingFinished()
+    {
+        QString intervalString = zfmfDeltaLineEditPtr_ -> text();
+        unsigned int interval = intervalString.toUInt();
+        params_.zfmf.keyFrameInterval = interval;
+        emit parametersChanged(params_);
+    }
+
+
     void LoggingSettingsDialog::imageCaptureStarted(bool logging)
     {
         setEnabled(false);
@@ -25,6 +25,10 @@ namespace bias
         private slots:
 
             void bmpFrameSkip_EditingFinished();
+            void bmpImageFormatComboBox_CurrentIndexChanged(QString text);
+            void bmpCompressionLevel_EditingFinished();
+            void bmpWriterThreads_EditingFinished();
+            void bmpFramesPerDirectory_EditingFinished();
             void jpgFrameSkip_EditingFinished();
             void jpgQuality_EditingFinished();
             void jpgCompressionThreads_EditingFinished();
@@ -32,6 +36,8 @@ namespace bias
             void jpgMjpgMaxFramePerFile_EditingFinished();
             void aviFrameSkip_EditingFinished();
             void aviCodecComboBox_CurrentIndexChanged(QString text);
+            void aviEncoderThreads_EditingFinished();
+            void aviSegmentFrames_EditingFinished();
             void fmfFrameSkip_EditingFinished();
             void ufmfFrameSkip_EditingFinished();
             void ufmfBackgroundThreshold_EditingFinished();
@@ -42,6 +48,12 @@ namespace bias
             void ufmfDilateCheckBox_StateChanged(int state);
             void jpgMjpgMaxFramePerFileFlagCheckBox_StateChanged(int state);
             void ufmfDilate_EditingFinished();
+            void zfmfFrameSkip_EditingFinished();
+            void zfmfCompressionThreads_EditingFinished();
+            void zfmfCompressionLevel_EditingFinished();
+            void zfmfTileRows_EditingFinished();
+            void zfmfDeltaCheckBox_StateChanged(int state);
+            void zfmfDelta_EditingFinished();
             void imageCaptureStarted(bool logging);
             void imageCaptureStopped();
 
@@ -1,5 +1,7 @@
 #include <plugin_handler.hpp>
 #include <QThread>
+#include <QThreadPool>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include "affinity.hpp"
@@ -10,6 +12,41 @@ namespace bias
 { 
     const unsigned int PluginHandler::MAX_IMAGE_QUEUE_SIZE = 500;
 
+
+    // Worker task for reentrant plugins - processes one frame 
+    // ----------------------------------------------------------------------------------
+    class PluginFrameTask : public QRunnable
+    {
+        public:
+
+            PluginFrameTask(
+                    PluginHandler *handlerPtr, 
+                    BiasPlugin *pluginPtr, 
+                    unsigned long index, 
+                    StampedImage stampedImage
+                    )
+            {
+                handlerPtr_ = handlerPtr;
+                pluginPtr_ = pluginPtr;
+                index_ = index;
+                stampedImage_ = stampedImage;
+            }
+
+            void run()
+            {
+                PluginFrameResult result = pluginPtr_ -> processFrameConcurrent(stampedImage_);
+                handlerPtr_ -> addFrameResult(index_, result);
+            }
+
+        private:
+
+            PluginHandler *handlerPtr_;
+            BiasPlugin *pluginPtr_;
+            unsigned long index_;
+            StampedImage stampedImage_;
+    };
+
+
     PluginHandler::PluginHandler(QObject *parent) : QObject(parent)
     {
         QPointer<BiasPlugin> emptyPluginPtr;
@@ -66,6 +103,8 @@ namespace bias
     {
         ready_ = false;
         stopped_ = true;
+        nextSubmitIndex_ = 0;
+        nextDeliverIndex_ = 0;
         setCameraNumber(cameraNumber);
         setImageQueue(pluginImageQueuePtr);
         setPlugin(pluginPtr);
@@ -81,16 +120,34 @@ namespace bias
     }
 
 
-    cv::Mat PluginHandler::getImage() const
+    PluginPreview PluginHandler::getPreview(QSize maxSize) const
     {
-        cv::Mat currentImage;
+        PluginPreview preview;
         if (!pluginPtr_.isNull())
         {
-            currentImage = pluginPtr_ -> getCurrentImage();
+            preview = pluginPtr_ -> getPreview(maxSize);
+        }
+        return preview;
+    }
+
+    void PluginHandler::addFrameResult(unsigned long index, PluginFrameResult result)
+    {
+        resultMutex_.lock();
+        resultMap_[index] = result;
+        bool isNext = (index == nextDeliverIndex_);
+        resultWaitCond_.wakeAll();
+        resultMutex_.unlock();
+
+        // Wake the handler if it is waiting on the image queue 
+        if (isNext)
+        {
+            pluginImageQueuePtr_ -> acquireLock();
+            pluginImageQueuePtr_ -> signalNotEmpty();
+            pluginImageQueuePtr_ -> releaseLock();
         }
-        return currentImage;
     }
 
+
     void PluginHandler::setReadyState()
     {
         if ((pluginImageQueuePtr_ != NULL) && (!pluginPtr_.isNull()))
@@ -105,8 +162,6 @@ namespace bias
 
     void PluginHandler::run()
     {
-        bool done = false;
-
         if (!ready_) 
         { 
             return; 
@@ -120,6 +175,22 @@ namespace bias
         stopped_ = false;
         releaseLock();
 
+        if (pluginPtr_ -> isReentrant())
+        {
+            runConcurrent();
+        }
+        else
+        {
+            runSerial();
+        }
+
+    } // PlugingHandler::run()
+
+
+    void PluginHandler::runSerial()
+    {
+        bool done = false;
+
         while (!done)
         {
             QList<StampedImage> frameList;
@@ -154,7 +225,110 @@ namespace bias
 
         // Plugin clean up actions
         //std::cout << "plugin: clean up" << std::endl;
+    }
 
-    } // PlugingHandler::run()
+
+    void PluginHandler::runConcurrent()
+    {
+        bool done = false;
+        BiasPlugin *pluginPtr = pluginPtr_;
+        unsigned long maxInFlight = pluginPtr -> maxInFlight();
+
+        // Worker threads aren't given camera affinity - they are meant to 
+        // spread across cores.
+        QThreadPool workerPool;
+        int numWorkers = std::min(int(maxInFlight), std::max(QThread::idealThreadCount(),1));
+        workerPool.setMaxThreadCount(numWorkers);
+
+        resultMutex_.lock();
+        resultMap_.clear();
+        nextSubmitIndex_ = 0;
+        nextDeliverIndex_ = 0;
+        resultMutex_.unlock();
+
+        while (!done)
+        {
+            QList<StampedImage> frameList;
+
+            // Grab frames from image queue - also woken by in order results
+            pluginImageQueuePtr_ -> acquireLock();
+            if (!isNextResultReady())
+            {
+                pluginImageQueuePtr_ -> waitIfEmpty();
+            }
+            while ( !(pluginImageQueuePtr_ ->  empty()) )
+            {
+                frameList.append(pluginImageQueuePtr_ -> front());
+                pluginImageQueuePtr_ -> pop();
+            }
+            pluginImageQueuePtr_ -> releaseLock();
+
+            for (StampedImage &stampedImage : frameList)
+            {
+                // Frames in flight include finished frames waiting on an 
+                // earlier one - block until the oldest is delivered.
+                while ((nextSubmitIndex_ - nextDeliverIndex_) >= maxInFlight)
+                {
+                    deliverFrameResults(true);
+                }
+                PluginFrameTask *taskPtr = new PluginFrameTask(
+                        this, 
+                        pluginPtr, 
+                        nextSubmitIndex_, 
+                        stampedImage
+                        );
+                nextSubmitIndex_++;
+                workerPool.start(taskPtr);
+            }
+            deliverFrameResults(false);
+
+            acquireLock();
+            done = stopped_;
+            releaseLock();
+
+        } // while (!done)
+
+        workerPool.waitForDone();
+        deliverFrameResults(false);
+    }
+
+
+    bool PluginHandler::isNextResultReady()
+    {
+        resultMutex_.lock();
+        bool isReady = (resultMap_.count(nextDeliverIndex_) > 0);
+        resultMutex_.unlock();
+        return isReady;
+    }
+
+
+    bool PluginHandler::deliverFrameResults(bool wait)
+    {
+        QList<PluginFrameResult> resultList;
+
+        resultMutex_.lock();
+        if (wait)
+        {
+            while (resultMap_.count(nextDeliverIndex_) == 0)
+            {
+                resultWaitCond_.wait(&resultMutex_);
+            }
+        }
+        auto it = resultMap_.begin();
+        while ((it != resultMap_.end()) && (it -> first == nextDeliverIndex_))
+        {
+            resultList.append(it -> second);
+            it = resultMap_.erase(it);
+            nextDeliverIndex_++;
+        }
+        resultMutex_.unlock();
+
+        // Plugin sees results on this thread only and in frame order
+        if (!resultList.isEmpty())
+        {
+            pluginPtr_ -> processFrameResults(resultList);
+        }
+        return !resultList.isEmpty();
+    }
 
 } // namespace bias;
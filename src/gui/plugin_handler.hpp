@@ -1,7 +1,9 @@
 #ifndef BIAS_PLUGIN_HANDLER_HPP 
 #define BIAS_PLUGIN_HANDLER_HPP
 #include <memory>
+#include <map>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QObject>
 #include <QRunnable>
 #include <QPointer>
@@ -47,7 +49,10 @@ namespace bias
             void setCameraNumber(unsigned int cameraNumber);
             void setImageQueue(std::shared_ptr<LockableQueue<StampedImage>> pluginImageQueuePtr);
             void setPlugin(BiasPlugin *pluginPtr);
-            cv::Mat getImage() const;
+            PluginPreview getPreview(QSize maxSize) const;
+
+            // Called by worker tasks when a reentrant plugin finishes a frame
+            void addFrameResult(unsigned long index, PluginFrameResult result);
 
         signals:
             void pluginError(unsigned int errorId, QString errorMsg);
@@ -59,7 +64,19 @@ namespace bias
             QPointer<BiasPlugin> pluginPtr_;
             std::shared_ptr<LockableQueue<StampedImage>> pluginImageQueuePtr_;
 
+            // Reentrant plugins - frames are processed on a worker pool and
+            // reordered by index before being delivered to the plugin.
+            QMutex resultMutex_;
+            QWaitCondition resultWaitCond_;
+            std::map<unsigned long, PluginFrameResult> resultMap_;
+            unsigned long nextSubmitIndex_;
+            unsigned long nextDeliverIndex_;
+
             void run();
+            void runSerial();
+            void runConcurrent();
+            bool isNextResultReady();
+            bool deliverFrameResults(bool wait);
             void setReadyState();
 
 
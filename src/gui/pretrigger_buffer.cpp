@@ -0,0 +1,203 @@
+#include "pretrigger_buffer.hpp"
+#include <algorithm>
+
+namespace bias
+{
+    // Constants
+    // ------------------------------------------------------------------------
+    const bool PretriggerBuffer::DEFAULT_PRETRIGGER_FLAG = false;
+    const double PretriggerBuffer::DEFAULT_PRE_SECONDS = 2.0;
+    const double PretriggerBuffer::DEFAULT_POST_SECONDS = 2.0;
+    const unsigned long PretriggerBuffer::DEFAULT_MAX_MEGABYTES = 512;
+
+
+    // Public methods
+    // ------------------------------------------------------------------------
+    PretriggerBuffer::PretriggerBuffer()
+    {
+        clear();
+    }
+
+
+    PretriggerBuffer::PretriggerBuffer(VideoWriterParams_pretrigger params) 
+        : PretriggerBuffer()
+    {
+        setParams(params);
+    }
+
+
+    void PretriggerBuffer::setParams(VideoWriterParams_pretrigger params)
+    {
+        params_ = params;
+        params_.preSeconds = std::max(params_.preSeconds, 0.0);
+        params_.postSeconds = std::max(params_.postSeconds, 0.0);
+        evictFrames();
+    }
+
+
+    VideoWriterParams_pretrigger PretriggerBuffer::getParams() const
+    {
+        return params_;
+    }
+
+
+    void PretriggerBuffer::clear()
+    {
+        FrameGate::clear();
+        ringBuffer_.clear();
+        ringBytes_ = 0;
+        triggerPending_ = false;
+        haveTriggerTimeStamp_ = false;
+        triggerTimeStamp_ = 0.0;
+        recording_ = false;
+        postEndTimeStamp_ = 0.0;
+        numberOfTriggers_ = 0;
+        numberEvicted_ = 0;
+    }
+
+
+    void PretriggerBuffer::addFrame(
+            StampedImage stampedImg, 
+            std::vector<StampedImage> &releaseVec
+            )
+    {
+        if (!params_.pretriggerFlag)
+        {
+            releaseVec.push_back(stampedImg);
+            return;
+        }
+
+        if (triggerPending_)
+        {
+            // Host side triggers (http commands) have no camera time stamp - 
+            // use the first frame which arrives after the trigger.
+            double timeStamp = haveTriggerTimeStamp_ ? triggerTimeStamp_ : stampedImg.timeStamp;
+            startRecording(timeStamp, releaseVec);
+        }
+
+        if (recording_)
+        {
+            if (stampedImg.timeStamp <= postEndTimeStamp_)
+            {
+                release(stampedImg, releaseVec);
+                return;
+            }
+            recording_ = false;
+        }
+
+        ringBuffer_.push_back(stampedImg);
+        ringBytes_ += getFrameBytes(stampedImg);
+        evictFrames();
+    }
+
+
+    void PretriggerBuffer::trigger()
+    {
+        triggerPending_ = true;
+        haveTriggerTimeStamp_ = false;
+    }
+
+
+    void PretriggerBuffer::trigger(double timeStamp)
+    {
+        triggerPending_ = true;
+        haveTriggerTimeStamp_ = true;
+        triggerTimeStamp_ = timeStamp;
+    }
+
+
+    bool PretriggerBuffer::isEnabled() const
+    {
+        return params_.pretriggerFlag;
+    }
+
+
+    bool PretriggerBuffer::isRecording() const
+    {
+        return recording_ || triggerPending_;
+    }
+
+
+    unsigned long PretriggerBuffer::numberOfFrames() const
+    {
+        return (unsigned long)(ringBuffer_.size());
+    }
+
+
+    unsigned long long PretriggerBuffer::numberOfBytes() const
+    {
+        return ringBytes_;
+    }
+
+
+    unsigned long PretriggerBuffer::numberOfTriggers() const
+    {
+        return numberOfTriggers_;
+    }
+
+
+    unsigned long PretriggerBuffer::numberEvicted() const
+    {
+        return numberEvicted_;
+    }
+
+
+    // Private methods
+    // ------------------------------------------------------------------------
+    void PretriggerBuffer::startRecording(
+            double timeStamp, 
+            std::vector<StampedImage> &releaseVec
+            )
+    {
+        double postEndTimeStamp = timeStamp + params_.postSeconds;
+        if (recording_)
+        {
+            // Retrigger - ring is empty while recording, just extend the window
+            postEndTimeStamp_ = std::max(postEndTimeStamp_, postEndTimeStamp);
+        }
+        else
+        {
+            double preBegTimeStamp = timeStamp - params_.preSeconds;
+            for (StampedImage &bufferedImg : ringBuffer_)
+            {
+                if (bufferedImg.timeStamp >= preBegTimeStamp)
+                {
+                    release(bufferedImg, releaseVec);
+                }
+            }
+            ringBuffer_.clear();
+            ringBytes_ = 0;
+            postEndTimeStamp_ = postEndTimeStamp;
+            recording_ = true;
+        }
+        triggerPending_ = false;
+        haveTriggerTimeStamp_ = false;
+        numberOfTriggers_++;
+    }
+
+
+    void PretriggerBuffer::evictFrames()
+    {
+        // Always keep the newest frame so that a trigger arriving with 
+        // preSeconds = 0 still records the frame on which it fired.
+        unsigned long long maxBytes = (unsigned long long)(params_.maxMegaBytes)*1024ull*1024ull;
+        while (ringBuffer_.size() > 1)
+        {
+            double bufferSeconds = ringBuffer_.back().timeStamp - ringBuffer_.front().timeStamp;
+            if ((bufferSeconds <= params_.preSeconds) && (ringBytes_ <= maxBytes))
+            {
+                break;
+            }
+            ringBytes_ -= std::min(ringBytes_, getFrameBytes(ringBuffer_.front()));
+            ringBuffer_.pop_front();
+            numberEvicted_++;
+        }
+    }
+
+
+    unsigned long long PretriggerBuffer::getFrameBytes(const StampedImage &stampedImg)
+    {
+        return (unsigned long long)(stampedImg.image.total()*stampedImg.image.elemSize());
+    }
+
+} // namespace bias
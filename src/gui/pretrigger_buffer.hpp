@@ -0,0 +1,76 @@
+#ifndef BIAS_PRETRIGGER_BUFFER_HPP
+#define BIAS_PRETRIGGER_BUFFER_HPP
+#include "frame_gate.hpp"
+#include "video_writer_params.hpp"
+#include <deque>
+#include <vector>
+
+namespace bias
+{
+
+    class PretriggerBuffer : public FrameGate
+    {
+        // In-memory ring of the most recent frames used for event triggered
+        // logging. While idle the buffer holds at most preSeconds of frames
+        // and at most maxMegaBytes of image data (oldest frames are evicted
+        // first). When a trigger arrives the buffered pre-trigger window is 
+        // released followed by all frames up to postSeconds after the 
+        // trigger.  Released frames are handed back to the caller (the image 
+        // logger) which passes them on to the video writer so that any 
+        // VideoWriter can be used for output.  Repeated triggers during the
+        // post-trigger window extend it. Released frames are numbered 
+        // contiguously across triggers (see FrameGate), the time stamps 
+        // identify the camera frames.
+
+        public:
+
+            static const bool DEFAULT_PRETRIGGER_FLAG;
+            static const double DEFAULT_PRE_SECONDS;
+            static const double DEFAULT_POST_SECONDS;
+            static const unsigned long DEFAULT_MAX_MEGABYTES;
+
+            PretriggerBuffer();
+            explicit PretriggerBuffer(VideoWriterParams_pretrigger params);
+
+            // Use lock when calling these methods
+            // ----------------------------------
+            void setParams(VideoWriterParams_pretrigger params);
+            VideoWriterParams_pretrigger getParams() const;
+            virtual void clear();
+            virtual bool isEnabled() const;
+            virtual void addFrame(StampedImage stampedImg, std::vector<StampedImage> &releaseVec);
+
+            void trigger();
+            void trigger(double timeStamp);
+
+            bool isRecording() const;
+            unsigned long numberOfFrames() const;
+            unsigned long long numberOfBytes() const;
+            unsigned long numberOfTriggers() const;
+            unsigned long numberEvicted() const;
+            // ----------------------------------
+
+        private:
+
+            VideoWriterParams_pretrigger params_;
+            std::deque<StampedImage> ringBuffer_;
+            unsigned long long ringBytes_;
+
+            bool triggerPending_;
+            bool haveTriggerTimeStamp_;
+            double triggerTimeStamp_;
+            bool recording_;
+            double postEndTimeStamp_;
+
+            unsigned long numberOfTriggers_;
+            unsigned long numberEvicted_;
+
+            void startRecording(double timeStamp, std::vector<StampedImage> &releaseVec);
+            void evictFrames();
+            static unsigned long long getFrameBytes(const StampedImage &stampedImg);
+
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_PRETRIGGER_BUFFER_HPP
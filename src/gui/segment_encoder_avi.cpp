@@ -0,0 +1,139 @@
+#include "segment_encoder_avi.hpp"
+#include "basic_types.hpp"
+#include "affinity.hpp"
+#include <QMutex>
+#include <QThread>
+#include <iostream>
+
+namespace bias
+{
+
+    SegmentEncoder_avi::SegmentEncoder_avi(QObject *parent) : QObject(parent)
+    {
+        ready_ = false;
+        fourcc_ = 0;
+        fps_ = 0.0;
+        isColor_ = false;
+        cameraNumber_ = 0;
+        openMutexPtr_ = nullptr;
+    }
+
+
+    SegmentEncoder_avi::SegmentEncoder_avi(
+            QString fileName,
+            int fourcc,
+            double fps,
+            cv::Size size,
+            bool isColor,
+            SegmentFrameQueuePtr_avi framesQueuePtr,
+            FrameDrainPtr frameDrainPtr,
+            QMutex *openMutexPtr,
+            unsigned int cameraNumber,
+            QObject *parent
+            ) : QObject(parent)
+    {
+        fileName_ = fileName;
+        fourcc_ = fourcc;
+        fps_ = fps;
+        size_ = size;
+        isColor_ = isColor;
+        framesQueuePtr_ = framesQueuePtr;
+        frameDrainPtr_ = frameDrainPtr;
+        openMutexPtr_ = openMutexPtr;
+        cameraNumber_ = cameraNumber;
+        ready_ = (framesQueuePtr_ != nullptr) && (frameDrainPtr_ != nullptr) && (openMutexPtr_ != nullptr);
+    }
+
+
+    bool SegmentEncoder_avi::openVideoWriter(cv::VideoWriter &videoWriter)
+    {
+        // Opening (and releasing) cv::VideoWriters is not thread safe 
+        bool openOK = false;
+        QString errorDetail("returned false");
+
+        openMutexPtr_ -> lock();
+        try
+        {
+            openOK = videoWriter.open(fileName_.toStdString(), fourcc_, fps_, size_, isColor_);
+            openOK = openOK && videoWriter.isOpened();
+        }
+        catch (cv::Exception &e)
+        {
+            openOK = false;
+            errorDetail = QString::fromStdString(e.what());
+        }
+        openMutexPtr_ -> unlock();
+
+        if (!openOK)
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            QString errorMsg = QString("video writer unable to open avi segment %1:\n\n").arg(fileName_);
+            errorMsg += errorDetail;
+            emit imageLoggingError(errorId, errorMsg);
+        }
+        return openOK;
+    }
+
+
+    void SegmentEncoder_avi::run()
+    {
+        if (!ready_)
+        {
+            return;
+        }
+
+        QThread *thisThread = QThread::currentThread();
+        thisThread -> setPriority(QThread::NormalPriority);
+        ThreadAffinityService::assignThreadAffinity(false,cameraNumber_);
+
+        cv::VideoWriter videoWriter;
+        bool isOpen = openVideoWriter(videoWriter);
+
+        bool done = false;
+        StampedImage stampedImg;
+
+        while (!done)
+        {
+            bool haveNewFrame = false;
+
+            framesQueuePtr_ -> acquireLock();
+            if (!(framesQueuePtr_ -> isClosed()))
+            {
+                framesQueuePtr_ -> waitIfEmpty();
+            }
+            if (!(framesQueuePtr_ -> empty()))
+            {
+                stampedImg = framesQueuePtr_ -> front();
+                framesQueuePtr_ -> pop();
+                haveNewFrame = true;
+            }
+            else
+            {
+                done = framesQueuePtr_ -> isClosed();
+            }
+            framesQueuePtr_ -> releaseLock();
+
+            if (haveNewFrame)
+            {
+                if (isOpen)
+                {
+                    videoWriter << stampedImg.image;
+                    frameDrainPtr_ -> frameDone();
+                }
+                else
+                {
+                    frameDrainPtr_ -> frameDropped();
+                }
+                stampedImg.image.release();
+            }
+        }
+
+        if (isOpen)
+        {
+            openMutexPtr_ -> lock();
+            videoWriter.release();
+            openMutexPtr_ -> unlock();
+        }
+    }
+
+} // namespace bias
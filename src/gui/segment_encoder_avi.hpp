@@ -0,0 +1,84 @@
+#ifndef BIAS_SEGMENT_ENCODER_AVI_HPP
+#define BIAS_SEGMENT_ENCODER_AVI_HPP
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <memory>
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include "lockable.hpp"
+#include "stamped_image.hpp"
+#include "frame_drain.hpp"
+
+class QMutex;
+
+namespace bias
+{
+
+    class SegmentFrameQueue_avi : public LockableQueue<StampedImage>
+    {
+        // Frames for one avi segment. Closed by the video writer once the
+        // segment is full - the encoder exits when it is closed and empty.
+
+        public:
+
+            SegmentFrameQueue_avi() : LockableQueue<StampedImage>(), closed_(false) {};
+
+            bool isClosed() const { return closed_; }
+            void close() { closed_ = true; }
+
+        protected:
+            bool closed_;
+    };
+
+    typedef std::shared_ptr<SegmentFrameQueue_avi> SegmentFrameQueuePtr_avi;
+
+
+    class SegmentEncoder_avi : public QObject, public QRunnable
+    {
+        // Encodes one fixed length segment of an avi stream with its own 
+        // cv::VideoWriter. Several encoders run concurrently, each on a 
+        // different segment file.
+
+        Q_OBJECT
+
+        public:
+
+            SegmentEncoder_avi(QObject *parent=0);
+            SegmentEncoder_avi(
+                    QString fileName,
+                    int fourcc,
+                    double fps,
+                    cv::Size size,
+                    bool isColor,
+                    SegmentFrameQueuePtr_avi framesQueuePtr,
+                    FrameDrainPtr frameDrainPtr,
+                    QMutex *openMutexPtr,
+                    unsigned int cameraNumber,
+                    QObject *parent=0
+                    );
+
+        signals:
+            void imageLoggingError(unsigned int errorId, QString errorMsg);
+
+        private:
+
+            bool ready_;
+            QString fileName_;
+            int fourcc_;
+            double fps_;
+            cv::Size size_;
+            bool isColor_;
+            unsigned int cameraNumber_;
+            QMutex *openMutexPtr_;
+
+            SegmentFrameQueuePtr_avi framesQueuePtr_;
+            FrameDrainPtr frameDrainPtr_;
+
+            bool openVideoWriter(cv::VideoWriter &videoWriter);
+            void run();
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_SEGMENT_ENCODER_AVI_HPP
@@ -0,0 +1,319 @@
+#include "slice_encoder_jpg.hpp"
+#include "basic_types.hpp"
+#include "exception.hpp"
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace bias
+{
+    // Constants
+    // -------------------------------------------------------------------------------------------------------
+    const unsigned int SliceEncoder_jpg::DEFAULT_NUMBER_OF_SLICES = 1;
+    const unsigned int SliceEncoder_jpg::MIN_NUMBER_OF_SLICES = 1;
+    const unsigned int SliceEncoder_jpg::MAX_NUMBER_OF_SLICES = 64;
+
+    // Slice heights must be a multiple of the MCU height (8 or 16 rows)
+    const int SliceEncoder_jpg::SLICE_ROW_ALIGNMENT = 16;
+
+    // Below this slice height splitting costs more than it saves
+    const int MIN_SLICE_ROWS = 256;
+
+    // Jpeg markers
+    const uchar MARKER_PREFIX = 0xFF;
+    const uchar MARKER_SOF0 = 0xC0;
+    const uchar MARKER_SOF1 = 0xC1;
+    const uchar MARKER_SOS = 0xDA;
+    const uchar MARKER_DRI = 0xDD;
+    const uchar MARKER_RST0 = 0xD0;
+    const uchar MARKER_EOI = 0xD9;
+
+
+    // Helper functions
+    // -------------------------------------------------------------------------------------------------------
+    struct JpgLayout
+    {
+        size_t sofPos;      // start of SOF marker
+        size_t sosPos;      // start of SOS marker
+        size_t dataPos;     // start of entropy coded data
+        size_t dataEnd;     // end of entropy coded data (EOI position)
+        int mcuWidth;
+        int mcuHeight;
+    };
+
+
+    unsigned int readUInt16BE(const std::vector<uchar> &buffer, size_t pos)
+    {
+        return (unsigned int)(buffer[pos] << 8) | (unsigned int)(buffer[pos+1]);
+    }
+
+
+    bool parseJpgLayout(const std::vector<uchar> &buffer, JpgLayout &layout)
+    {
+        // Walk marker segments from SOI until the start of scan
+        size_t pos = 2;
+        bool haveSof = false;
+        while (pos + 4 <= buffer.size())
+        {
+            if (buffer[pos] != MARKER_PREFIX)
+            {
+                return false;
+            }
+            uchar marker = buffer[pos+1];
+            size_t segLen = readUInt16BE(buffer, pos+2);
+
+            if ((marker == MARKER_SOF0) || (marker == MARKER_SOF1))
+            {
+                layout.sofPos = pos;
+                int numComp = buffer[pos+9];
+                int maxH = 1;
+                int maxV = 1;
+                for (int i=0; i<numComp; i++)
+                {
+                    uchar sampling = buffer[pos + 10 + 3*i + 1];
+                    maxH = std::max(maxH, int(sampling >> 4));
+                    maxV = std::max(maxV, int(sampling & 0x0F));
+                }
+                layout.mcuWidth = 8*maxH;
+                layout.mcuHeight = 8*maxV;
+                haveSof = true;
+            }
+            else if (marker == MARKER_DRI)
+            {
+                // Slices must not contain their own restart markers
+                return false;
+            }
+            else if (marker == MARKER_SOS)
+            {
+                layout.sosPos = pos;
+                layout.dataPos = pos + 2 + segLen;
+                break;
+            }
+            pos += 2 + segLen;
+        }
+
+        size_t size = buffer.size();
+        bool haveEoi = (size >= 2) && (buffer[size-2] == MARKER_PREFIX) && (buffer[size-1] == MARKER_EOI);
+        if (!haveSof || !haveEoi || (layout.dataPos == 0) || (layout.dataPos > size-2))
+        {
+            return false;
+        }
+        layout.dataEnd = size-2;
+        return true;
+    }
+
+
+    // Public methods
+    // -------------------------------------------------------------------------------------------------------
+    SliceEncoder_jpg::SliceEncoder_jpg() : SliceEncoder_jpg(DEFAULT_NUMBER_OF_SLICES) 
+    {}
+
+
+    SliceEncoder_jpg::SliceEncoder_jpg(unsigned int numberOfSlices)
+    {
+        quality_ = 0;
+        setNumberOfSlices(numberOfSlices);
+        setQuality(90);
+    }
+
+
+    void SliceEncoder_jpg::setNumberOfSlices(unsigned int numberOfSlices)
+    {
+        numberOfSlices_ = std::min(std::max(numberOfSlices, MIN_NUMBER_OF_SLICES), MAX_NUMBER_OF_SLICES);
+        sliceBufferVec_.resize(numberOfSlices_);
+    }
+
+
+    unsigned int SliceEncoder_jpg::getNumberOfSlices() const
+    {
+        return numberOfSlices_;
+    }
+
+
+    void SliceEncoder_jpg::encode(const cv::Mat &image, unsigned int quality, std::vector<uchar> &jpgBuffer)
+    {
+        setQuality(quality);
+        const cv::Mat &encImage = prepareImage(image);
+        if (!encodeSlices(encImage, jpgBuffer))
+        {
+            encodeSingle(encImage, jpgBuffer);
+        }
+    }
+
+
+    void SliceEncoder_jpg::write(const cv::Mat &image, unsigned int quality, std::string fileName)
+    {
+        // Output buffer is reused between files
+        encode(image, quality, jpgBuffer_);
+        const std::vector<uchar> &encBuffer = jpgBuffer_;
+        std::ofstream file(fileName, std::ios::out | std::ios::binary);
+        if (!file.is_open())
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+            std::string errorMsg("writing jpg frame failed - unable to open ");
+            errorMsg += fileName;
+            throw RuntimeError(errorId, errorMsg);
+        }
+        file.write((const char *) &encBuffer[0], encBuffer.size());
+    }
+
+
+    // Protected methods
+    // -------------------------------------------------------------------------------------------------------
+    const cv::Mat &SliceEncoder_jpg::prepareImage(const cv::Mat &image)
+    {
+        // Grayscale and BGR 8 bit images are encoded directly. Everything else 
+        // is converted into a reused buffer. Other depths are saturated to 8 
+        // bits without scaling, the same as cv::imencode does for jpeg.
+        if (image.depth() != CV_8U)
+        {
+            image.convertTo(convertMat_, CV_8U);
+            if (convertMat_.channels() == 4)
+            {
+                cv::cvtColor(convertMat_, convertMat_, cv::COLOR_BGRA2BGR);
+            }
+            return convertMat_;
+        }
+        if (image.channels() == 4)
+        {
+            cv::cvtColor(image, convertMat_, cv::COLOR_BGRA2BGR);
+            return convertMat_;
+        }
+        return image;
+    }
+
+
+    void SliceEncoder_jpg::setQuality(unsigned int quality)
+    {
+        quality = std::min(quality, 100u);
+        if ((quality == quality_) && (!params_.empty()))
+        {
+            return;
+        }
+        quality_ = quality;
+        params_.clear();
+        params_.push_back(cv::IMWRITE_JPEG_QUALITY);
+        params_.push_back(int(quality_));
+        params_.push_back(cv::IMWRITE_JPEG_OPTIMIZE);
+        params_.push_back(0);
+    }
+
+
+    void SliceEncoder_jpg::reserveBuffer(std::vector<uchar> &buffer, const cv::Mat &image)
+    {
+        // Worst case: jpeg output is bounded by roughly the raw image size 
+        // plus headers, reserving this keeps imencode from reallocating.
+        size_t worstCase = image.total()*image.elemSize() + 2048;
+        if (buffer.capacity() < worstCase)
+        {
+            buffer.reserve(worstCase);
+        }
+    }
+
+
+    void SliceEncoder_jpg::encodeSingle(const cv::Mat &image, std::vector<uchar> &jpgBuffer)
+    {
+        reserveBuffer(jpgBuffer, image);
+        cv::imencode(".jpg", image, jpgBuffer, params_);
+    }
+
+
+    bool SliceEncoder_jpg::encodeSlices(const cv::Mat &image, std::vector<uchar> &jpgBuffer)
+    {
+        if (numberOfSlices_ <= 1)
+        {
+            return false;
+        }
+
+        // Slice height - multiple of the largest possible MCU height
+        int sliceRows = (image.rows + int(numberOfSlices_) - 1)/int(numberOfSlices_);
+        sliceRows = ((sliceRows + SLICE_ROW_ALIGNMENT - 1)/SLICE_ROW_ALIGNMENT)*SLICE_ROW_ALIGNMENT;
+        if (sliceRows < MIN_SLICE_ROWS)
+        {
+            return false;
+        }
+        int numSlices = (image.rows + sliceRows - 1)/sliceRows;
+        if (numSlices <= 1)
+        {
+            return false;
+        }
+
+        // Encode slices in parallel 
+        cv::parallel_for_(cv::Range(0, numSlices), [&](const cv::Range &range)
+        {
+            for (int i=range.start; i<range.end; i++)
+            {
+                int rowBeg = i*sliceRows;
+                int rowEnd = std::min(rowBeg + sliceRows, image.rows);
+                cv::Mat sliceImage = image.rowRange(rowBeg, rowEnd);
+                reserveBuffer(sliceBufferVec_[i], sliceImage);
+                cv::imencode(".jpg", sliceImage, sliceBufferVec_[i], params_);
+            }
+        });
+
+        // Parse slice layouts 
+        std::vector<JpgLayout> layoutVec(numSlices);
+        for (int i=0; i<numSlices; i++)
+        {
+            layoutVec[i] = JpgLayout();
+            if (!parseJpgLayout(sliceBufferVec_[i], layoutVec[i]))
+            {
+                return false;
+            }
+        }
+
+        // One restart interval per slice 
+        JpgLayout &layout0 = layoutVec[0];
+        if (sliceRows%layout0.mcuHeight != 0)
+        {
+            return false;
+        }
+        unsigned long mcuCols = (image.cols + layout0.mcuWidth - 1)/layout0.mcuWidth;
+        unsigned long restartInterval = mcuCols*(sliceRows/layout0.mcuHeight);
+        if (restartInterval > 0xFFFF)
+        {
+            return false;
+        }
+
+        // Assemble: headers of first slice (with full image height) + DRI + 
+        // scan header + slice data separated by RSTn markers + EOI
+        const std::vector<uchar> &buf0 = sliceBufferVec_[0];
+        size_t totalSize = layout0.dataPos + 6 + 2;
+        for (int i=0; i<numSlices; i++)
+        {
+            totalSize += layoutVec[i].dataEnd - layoutVec[i].dataPos + 2;
+        }
+        jpgBuffer.clear();
+        jpgBuffer.reserve(totalSize);
+
+        jpgBuffer.insert(jpgBuffer.end(), buf0.begin(), buf0.begin() + layout0.sosPos);
+        size_t heightPos = layout0.sofPos + 5;
+        jpgBuffer[heightPos] = uchar((image.rows >> 8) & 0xFF);
+        jpgBuffer[heightPos+1] = uchar(image.rows & 0xFF);
+
+        uchar dri[6] = {
+            MARKER_PREFIX, MARKER_DRI, 0x00, 0x04, 
+            uchar((restartInterval >> 8) & 0xFF), uchar(restartInterval & 0xFF)
+        };
+        jpgBuffer.insert(jpgBuffer.end(), dri, dri+6);
+        jpgBuffer.insert(jpgBuffer.end(), buf0.begin() + layout0.sosPos, buf0.begin() + layout0.dataPos);
+
+        for (int i=0; i<numSlices; i++)
+        {
+            if (i > 0)
+            {
+                jpgBuffer.push_back(MARKER_PREFIX);
+                jpgBuffer.push_back(uchar(MARKER_RST0 + ((i-1)%8)));
+            }
+            const std::vector<uchar> &buf = sliceBufferVec_[i];
+            jpgBuffer.insert(jpgBuffer.end(), buf.begin() + layoutVec[i].dataPos, buf.begin() + layoutVec[i].dataEnd);
+        }
+        jpgBuffer.push_back(MARKER_PREFIX);
+        jpgBuffer.push_back(MARKER_EOI);
+        return true;
+    }
+
+} // namespace bias
@@ -0,0 +1,58 @@
+#ifndef BIAS_SLICE_ENCODER_JPG_HPP
+#define BIAS_SLICE_ENCODER_JPG_HPP
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include <string>
+
+namespace bias
+{
+
+    class SliceEncoder_jpg
+    {
+        // Jpeg encoding via cv::imencode, one per compressor thread. Only the
+        // encoding parameters and the slice and conversion buffers are kept 
+        // between frames - imencode sets up a new libjpeg compressor on every
+        // call. The encoded frame is written straight into the caller's buffer.
+        //
+        // Optionally large frames are split into horizontal slices which are 
+        // encoded in parallel on OpenCV's thread pool and joined into a single
+        // baseline jpeg using restart markers (one restart interval per slice).
+        // The caller should keep compressors x slices within the core count.
+
+        public:
+
+            SliceEncoder_jpg();
+            SliceEncoder_jpg(unsigned int numberOfSlices);
+
+            void setNumberOfSlices(unsigned int numberOfSlices);
+            unsigned int getNumberOfSlices() const;
+
+            // Encodes image into jpgBuffer (replacing its contents) 
+            void encode(const cv::Mat &image, unsigned int quality, std::vector<uchar> &jpgBuffer);
+            void write(const cv::Mat &image, unsigned int quality, std::string fileName);
+
+            static const unsigned int DEFAULT_NUMBER_OF_SLICES;
+            static const unsigned int MIN_NUMBER_OF_SLICES;
+            static const unsigned int MAX_NUMBER_OF_SLICES;
+            static const int SLICE_ROW_ALIGNMENT;
+
+        protected:
+
+            unsigned int numberOfSlices_;
+            unsigned int quality_;
+            std::vector<int> params_;
+
+            cv::Mat convertMat_;
+            std::vector<uchar> jpgBuffer_;
+            std::vector<std::vector<uchar>> sliceBufferVec_;
+
+            const cv::Mat &prepareImage(const cv::Mat &image);
+            void setQuality(unsigned int quality);
+            void reserveBuffer(std::vector<uchar> &buffer, const cv::Mat &image);
+            void encodeSingle(const cv::Mat &image, std::vector<uchar> &jpgBuffer);
+            bool encodeSlices(const cv::Mat &image, std::vector<uchar> &jpgBuffer);
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_SLICE_ENCODER_JPG_HPP
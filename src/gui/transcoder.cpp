@@ -0,0 +1,399 @@
+#include "transcoder.hpp"
+#include "video_writer.hpp"
+#include "video_writer_factory.hpp"
+#include "video_reader.hpp"
+#include "video_reader_image.hpp"
+#include "exception.hpp"
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <opencv2/imgproc/imgproc.hpp>
+
+namespace bias
+{
+    // Constants
+    // -------------------------------------------------------------------------------------------------------
+    const unsigned long Transcoder::DEFAULT_MAX_PENDING = 100;
+    const int Transcoder::PROGRESS_INTERVAL = 1000;    // msec
+
+    const unsigned long WRITER_WAIT_INTERVAL = 200;    // usec
+
+
+    // TranscoderParams
+    // -------------------------------------------------------------------------------------------------------
+    TranscoderParams::TranscoderParams()
+    {
+        videoFileFormat = VIDEOFILE_FORMAT_UFMF;
+        outputDir = QDir::currentPath();
+        numberOfJobs = 1;
+        maxPending = Transcoder::DEFAULT_MAX_PENDING;
+        frameRate = 1.0/VideoReader::DEFAULT_DT_ESTIMATE;
+        overwrite = false;
+    }
+
+
+    std::string TranscoderParams::toString()
+    {
+        std::stringstream ss;
+        ss << "format: " << getVideoFileExtensionMap()[videoFileFormat].toStdString() << std::endl;
+        ss << "outputDir: " << outputDir.toStdString() << std::endl;
+        ss << "numberOfJobs: " << numberOfJobs << std::endl;
+        ss << "maxPending: " << maxPending << std::endl;
+        ss << "frameRate: " << frameRate << std::endl;
+        ss << "overwrite: " << std::boolalpha << overwrite << std::noboolalpha << std::endl;
+        return ss.str();
+    }
+
+
+    // TranscodeResult
+    // -------------------------------------------------------------------------------------------------------
+    TranscodeResult::TranscodeResult()
+    {
+        success = false;
+        numberOfFrames = 0;
+        numberSkipped = 0;
+        numberDropped = 0;
+        elapsedTime = 0.0;
+    }
+
+
+    double TranscodeResult::framesPerSec() const
+    {
+        return (elapsedTime > 0.0) ? numberOfFrames/elapsedTime : 0.0;
+    }
+
+
+    std::string TranscodeResult::toString() const
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        ss << (success ? "ok     " : "FAILED ") << inputFileName.toStdString();
+        ss << " -> " << outputFileName.toStdString() << std::endl;
+        ss << "       " << numberOfFrames << " frames, " << elapsedTime << " s, ";
+        ss << framesPerSec() << " fps";
+        if ((numberSkipped > 0) || (numberDropped > 0))
+        {
+            ss << ", skipped " << numberSkipped << ", dropped " << numberDropped;
+        }
+        ss << std::endl;
+        for (int i=0; i<errorMessages.size(); i++)
+        {
+            ss << "       error: " << errorMessages[i].toStdString() << std::endl;
+        }
+        return ss.str();
+    }
+
+
+    // TranscodeJob
+    // -------------------------------------------------------------------------------------------------------
+    TranscodeJob::TranscodeJob(
+            QString inputFileName, 
+            QString outputFileName, 
+            TranscoderParams params, 
+            QObject *parent
+            ) : QObject(parent)
+    {
+        params_ = params;
+        stopped_ = false;
+        done_ = false;
+        numberOfFramesDone_ = 0;
+        numberOfFrames_ = 0;
+        result_.inputFileName = inputFileName;
+        result_.outputFileName = outputFileName;
+    }
+
+
+    void TranscodeJob::stop()
+    {
+        acquireLock();
+        stopped_ = true;
+        releaseLock();
+    }
+
+
+    unsigned long TranscodeJob::getNumberOfFramesDone()
+    {
+        acquireLock();
+        unsigned long number = numberOfFramesDone_;
+        releaseLock();
+        return number;
+    }
+
+
+    unsigned long TranscodeJob::getNumberOfFrames()
+    {
+        acquireLock();
+        unsigned long number = numberOfFrames_;
+        releaseLock();
+        return number;
+    }
+
+
+    bool TranscodeJob::isDone()
+    {
+        acquireLock();
+        bool done = done_;
+        releaseLock();
+        return done;
+    }
+
+
+    TranscodeResult TranscodeJob::getResult()
+    {
+        acquireLock();
+        TranscodeResult result = result_;
+        releaseLock();
+        return result;
+    }
+
+
+    void TranscodeJob::onImageLoggingError(unsigned int errorId, QString errorMsg)
+    {
+        acquireLock();
+        result_.errorMessages.append(QString("(%1) %2").arg(errorId).arg(errorMsg));
+        releaseLock();
+    }
+
+
+    void TranscodeJob::run()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        try
+        {
+            transcode();
+        }
+        catch (RuntimeError &runtimeError)
+        {
+            onImageLoggingError(runtimeError.id(), QString::fromStdString(runtimeError.what()));
+        }
+
+        acquireLock();
+        result_.elapsedTime = 1.0e-9*timer.nsecsElapsed();
+        result_.success = result_.errorMessages.isEmpty() && !stopped_;
+        done_ = true;
+        releaseLock();
+    }
+
+
+    void TranscodeJob::transcode()
+    {
+        VideoReaderPtr readerPtr = createVideoReader(result_.inputFileName);
+        std::shared_ptr<VideoReader_image> imageReaderPtr = std::dynamic_pointer_cast<VideoReader_image>(readerPtr);
+        if (imageReaderPtr)
+        {
+            imageReaderPtr -> setFrameRate(params_.frameRate);
+        }
+
+        acquireLock();
+        numberOfFrames_ = readerPtr -> getNumberOfFrames();
+        releaseLock();
+
+        std::shared_ptr<VideoWriter> videoWriterPtr = createVideoWriter(
+                params_.videoFileFormat,
+                params_.videoWriterParams,
+                result_.outputFileName,
+                0
+                );
+        videoWriterPtr -> setFileName(result_.outputFileName);
+        videoWriterPtr -> setVersioning(false);
+        connect(
+                videoWriterPtr.get(),
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                this,
+                SLOT(onImageLoggingError(unsigned int, QString)),
+                Qt::DirectConnection
+               );
+
+        bool convertToMono = requiresMono();
+        FrameDrainPtr frameDrainPtr = videoWriterPtr -> getFrameDrain();
+        unsigned long numberOfFramesRead = 0;
+        StampedImage stampedImage;
+
+        while (readerPtr -> readFrame(stampedImage))
+        {
+            if (convertToMono && (stampedImage.image.channels() == 3))
+            {
+                cv::cvtColor(stampedImage.image, stampedImage.image, cv::COLOR_BGR2GRAY);
+            }
+
+            // Hold back rather than let the writer skip frames 
+            waitForWriter(frameDrainPtr);
+            videoWriterPtr -> addFrame(stampedImage);
+            numberOfFramesRead++;
+
+            acquireLock();
+            numberOfFramesDone_ = numberOfFramesRead;
+            bool stopped = stopped_;
+            releaseLock();
+            if (stopped)
+            {
+                break;
+            }
+        }
+        videoWriterPtr -> finish();
+
+        acquireLock();
+        result_.numberOfFrames = numberOfFramesRead;
+        numberOfFrames_ = numberOfFramesRead;
+        if (frameDrainPtr)
+        {
+            result_.numberSkipped = frameDrainPtr -> numberSkipped();
+            result_.numberDropped = frameDrainPtr -> numberDropped();
+        }
+        if (result_.numberDropped > 0)
+        {
+            // Dropped frames leave gaps in the output - report the job as failed
+            QString errorMsg = QString("writer dropped %1 frames").arg(result_.numberDropped);
+            result_.errorMessages.append(errorMsg);
+        }
+        releaseLock();
+    }
+
+
+    void TranscodeJob::waitForWriter(FrameDrainPtr frameDrainPtr)
+    {
+        if (!frameDrainPtr)
+        {
+            return;
+        }
+        while (frameDrainPtr -> numberPending() >= params_.maxPending)
+        {
+            QThread::usleep(WRITER_WAIT_INTERVAL);
+        }
+    }
+
+
+    bool TranscodeJob::requiresMono()
+    {
+        switch (params_.videoFileFormat)
+        {
+            case VIDEOFILE_FORMAT_FMF:
+            case VIDEOFILE_FORMAT_UFMF:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+
+    // Transcoder
+    // -------------------------------------------------------------------------------------------------------
+    Transcoder::Transcoder(TranscoderParams params, QObject *parent) : QObject(parent)
+    {
+        params_ = params;
+        threadPoolPtr_ = new QThreadPool(this);
+        threadPoolPtr_ -> setMaxThreadCount(std::max(params_.numberOfJobs, 1u));
+    }
+
+
+    QString Transcoder::getOutputFileName(QString inputFileName)
+    {
+        // Image sequences are directories - name the output after the directory
+        QFileInfo inputInfo(inputFileName);
+        QString baseName = inputInfo.isDir() ? QDir(inputFileName).dirName() : inputInfo.completeBaseName();
+        if (params_.videoFileFormat != VIDEOFILE_FORMAT_BMP)
+        {
+            baseName += "." + getVideoFileExtensionMap()[params_.videoFileFormat];
+        }
+        return QDir(params_.outputDir).absoluteFilePath(baseName);
+    }
+
+
+    QList<TranscodeResult> Transcoder::run(QStringList inputFileNameList, bool verbose)
+    {
+        QList<TranscodeResult> resultList;
+        QStringList outputFileNameList;
+
+        jobPtrList_.clear();
+        for (int i=0; i<inputFileNameList.size(); i++)
+        {
+            QString inputFileName = inputFileNameList[i];
+            QString outputFileName = getOutputFileName(inputFileName);
+
+            bool isDuplicate = outputFileNameList.contains(outputFileName);
+            bool isExisting = QFileInfo(outputFileName).exists() && !params_.overwrite;
+            bool isSame = QFileInfo(outputFileName) == QFileInfo(inputFileName);
+            if (isDuplicate || isExisting || isSame)
+            {
+                TranscodeResult result;
+                result.inputFileName = inputFileName;
+                result.outputFileName = outputFileName;
+                if (isSame)
+                {
+                    result.errorMessages.append("output would overwrite the input");
+                }
+                else if (isDuplicate)
+                {
+                    result.errorMessages.append("output name used by another input");
+                }
+                else
+                {
+                    result.errorMessages.append("output exists, use overwrite to replace it");
+                }
+                resultList.append(result);
+                continue;
+            }
+            outputFileNameList.append(outputFileName);
+
+            TranscodeJob *jobPtr = new TranscodeJob(inputFileName, outputFileName, params_, this);
+            jobPtr -> setAutoDelete(false);
+            jobPtrList_.append(jobPtr);
+            threadPoolPtr_ -> start(jobPtr);
+        }
+
+        // Report progress while the jobs run
+        QElapsedTimer timer;
+        timer.start();
+        bool threadsDone = false;
+        while (!threadsDone)
+        {
+            threadsDone = threadPoolPtr_ -> waitForDone(PROGRESS_INTERVAL);
+            if (!verbose || threadsDone)
+            {
+                continue;
+            }
+            std::cout << std::fixed << std::setprecision(1) << "[" << 1.0e-3*timer.elapsed() << " s]";
+            for (int i=0; i<jobPtrList_.size(); i++)
+            {
+                TranscodeJob *jobPtr = jobPtrList_[i];
+                unsigned long numberOfFrames = jobPtr -> getNumberOfFrames();
+                unsigned long numberDone = jobPtr -> getNumberOfFramesDone();
+                if ((numberDone > 0) && !jobPtr -> isDone())
+                {
+                    double percent = (numberOfFrames > 0) ? 100.0*numberDone/numberOfFrames : 0.0;
+                    std::cout << "  " << QFileInfo(jobPtr -> getResult().inputFileName).fileName().toStdString();
+                    std::cout << " " << std::min(percent, 100.0) << "%";
+                }
+            }
+            std::cout << std::endl;
+        }
+
+        for (int i=0; i<jobPtrList_.size(); i++)
+        {
+            resultList.append(jobPtrList_[i] -> getResult());
+            delete jobPtrList_[i];
+        }
+        jobPtrList_.clear();
+        return resultList;
+    }
+
+
+    void Transcoder::stop()
+    {
+        for (int i=0; i<jobPtrList_.size(); i++)
+        {
+            if (!jobPtrList_[i].isNull())
+            {
+                jobPtrList_[i] -> stop();
+            }
+        }
+    }
+
+} // namespace bias
@@ -0,0 +1,120 @@
+#ifndef BIAS_TRANSCODER_HPP
+#define BIAS_TRANSCODER_HPP
+#include "basic_types.hpp"
+#include "video_writer_params.hpp"
+#include "lockable.hpp"
+#include "frame_drain.hpp"
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPointer>
+#include <memory>
+
+class QThreadPool;
+
+namespace bias
+{
+
+    struct TranscoderParams
+    {
+        VideoFileFormat videoFileFormat;
+        VideoWriterParams videoWriterParams;
+        QString outputDir;
+        unsigned int numberOfJobs;  // files transcoded concurrently
+        unsigned long maxPending;   // frames outstanding in a writer before reading waits
+        double frameRate;           // for image sequences, which have no time stamps 
+        bool overwrite;
+        TranscoderParams();
+        std::string toString();
+    };
+
+
+    struct TranscodeResult
+    {
+        QString inputFileName;
+        QString outputFileName;
+        bool success;
+        unsigned long numberOfFrames;
+        unsigned long numberSkipped;
+        unsigned long numberDropped;
+        double elapsedTime;
+        QStringList errorMessages;
+        TranscodeResult();
+        double framesPerSec() const;
+        std::string toString() const;
+    };
+
+
+    class TranscodeJob : public QObject, public QRunnable, public Lockable<Empty>
+    {
+        // Transcodes one recording. Frames are read on the job thread and 
+        // handed to the writer as fast as it takes them - the writer's own 
+        // compressor threads provide the parallelism within the file. 
+
+        Q_OBJECT
+
+        public:
+
+            TranscodeJob(
+                    QString inputFileName, 
+                    QString outputFileName, 
+                    TranscoderParams params, 
+                    QObject *parent=0
+                    );
+
+            void stop();
+            unsigned long getNumberOfFramesDone();
+            unsigned long getNumberOfFrames();
+            bool isDone();
+            TranscodeResult getResult();
+
+        protected slots:
+
+            void onImageLoggingError(unsigned int errorId, QString errorMsg);
+
+        private:
+
+            bool stopped_;
+            bool done_;
+            unsigned long numberOfFramesDone_;
+            unsigned long numberOfFrames_;
+            TranscoderParams params_;
+            TranscodeResult result_;
+
+            void run();
+            void transcode();
+            void waitForWriter(FrameDrainPtr frameDrainPtr);
+            bool requiresMono();
+    };
+
+
+    class Transcoder : public QObject
+    {
+        // Transcodes a list of recordings into one video format, several 
+        // files at a time.
+
+        Q_OBJECT
+
+        public:
+
+            Transcoder(TranscoderParams params, QObject *parent=0);
+
+            QString getOutputFileName(QString inputFileName);
+            QList<TranscodeResult> run(QStringList inputFileNameList, bool verbose=true);
+            void stop();
+
+            static const unsigned long DEFAULT_MAX_PENDING;
+            static const int PROGRESS_INTERVAL;
+
+        protected:
+
+            TranscoderParams params_;
+            QPointer<QThreadPool> threadPoolPtr_;
+            QList<QPointer<TranscodeJob>> jobPtrList_;
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_TRANSCODER_HPP
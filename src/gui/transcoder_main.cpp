@@ -0,0 +1,106 @@
+#include "transcoder.hpp"
+#include "video_writer_factory.hpp"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QThread>
+#include <algorithm>
+#include <iostream>
+
+
+// ------------------------------------------------------------------------
+// Offline transcoder. Converts recordings (fmf, avi or image sequence 
+// directories) to another format using the video writers, e.g.
+//
+//   transcoder --format ufmf --output converted --jobs 4 *.fmf
+// ------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("transcoder");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("BIAS offline transcoder");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Recordings to transcode (fmf, avi or image directories).", "inputs...");
+
+    QCommandLineOption formatOption("format", "Output format (bmp,jpg,avi,fmf,ufmf,zfmf).", "format", "ufmf");
+    QCommandLineOption outputOption("output", "Output directory.", "dir", QDir::currentPath());
+    QCommandLineOption jobsOption("jobs", "Number of files transcoded at the same time.", "count");
+    QCommandLineOption threadsOption("threads", "Compressor/writer/encoder threads per file.", "count");
+    QCommandLineOption pendingOption("max-pending", "Frames outstanding in a writer before reading waits.", "count", QString::number(bias::Transcoder::DEFAULT_MAX_PENDING));
+    QCommandLineOption rateOption("rate", "Frame rate (Hz) for image sequences, which have no time stamps.", "hz", "100");
+    QCommandLineOption overwriteOption("overwrite", "Replace existing output files.");
+    QCommandLineOption quietOption("quiet", "No progress output.");
+
+    parser.addOption(formatOption);
+    parser.addOption(outputOption);
+    parser.addOption(jobsOption);
+    parser.addOption(threadsOption);
+    parser.addOption(pendingOption);
+    parser.addOption(rateOption);
+    parser.addOption(overwriteOption);
+    parser.addOption(quietOption);
+    parser.process(app);
+
+    QStringList inputFileNameList = parser.positionalArguments();
+    if (inputFileNameList.isEmpty())
+    {
+        parser.showHelp(1);
+    }
+
+    bias::TranscoderParams params;
+    params.videoFileFormat = bias::getVideoFileFormatFromExtension(parser.value(formatOption));
+    if (params.videoFileFormat == bias::VIDEOFILE_FORMAT_UNSPECIFIED)
+    {
+        std::cerr << "error: unknown format " << parser.value(formatOption).toStdString() << std::endl;
+        return 1;
+    }
+    params.outputDir = parser.value(outputOption);
+    params.maxPending = std::max(parser.value(pendingOption).toULong(), 1ul);
+    params.frameRate = parser.value(rateOption).toDouble();
+    params.overwrite = parser.isSet(overwriteOption);
+
+    unsigned int numberOfThreads = 1;
+    if (parser.isSet(threadsOption))
+    {
+        numberOfThreads = std::max(parser.value(threadsOption).toUInt(), 1u);
+        params.videoWriterParams.bmp.numberOfWriters = numberOfThreads;
+        params.videoWriterParams.jpg.numberOfCompressors = numberOfThreads;
+        params.videoWriterParams.avi.numberOfEncoders = numberOfThreads;
+        params.videoWriterParams.ufmf.numberOfCompressors = numberOfThreads;
+        params.videoWriterParams.zfmf.numberOfCompressors = numberOfThreads;
+    }
+
+    // By default share the cores between files - each file also runs its
+    // writer's compressor threads.
+    if (parser.isSet(jobsOption))
+    {
+        params.numberOfJobs = std::max(parser.value(jobsOption).toUInt(), 1u);
+    }
+    else
+    {
+        unsigned int numberOfCores = std::max(QThread::idealThreadCount(), 1);
+        params.numberOfJobs = std::max(numberOfCores/(numberOfThreads + 1), 1u);
+    }
+
+    if (!QDir().mkpath(params.outputDir))
+    {
+        std::cerr << "error: unable to create " << params.outputDir.toStdString() << std::endl;
+        return 1;
+    }
+
+    bias::Transcoder transcoder(params);
+    QList<bias::TranscodeResult> resultList = transcoder.run(inputFileNameList, !parser.isSet(quietOption));
+
+    int rtnValue = 0;
+    for (int i=0; i<resultList.size(); i++)
+    {
+        std::cout << resultList[i].toString();
+        if (!resultList[i].success)
+        {
+            rtnValue = 1;
+        }
+    }
+    return rtnValue;
+}
@@ -0,0 +1,104 @@
+#include "video_reader.hpp"
+#include "video_reader_fmf.hpp"
+#include "video_reader_avi.hpp"
+#include "video_reader_image.hpp"
+#include "basic_types.hpp"
+#include "exception.hpp"
+#include <QFileInfo>
+
+namespace bias
+{
+    const double VideoReader::DEFAULT_DT_ESTIMATE = 0.01;
+
+
+    VideoReader::VideoReader()
+    {
+        size_ = cv::Size(0,0);
+        numberOfFrames_ = 0;
+        frameIndex_ = 0;
+    }
+
+
+    VideoReader::~VideoReader()
+    {}
+
+
+    void VideoReader::open(QString fileName)
+    {
+        fileName_ = fileName;
+    }
+
+
+    void VideoReader::close()
+    {
+        numberOfFrames_ = 0;
+        frameIndex_ = 0;
+    }
+
+
+    bool VideoReader::isOpen() const
+    {
+        return false;
+    }
+
+
+    bool VideoReader::readFrame(StampedImage &stampedImg)
+    {
+        return false;
+    }
+
+
+    QString VideoReader::getFileName() const
+    {
+        return fileName_;
+    }
+
+
+    cv::Size VideoReader::getSize() const
+    {
+        return size_;
+    }
+
+
+    unsigned long VideoReader::getNumberOfFrames() const
+    {
+        return numberOfFrames_;
+    }
+
+
+    unsigned long VideoReader::getFrameIndex() const
+    {
+        return frameIndex_;
+    }
+
+
+    VideoReaderPtr createVideoReader(QString fileName)
+    {
+        QFileInfo fileInfo(fileName);
+        VideoReaderPtr videoReaderPtr;
+
+        if (fileInfo.isDir())
+        {
+            videoReaderPtr = std::make_shared<VideoReader_image>();
+        }
+        else if (fileInfo.suffix().toLower() == QString("fmf"))
+        {
+            videoReaderPtr = std::make_shared<VideoReader_fmf>();
+        }
+        else if (VideoReader_avi::isAllowedExtension(fileInfo.suffix()))
+        {
+            videoReaderPtr = std::make_shared<VideoReader_avi>();
+        }
+        else
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+            std::string errorMsg("no video reader for file:\n\n"); 
+            errorMsg += fileName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        videoReaderPtr -> open(fileName);
+        return videoReaderPtr;
+    }
+
+} // namespace bias
@@ -0,0 +1,52 @@
+#ifndef BIAS_VIDEO_READER_HPP
+#define BIAS_VIDEO_READER_HPP
+#include "stamped_image.hpp"
+#include <QString>
+#include <memory>
+#include <opencv2/core/core.hpp>
+
+namespace bias
+{
+
+    class VideoReader
+    {
+        // Base class for sequential readers of recorded video. Used by the
+        // command line tools to feed recordings back through the writers.
+
+        public:
+
+            VideoReader();
+            virtual ~VideoReader();
+
+            virtual void open(QString fileName);
+            virtual void close();
+            virtual bool isOpen() const;
+
+            // Reads the next frame, returns false at the end of the video. The
+            // image is newly allocated so it may be handed to other threads.
+            virtual bool readFrame(StampedImage &stampedImg);
+
+            virtual QString getFileName() const;
+            virtual cv::Size getSize() const;
+            virtual unsigned long getNumberOfFrames() const;
+            virtual unsigned long getFrameIndex() const;
+
+            static const double DEFAULT_DT_ESTIMATE;
+
+        protected:
+
+            QString fileName_;
+            cv::Size size_;
+            unsigned long numberOfFrames_;
+            unsigned long frameIndex_;
+    };
+
+    typedef std::shared_ptr<VideoReader> VideoReaderPtr;
+
+    // Creates the reader for an fmf file, an avi (or other container opencv 
+    // can read) or a directory holding an image sequence. 
+    VideoReaderPtr createVideoReader(QString fileName);
+
+} // namespace bias
+
+#endif // #ifndef BIAS_VIDEO_READER_HPP
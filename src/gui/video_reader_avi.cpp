@@ -0,0 +1,120 @@
+#include "video_reader_avi.hpp"
+#include "basic_types.hpp"
+#include "exception.hpp"
+
+namespace bias
+{
+
+    VideoReader_avi::VideoReader_avi() : VideoReader()
+    {
+        frameRate_ = 1.0/DEFAULT_DT_ESTIMATE;
+    }
+
+
+    VideoReader_avi::VideoReader_avi(QString fileName) : VideoReader_avi()
+    {
+        open(fileName);
+    }
+
+
+    VideoReader_avi::~VideoReader_avi()
+    {
+        close();
+    }
+
+
+    void VideoReader_avi::open(QString fileName)
+    {
+        close();
+        fileName_ = fileName;
+
+        bool openOk = false;
+        try
+        {
+            openOk = capture_.open(fileName.toStdString());
+        }
+        catch (cv::Exception &e)
+        {
+            openOk = false;
+        }
+        if (!openOk || !capture_.isOpened())
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+            std::string errorMsg("video reader unable to open file:\n\n"); 
+            errorMsg += fileName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        int width = int(capture_.get(cv::CAP_PROP_FRAME_WIDTH));
+        int height = int(capture_.get(cv::CAP_PROP_FRAME_HEIGHT));
+        size_ = cv::Size(width, height);
+
+        // Frame count is taken from the container and may be an estimate
+        double numberOfFrames = capture_.get(cv::CAP_PROP_FRAME_COUNT);
+        numberOfFrames_ = (numberOfFrames > 0.0) ? (unsigned long)(numberOfFrames) : 0;
+
+        double frameRate = capture_.get(cv::CAP_PROP_FPS);
+        frameRate_ = (frameRate > 0.0) ? frameRate : 1.0/DEFAULT_DT_ESTIMATE;
+        frameIndex_ = 0;
+    }
+
+
+    void VideoReader_avi::close()
+    {
+        if (capture_.isOpened())
+        {
+            capture_.release();
+        }
+        VideoReader::close();
+    }
+
+
+    bool VideoReader_avi::isOpen() const
+    {
+        return capture_.isOpened();
+    }
+
+
+    bool VideoReader_avi::readFrame(StampedImage &stampedImg)
+    {
+        if (!capture_.isOpened())
+        {
+            return false;
+        }
+
+        cv::Mat image;
+        if (!capture_.read(image) || image.empty())
+        {
+            return false;
+        }
+
+        // The capture may reuse its buffer for the next frame
+        stampedImg.image = image.clone();
+        stampedImg.timeStamp = frameIndex_/frameRate_;
+        stampedImg.dtEstimate = 1.0/frameRate_;
+        stampedImg.frameCount = frameIndex_;
+        frameIndex_++;
+        return true;
+    }
+
+
+    double VideoReader_avi::getFrameRate() const
+    {
+        return frameRate_;
+    }
+
+
+    QStringList VideoReader_avi::getListOfAllowedExtensions()
+    {
+        QStringList extensionList;
+        extensionList << "avi" << "mp4" << "mov" << "mkv";
+        return extensionList;
+    }
+
+
+    bool VideoReader_avi::isAllowedExtension(QString extension)
+    {
+        return getListOfAllowedExtensions().contains(extension.toLower());
+    }
+
+} // namespace bias
@@ -0,0 +1,39 @@
+#ifndef BIAS_VIDEO_READER_AVI_HPP
+#define BIAS_VIDEO_READER_AVI_HPP
+#include "video_reader.hpp"
+#include <QStringList>
+#include <opencv2/highgui/highgui.hpp>
+
+namespace bias
+{
+
+    class VideoReader_avi : public VideoReader
+    {
+        // Reads avi (and other containers supported by opencv) files. Time
+        // stamps are derived from the frame rate stored in the file.
+
+        public:
+
+            VideoReader_avi();
+            explicit VideoReader_avi(QString fileName);
+            virtual ~VideoReader_avi();
+
+            virtual void open(QString fileName);
+            virtual void close();
+            virtual bool isOpen() const;
+            virtual bool readFrame(StampedImage &stampedImg);
+
+            double getFrameRate() const;
+
+            static QStringList getListOfAllowedExtensions();
+            static bool isAllowedExtension(QString extension);
+
+        protected:
+
+            cv::VideoCapture capture_;
+            double frameRate_;
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_VIDEO_READER_AVI_HPP
@@ -0,0 +1,191 @@
+#include "video_reader_fmf.hpp"
+#include "basic_types.hpp"
+#include "exception.hpp"
+#include <string>
+#include <algorithm>
+
+namespace bias
+{
+    VideoReader_fmf::VideoReader_fmf() : VideoReader()
+    {
+        version_ = 0;
+        bytesPerChunk_ = 0;
+        headerSize_ = 0;
+        lastTimeStamp_ = 0.0;
+    }
+
+
+    VideoReader_fmf::VideoReader_fmf(QString fileName) : VideoReader_fmf()
+    {
+        open(fileName);
+    }
+
+
+    VideoReader_fmf::~VideoReader_fmf()
+    {
+        close();
+    }
+
+
+    void VideoReader_fmf::open(QString fileName)
+    {
+        close();
+        fileName_ = fileName;
+
+        file_.clear();
+        file_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        try
+        {
+            file_.open(fileName.toStdString(), std::ios::binary | std::ios::in);
+        }
+        catch (std::ifstream::failure &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+            std::string errorMsg("video reader unable to open file:\n\n"); 
+            errorMsg += fileName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+        readHeader();
+    }
+
+
+    void VideoReader_fmf::close()
+    {
+        if (file_.is_open())
+        {
+            file_.exceptions(std::ifstream::goodbit);
+            file_.close();
+        }
+        lastTimeStamp_ = 0.0;
+        VideoReader::close();
+    }
+
+
+    bool VideoReader_fmf::isOpen() const
+    {
+        return file_.is_open();
+    }
+
+
+    bool VideoReader_fmf::readFrame(StampedImage &stampedImg)
+    {
+        if (!file_.is_open() || (frameIndex_ >= numberOfFrames_))
+        {
+            return false;
+        }
+
+        double timeStamp = 0.0;
+        cv::Mat image(size_, CV_8UC1);
+        try
+        {
+            file_.read((char*) &timeStamp, sizeof(double));
+            file_.read((char*) image.data, size_.width*size_.height);
+        }
+        catch (std::ifstream::failure &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_READ_FRAME;
+            std::string errorMsg("video reader unable to read frame from:\n\n"); 
+            errorMsg += fileName_.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        stampedImg.image = image;
+        stampedImg.timeStamp = timeStamp;
+        stampedImg.frameCount = frameIndex_;
+        if ((frameIndex_ > 0) && (timeStamp > lastTimeStamp_))
+        {
+            stampedImg.dtEstimate = timeStamp - lastTimeStamp_;
+        }
+        else
+        {
+            stampedImg.dtEstimate = DEFAULT_DT_ESTIMATE;
+        }
+        lastTimeStamp_ = timeStamp;
+        frameIndex_++;
+        return true;
+    }
+
+
+    void VideoReader_fmf::seek(unsigned long frameIndex)
+    {
+        frameIndex_ = std::min(frameIndex, numberOfFrames_);
+        file_.clear();
+        file_.seekg(std::streamoff(headerSize_ + frameIndex_*bytesPerChunk_));
+        lastTimeStamp_ = 0.0;
+    }
+
+
+    void VideoReader_fmf::readHeader()
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint64_t numberOfFrames = 0;
+
+        try
+        {
+            file_.read((char*) &version_, sizeof(uint32_t));
+            if (version_ == 3)
+            {
+                uint32_t formatLength = 0;
+                uint32_t bitsPerPixel = 0;
+                file_.read((char*) &formatLength, sizeof(uint32_t));
+                std::string format(formatLength, ' ');
+                file_.read(&format[0], formatLength);
+                file_.read((char*) &bitsPerPixel, sizeof(uint32_t));
+                if (bitsPerPixel != 8)
+                {
+                    unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+                    std::string errorMsg("video reader fmf only 8 bit images supported, format = "); 
+                    errorMsg += format;
+                    throw RuntimeError(errorId, errorMsg); 
+                }
+            }
+            else if (version_ != 1)
+            {
+                unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+                std::string errorMsg("video reader fmf unsupported version: "); 
+                errorMsg += std::to_string(version_);
+                throw RuntimeError(errorId, errorMsg); 
+            }
+            file_.read((char*) &height, sizeof(uint32_t));
+            file_.read((char*) &width, sizeof(uint32_t));
+            file_.read((char*) &bytesPerChunk_, sizeof(uint64_t));
+            file_.read((char*) &numberOfFrames, sizeof(uint64_t));
+            headerSize_ = uint64_t(file_.tellg());
+
+            // Number of frames is only written when the recording is finished
+            // - use the file size for files which were not closed properly.
+            file_.seekg(0, std::ios::end);
+            uint64_t fileSize = uint64_t(file_.tellg());
+            file_.seekg(std::streamoff(headerSize_));
+            uint64_t numberInFile = 0; 
+            if (bytesPerChunk_ > 0)
+            {
+                numberInFile = (fileSize - headerSize_)/bytesPerChunk_;
+            }
+            if ((numberOfFrames == 0) || (numberOfFrames > numberInFile))
+            {
+                numberOfFrames = numberInFile;
+            }
+        }
+        catch (std::ifstream::failure &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+            std::string errorMsg("video reader unable to read fmf header:\n\n"); 
+            errorMsg += exc.what();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        if (bytesPerChunk_ != uint64_t(width)*uint64_t(height) + sizeof(double))
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+            std::string errorMsg("video reader fmf header inconsistent bytes per chunk"); 
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        size_ = cv::Size(int(width), int(height));
+        numberOfFrames_ = (unsigned long)(numberOfFrames);
+        frameIndex_ = 0;
+    }
+
+} // namespace bias
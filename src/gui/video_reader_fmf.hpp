@@ -0,0 +1,44 @@
+#ifndef BIAS_VIDEO_READER_FMF_HPP
+#define BIAS_VIDEO_READER_FMF_HPP
+#include "video_reader.hpp"
+#include <QString>
+#include <fstream>
+#include <stdint.h>
+#include <opencv2/core/core.hpp>
+
+namespace bias
+{
+
+    class VideoReader_fmf : public VideoReader
+    {
+        // Sequential reader for fmf files (version 1 as written by 
+        // VideoWriter_fmf, and 8 bit version 3). Used by the command line 
+        // tools to replay recordings through the video writers.
+
+        public:
+
+            VideoReader_fmf();
+            explicit VideoReader_fmf(QString fileName);
+            virtual ~VideoReader_fmf();
+
+            virtual void open(QString fileName);
+            virtual void close();
+            virtual bool isOpen() const;
+            virtual bool readFrame(StampedImage &stampedImg);
+
+            void seek(unsigned long frameIndex);
+
+        protected:
+
+            std::ifstream file_;
+            uint32_t version_;
+            uint64_t bytesPerChunk_;
+            uint64_t headerSize_;
+            double lastTimeStamp_;
+
+            void readHeader();
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_VIDEO_READER_FMF_HPP
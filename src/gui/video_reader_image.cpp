@@ -0,0 +1,138 @@
+#include "video_reader_image.hpp"
+#include "basic_types.hpp"
+#include "exception.hpp"
+#include <QDir>
+#include <QDirIterator>
+#include <QCollator>
+#include <algorithm>
+#include <opencv2/highgui/highgui.hpp>
+
+namespace bias
+{
+
+    VideoReader_image::VideoReader_image() : VideoReader()
+    {
+        frameRate_ = 1.0/DEFAULT_DT_ESTIMATE;
+    }
+
+
+    VideoReader_image::VideoReader_image(QString dirName) : VideoReader_image()
+    {
+        open(dirName);
+    }
+
+
+    VideoReader_image::~VideoReader_image()
+    {}
+
+
+    void VideoReader_image::open(QString dirName)
+    {
+        close();
+        fileName_ = dirName;
+
+        QDir dir(dirName);
+        if (!dir.exists())
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+            std::string errorMsg("video reader image directory does not exist:\n\n"); 
+            errorMsg += dirName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        QStringList nameFilters;
+        QStringList extensionList = getListOfAllowedExtensions();
+        for (int i=0; i<extensionList.size(); i++)
+        {
+            nameFilters << QString("*.%1").arg(extensionList[i]);
+        }
+
+        QDirIterator it(dir.absolutePath(), nameFilters, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            imageFileList_.append(it.next());
+        }
+
+        // Numeric ordering so image_10 follows image_9 and frames_1/ follows frames_0/
+        QCollator collator;
+        collator.setNumericMode(true);
+        std::sort(imageFileList_.begin(), imageFileList_.end(), 
+                [&collator](const QString &a, const QString &b) { return collator.compare(a,b) < 0; });
+
+        if (imageFileList_.isEmpty())
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_OPEN;
+            std::string errorMsg("video reader no images found in:\n\n"); 
+            errorMsg += dirName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        cv::Mat firstImage = cv::imread(imageFileList_[0].toStdString(), cv::IMREAD_UNCHANGED);
+        size_ = firstImage.size();
+        numberOfFrames_ = (unsigned long)(imageFileList_.size());
+        frameIndex_ = 0;
+    }
+
+
+    void VideoReader_image::close()
+    {
+        imageFileList_.clear();
+        VideoReader::close();
+    }
+
+
+    bool VideoReader_image::isOpen() const
+    {
+        return !imageFileList_.isEmpty();
+    }
+
+
+    bool VideoReader_image::readFrame(StampedImage &stampedImg)
+    {
+        if (frameIndex_ >= numberOfFrames_)
+        {
+            return false;
+        }
+
+        QString imageFileName = imageFileList_[int(frameIndex_)];
+        cv::Mat image = cv::imread(imageFileName.toStdString(), cv::IMREAD_UNCHANGED);
+        if (image.empty())
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_READ_FRAME;
+            std::string errorMsg("video reader unable to read image:\n\n"); 
+            errorMsg += imageFileName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+
+        stampedImg.image = image;
+        stampedImg.timeStamp = frameIndex_/frameRate_;
+        stampedImg.dtEstimate = 1.0/frameRate_;
+        stampedImg.frameCount = frameIndex_;
+        frameIndex_++;
+        return true;
+    }
+
+
+    void VideoReader_image::setFrameRate(double frameRate)
+    {
+        if (frameRate > 0.0)
+        {
+            frameRate_ = frameRate;
+        }
+    }
+
+
+    double VideoReader_image::getFrameRate() const
+    {
+        return frameRate_;
+    }
+
+
+    QStringList VideoReader_image::getListOfAllowedExtensions()
+    {
+        QStringList extensionList;
+        extensionList << "bmp" << "png" << "tif" << "tiff" << "jpg" << "jpeg";
+        return extensionList;
+    }
+
+} // namespace bias
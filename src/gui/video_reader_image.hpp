@@ -0,0 +1,40 @@
+#ifndef BIAS_VIDEO_READER_IMAGE_HPP
+#define BIAS_VIDEO_READER_IMAGE_HPP
+#include "video_reader.hpp"
+#include <QStringList>
+
+namespace bias
+{
+
+    class VideoReader_image : public VideoReader
+    {
+        // Reads an image sequence from a directory, e.g. as written by the 
+        // bmp writer. Images in sub-directories (shards) are included and 
+        // files are ordered by their numbered names. There are no time stamps
+        // so frames are spaced by the frame rate given.
+
+        public:
+
+            VideoReader_image();
+            explicit VideoReader_image(QString dirName);
+            virtual ~VideoReader_image();
+
+            virtual void open(QString dirName);
+            virtual void close();
+            virtual bool isOpen() const;
+            virtual bool readFrame(StampedImage &stampedImg);
+
+            void setFrameRate(double frameRate);
+            double getFrameRate() const;
+
+            static QStringList getListOfAllowedExtensions();
+
+        protected:
+
+            QStringList imageFileList_;
+            double frameRate_;
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_VIDEO_READER_IMAGE_HPP
@@ -1,13 +1,16 @@
 #include "video_writer.hpp"
 #include "stamped_image.hpp"
+#include "basic_types.hpp"
 #include <iostream>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QtDebug>
 
 namespace bias
 {
     const unsigned int DEFAULT_FRAME_SKIP = 1;
     const QString DUMMY_FILENAME("dummy_filename");
+    const double VideoWriter::DEFAULT_FINISH_TIMEOUT = 30.0;  // sec
 
     VideoWriter::VideoWriter(QObject *parent) 
         : VideoWriter(DUMMY_FILENAME,0, parent) 
@@ -22,6 +25,8 @@ namespace bias
         frameCount_ = 0;
         frameSkip_ = DEFAULT_FRAME_SKIP;
         addVersionNumber_ = true;
+        finishTimeout_ = DEFAULT_FINISH_TIMEOUT;
+        bayerPattern_ = BAYER_PATTERN_NONE;
     }
 
     VideoWriter::~VideoWriter() 
@@ -50,6 +55,9 @@ namespace bias
         addVersionNumber_ = value;
     }
 
+    void VideoWriter::prepare(StampedImage stampedImg)
+    {}
+
     void VideoWriter::addFrame(StampedImage stampedImg)
     {
         std::cout << __FUNCTION__;
@@ -81,8 +89,96 @@ namespace bias
         return frameSkip_;
     }
 
+    void VideoWriter::setFinishTimeout(double finishTimeout)
+    {
+        finishTimeout_ = finishTimeout;
+    }
+
+    double VideoWriter::getFinishTimeout() const
+    {
+        return finishTimeout_;
+    }
+
+    void VideoWriter::setBayerPattern(BayerPattern pattern)
+    {
+        bayerPattern_ = pattern;
+    }
+
+    BayerPattern VideoWriter::getBayerPattern() const
+    {
+        return bayerPattern_;
+    }
+
     void VideoWriter::finish() {};
 
+    FrameDrainPtr VideoWriter::getFrameDrain() const
+    {
+        return FrameDrainPtr();
+    }
+
+    unsigned long long VideoWriter::getBytesWritten()
+    {
+        QFileInfo fileInfo(fileName_);
+        if (!fileInfo.exists() || fileInfo.isDir())
+        {
+            return 0;
+        }
+        return (unsigned long long)(fileInfo.size());
+    }
+
+    bool VideoWriter::waitForFrameDrain(
+            FrameDrainPtr frameDrainPtr, 
+            std::function<void()> writeFinished
+            )
+    {
+        QElapsedTimer timer;
+        timer.start();
+        qint64 timeout = qint64(1000.0*finishTimeout_);
+        qint64 lastReportTime = 0;
+        bool drained = (frameDrainPtr -> numberPending() == 0);
+
+        while (!drained)
+        {
+            if (timer.elapsed() >= timeout)
+            {
+                break;
+            }
+            drained = frameDrainPtr -> waitForProgress(FrameDrain::WAIT_INTERVAL);
+            if (writeFinished)
+            {
+                writeFinished();
+            }
+
+            if ((timer.elapsed() - lastReportTime) >= qint64(FrameDrain::PROGRESS_INTERVAL))
+            {
+                unsigned long numberPending = frameDrainPtr -> numberPending();
+                unsigned long numberQueued = frameDrainPtr -> numberQueued();
+                std::cout << "video writer finishing - " << numberPending << " frames remaining" << std::endl;
+                emit finishProgress(numberPending, numberQueued);
+                lastReportTime = timer.elapsed();
+            }
+        }
+
+        if (writeFinished)
+        {
+            writeFinished();
+        }
+        emit finishProgress(frameDrainPtr -> numberPending(), frameDrainPtr -> numberQueued());
+        return drained;
+    }
+
+    void VideoWriter::reportDroppedFrames(unsigned long numberDropped)
+    {
+        if (numberDropped == 0)
+        {
+            return;
+        }
+        std::cout << "warning: video writer finish timeout - dropped " << numberDropped << " frames" << std::endl;
+        unsigned int errorId = ERROR_FRAMES_DROPPED_AT_FINISH;
+        QString errorMsg = QString("video writer finish timeout - %1 frames dropped").arg(numberDropped);
+        emit imageLoggingError(errorId, errorMsg);
+    }
+
     unsigned int VideoWriter::getNextVersionNumber()
     {
         unsigned int nextVerNum = 0;
@@ -116,15 +212,32 @@ namespace bias
 
     QFileInfo VideoWriter::getFileInfo(unsigned int verNum)
     {
-        QFileInfo fileInfo(fileName_);
+        if (!addVersionNumber_)
+        {
+            return QFileInfo(fileName_);
+        }
+        return getVersionFileInfo(fileName_, verNum);
+    }
+
+    QFileInfo VideoWriter::getVersionFileInfo(QString fileName, unsigned int verNum)
+    {
+        QFileInfo fileInfo(fileName);
         QDir filePath = QDir(fileInfo.absolutePath());
         QString baseName = fileInfo.baseName();
         QString ext = fileInfo.suffix();
 
-        if (addVersionNumber_ && (verNum > 0))
+        if (verNum > 0)
         {
             QString verStr = QString("_v%1").arg(verNum,3,10,QChar('0'));
-            fileInfo = QFileInfo(filePath, baseName + verStr + "." + ext);
+            if (ext.isEmpty())
+            {
+                // Image directory writers (bmp, jpg) - no extension
+                fileInfo = QFileInfo(filePath, baseName + verStr);
+            }
+            else
+            {
+                fileInfo = QFileInfo(filePath, baseName + verStr + "." + ext);
+            }
         }
         return fileInfo;
     }
@@ -1,10 +1,13 @@
 #ifndef BIAS_VIDEO_WRITER_HPP
 #define BIAS_VIDEO_WRITER_HPP
 #include "stamped_image.hpp"
+#include "frame_drain.hpp"
+#include "basic_types.hpp"
 #include <QString>
 #include <QObject>
 #include <QFileInfo>
 #include <opencv2/core/core.hpp>
+#include <functional>
 
 namespace bias
 {
@@ -22,14 +25,41 @@ namespace bias
             virtual void setFrameSkip(unsigned int frameSkip);
             virtual void setVersioning(bool value);
             virtual unsigned int getNextVersionNumber();
+
+            // Opens the output and starts any worker threads, taking the image
+            // size and format from stampedImg without adding it. addFrame does
+            // this for the first frame when it hasn't been done already - lets
+            // the segmented writer get the next segment ready ahead of time.
+            virtual void prepare(StampedImage stampedImg);
             virtual void addFrame(StampedImage stampedImg);
             virtual QString getFileName() const;
             virtual cv::Size getSize() const;
             virtual unsigned int getFrameSkip() const;
+            virtual void setFinishTimeout(double finishTimeout);
+            virtual double getFinishTimeout() const;
+            virtual void setBayerPattern(BayerPattern pattern);
+            virtual BayerPattern getBayerPattern() const;
             virtual void finish();
 
+            // Book keeping for writers which hand frames to worker threads,
+            // null for writers which write frames directly.
+            virtual FrameDrainPtr getFrameDrain() const;
+
+            // Size of the output written so far - the file size by default. 
+            virtual unsigned long long getBytesWritten();
+
+            // Versioned output name, e.g. name_v001.ext - as used by the 
+            // writers when versioning is on
+            static QFileInfo getVersionFileInfo(QString fileName, unsigned int verNum);
+
+            static const double DEFAULT_FINISH_TIMEOUT;
+
         signals:
+            // Compressor/encoder errors are forwarded with direct connections
+            // and so may be emitted from any thread - the writer's own thread
+            // need not run an event loop (e.g. the transcoder's pool threads).
             void imageLoggingError(unsigned int errorId, QString errorMsg);
+            void finishProgress(unsigned long numberPending, unsigned long numberQueued);
 
         protected:
 
@@ -39,9 +69,20 @@ namespace bias
             unsigned int frameSkip_;
             unsigned int cameraNumber_;
             bool addVersionNumber_;
+            double finishTimeout_;
+            BayerPattern bayerPattern_;
 
             QString getUniqueFileName();
             QFileInfo getFileInfo(unsigned int verNum);
+
+            // Waits for worker threads to work through all queued frames,
+            // calling writeFinished as frames complete. Returns false if the
+            // finish timeout expires first.
+            bool waitForFrameDrain(
+                    FrameDrainPtr frameDrainPtr, 
+                    std::function<void()> writeFinished
+                    );
+            void reportDroppedFrames(unsigned long numberDropped);
     };
 
 } // namespace bias
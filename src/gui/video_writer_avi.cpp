@@ -1,9 +1,18 @@
 #include "video_writer_avi.hpp"
 #include "basic_types.hpp"
 #include "exception.hpp"
+#include "json.hpp"
+#include "json_utils.hpp"
 #include <QFileInfo>
 #include <QDir>
+#include <QFile>
+#include <QThreadPool>
+#include <QVariantMap>
+#include <QVariantList>
+#include <algorithm>
 #include <iostream>
+#include <iomanip>
+#include <limits>
 
 namespace bias
 { 
@@ -15,6 +24,16 @@ namespace bias
     const unsigned int VideoWriter_avi::DEFAULT_FRAME_SKIP = 1;
     //const int VideoWriter_avi::DEFAULT_FOURCC = CV_FOURCC('X','V','I','D');
     const int VideoWriter_avi::DEFAULT_FOURCC = cv::VideoWriter::fourcc('X','V','I','D');
+    const unsigned int VideoWriter_avi::DEFAULT_NUMBER_OF_ENCODERS = 1;
+    const unsigned int VideoWriter_avi::MAX_NUMBER_OF_ENCODERS = 16;
+    const unsigned long VideoWriter_avi::DEFAULT_SEGMENT_FRAMES = 250;
+    const unsigned long VideoWriter_avi::MIN_SEGMENT_FRAMES = 10;
+    const unsigned int VideoWriter_avi::FRAMES_TODO_MAX_QUEUE_SIZE = 1000;
+    const QString VideoWriter_avi::SEGMENT_TAG = QString("_part");
+    const QString VideoWriter_avi::MANIFEST_TAG = QString("_parts");
+    const QString VideoWriter_avi::MANIFEST_EXT = QString("json");
+    const QString VideoWriter_avi::INDEX_EXT = QString("txt");
+    const int ENCODER_WAIT_TIMEOUT = 10;  // msec
     const VideoWriterParams_avi VideoWriter_avi::DEFAULT_PARAMS = 
         VideoWriterParams_avi();
 
@@ -35,14 +54,40 @@ namespace bias
         : VideoWriter(fileName,cameraNumber,parent)
     {
         isFirst_ = true;
+        isColor_ = false;
+        skipReported_ = false;
         fps_ = DEFAULT_FPS;
         fourcc_ = stringToFourcc(params.codec);
         setFrameSkip(params.frameSkip);
+
+        numberOfEncoders_ = std::min(std::max(params.numberOfEncoders, 1u), MAX_NUMBER_OF_ENCODERS);
+        segmentFrames_ = std::max(params.segmentFrames, MIN_SEGMENT_FRAMES);
+
+        // Every encoder busy with a full segment while the next one fills must 
+        // fit in the queue, otherwise frames are skipped before all encoders run.
+        maxQueueSize_ = std::max(
+                (unsigned long)(FRAMES_TODO_MAX_QUEUE_SIZE), 
+                (numberOfEncoders_ + 1)*segmentFrames_
+                );
+        frameDrainPtr_ = std::make_shared<FrameDrain>();
+        if (isSegmented())
+        {
+            threadPoolPtr_ = new QThreadPool(this);
+            threadPoolPtr_ -> setMaxThreadCount(numberOfEncoders_);
+        }
     }
 
 
     VideoWriter_avi::~VideoWriter_avi() 
     {
+        if (isSegmented())
+        {
+            closeCurrentSegment();
+            dropQueuedFrames();
+            while (!(threadPoolPtr_ -> waitForDone(ENCODER_WAIT_TIMEOUT)));
+            indexFile_.close();
+        }
+
         videoWriterMutexPtr_ -> lock();
         bool isOpened = videoWriter_.isOpened();
         if (isOpened)
@@ -53,26 +98,299 @@ namespace bias
     };
 
 
-    void VideoWriter_avi::addFrame(StampedImage stampedImg)
+    unsigned int VideoWriter_avi::getNextVersionNumber()
+    {
+        if (!isSegmented())
+        {
+            return VideoWriter::getNextVersionNumber();
+        }
+
+        // Segmented output - there is no <base>.avi so check for the manifest 
+        unsigned int nextVerNum = 0;
+        if (addVersionNumber_)
+        {
+            nextVerNum = 1;
+            while (QFileInfo(getManifestFileName(nextVerNum)).exists())
+            {
+                nextVerNum++;
+            }
+        }
+        return nextVerNum;
+    }
+
+
+    void VideoWriter_avi::prepare(StampedImage stampedImg)
     {
         if (isFirst_)
         {
             setupOutput(stampedImg);
             isFirst_ = false;
         }
+    }
+
+
+    void VideoWriter_avi::addFrame(StampedImage stampedImg)
+    {
+        prepare(stampedImg);
         if (frameCount_%frameSkip_==0)
         {
             //std::cout << "add frame: " << frameCount_ << std::endl;
-            videoWriter_ << stampedImg.image;
+            if (isSegmented())
+            {
+                addSegmentFrame(stampedImg);
+            }
+            else
+            {
+                videoWriter_ << stampedImg.image;
+            }
         }
         frameCount_++;
     }
 
 
+    FrameDrainPtr VideoWriter_avi::getFrameDrain() const
+    {
+        return frameDrainPtr_;
+    }
+
+
+    void VideoWriter_avi::finish()
+    {
+        if (!isSegmented() || isFirst_)
+        {
+            return;
+        }
+
+        // Close the last segment and wait for the encoders to work through
+        // their queues. Frames still queued at the finish timeout are dropped.
+        closeCurrentSegment();
+        unsigned long numberDroppedBefore = frameDrainPtr_ -> numberDropped();
+        bool drained = waitForFrameDrain(frameDrainPtr_, nullptr);
+        if (!drained)
+        {
+            dropQueuedFrames();
+        }
+        while (!(threadPoolPtr_ -> waitForDone(ENCODER_WAIT_TIMEOUT)));
+
+        indexFile_.close();
+        writeManifest(true);
+
+        if (!drained)
+        {
+            reportDroppedFrames(frameDrainPtr_ -> numberDropped() - numberDroppedBefore);
+        }
+    }
+
+
+    bool VideoWriter_avi::isSegmented() const
+    {
+        return numberOfEncoders_ > 1;
+    }
+
+
+    void VideoWriter_avi::setupSegments()
+    {
+        unsigned int verNum = getNextVersionNumber();
+        baseFileInfo_ = getFileInfo(verNum);
+        manifestFileName_ = getManifestFileName(verNum);
+        segmentInfoVec_.clear();
+        segmentQueuePtrVec_.clear();
+        frameDrainPtr_ -> reset();
+
+        QString indexName = QString("%1%2.%3").arg(baseFileInfo_.completeBaseName())
+            .arg(MANIFEST_TAG).arg(INDEX_EXT);
+        QString indexFileName = baseFileInfo_.absoluteDir().absoluteFilePath(indexName);
+        indexFile_.open(indexFileName.toStdString(), std::ios::out);
+        if (!indexFile_.is_open())
+        {
+            isFirst_ = false;
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            std::string errorMsg("video writer unable to open avi segment index file:\n\n"); 
+            errorMsg += indexFileName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+        indexFile_ << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+    }
+
+
+    void VideoWriter_avi::addSegmentFrame(StampedImage &stampedImg)
+    {
+        if (segmentInfoVec_.empty() || (segmentInfoVec_.back().numberOfFrames >= segmentFrames_))
+        {
+            startNextSegment(stampedImg);
+        }
+
+        // Frames buffered for all segments are bounded - skip when full
+        if (frameDrainPtr_ -> numberPending() >= maxQueueSize_)
+        {
+            frameDrainPtr_ -> frameSkipped();
+            if (!skipReported_)
+            {
+                std::cout << "warning: logging overflow - skipped frame -" << std::endl;
+                unsigned int errorId = ERROR_FRAMES_TODO_MAX_QUEUE_SIZE;
+                QString errorMsg("avi segment encoders have exceeded the maximum allowed queue size");
+                emit imageLoggingError(errorId, errorMsg);
+                skipReported_ = true;
+            }
+            return;
+        }
+
+        SegmentInfo &segmentInfo = segmentInfoVec_.back();
+        SegmentFrameQueuePtr_avi queuePtr = segmentQueuePtrVec_.back();
+
+        frameDrainPtr_ -> frameQueued();
+        queuePtr -> acquireLock();
+        queuePtr -> push(stampedImg);
+        queuePtr -> wakeOne();
+        queuePtr -> releaseLock();
+
+        if (segmentInfo.numberOfFrames == 0)
+        {
+            segmentInfo.firstFrameCount = stampedImg.frameCount;
+            segmentInfo.startTime = stampedImg.timeStamp;
+        }
+        segmentInfo.endTime = stampedImg.timeStamp;
+        indexFile_ << stampedImg.frameCount << " " << stampedImg.timeStamp << " ";
+        indexFile_ << segmentInfo.index << " " << segmentInfo.numberOfFrames << std::endl;
+        segmentInfo.numberOfFrames++;
+    }
+
+
+    void VideoWriter_avi::startNextSegment(StampedImage &stampedImg)
+    {
+        closeCurrentSegment();
+
+        SegmentInfo segmentInfo;
+        segmentInfo.index = (unsigned int)(segmentInfoVec_.size());
+        segmentInfo.fileName = getSegmentFileName(segmentInfo.index);
+        segmentInfo.firstFrameCount = stampedImg.frameCount;
+        segmentInfo.numberOfFrames = 0;
+        segmentInfo.startTime = stampedImg.timeStamp;
+        segmentInfo.endTime = stampedImg.timeStamp;
+        segmentInfoVec_.push_back(segmentInfo);
+
+        SegmentFrameQueuePtr_avi queuePtr = std::make_shared<SegmentFrameQueue_avi>();
+        segmentQueuePtrVec_.push_back(queuePtr);
+
+        // Encoders beyond the pool's thread count wait in the pool's queue,
+        // their frames are buffered until a thread frees up.
+        SegmentEncoder_avi *encoderPtr = new SegmentEncoder_avi(
+                segmentInfo.fileName,
+                fourcc_,
+                fps_,
+                size_,
+                isColor_,
+                queuePtr,
+                frameDrainPtr_,
+                videoWriterMutexPtr_,
+                cameraNumber_
+                );
+        connect(
+                encoderPtr,
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                this,
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                Qt::DirectConnection
+               );
+        threadPoolPtr_ -> start(encoderPtr);
+
+        writeManifest(false);
+    }
+
+
+    void VideoWriter_avi::closeCurrentSegment()
+    {
+        if (segmentQueuePtrVec_.empty())
+        {
+            return;
+        }
+        SegmentFrameQueuePtr_avi queuePtr = segmentQueuePtrVec_.back();
+        queuePtr -> acquireLock();
+        queuePtr -> close();
+        queuePtr -> signalNotEmpty();
+        queuePtr -> releaseLock();
+    }
+
+
+    void VideoWriter_avi::dropQueuedFrames()
+    {
+        unsigned long numberDropped = 0;
+        for (unsigned int i=0; i<segmentQueuePtrVec_.size(); i++)
+        {
+            SegmentFrameQueuePtr_avi queuePtr = segmentQueuePtrVec_[i];
+            queuePtr -> acquireLock();
+            numberDropped += queuePtr -> size();
+            queuePtr -> clear();
+            queuePtr -> close();
+            queuePtr -> signalNotEmpty();
+            queuePtr -> releaseLock();
+        }
+        frameDrainPtr_ -> frameDropped(numberDropped);
+    }
+
+
+    QString VideoWriter_avi::getSegmentFileName(unsigned int index)
+    {
+        QString segmentName = QString("%1%2%3.%4").arg(baseFileInfo_.completeBaseName())
+            .arg(SEGMENT_TAG).arg(index,4,10,QChar('0')).arg(baseFileInfo_.suffix());
+        return baseFileInfo_.absoluteDir().absoluteFilePath(segmentName);
+    }
+
+
+    QString VideoWriter_avi::getManifestFileName(unsigned int verNum)
+    {
+        QFileInfo fileInfo = getFileInfo(verNum);
+        QString manifestName = QString("%1%2.%3").arg(fileInfo.completeBaseName())
+            .arg(MANIFEST_TAG).arg(MANIFEST_EXT);
+        return fileInfo.absoluteDir().absoluteFilePath(manifestName);
+    }
+
+
+    void VideoWriter_avi::writeManifest(bool complete)
+    {
+        QVariantList segmentList;
+        for (unsigned int i=0; i<segmentInfoVec_.size(); i++)
+        {
+            SegmentInfo &segmentInfo = segmentInfoVec_[i];
+            QVariantMap segmentMap;
+            segmentMap.insert("index", segmentInfo.index);
+            segmentMap.insert("fileName", QFileInfo(segmentInfo.fileName).fileName());
+            segmentMap.insert("firstFrame", (unsigned long long)(segmentInfo.firstFrameCount));
+            segmentMap.insert("numberOfFrames", (unsigned long long)(segmentInfo.numberOfFrames));
+            segmentMap.insert("startTime", segmentInfo.startTime);
+            segmentMap.insert("endTime", segmentInfo.endTime);
+            segmentList.append(segmentMap);
+        }
+
+        QVariantMap manifestMap;
+        manifestMap.insert("baseName", baseFileInfo_.fileName());
+        manifestMap.insert("codec", fourccToString(fourcc_));
+        manifestMap.insert("fps", fps_);
+        manifestMap.insert("complete", complete);
+        manifestMap.insert("segments", segmentList);
+
+        bool ok = false;
+        QByteArray manifestJson = QtJson::serialize(manifestMap, ok);
+        if (!ok)
+        {
+            return;
+        }
+
+        QFile manifestFile(manifestFileName_);
+        if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+            QString errorMsg = QString("unable to write avi segment manifest %1").arg(manifestFileName_);
+            emit imageLoggingError(errorId, errorMsg);
+            return;
+        }
+        manifestFile.write(prettyIndentJson(manifestJson));
+        manifestFile.close();
+    }
+
+
     void VideoWriter_avi::setupOutput(StampedImage stampedImg)
     {
-        std::string incrFileName = getUniqueFileName().toStdString();
-        
         setSize(stampedImg.image.size());
 
         if (stampedImg.dtEstimate > MIN_ALLOWED_DT_ESTIMATE)
@@ -93,7 +411,16 @@ namespace bias
         {
             isColorImage = false;
         }
+        isColor_ = isColorImage;
+
+        if (isSegmented())
+        {
+            // Segment files are opened by their encoders
+            setupSegments();
+            return;
+        }
 
+        std::string incrFileName = getUniqueFileName().toStdString();
         bool openOK= true;
         
         videoWriterMutexPtr_ -> lock();
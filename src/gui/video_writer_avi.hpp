@@ -3,17 +3,31 @@
 
 #include "video_writer.hpp"
 #include "video_writer_params.hpp"
+#include "segment_encoder_avi.hpp"
+#include "frame_drain.hpp"
 #include <opencv2/highgui/highgui.hpp>
 #include <QString>
 #include <QStringList>
 #include <QMap>
 #include <QPointer>
 #include <QMutex>
+#include <QFileInfo>
+#include <vector>
+#include <fstream>
+
+class QThreadPool;
 
 namespace bias
 {
     class VideoWriter_avi : public VideoWriter
     {
+        // Avi video writer. With more than one encoder the stream is split 
+        // into fixed length segments <base>_part0000.avi, <base>_part0001.avi,
+        // ... which are encoded concurrently, each by its own cv::VideoWriter.
+        // Segments are listed in order in <base>_parts.json and the frame
+        // count and time stamp of every frame written are kept in 
+        // <base>_parts.txt.
+
         Q_OBJECT 
 
         public:
@@ -26,13 +40,26 @@ namespace bias
                     QObject *parent=0
                     );
             virtual ~VideoWriter_avi();
+            virtual unsigned int getNextVersionNumber();
+            virtual void prepare(StampedImage stampedImg);
             virtual void addFrame(StampedImage stampedImg);
+            virtual void finish();
+            virtual FrameDrainPtr getFrameDrain() const;
 
             // Static variables 
             static const int DEFAULT_FOURCC;
             static const double DEFAULT_FPS;
             static const double MIN_ALLOWED_DT_ESTIMATE;
             static const unsigned int DEFAULT_FRAME_SKIP;
+            static const unsigned int DEFAULT_NUMBER_OF_ENCODERS;
+            static const unsigned int MAX_NUMBER_OF_ENCODERS;
+            static const unsigned long DEFAULT_SEGMENT_FRAMES;
+            static const unsigned long MIN_SEGMENT_FRAMES;
+            static const unsigned int FRAMES_TODO_MAX_QUEUE_SIZE;
+            static const QString SEGMENT_TAG;
+            static const QString MANIFEST_TAG;
+            static const QString MANIFEST_EXT;
+            static const QString INDEX_EXT;
             static const VideoWriterParams_avi DEFAULT_PARAMS;
 
             // Static methods
@@ -45,12 +72,46 @@ namespace bias
 
         protected:
 
+            struct SegmentInfo
+            {
+                unsigned int index;
+                QString fileName;
+                unsigned long firstFrameCount;
+                unsigned long numberOfFrames;
+                double startTime;
+                double endTime;
+            };
+
             int fourcc_;
             double fps_;
             bool isFirst_;
+            bool isColor_;
+            bool skipReported_;
             cv::VideoWriter videoWriter_;
             void setupOutput(StampedImage stampedImage);
             static QMutex *videoWriterMutexPtr_;
+
+            // Segment parallel encoding
+            unsigned int numberOfEncoders_;
+            unsigned long segmentFrames_;
+            unsigned long maxQueueSize_;
+            QFileInfo baseFileInfo_;
+            QString manifestFileName_;
+            std::ofstream indexFile_;
+            std::vector<SegmentInfo> segmentInfoVec_;
+            std::vector<SegmentFrameQueuePtr_avi> segmentQueuePtrVec_;
+            FrameDrainPtr frameDrainPtr_;
+            QPointer<QThreadPool> threadPoolPtr_;
+
+            bool isSegmented() const;
+            void setupSegments();
+            void addSegmentFrame(StampedImage &stampedImg);
+            void startNextSegment(StampedImage &stampedImg);
+            void closeCurrentSegment();
+            void dropQueuedFrames();
+            QString getSegmentFileName(unsigned int index);
+            QString getManifestFileName(unsigned int verNum);
+            void writeManifest(bool complete);
             
     };
 
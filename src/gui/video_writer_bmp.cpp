@@ -5,6 +5,7 @@
 #include <QFileInfo>
 #include <stdexcept>
 #include <opencv2/highgui/highgui.hpp>
+#include <QThreadPool>
 #include <QtDebug>
 
 namespace bias
@@ -12,8 +13,21 @@ namespace bias
 
     const QString VideoWriter_bmp::IMAGE_FILE_BASE = QString("image_");
     const QString VideoWriter_bmp::IMAGE_FILE_EXT = QString(".bmp");
+    const QString VideoWriter_bmp::SHARD_DIR_BASE = QString("frames_");
+    const QString VideoWriter_bmp::IMAGE_FORMAT_BMP = QString("bmp");
+    const QString VideoWriter_bmp::IMAGE_FORMAT_PNG = QString("png");
+    const QString VideoWriter_bmp::IMAGE_FORMAT_TIF = QString("tif");
+    const QString VideoWriter_bmp::DEFAULT_IMAGE_FORMAT = VideoWriter_bmp::IMAGE_FORMAT_BMP;
     const QString DUMMY_FILENAME("dummy.bmp");
+    const int WRITER_WAIT_TIMEOUT = 10;  // msec
     const unsigned int VideoWriter_bmp::DEFAULT_FRAME_SKIP = 1;
+    const unsigned int VideoWriter_bmp::DEFAULT_NUMBER_OF_WRITERS = 4;
+    const unsigned int VideoWriter_bmp::MAX_NUMBER_OF_WRITERS = 32;
+    const unsigned int VideoWriter_bmp::DEFAULT_FRAMES_PER_DIRECTORY = 0;
+    const int VideoWriter_bmp::DEFAULT_COMPRESSION_LEVEL = 1;
+    const int VideoWriter_bmp::MIN_COMPRESSION_LEVEL = 0;
+    const int VideoWriter_bmp::MAX_COMPRESSION_LEVEL = 9;
+    const unsigned int VideoWriter_bmp::FRAMES_TODO_MAX_QUEUE_SIZE = 250;
     const VideoWriterParams_bmp VideoWriter_bmp::DEFAULT_PARAMS = 
         VideoWriterParams_bmp();
 
@@ -30,10 +44,44 @@ namespace bias
             ) : VideoWriter(fileName,cameraNumber,parent) 
     {
         isFirst_ = true;
+        skipReported_ = false;
+        currentShard_ = 0;
         setFrameSkip(params.frameSkip);
+
+        imageFormat_ = params.imageFormat;
+        if (!isAllowedImageFormat(imageFormat_))
+        {
+            imageFormat_ = DEFAULT_IMAGE_FORMAT;
+        }
+        compressionLevel_ = params.compressionLevel;
+        numberOfWriters_ = params.numberOfWriters;
+        framesPerDirectory_ = params.framesPerDirectory;
+        fileNameExt_ = (QString(".") + imageFormat_).toStdString();
+
+        threadPoolPtr_ = new QThreadPool(this);
+        threadPoolPtr_ -> setMaxThreadCount(numberOfWriters_ > 0 ? numberOfWriters_ : 1);
+        jobQueuePtr_ = std::make_shared<ImageFileJobQueue>();
+        frameDrainPtr_ = std::make_shared<FrameDrain>();
+    }
+
+    VideoWriter_bmp::~VideoWriter_bmp() 
+    {
+        stopWriters();
     }
 
-    VideoWriter_bmp::~VideoWriter_bmp() {}
+
+    QStringList VideoWriter_bmp::getListOfAllowedImageFormats()
+    {
+        QStringList imageFormatList;
+        imageFormatList << IMAGE_FORMAT_BMP << IMAGE_FORMAT_PNG << IMAGE_FORMAT_TIF;
+        return imageFormatList;
+    }
+
+
+    bool VideoWriter_bmp::isAllowedImageFormat(QString imageFormat)
+    {
+        return getListOfAllowedImageFormats().contains(imageFormat);
+    }
 
 
     void VideoWriter_bmp::setFileName(QString fileName)
@@ -44,37 +92,115 @@ namespace bias
         baseDir_ = fileInfo.dir();
     }
 
-    void VideoWriter_bmp::addFrame(StampedImage stampedImg)
+    void VideoWriter_bmp::prepare(StampedImage stampedImg)
     {
         if (isFirst_)
         {
             setupOutput();
+            setupShard(0);
+            startWriters();
             isFirst_= false;
         }
+    }
+
+
+    void VideoWriter_bmp::addFrame(StampedImage stampedImg)
+    {
+        bool skipFrame = false;
+
+        prepare(stampedImg);
 
-        QString imageFileName = IMAGE_FILE_BASE;  
-        imageFileName += QString::number(frameCount_);
-        imageFileName += IMAGE_FILE_EXT;
-        QFileInfo imageFileInfo(logDir_,imageFileName);
-        QString fullPathName = imageFileInfo.absoluteFilePath();
         if (frameCount_%frameSkip_==0) 
         {
-            try
+            if ((framesPerDirectory_ > 0) && (frameCount_/framesPerDirectory_ != currentShard_))
             {
-                cv::imwrite(fullPathName.toStdString(), stampedImg.image);
+                setupShard(frameCount_/framesPerDirectory_);
             }
-            catch (cv::Exception &exc)
+            std::string fileName = fileNamePrefix_ + std::to_string(frameCount_) + fileNameExt_;
+
+            if (numberOfWriters_ == 0)
             {
-                unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
-                std::string errorMsg("adding frame failed - "); 
-                errorMsg += exc.what();
-                throw RuntimeError(errorId, errorMsg);
+                // Synchronous write on the logging thread
+                try
+                {
+                    cv::imwrite(fileName, stampedImg.image, getImwriteParams());
+                    QFileInfo fileInfo(QString::fromStdString(fileName));
+                    frameDrainPtr_ -> addBytesWritten((unsigned long long)(fileInfo.size()));
+                }
+                catch (cv::Exception &exc)
+                {
+                    unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+                    std::string errorMsg("adding frame failed - "); 
+                    errorMsg += exc.what();
+                    throw RuntimeError(errorId, errorMsg);
+                }
             }
+            else
+            {
+                jobQueuePtr_ -> acquireLock();
+                if (jobQueuePtr_ -> size() < FRAMES_TODO_MAX_QUEUE_SIZE)
+                {
+                    ImageFileJob job;
+                    job.fileName = fileName;
+                    job.stampedImg = stampedImg;
+                    frameDrainPtr_ -> frameQueued();
+                    jobQueuePtr_ -> push(job);
+                    jobQueuePtr_ -> wakeOne();
+                }
+                else
+                {
+                    frameDrainPtr_ -> frameSkipped();
+                    skipFrame = true;
+                }
+                jobQueuePtr_ -> releaseLock();
+            }
+        }
+
+        if ((skipFrame) && (!skipReported_))
+        {
+            std::cout << "warning: logging overflow - skipped frame -" << std::endl;
+            unsigned int errorId = ERROR_FRAMES_TODO_MAX_QUEUE_SIZE;
+            QString errorMsg("logger image file queue has exceeded the maximum allowed size");
+            emit imageLoggingError(errorId, errorMsg);
+            skipReported_ = true;
         }
 
         frameCount_++;
     }
 
+
+    FrameDrainPtr VideoWriter_bmp::getFrameDrain() const
+    {
+        return frameDrainPtr_;
+    }
+
+
+    unsigned long long VideoWriter_bmp::getBytesWritten()
+    {
+        // Output is a directory of images - use the running count rather 
+        // than walking the directory
+        return frameDrainPtr_ -> numberBytesWritten();
+    }
+
+
+    void VideoWriter_bmp::finish()
+    {
+        // Wait for the writers to work through the queued images. Images still
+        // queued when the finish timeout expires are dropped.
+        unsigned long numberDroppedBefore = frameDrainPtr_ -> numberDropped();
+        bool drained = waitForFrameDrain(frameDrainPtr_, nullptr);
+        if (!drained)
+        {
+            dropQueuedJobs();
+        }
+        stopWriters();
+
+        if (!drained)
+        {
+            reportDroppedFrames(frameDrainPtr_ -> numberDropped() - numberDroppedBefore);
+        }
+    }
+
     unsigned int VideoWriter_bmp::getNextVersionNumber()
     {
         unsigned int nextVerNum = 0;
@@ -140,6 +266,119 @@ namespace bias
 
     }
 
+
+    void VideoWriter_bmp::setupShard(unsigned long shard)
+    {
+        // Without sharding all images go directly in the log directory
+        if (framesPerDirectory_ == 0)
+        {
+            QString prefix = logDir_.absolutePath() + "/" + IMAGE_FILE_BASE;
+            fileNamePrefix_ = prefix.toStdString();
+            currentShard_ = 0;
+            return;
+        }
+
+        // Create this shard's directory (if not created ahead of time) and the
+        // next one so the directory is ready before its first frame arrives.
+        for (unsigned long i=shard; i<=shard+1; i++)
+        {
+            QString shardDirName = getShardDirName(i);
+            if (!logDir_.exists(shardDirName) && !logDir_.mkdir(shardDirName))
+            {
+                unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+                std::string errorMsg("unable to create image directory, "); 
+                errorMsg += logDir_.absoluteFilePath(shardDirName).toStdString();
+                throw RuntimeError(errorId, errorMsg);
+            }
+        }
+
+        QString prefix = logDir_.absoluteFilePath(getShardDirName(shard)) + "/" + IMAGE_FILE_BASE;
+        fileNamePrefix_ = prefix.toStdString();
+        currentShard_ = shard;
+    }
+
+
+    QString VideoWriter_bmp::getShardDirName(unsigned long shard)
+    {
+        return SHARD_DIR_BASE + QString("%1").arg(shard,6,10,QChar('0'));
+    }
+
+
+    std::vector<int> VideoWriter_bmp::getImwriteParams()
+    {
+        std::vector<int> imwriteParams;
+        if (imageFormat_ == IMAGE_FORMAT_PNG)
+        {
+            imwriteParams.push_back(cv::IMWRITE_PNG_COMPRESSION);
+            imwriteParams.push_back(compressionLevel_);
+        }
+        else if (imageFormat_ == IMAGE_FORMAT_TIF)
+        {
+            // libtiff compression scheme: 1 = none, 5 = LZW
+            imwriteParams.push_back(cv::IMWRITE_TIFF_COMPRESSION);
+            imwriteParams.push_back(compressionLevel_ > 0 ? 5 : 1);
+        }
+        return imwriteParams;
+    }
+
+
+    void VideoWriter_bmp::startWriters()
+    {
+        jobQueuePtr_ -> clear();
+        writerPtrVec_.resize(numberOfWriters_);
+        std::vector<int> imwriteParams = getImwriteParams();
+        for (unsigned int i=0; i<writerPtrVec_.size(); i++)
+        {
+            writerPtrVec_[i] = new ImageFileWriter(jobQueuePtr_, frameDrainPtr_, imwriteParams, cameraNumber_);
+            connect(
+                    writerPtrVec_[i],
+                    SIGNAL(imageLoggingError(unsigned int, QString)),
+                    this,
+                    SIGNAL(imageLoggingError(unsigned int, QString)),
+                    Qt::DirectConnection
+                   );
+            threadPoolPtr_ -> start(writerPtrVec_[i]);
+        }
+    }
+
+
+    void VideoWriter_bmp::stopWriters()
+    {
+        // Writers drain the job queue before exiting
+        for (unsigned int i=0; i<writerPtrVec_.size(); i++)
+        {
+            if (!(writerPtrVec_[i].isNull()))
+            {
+                writerPtrVec_[i] -> acquireLock();
+                writerPtrVec_[i] -> stop();
+                writerPtrVec_[i] -> releaseLock();
+            }
+        }
+
+        if (threadPoolPtr_.isNull())
+        {
+            return;
+        }
+        while (!(threadPoolPtr_ -> waitForDone(WRITER_WAIT_TIMEOUT)))
+        {
+            jobQueuePtr_ -> acquireLock();
+            jobQueuePtr_ -> signalNotEmpty();
+            jobQueuePtr_ -> releaseLock();
+        }
+        writerPtrVec_.clear();
+    }
+
+
+    void VideoWriter_bmp::dropQueuedJobs()
+    {
+        jobQueuePtr_ -> acquireLock();
+        unsigned long numberDropped = jobQueuePtr_ -> size();
+        jobQueuePtr_ -> clear();
+        jobQueuePtr_ -> releaseLock();
+        frameDrainPtr_ -> frameDropped(numberDropped);
+    }
+
+
     QString VideoWriter_bmp::getUniqueDirName()
     {
         unsigned int nextVerNum = getNextVersionNumber();
@@ -2,9 +2,15 @@
 #define BIAS_VIDEO_WRITER_BMP_HPP
 #include "video_writer.hpp"
 #include "video_writer_params.hpp"
+#include "image_file_writer.hpp"
 #include <QDir>
 #include <QString>
+#include <QStringList>
+#include <QPointer>
 #include <vector>
+#include <string>
+
+class QThreadPool;
 
 namespace bias
 {
@@ -23,21 +29,63 @@ namespace bias
                     );
             virtual ~VideoWriter_bmp();
             virtual void setFileName(QString fileName);
+            virtual void prepare(StampedImage stampedImg);
             virtual void addFrame(StampedImage stampedImg);
             virtual unsigned int getNextVersionNumber();
+            virtual void finish();
+            virtual FrameDrainPtr getFrameDrain() const;
+            virtual unsigned long long getBytesWritten();
+
+            static QStringList getListOfAllowedImageFormats();
+            static bool isAllowedImageFormat(QString imageFormat);
 
             static const QString IMAGE_FILE_BASE;
             static const QString IMAGE_FILE_EXT;
+            static const QString SHARD_DIR_BASE;
+            static const QString IMAGE_FORMAT_BMP;
+            static const QString IMAGE_FORMAT_PNG;
+            static const QString IMAGE_FORMAT_TIF;
+            static const QString DEFAULT_IMAGE_FORMAT;
             static const unsigned int DEFAULT_FRAME_SKIP;
+            static const unsigned int DEFAULT_NUMBER_OF_WRITERS;
+            static const unsigned int MAX_NUMBER_OF_WRITERS;
+            static const unsigned int DEFAULT_FRAMES_PER_DIRECTORY;
+            static const int DEFAULT_COMPRESSION_LEVEL;
+            static const int MIN_COMPRESSION_LEVEL;
+            static const int MAX_COMPRESSION_LEVEL;
+            static const unsigned int FRAMES_TODO_MAX_QUEUE_SIZE;
             static const VideoWriterParams_bmp DEFAULT_PARAMS;
 
         protected:
 
             bool isFirst_;
+            bool skipReported_;
             QDir baseDir_;
             QDir logDir_;
             QString baseName_;
+
+            QString imageFormat_;
+            int compressionLevel_;
+            unsigned int numberOfWriters_;
+            unsigned int framesPerDirectory_;
+
+            // Precomputed file name parts: prefix + frame number + ext 
+            std::string fileNamePrefix_;
+            std::string fileNameExt_;
+            unsigned long currentShard_;
+
+            std::vector<QPointer<ImageFileWriter>> writerPtrVec_;
+            ImageFileJobQueuePtr jobQueuePtr_;
+            FrameDrainPtr frameDrainPtr_;
+            QPointer<QThreadPool> threadPoolPtr_;
+
             void setupOutput();
+            void setupShard(unsigned long shard);
+            QString getShardDirName(unsigned long shard);
+            std::vector<int> getImwriteParams();
+            void startWriters();
+            void stopWriters();
+            void dropQueuedJobs();
             QString getUniqueDirName();
             QString getLogDirName(unsigned int verNum);
             QDir getLogDir(unsigned int verNum);
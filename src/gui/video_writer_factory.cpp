@@ -0,0 +1,114 @@
+#include "video_writer_factory.hpp"
+#include "video_writer.hpp"
+#include "video_writer_bmp.hpp"
+#include "video_writer_jpg.hpp"
+#include "video_writer_avi.hpp"
+#include "video_writer_fmf.hpp"
+#include "video_writer_ufmf.hpp"
+#include "video_writer_zfmf.hpp"
+
+namespace bias
+{
+
+    std::shared_ptr<VideoWriter> createVideoWriter(
+            VideoFileFormat videoFileFormat,
+            VideoWriterParams videoWriterParams,
+            QString fileName,
+            unsigned int cameraNumber
+            )
+    {
+        // Create video writer based on video file format type
+        std::shared_ptr<VideoWriter> videoWriterPtr; 
+
+        switch (videoFileFormat)
+        {
+            case VIDEOFILE_FORMAT_BMP:
+                videoWriterPtr = std::make_shared<VideoWriter_bmp>(
+                        videoWriterParams.bmp,
+                        fileName,
+                        cameraNumber
+                        );
+                break;
+
+            case VIDEOFILE_FORMAT_JPG:
+                videoWriterPtr = std::make_shared<VideoWriter_jpg>(
+                        videoWriterParams.jpg,
+                        fileName,
+                        cameraNumber
+                        );
+                break;
+
+            case VIDEOFILE_FORMAT_AVI:  
+                videoWriterPtr = std::make_shared<VideoWriter_avi>(
+                        videoWriterParams.avi,
+                        fileName,
+                        cameraNumber
+                        );
+                break;
+
+            case VIDEOFILE_FORMAT_FMF:
+                videoWriterPtr = std::make_shared<VideoWriter_fmf>(
+                        videoWriterParams.fmf,
+                        fileName,
+                        cameraNumber
+                        );
+                break;
+
+            case VIDEOFILE_FORMAT_UFMF:
+                videoWriterPtr = std::make_shared<VideoWriter_ufmf>(
+                        videoWriterParams.ufmf,
+                        fileName,
+                        cameraNumber
+                        );
+                break;
+
+            case VIDEOFILE_FORMAT_ZFMF:
+                videoWriterPtr = std::make_shared<VideoWriter_zfmf>(
+                        videoWriterParams.zfmf,
+                        fileName,
+                        cameraNumber
+                        );
+                break;
+
+            default:
+                videoWriterPtr = std::make_shared<VideoWriter>(
+                        fileName,
+                        cameraNumber
+                        );
+                break;
+
+        } // switch (videoFileFormat) 
+
+        videoWriterPtr -> setFinishTimeout(videoWriterParams.finishTimeout);
+        return videoWriterPtr;
+    }
+
+
+    QMap<VideoFileFormat, QString> getVideoFileExtensionMap()
+    {
+        QMap<VideoFileFormat, QString> map;
+        map.insert(VIDEOFILE_FORMAT_BMP,  QString("bmp"));
+        map.insert(VIDEOFILE_FORMAT_JPG,  QString("jpg"));
+        map.insert(VIDEOFILE_FORMAT_AVI,  QString("avi"));
+        map.insert(VIDEOFILE_FORMAT_FMF,  QString("fmf"));
+        map.insert(VIDEOFILE_FORMAT_UFMF, QString("ufmf"));
+        map.insert(VIDEOFILE_FORMAT_ZFMF, QString("zfmf"));
+        return map;
+    }
+
+
+    VideoFileFormat getVideoFileFormatFromExtension(QString extension)
+    {
+        QMap<VideoFileFormat, QString> extensionMap = getVideoFileExtensionMap();
+        QMap<VideoFileFormat, QString>::iterator it;
+        for (it=extensionMap.begin(); it!=extensionMap.end(); it++)
+        {
+            if (it.value() == extension.toLower())
+            {
+                return it.key();
+            }
+        }
+        return VIDEOFILE_FORMAT_UNSPECIFIED;
+    }
+
+} // namespace bias
@@ -0,0 +1,29 @@
+#ifndef BIAS_VIDEO_WRITER_FACTORY_HPP
+#define BIAS_VIDEO_WRITER_FACTORY_HPP
+#include "basic_types.hpp"
+#include "video_writer_params.hpp"
+#include <QMap>
+#include <QString>
+#include <memory>
+
+namespace bias
+{
+    class VideoWriter;
+
+    // Creates the video writer for the given file format. Shared by the
+    // camera window and the command line tools.
+    std::shared_ptr<VideoWriter> createVideoWriter(
+            VideoFileFormat videoFileFormat,
+            VideoWriterParams videoWriterParams,
+            QString fileName,
+            unsigned int cameraNumber
+            );
+
+    QMap<VideoFileFormat, QString> getVideoFileExtensionMap();
+
+    // Returns VIDEOFILE_FORMAT_UNSPECIFIED for unknown extensions
+    VideoFileFormat getVideoFileFormatFromExtension(QString extension);
+
+} // namespace bias
+
+#endif // #ifndef BIAS_VIDEO_WRITER_FACTORY_HPP
@@ -1,6 +1,7 @@
 #include "video_writer_fmf.hpp"
 #include "basic_types.hpp"
 #include "exception.hpp"
+#include "utils.hpp"
 #include <iostream>
 #include <stdint.h>
 #include <stdexcept>
@@ -9,6 +10,7 @@ namespace bias
 {
     const unsigned int VideoWriter_fmf::DEFAULT_FRAME_SKIP = 1;
     const unsigned int VideoWriter_fmf::FMF_VERSION = 1;
+    const unsigned int VideoWriter_fmf::FMF_BAYER_VERSION = 3;
     const QString DUMMY_FILENAME("dummy.fmf");
     const VideoWriterParams_fmf VideoWriter_fmf::DEFAULT_PARAMS =
         VideoWriterParams_fmf();
@@ -25,6 +27,7 @@ namespace bias
             ) : VideoWriter(fileName, cameraNumber, parent)
     {
         numWritten_ = 0;
+        numWrittenPos_ = 20;
         isFirst_ = true;
         setFrameSkip(params.frameSkip);
     }
@@ -38,7 +41,7 @@ namespace bias
     {
         try
         {
-            file_.seekp(20);
+            file_.seekp(numWrittenPos_);
             file_.write((char*) &numWritten_, sizeof(uint64_t));
         }
         catch (std::ifstream::failure &exc)
@@ -51,19 +54,25 @@ namespace bias
         }
     }
 
-    void VideoWriter_fmf::addFrame(StampedImage stampedImg)
+    void VideoWriter_fmf::prepare(StampedImage stampedImg)
     {
         if (isFirst_)
         {
             setupOutput(stampedImg);
             isFirst_ = false;
         }
+    }
+
+
+    void VideoWriter_fmf::addFrame(StampedImage stampedImg)
+    {
+        prepare(stampedImg);
         if (frameCount_%frameSkip_==0)
         {
             try
             {
                 file_.write((char*) &stampedImg.timeStamp, sizeof(double));
-                file_.write((char*) stampedImg.image.data, size_.width*size_.height*sizeof(char)); 
+                file_.write((char*) stampedImg.image.data, size_.width*size_.height*stampedImg.image.elemSize()); 
             }
             catch (std::ifstream::failure &exc)
             {
@@ -83,7 +92,8 @@ namespace bias
 
     void VideoWriter_fmf::setupOutput(StampedImage stampedImg)
     {
-        // Check image format - must be CV_8UC1
+        // Check image format - must be CV_8UC1, raw Bayer frames may also be CV_16UC1
+        bool isBayer = (bayerPattern_ != BAYER_PATTERN_NONE);
         if (stampedImg.image.channels() != 1)
         {
             unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
@@ -92,11 +102,12 @@ namespace bias
             throw RuntimeError(errorId,errorMsg);
         }
 
-        if (stampedImg.image.depth() != CV_8U)
+        bool isRaw16 = isBayer && (stampedImg.image.depth() == CV_16U);
+        if ((stampedImg.image.depth() != CV_8U) && !isRaw16)
         {
             unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
             std::string errorMsg("video writer fmf setup failed:\n\n"); 
-            errorMsg += "image depth must be CV_8U";
+            errorMsg += "image depth must be CV_8U (or CV_16U for raw Bayer frames)";
             throw RuntimeError(errorId,errorMsg);
         }
 
@@ -129,19 +140,31 @@ namespace bias
 
         setSize(stampedImg.image.size());
 
-        // Cast values to integers with specific widths
-        uint32_t fmfVersion = uint32_t(FMF_VERSION);
+        // Cast values to integers with specific widths. Raw Bayer images use
+        // the version 3 header which carries the format string and the bits 
+        // per pixel, e.g. RAW8:RGGB or RAW16:RGGB (two bytes, host order).
+        uint32_t fmfVersion = uint32_t(isBayer ? FMF_BAYER_VERSION : FMF_VERSION);
+        std::string formatString = std::string(isRaw16 ? "RAW16:" : "RAW8:") + getBayerPatternString(bayerPattern_);
+        uint32_t formatLength = uint32_t(formatString.size());
+        uint32_t bitsPerPixel = uint32_t(8*stampedImg.image.elemSize());
         uint32_t width = uint32_t(size_.width);
         uint32_t height = uint32_t(size_.height);
-        uint64_t bytesPerChunk = uint64_t(width)*uint64_t(height) + sizeof(double);
+        uint64_t bytesPerChunk = uint64_t(width)*uint64_t(height)*stampedImg.image.elemSize() + sizeof(double);
 
         // Add fmf header to file
         try 
         {
             file_.write((char*) &fmfVersion, sizeof(uint32_t));
+            if (isBayer)
+            {
+                file_.write((char*) &formatLength, sizeof(uint32_t));
+                file_.write(formatString.data(), formatLength);
+                file_.write((char*) &bitsPerPixel, sizeof(uint32_t));
+            }
             file_.write((char*) &height, sizeof(uint32_t));
             file_.write((char*) &width, sizeof(uint32_t));
             file_.write((char*) &bytesPerChunk, sizeof(uint64_t));
+            numWrittenPos_ = file_.tellp();
             file_.write((char*) &numWritten_, sizeof(uint64_t));
         }
         catch (std::ifstream::failure &exc)
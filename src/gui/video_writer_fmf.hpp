@@ -21,16 +21,19 @@ namespace bias
                     );
             ~VideoWriter_fmf();
             virtual void finish();
+            virtual void prepare(StampedImage stampedImg);
             virtual void addFrame(StampedImage stampedImg);
 
             static const unsigned int DEFAULT_FRAME_SKIP;
             static const unsigned int FMF_VERSION;
+            static const unsigned int FMF_BAYER_VERSION;
             static const VideoWriterParams_fmf DEFAULT_PARAMS;
 
         private:
             bool isFirst_;
             std::fstream file_;
             uint64_t numWritten_;
+            std::streampos numWrittenPos_;
             void setupOutput(StampedImage stampImg);
     };
 
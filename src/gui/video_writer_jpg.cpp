@@ -7,9 +7,11 @@
 #include <limits>
 #include <QFileInfo>
 #include <QThreadPool>
+#include <QThread>
 #include <stdexcept>
 #include <opencv2/highgui/highgui.hpp>
 #include <vector>
+#include <algorithm>
 #include <QtDebug>
 
 namespace bias
@@ -22,6 +24,7 @@ namespace bias
     const QString VideoWriter_jpg::MJPG_INDEX_NAME = QString("index");
     const std::string VideoWriter_jpg::MJPG_BOUNDARY_MARKER = std::string("--boundary\r\n");
     const QString DUMMY_FILENAME("dummy.jpg");
+    const int COMPRESSOR_WAIT_TIMEOUT = 10;  // msec
     const unsigned int VideoWriter_jpg::FRAMES_TODO_MAX_QUEUE_SIZE = 250;
     const unsigned int VideoWriter_jpg::FRAMES_FINISHED_MAX_SET_SIZE = 250;
     const unsigned int VideoWriter_jpg::DEFAULT_FRAME_SKIP = 1;
@@ -29,6 +32,9 @@ namespace bias
     const unsigned int VideoWriter_jpg::MIN_QUALITY = 0;
     const unsigned int VideoWriter_jpg::MAX_QUALITY = 100;
     const unsigned int VideoWriter_jpg::DEFAULT_NUMBER_OF_COMPRESSORS = 10;
+    const unsigned int VideoWriter_jpg::DEFAULT_NUMBER_OF_SLICES = 1;
+    const unsigned int VideoWriter_jpg::MIN_NUMBER_OF_SLICES = 1;
+    const unsigned int VideoWriter_jpg::MAX_NUMBER_OF_SLICES = 64;
     const bool VideoWriter_jpg::DEFAULT_MJPG_FLAG = true;
     const bool VideoWriter_jpg::DEFAULT_MJPG_MAX_FRAME_PER_FILE_FLAG = false;
     const unsigned long VideoWriter_jpg::DEFAULT_MJPG_MAX_FRAME_PER_FILE = 5000000;
@@ -62,12 +68,14 @@ namespace bias
         mjpgMaxFramePerFileFlag_ = params.mjpgMaxFramePerFileFlag;
         mjpgMaxFramePerFile_ = params.mjpgMaxFramePerFile;
         numberOfCompressors_ = params.numberOfCompressors; 
+        numberOfSlices_ = params.numberOfSlices;
 
         threadPoolPtr_ = new QThreadPool(this);
         threadPoolPtr_ -> setMaxThreadCount(numberOfCompressors_);
         framesToDoQueuePtr_ = std::make_shared<CompressedFrameQueue_jpg>();
         framesFinishedSetPtr_ = std::make_shared<CompressedFrameSet_jpg>();
         framesSkippedIndexListPtr_ = std::make_shared<Lockable<std::list<unsigned long>>>();
+        frameDrainPtr_ = std::make_shared<FrameDrain>();
     }
 
 
@@ -90,16 +98,22 @@ namespace bias
         baseDir_ = fileInfo.dir();
     }
 
-    void VideoWriter_jpg::addFrame(StampedImage stampedImg)
+    void VideoWriter_jpg::prepare(StampedImage stampedImg)
     {
-        bool skipFrame = false;
-
         if (isFirst_)
         {
             setupOutput();
             startCompressors();
             isFirst_= false;
         }
+    }
+
+
+    void VideoWriter_jpg::addFrame(StampedImage stampedImg)
+    {
+        bool skipFrame = false;
+
+        prepare(stampedImg);
 
         QString imageFileName = IMAGE_FILE_BASE;  
         imageFileName += QString::number(frameCount_);
@@ -117,6 +131,7 @@ namespace bias
             if (framesToDoQueueSize < FRAMES_TODO_MAX_QUEUE_SIZE)
             {
                 CompressedFrame_jpg compressedFrame(fullPathName, stampedImg, quality_, mjpgFlag_);
+                frameDrainPtr_ -> frameQueued();
                 framesToDoQueuePtr_ -> push(compressedFrame);
                 framesToDoQueuePtr_ -> wakeOne();
             }
@@ -128,6 +143,7 @@ namespace bias
 
             if (skipFrame)
             {
+                frameDrainPtr_ -> frameSkipped();
                 framesSkippedIndexListPtr_ -> acquireLock();
                 framesSkippedIndexListPtr_ -> push_back(stampedImg.frameCount);
                 framesSkippedIndexListPtr_ -> releaseLock();
@@ -153,19 +169,43 @@ namespace bias
     }
 
 
+    FrameDrainPtr VideoWriter_jpg::getFrameDrain() const
+    {
+        return frameDrainPtr_;
+    }
+
+
+    unsigned long long VideoWriter_jpg::getBytesWritten()
+    {
+        // Output is a directory of images - use the running count rather 
+        // than walking the directory
+        return frameDrainPtr_ -> numberBytesWritten();
+    }
+
+
     void VideoWriter_jpg::finish()
     {
-        bool finished = false;
-        while (!finished)
+        if (isFirst_)
         {
-            framesToDoQueuePtr_ -> acquireLock();
-            if ( (framesToDoQueuePtr_ -> size()) == 0)
-            {
-                finished = true;
-            }
-            framesToDoQueuePtr_ -> releaseLock();
+            return;
+        }
+
+        // Wait for the compressors to work through the queued frames, writing
+        // finished frames as they arrive, then shut them down. Frames still 
+        // queued when the finish timeout expires are dropped.
+        unsigned long numberDroppedBefore = frameDrainPtr_ -> numberDropped();
+        bool drained = waitForFrameDrain(frameDrainPtr_, [this]() { clearFinishedFrames(); });
+        if (!drained)
+        {
+            dropQueuedFrames();
+        }
+        stopCompressors();
+        flushFinishedFrames();
+
+        if (!drained)
+        {
+            reportDroppedFrames(frameDrainPtr_ -> numberDropped() - numberDroppedBefore);
         }
-        while (clearFinishedFrames() > 0);
     }
 
 
@@ -308,6 +348,12 @@ namespace bias
 
     void VideoWriter_jpg::startCompressors()
     {
+        // Each compressor encodes its slices in parallel - cap the slices so
+        // the compressors don't oversubscribe the cores between them
+        unsigned int numberOfCores = (unsigned int)(std::max(QThread::idealThreadCount(), 1));
+        unsigned int maxSlices = std::max(numberOfCores/std::max(numberOfCompressors_, 1u), 1u);
+        unsigned int numberOfSlices = std::min(numberOfSlices_, maxSlices);
+
         framesToDoQueuePtr_ -> clear();
         compressorPtrVec_.resize(numberOfCompressors_);
         for (unsigned int i=0; i<compressorPtrVec_.size(); i++)
@@ -316,14 +362,17 @@ namespace bias
                     framesToDoQueuePtr_, 
                     framesFinishedSetPtr_, 
                     framesSkippedIndexListPtr_, 
+                    frameDrainPtr_,
                     cameraNumber_
                     );
+            compressorPtrVec_[i] -> setNumberOfSlices(numberOfSlices);
             threadPoolPtr_ -> start(compressorPtrVec_[i]);
             connect(
                     compressorPtrVec_[i],
                     SIGNAL(imageLoggingError(unsigned int, QString)),
                     this,
-                    SLOT(onCompressorError(unsigned int, QString))
+                    SLOT(onCompressorError(unsigned int, QString)),
+                    Qt::DirectConnection
                    );
         }
     }
@@ -342,15 +391,47 @@ namespace bias
             }
         }
 
-        // Wait until all compressor threads are null
-        for (unsigned int i=0; i<compressorPtrVec_.size(); i++)
+        // Wait for the compressor threads to exit - blocking, waking any which 
+        // are still waiting on the empty queue.
+        while (!(threadPoolPtr_ -> waitForDone(COMPRESSOR_WAIT_TIMEOUT)))
         {
-            while (!(compressorPtrVec_[i].isNull()))
-            {
-                framesToDoQueuePtr_ -> acquireLock();
-                framesToDoQueuePtr_ -> wakeOne();
-                framesToDoQueuePtr_ -> releaseLock();
-            }
+            framesToDoQueuePtr_ -> acquireLock();
+            framesToDoQueuePtr_ -> signalNotEmpty();
+            framesToDoQueuePtr_ -> releaseLock();
+        }
+    }
+
+
+    void VideoWriter_jpg::dropQueuedFrames()
+    {
+        // Discard frames still waiting for a compressor. They are marked as
+        // skipped so that writing can continue past them.
+        unsigned long numberDropped = 0;
+        framesToDoQueuePtr_ -> acquireLock();
+        framesSkippedIndexListPtr_ -> acquireLock();
+        while (!(framesToDoQueuePtr_ -> empty()))
+        {
+            framesSkippedIndexListPtr_ -> push_back(framesToDoQueuePtr_ -> front().getFrameCount());
+            framesToDoQueuePtr_ -> pop();
+            numberDropped++;
+        }
+        framesSkippedIndexListPtr_ -> releaseLock();
+        framesToDoQueuePtr_ -> releaseLock();
+        frameDrainPtr_ -> frameDropped(numberDropped);
+    }
+
+
+    void VideoWriter_jpg::flushFinishedFrames()
+    {
+        // Compressors have stopped - any gap left in the finished set is a 
+        // frame which will never arrive so write what remains in order. 
+        unsigned int framesFinishedSetSize = clearFinishedFrames();
+        while (framesFinishedSetSize > 0)
+        {
+            framesFinishedSetPtr_ -> acquireLock();
+            nextFrameToWrite_ = framesFinishedSetPtr_ -> begin() -> getFrameCount();
+            framesFinishedSetPtr_ -> releaseLock();
+            framesFinishedSetSize = clearFinishedFrames();
         }
     }
 
@@ -459,6 +540,7 @@ namespace bias
             ss << frameEndPos            << std::endl;;
             std::string indexData = ss.str();
             indexFile_.write(indexData.c_str(), indexData.size());
+            frameDrainPtr_ -> addBytesWritten(MJPG_BOUNDARY_MARKER.size() + jpgBuffer.size() + indexData.size());
         }
     }
 
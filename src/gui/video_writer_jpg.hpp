@@ -35,8 +35,11 @@ namespace bias
             virtual ~VideoWriter_jpg();
             virtual void setFileName(QString fileName);
             virtual unsigned int getNextVersionNumber();
+            virtual void prepare(StampedImage stampedImg);
             virtual void addFrame(StampedImage stampedImg);
             virtual void finish();
+            virtual FrameDrainPtr getFrameDrain() const;
+            virtual unsigned long long getBytesWritten();
 
             static const QString IMAGE_FILE_BASE;
             static const QString IMAGE_FILE_EXT;
@@ -52,6 +55,9 @@ namespace bias
             static const unsigned int MIN_QUALITY;
             static const unsigned int MAX_QUALITY;
             static const unsigned int DEFAULT_NUMBER_OF_COMPRESSORS;
+            static const unsigned int DEFAULT_NUMBER_OF_SLICES;
+            static const unsigned int MIN_NUMBER_OF_SLICES;
+            static const unsigned int MAX_NUMBER_OF_SLICES;
             static const bool DEFAULT_MJPG_FLAG;
             static const bool DEFAULT_MJPG_MAX_FRAME_PER_FILE_FLAG;
             static const unsigned long DEFAULT_MJPG_MAX_FRAME_PER_FILE;
@@ -71,6 +77,7 @@ namespace bias
             QString baseName_;
             QDir logDir_;
             unsigned int numberOfCompressors_;
+            unsigned int numberOfSlices_;
             unsigned long nextFrameToWrite_;
 
             std::ofstream movieFile_;
@@ -84,6 +91,7 @@ namespace bias
             CompressedFrameQueuePtr_jpg framesToDoQueuePtr_;
             CompressedFrameSetPtr_jpg framesFinishedSetPtr_;
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr_;
+            FrameDrainPtr frameDrainPtr_;
 
             QPointer<QThreadPool> threadPoolPtr_;
 
@@ -97,6 +105,8 @@ namespace bias
             void startCompressors();
             void stopCompressors();
             unsigned int clearFinishedFrames();
+            void flushFinishedFrames();
+            void dropQueuedFrames();
             void writeCompressedMjpgFrame(CompressedFrame_jpg frame);
 
 
@@ -4,6 +4,10 @@
 #include "video_writer_avi.hpp"
 #include "video_writer_fmf.hpp"
 #include "video_writer_ufmf.hpp"
+#include "video_writer_zfmf.hpp"
+#include "video_writer_segmented.hpp"
+#include "pretrigger_buffer.hpp"
+#include "activity_gate.hpp"
 #include "background_histogram_ufmf.hpp"
 #include <sstream>
 
@@ -15,12 +19,20 @@ namespace bias
     VideoWriterParams_bmp::VideoWriterParams_bmp()
     {
         frameSkip = VideoWriter_bmp::DEFAULT_FRAME_SKIP;
+        imageFormat = VideoWriter_bmp::DEFAULT_IMAGE_FORMAT;
+        compressionLevel = VideoWriter_bmp::DEFAULT_COMPRESSION_LEVEL;
+        numberOfWriters = VideoWriter_bmp::DEFAULT_NUMBER_OF_WRITERS;
+        framesPerDirectory = VideoWriter_bmp::DEFAULT_FRAMES_PER_DIRECTORY;
     }
 
     std::string VideoWriterParams_bmp::toString()
     {
         std::stringstream ss;
         ss << "frameSkip: " << frameSkip << std::endl;
+        ss << "imageFormat: " << imageFormat.toStdString() << std::endl;
+        ss << "compressionLevel: " << compressionLevel << std::endl;
+        ss << "numberOfWriters: " << numberOfWriters << std::endl;
+        ss << "framesPerDirectory: " << framesPerDirectory << std::endl;
         return ss.str();
     }
 
@@ -32,6 +44,7 @@ namespace bias
         frameSkip = VideoWriter_jpg::DEFAULT_FRAME_SKIP;
         quality = VideoWriter_jpg::DEFAULT_QUALITY;
         numberOfCompressors = VideoWriter_jpg::DEFAULT_NUMBER_OF_COMPRESSORS;
+        numberOfSlices = VideoWriter_jpg::DEFAULT_NUMBER_OF_SLICES;
         mjpgFlag = VideoWriter_jpg::DEFAULT_MJPG_FLAG;
         mjpgMaxFramePerFileFlag = VideoWriter_jpg::DEFAULT_MJPG_MAX_FRAME_PER_FILE_FLAG;
         mjpgMaxFramePerFile = VideoWriter_jpg::DEFAULT_MJPG_MAX_FRAME_PER_FILE;
@@ -44,6 +57,7 @@ namespace bias
         ss << "frameSkip: " << frameSkip << std::endl;
         ss << "quality: " << quality << std::endl;
         ss << "numberOfCompressors: " << numberOfCompressors << std::endl;
+        ss << "numberOfSlices: " << numberOfSlices << std::endl;
         ss << "mjpgFlag: " << std::boolalpha << mjpgFlag << std::noboolalpha << std::endl;
         ss << "mjpgMaxFramePerFileFlag: " << std::boolalpha << mjpgMaxFramePerFileFlag << std::noboolalpha << std::endl;
         ss << "mjpgMaxFramePerFile: " << mjpgMaxFramePerFile << std::endl;
@@ -59,6 +73,8 @@ namespace bias
         unsigned int fourcc = VideoWriter_avi::DEFAULT_FOURCC;
         //codec = fourccToQString(fourcc); 
         codec = VideoWriter_avi::fourccToString(fourcc); 
+        numberOfEncoders = VideoWriter_avi::DEFAULT_NUMBER_OF_ENCODERS;
+        segmentFrames = VideoWriter_avi::DEFAULT_SEGMENT_FRAMES;
     }
 
     std::string VideoWriterParams_avi::toString()
@@ -66,6 +82,8 @@ namespace bias
         std::stringstream ss;
         ss << "frameSkip: " << frameSkip << std::endl;
         ss << "codec: " << codec.toStdString() << std::endl;
+        ss << "numberOfEncoders: " << numberOfEncoders << std::endl;
+        ss << "segmentFrames: " << segmentFrames << std::endl;
         return ss.str();
     }
 
@@ -98,6 +116,12 @@ namespace bias
         numberOfCompressors = VideoWriter_ufmf::DEFAULT_NUMBER_OF_COMPRESSORS;
         dilateState = VideoWriter_ufmf::DEFAULT_DILATE_STATE;
         dilateWindowSize = VideoWriter_ufmf::DEFAULT_DILATE_WINDOW_SIZE;
+        backgroundModel = VideoWriter_ufmf::DEFAULT_BACKGROUND_MODEL;
+        keyFrameDeltaFlag = VideoWriter_ufmf::DEFAULT_KEYFRAME_DELTA_FLAG;
+        keyFrameTileSize = VideoWriter_ufmf::DEFAULT_KEYFRAME_TILE_SIZE;
+        keyFrameFullInterval = VideoWriter_ufmf::DEFAULT_KEYFRAME_FULL_INTERVAL;
+        compressPayloadFlag = VideoWriter_ufmf::DEFAULT_COMPRESS_PAYLOAD_FLAG;
+        compressPayloadLevel = VideoWriter_ufmf::DEFAULT_COMPRESS_PAYLOAD_LEVEL;
     }
 
 
@@ -111,12 +135,129 @@ namespace bias
         ss << "numberOfCompressors: " << numberOfCompressors << std::endl;
         ss << "dilateState: " << std::boolalpha << dilateState << std::noboolalpha << std::endl;
         ss << "dilateWindowSize: " << dilateWindowSize << std::endl;
+        ss << "backgroundModel: " << backgroundModel.toStdString() << std::endl;
+        ss << "keyFrameDeltaFlag: " << std::boolalpha << keyFrameDeltaFlag << std::noboolalpha << std::endl;
+        ss << "keyFrameTileSize: " << keyFrameTileSize << std::endl;
+        ss << "keyFrameFullInterval: " << keyFrameFullInterval << std::endl;
+        ss << "compressPayloadFlag: " << std::boolalpha << compressPayloadFlag << std::noboolalpha << std::endl;
+        ss << "compressPayloadLevel: " << compressPayloadLevel << std::endl;
+        return ss.str();
+    }
+
+
+    // ZFMF
+    // ------------------------------------------------------------------------
+    VideoWriterParams_zfmf::VideoWriterParams_zfmf()
+    {
+        frameSkip = VideoWriter_zfmf::DEFAULT_FRAME_SKIP;
+        numberOfCompressors = VideoWriter_zfmf::DEFAULT_NUMBER_OF_COMPRESSORS;
+        compressionLevel = VideoWriter_zfmf::DEFAULT_COMPRESSION_LEVEL;
+        deltaFlag = VideoWriter_zfmf::DEFAULT_DELTA_FLAG;
+        keyFrameInterval = VideoWriter_zfmf::DEFAULT_KEYFRAME_INTERVAL;
+        tileRows = VideoWriter_zfmf::DEFAULT_TILE_ROWS;
+    }
+
+
+    std::string VideoWriterParams_zfmf::toString()
+    {
+        std::stringstream ss;
+        ss << "frameSkip: " << frameSkip << std::endl;
+        ss << "numberOfCompressors: " << numberOfCompressors << std::endl;
+        ss << "compressionLevel: " << compressionLevel << std::endl;
+        ss << "deltaFlag: " << std::boolalpha << deltaFlag << std::noboolalpha << std::endl;
+        ss << "keyFrameInterval: " << keyFrameInterval << std::endl;
+        ss << "tileRows: " << tileRows << std::endl;
+        return ss.str();
+    }
+
+
+    // Segment (file rotation, all formats)
+    // ------------------------------------------------------------------------
+    VideoWriterParams_segment::VideoWriterParams_segment()
+    {
+        segmentFlag = VideoWriter_segmented::DEFAULT_SEGMENT_FLAG;
+        maxFrames = VideoWriter_segmented::DEFAULT_MAX_FRAMES;
+        maxMegaBytes = VideoWriter_segmented::DEFAULT_MAX_MEGABYTES;
+        maxSeconds = VideoWriter_segmented::DEFAULT_MAX_SECONDS;
+    }
+
+
+    std::string VideoWriterParams_segment::toString()
+    {
+        std::stringstream ss;
+        ss << "segmentFlag: " << std::boolalpha << segmentFlag << std::noboolalpha << std::endl;
+        ss << "maxFrames: " << maxFrames << std::endl;
+        ss << "maxMegaBytes: " << maxMegaBytes << std::endl;
+        ss << "maxSeconds: " << maxSeconds << std::endl;
+        return ss.str();
+    }
+
+
+    // Pre-trigger buffer (event triggered logging, all formats)
+    // ------------------------------------------------------------------------
+    VideoWriterParams_pretrigger::VideoWriterParams_pretrigger()
+    {
+        pretriggerFlag = PretriggerBuffer::DEFAULT_PRETRIGGER_FLAG;
+        preSeconds = PretriggerBuffer::DEFAULT_PRE_SECONDS;
+        postSeconds = PretriggerBuffer::DEFAULT_POST_SECONDS;
+        maxMegaBytes = PretriggerBuffer::DEFAULT_MAX_MEGABYTES;
+    }
+
+
+    std::string VideoWriterParams_pretrigger::toString()
+    {
+        std::stringstream ss;
+        ss << "pretriggerFlag: " << std::boolalpha << pretriggerFlag << std::noboolalpha << std::endl;
+        ss << "preSeconds: " << preSeconds << std::endl;
+        ss << "postSeconds: " << postSeconds << std::endl;
+        ss << "maxMegaBytes: " << maxMegaBytes << std::endl;
+        return ss.str();
+    }
+
+
+    // Activity gate (activity gated logging, all formats)
+    // ------------------------------------------------------------------------
+    VideoWriterParams_activity::VideoWriterParams_activity()
+    {
+        activityFlag = ActivityGate::DEFAULT_ACTIVITY_FLAG;
+        threshold = ActivityGate::DEFAULT_THRESHOLD;
+        startFraction = ActivityGate::DEFAULT_START_FRACTION;
+        stopFraction = ActivityGate::DEFAULT_STOP_FRACTION;
+        downsample = ActivityGate::DEFAULT_DOWNSAMPLE;
+        backgroundSeconds = ActivityGate::DEFAULT_BACKGROUND_SECONDS;
+        preSeconds = ActivityGate::DEFAULT_PRE_SECONDS;
+        holdSeconds = ActivityGate::DEFAULT_HOLD_SECONDS;
+        minClipSeconds = ActivityGate::DEFAULT_MIN_CLIP_SECONDS;
+        maxMegaBytes = ActivityGate::DEFAULT_MAX_MEGABYTES;
+    }
+
+
+    std::string VideoWriterParams_activity::toString()
+    {
+        std::stringstream ss;
+        ss << "activityFlag: " << std::boolalpha << activityFlag << std::noboolalpha << std::endl;
+        ss << "threshold: " << threshold << std::endl;
+        ss << "startFraction: " << startFraction << std::endl;
+        ss << "stopFraction: " << stopFraction << std::endl;
+        ss << "downsample: " << downsample << std::endl;
+        ss << "backgroundSeconds: " << backgroundSeconds << std::endl;
+        ss << "preSeconds: " << preSeconds << std::endl;
+        ss << "holdSeconds: " << holdSeconds << std::endl;
+        ss << "minClipSeconds: " << minClipSeconds << std::endl;
+        ss << "maxMegaBytes: " << maxMegaBytes << std::endl;
         return ss.str();
     }
 
 
     // VideoWriterParams
     // ------------------------------------------------------------------------
+    VideoWriterParams::VideoWriterParams()
+    {
+        rawBayerFlag = false;
+        finishTimeout = VideoWriter::DEFAULT_FINISH_TIMEOUT;
+    }
+
+
     std::string VideoWriterParams::toString()
     {
         std::stringstream ss; 
@@ -141,6 +282,29 @@ namespace bias
         ss << sepString << std::endl;
         ss << ufmf.toString() << std::endl;
 
+        ss << "zfmf" << std::endl;
+        ss << sepString << std::endl;
+        ss << zfmf.toString() << std::endl;
+
+        ss << "segment" << std::endl;
+        ss << sepString << std::endl;
+        ss << segment.toString() << std::endl;
+
+        ss << "pretrigger" << std::endl;
+        ss << sepString << std::endl;
+        ss << pretrigger.toString() << std::endl;
+
+        ss << "activity" << std::endl;
+        ss << sepString << std::endl;
+        ss << activity.toString() << std::endl;
+
+        ss << "roi" << std::endl;
+        ss << sepString << std::endl;
+        ss << roi.toString() << std::endl;
+
+        ss << "rawBayerFlag: " << rawBayerFlag << std::endl;
+        ss << "finishTimeout: " << finishTimeout << std::endl;
+
         return ss.str();
 
     }
@@ -1,5 +1,6 @@
 #ifndef BIAS_VIDEO_WRITER_PARAMS_HPP
 #define BIAS_VIDEO_WRITER_PARAMS_HPP
+#include "image_roi.hpp"
 #include <QString>
 #include <string>
 
@@ -10,6 +11,10 @@ namespace bias
     struct VideoWriterParams_bmp
     {
         unsigned int frameSkip;
+        QString imageFormat;
+        int compressionLevel;
+        unsigned int numberOfWriters;
+        unsigned int framesPerDirectory;
         VideoWriterParams_bmp();
         std::string toString();
     };
@@ -19,6 +24,7 @@ namespace bias
         unsigned int frameSkip;
         unsigned int quality;
         unsigned int numberOfCompressors;
+        unsigned int numberOfSlices;
         bool mjpgFlag; 
         bool mjpgMaxFramePerFileFlag;
         unsigned long mjpgMaxFramePerFile;
@@ -30,6 +36,8 @@ namespace bias
     {
         unsigned int frameSkip;
         QString codec;
+        unsigned int numberOfEncoders;
+        unsigned long segmentFrames;
         VideoWriterParams_avi();
         std::string toString();
     };
@@ -53,11 +61,69 @@ namespace bias
         unsigned int medianUpdateInterval;
         unsigned int dilateWindowSize;
         bool dilateState;
+        QString backgroundModel;
+        bool keyFrameDeltaFlag;
+        unsigned int keyFrameTileSize;
+        unsigned int keyFrameFullInterval;
+        bool compressPayloadFlag;
+        int compressPayloadLevel;
         VideoWriterParams_ufmf();
         std::string toString();
     };
 
 
+    struct VideoWriterParams_zfmf
+    {
+        unsigned int frameSkip;
+        unsigned int numberOfCompressors;
+        int compressionLevel;
+        bool deltaFlag;
+        unsigned int keyFrameInterval;
+        unsigned int tileRows;
+        VideoWriterParams_zfmf();
+        std::string toString();
+    };
+
+
+    struct VideoWriterParams_segment
+    {
+        bool segmentFlag;
+        unsigned long maxFrames;
+        unsigned long maxMegaBytes;
+        double maxSeconds;
+        VideoWriterParams_segment();
+        std::string toString();
+    };
+
+
+    struct VideoWriterParams_pretrigger
+    {
+        bool pretriggerFlag;
+        double preSeconds;
+        double postSeconds;
+        unsigned long maxMegaBytes;
+        VideoWriterParams_pretrigger();
+        std::string toString();
+    };
+
+
+    struct VideoWriterParams_activity
+    {
+        bool activityFlag;
+        unsigned int threshold;
+        double startFraction;
+        double stopFraction;
+        unsigned int downsample;
+        double backgroundSeconds;
+        double preSeconds;
+        double holdSeconds;
+        double minClipSeconds;
+        unsigned long maxMegaBytes;
+        VideoWriterParams_activity();
+        std::string toString();
+    };
+
+
     struct VideoWriterParams
     {
         VideoWriterParams_bmp bmp;
@@ -65,6 +131,14 @@ namespace bias
         VideoWriterParams_avi avi;
         VideoWriterParams_fmf fmf;
         VideoWriterParams_ufmf ufmf;
+        VideoWriterParams_zfmf zfmf;
+        VideoWriterParams_segment segment;
+        VideoWriterParams_pretrigger pretrigger;
+        VideoWriterParams_activity activity;
+        ImageRoiParams roi;
+        bool rawBayerFlag;
+        double finishTimeout;
+        VideoWriterParams();
         std::string toString();
     };
 
@@ -0,0 +1,496 @@
+#include "video_writer_segmented.hpp"
+#include "basic_types.hpp"
+#include "exception.hpp"
+#include "json.hpp"
+#include "json_utils.hpp"
+#include <iostream>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QVariantMap>
+
+namespace bias
+{
+    const bool VideoWriter_segmented::DEFAULT_SEGMENT_FLAG = false;
+    const unsigned long VideoWriter_segmented::DEFAULT_MAX_FRAMES = 0;
+    const unsigned long VideoWriter_segmented::DEFAULT_MAX_MEGABYTES = 0;
+    const double VideoWriter_segmented::DEFAULT_MAX_SECONDS = 3600.0;
+    const unsigned long VideoWriter_segmented::SIZE_CHECK_INTERVAL = 100;
+    const QString VideoWriter_segmented::SEGMENT_TAG = QString("_seg");
+    const QString VideoWriter_segmented::MANIFEST_TAG = QString("_segments");
+    const QString VideoWriter_segmented::MANIFEST_EXT = QString("json");
+    const QString DUMMY_FILENAME("dummy");
+    const VideoWriterParams_segment VideoWriter_segmented::DEFAULT_PARAMS = VideoWriterParams_segment();
+
+
+    // VideoWriterSegmentWorker methods
+    // ----------------------------------------------------------------------------------
+
+    VideoWriterSegmentWorker::VideoWriterSegmentWorker(QObject *parent) : QObject(parent)
+    {
+        numberPreparePending_ = 0;
+        busy_ = false;
+        connect(this, SIGNAL(jobAdded()), this, SLOT(runJobs()), Qt::QueuedConnection);
+    }
+
+
+    void VideoWriterSegmentWorker::prepareSegment(
+            std::shared_ptr<VideoWriter> videoWriterPtr, 
+            StampedImage stampedImg
+            )
+    {
+        Job job;
+        job.type = SEGMENT_JOB_PREPARE;
+        job.videoWriterPtr = videoWriterPtr;
+        job.stampedImg = stampedImg;
+        job.ownerThreadPtr = QThread::currentThread();
+        addJob(job);
+    }
+
+
+    void VideoWriterSegmentWorker::finishSegment(std::shared_ptr<VideoWriter> videoWriterPtr)
+    {
+        Job job;
+        job.type = SEGMENT_JOB_FINISH;
+        job.videoWriterPtr = videoWriterPtr;
+        job.ownerThreadPtr = nullptr;
+        addJob(job);
+    }
+
+
+    void VideoWriterSegmentWorker::discardSegment(std::shared_ptr<VideoWriter> videoWriterPtr)
+    {
+        Job job;
+        job.type = SEGMENT_JOB_DISCARD;
+        job.videoWriterPtr = videoWriterPtr;
+        job.ownerThreadPtr = nullptr;
+        addJob(job);
+    }
+
+
+    void VideoWriterSegmentWorker::waitForPrepared()
+    {
+        acquireLock();
+        while (numberPreparePending_ > 0)
+        {
+            progressWaitCond_.wait(&mutex_);
+        }
+        releaseLock();
+    }
+
+
+    void VideoWriterSegmentWorker::waitForDone()
+    {
+        acquireLock();
+        while (busy_ || !jobList_.empty())
+        {
+            progressWaitCond_.wait(&mutex_);
+        }
+        releaseLock();
+    }
+
+
+    void VideoWriterSegmentWorker::addJob(Job job)
+    {
+        // Hand the writer over to the worker thread - must be called from the
+        // thread which currently owns it.
+        job.videoWriterPtr -> moveToThread(thread());
+
+        acquireLock();
+        if (job.type == SEGMENT_JOB_PREPARE)
+        {
+            jobList_.push_front(job);
+            numberPreparePending_++;
+        }
+        else
+        {
+            jobList_.push_back(job);
+        }
+        releaseLock();
+
+        emit jobAdded();
+    }
+
+
+    void VideoWriterSegmentWorker::runJobs()
+    {
+        while (true)
+        {
+            acquireLock();
+            if (jobList_.empty())
+            {
+                busy_ = false;
+                progressWaitCond_.wakeAll();
+                releaseLock();
+                break;
+            }
+            busy_ = true;
+            Job job = jobList_.front();
+            jobList_.pop_front();
+            releaseLock();
+
+            runJob(job);
+
+            if (job.type == SEGMENT_JOB_PREPARE)
+            {
+                acquireLock();
+                numberPreparePending_--;
+                progressWaitCond_.wakeAll();
+                releaseLock();
+            }
+        }
+    }
+
+
+    void VideoWriterSegmentWorker::runJob(Job &job)
+    {
+        try
+        {
+            if (job.type == SEGMENT_JOB_PREPARE)
+            {
+                job.videoWriterPtr -> prepare(job.stampedImg);
+            }
+            else
+            {
+                job.videoWriterPtr -> finish();
+            }
+        }
+        catch (RuntimeError &runtimeError)
+        {
+            unsigned int errorId = runtimeError.id();
+            QString errorMsg = QString::fromStdString(runtimeError.what());
+            emit imageLoggingError(errorId, errorMsg);
+        }
+
+        if (job.type == SEGMENT_JOB_PREPARE)
+        {
+            // Give the prepared writer back to the logging thread
+            job.videoWriterPtr -> moveToThread(job.ownerThreadPtr);
+        }
+        else 
+        {
+            QString fileName = job.videoWriterPtr -> getFileName();
+            job.videoWriterPtr.reset();
+            if (job.type == SEGMENT_JOB_DISCARD)
+            {
+                removeOutput(fileName);
+            }
+        }
+    }
+
+
+    void VideoWriterSegmentWorker::removeOutput(QString fileName)
+    {
+        // Movie formats write a file, image sequence formats (bmp, jpg) a directory
+        QFileInfo fileInfo(fileName);
+        if (fileInfo.isDir())
+        {
+            QDir(fileName).removeRecursively();
+        }
+        else if (fileInfo.exists())
+        {
+            QFile::remove(fileName);
+        }
+    }
+
+
+    // VideoWriter_segmented methods
+    // ----------------------------------------------------------------------------------
+
+    VideoWriter_segmented::VideoWriter_segmented(QObject *parent) 
+        : VideoWriter_segmented(DEFAULT_PARAMS, nullptr, DUMMY_FILENAME, 0, parent)
+    {}
+
+
+    VideoWriter_segmented::VideoWriter_segmented(
+            VideoWriterParams_segment params,
+            VideoWriterFactory writerFactory,
+            QString fileName, 
+            unsigned int cameraNumber,
+            QObject *parent
+            ) : VideoWriter(fileName, cameraNumber, parent)
+    {
+        isFirst_ = true;
+        maxFrames_ = params.maxFrames;
+        maxBytes_ = (unsigned long long)(params.maxMegaBytes)*1024ULL*1024ULL;
+        maxSeconds_ = params.maxSeconds;
+        writerFactory_ = writerFactory;
+        nextWriterQueued_ = false;
+
+        // Single worker thread so that segments are prepared and closed in order
+        workerThreadPtr_ = new QThread(this);
+        workerPtr_ = new VideoWriterSegmentWorker();
+        workerPtr_ -> moveToThread(workerThreadPtr_);
+        connect(
+                workerPtr_,
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                this,
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                Qt::DirectConnection
+               );
+        workerThreadPtr_ -> start();
+    }
+
+
+    VideoWriter_segmented::~VideoWriter_segmented()
+    {
+        stopWorker();
+    }
+
+
+    void VideoWriter_segmented::stopWorker()
+    {
+        if (workerPtr_ == nullptr)
+        {
+            return;
+        }
+        workerPtr_ -> waitForDone();
+        if (!workerThreadPtr_.isNull())
+        {
+            workerThreadPtr_ -> quit();
+            workerThreadPtr_ -> wait();
+        }
+        delete workerPtr_;
+        workerPtr_ = nullptr;
+    }
+
+
+    unsigned int VideoWriter_segmented::getNextVersionNumber()
+    {
+        // A version is taken if its manifest exists
+        unsigned int nextVerNum = 0;
+        if (addVersionNumber_)
+        {
+            nextVerNum = 1;
+            while (QFileInfo(getManifestFileName(nextVerNum)).exists())
+            {
+                nextVerNum++;
+            }
+        }
+        return nextVerNum;
+    }
+
+
+    void VideoWriter_segmented::addFrame(StampedImage stampedImg)
+    {
+        if (isFirst_)
+        {
+            setupSegments();
+            startNextSegment(stampedImg);
+            isFirst_ = false;
+        }
+        else if (isSegmentFull(stampedImg))
+        {
+            startNextSegment(stampedImg);
+        }
+        else if (!nextWriterQueued_ && nextWriterPtr_)
+        {
+            // Open the following segment's output in the background, once the
+            // current segment has its first frame.
+            workerPtr_ -> prepareSegment(nextWriterPtr_, stampedImg);
+            nextWriterQueued_ = true;
+        }
+
+        // Segment writers expect frame counts to start from zero
+        SegmentInfo &segmentInfo = segmentInfoVec_.back();
+        StampedImage segmentImg = stampedImg;
+        segmentImg.frameCount = stampedImg.frameCount - segmentInfo.firstFrameCount;
+        currentWriterPtr_ -> addFrame(segmentImg);
+
+        segmentInfo.numberOfFrames++;
+        segmentInfo.endTime = stampedImg.timeStamp;
+        frameCount_++;
+    }
+
+
+    void VideoWriter_segmented::finish()
+    {
+        if (currentWriterPtr_)
+        {
+            currentWriterPtr_ -> finish();
+            currentWriterPtr_.reset();
+        }
+
+        // The next segment may already have its output opened - throw it away
+        if (nextWriterPtr_)
+        {
+            if (nextWriterQueued_)
+            {
+                workerPtr_ -> waitForPrepared();
+                workerPtr_ -> discardSegment(nextWriterPtr_);
+            }
+            nextWriterPtr_.reset();
+            nextWriterQueued_ = false;
+        }
+
+        if (workerPtr_ != nullptr)
+        {
+            workerPtr_ -> waitForDone();
+        }
+
+        if (!isFirst_)
+        {
+            writeManifest(true);
+        }
+    }
+
+
+    void VideoWriter_segmented::setupSegments()
+    {
+        if (!writerFactory_)
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            std::string errorMsg("segmented video writer setup failed:\n\n"); 
+            errorMsg += "no video writer factory";
+            throw RuntimeError(errorId, errorMsg);
+        }
+
+        unsigned int verNum = getNextVersionNumber();
+        baseFileInfo_ = getFileInfo(verNum);
+        manifestFileName_ = getManifestFileName(verNum);
+        segmentInfoVec_.clear();
+        nextWriterPtr_ = createSegmentWriter(0);
+        nextWriterQueued_ = false;
+    }
+
+
+    QString VideoWriter_segmented::getSegmentFileName(unsigned int index)
+    {
+        QString segmentName = QString("%1%2%3.%4").arg(baseFileInfo_.completeBaseName())
+            .arg(SEGMENT_TAG).arg(index,4,10,QChar('0')).arg(baseFileInfo_.suffix());
+        return baseFileInfo_.absoluteDir().absoluteFilePath(segmentName);
+    }
+
+
+    QString VideoWriter_segmented::getManifestFileName(unsigned int verNum)
+    {
+        QFileInfo fileInfo = getFileInfo(verNum);
+        QString manifestName = QString("%1%2.%3").arg(fileInfo.completeBaseName())
+            .arg(MANIFEST_TAG).arg(MANIFEST_EXT);
+        return fileInfo.absoluteDir().absoluteFilePath(manifestName);
+    }
+
+
+    std::shared_ptr<VideoWriter> VideoWriter_segmented::createSegmentWriter(unsigned int index)
+    {
+        QString segmentFileName = getSegmentFileName(index);
+        std::shared_ptr<VideoWriter> writerPtr = writerFactory_(segmentFileName);
+        writerPtr -> setFileName(segmentFileName);
+        writerPtr -> setVersioning(false);
+        writerPtr -> setBayerPattern(bayerPattern_);
+        connect(
+                writerPtr.get(),
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                this,
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                Qt::DirectConnection
+               );
+        return writerPtr;
+    }
+
+
+    bool VideoWriter_segmented::isSegmentFull(StampedImage &stampedImg)
+    {
+        SegmentInfo &segmentInfo = segmentInfoVec_.back();
+
+        if ((maxFrames_ > 0) && (segmentInfo.numberOfFrames >= maxFrames_))
+        {
+            return true;
+        }
+
+        if ((maxSeconds_ > 0.0) && ((stampedImg.timeStamp - segmentInfo.startTime) >= maxSeconds_))
+        {
+            return true;
+        }
+
+        // Writers that stat their output file are only asked every so often
+        if ((maxBytes_ > 0) && (segmentInfo.numberOfFrames%SIZE_CHECK_INTERVAL == 0))
+        {
+            if (currentWriterPtr_ -> getBytesWritten() >= maxBytes_)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    void VideoWriter_segmented::startNextSegment(StampedImage &stampedImg)
+    {
+        // Hand the completed segment to the worker thread to be closed
+        if (currentWriterPtr_)
+        {
+            workerPtr_ -> finishSegment(currentWriterPtr_);
+            currentWriterPtr_.reset();
+        }
+
+        // Switch to the pre-created writer, normally its output is already open
+        unsigned int index = segmentInfoVec_.size();
+        if (!nextWriterPtr_)
+        {
+            nextWriterPtr_ = createSegmentWriter(index);
+        }
+        if (nextWriterQueued_)
+        {
+            workerPtr_ -> waitForPrepared();
+        }
+        currentWriterPtr_ = nextWriterPtr_;
+        nextWriterQueued_ = false;
+
+        SegmentInfo segmentInfo;
+        segmentInfo.index = index;
+        segmentInfo.fileName = currentWriterPtr_ -> getFileName();
+        segmentInfo.firstFrameCount = stampedImg.frameCount;
+        segmentInfo.numberOfFrames = 0;
+        segmentInfo.startTime = stampedImg.timeStamp;
+        segmentInfo.endTime = stampedImg.timeStamp;
+        segmentInfoVec_.push_back(segmentInfo);
+
+        writeManifest(false);
+
+        // Get the writer for the following segment ready 
+        nextWriterPtr_ = createSegmentWriter(index+1);
+    }
+
+
+    void VideoWriter_segmented::writeManifest(bool complete)
+    {
+        QVariantList segmentList;
+        for (unsigned int i=0; i<segmentInfoVec_.size(); i++)
+        {
+            SegmentInfo &segmentInfo = segmentInfoVec_[i];
+            QVariantMap segmentMap;
+            segmentMap.insert("index", segmentInfo.index);
+            segmentMap.insert("fileName", QFileInfo(segmentInfo.fileName).fileName());
+            segmentMap.insert("firstFrame", (unsigned long long)(segmentInfo.firstFrameCount));
+            segmentMap.insert("numberOfFrames", (unsigned long long)(segmentInfo.numberOfFrames));
+            segmentMap.insert("startTime", segmentInfo.startTime);
+            segmentMap.insert("endTime", segmentInfo.endTime);
+            segmentList.append(segmentMap);
+        }
+
+        QVariantMap manifestMap;
+        manifestMap.insert("baseName", baseFileInfo_.fileName());
+        manifestMap.insert("complete", complete);
+        manifestMap.insert("segments", segmentList);
+
+        bool ok = false;
+        QByteArray manifestJson = QtJson::serialize(manifestMap, ok);
+        if (!ok)
+        {
+            return;
+        }
+
+        QFile manifestFile(manifestFileName_);
+        if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+            QString errorMsg = QString("unable to write segment manifest %1").arg(manifestFileName_);
+            emit imageLoggingError(errorId, errorMsg);
+            return;
+        }
+        manifestFile.write(prettyIndentJson(manifestJson));
+        manifestFile.close();
+    }
+
+} // namespace bias
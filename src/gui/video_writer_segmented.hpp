@@ -0,0 +1,159 @@
+#ifndef BIAS_VIDEO_WRITER_SEGMENTED_HPP
+#define BIAS_VIDEO_WRITER_SEGMENTED_HPP
+#include "video_writer.hpp"
+#include "video_writer_params.hpp"
+#include "lockable.hpp"
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVariantList>
+#include <QWaitCondition>
+#include <functional>
+#include <memory>
+#include <list>
+
+class QThread;
+
+namespace bias
+{
+
+    typedef std::function<std::shared_ptr<VideoWriter>(QString fileName)> VideoWriterFactory;
+
+
+    class VideoWriterSegmentWorker : public QObject, public Lockable<Empty>
+    {
+        // Lives on its own thread and, in order, prepares (opens) the writers 
+        // for upcoming segments and finishes (drains, writes index, closes) 
+        // completed ones so neither happens on the logging thread. A writer 
+        // is moved to the worker thread when handed over - prepared writers
+        // are moved back to the logging thread, finished ones are destroyed 
+        // on the worker thread. Prepare jobs go ahead of finish jobs.
+
+        Q_OBJECT
+
+        public:
+            VideoWriterSegmentWorker(QObject *parent=0);
+
+            // Call from the thread which owns the writer
+            void prepareSegment(std::shared_ptr<VideoWriter> videoWriterPtr, StampedImage stampedImg);
+            void finishSegment(std::shared_ptr<VideoWriter> videoWriterPtr);
+            void discardSegment(std::shared_ptr<VideoWriter> videoWriterPtr);
+
+            void waitForPrepared();
+            void waitForDone();
+
+        signals:
+            void jobAdded();
+            void imageLoggingError(unsigned int errorId, QString errorMsg);
+
+        private slots:
+            void runJobs();
+
+        private:
+
+            enum JobType
+            {
+                SEGMENT_JOB_PREPARE,
+                SEGMENT_JOB_FINISH,
+                SEGMENT_JOB_DISCARD,
+            };
+
+            struct Job
+            {
+                JobType type;
+                std::shared_ptr<VideoWriter> videoWriterPtr;
+                StampedImage stampedImg;
+                QThread *ownerThreadPtr;
+            };
+
+            std::list<Job> jobList_;              // use lock
+            unsigned int numberPreparePending_;   // use lock
+            bool busy_;                           // use lock
+            QWaitCondition progressWaitCond_;
+
+            void addJob(Job job);
+            void runJob(Job &job);
+            void removeOutput(QString fileName);
+    };
+
+
+    class VideoWriter_segmented : public VideoWriter
+    {
+        // Wraps any VideoWriter and rolls over to a new output file (segment)
+        // after a maximum number of frames, bytes or seconds. Segments are 
+        // named <base>_seg0000.<ext>, <base>_seg0001.<ext>, ... and listed in 
+        // a json manifest <base>_segments.json. The writer for the next 
+        // segment is created and its output opened ahead of time, and finished
+        // segments are closed, by a worker thread so that a switch does not 
+        // stall logging.
+
+        Q_OBJECT
+
+        public:
+
+            VideoWriter_segmented(QObject *parent=0);
+            explicit VideoWriter_segmented(
+                    VideoWriterParams_segment params,
+                    VideoWriterFactory writerFactory,
+                    QString fileName, 
+                    unsigned int cameraNumber,
+                    QObject *parent=0
+                    );
+            virtual ~VideoWriter_segmented();
+            virtual unsigned int getNextVersionNumber();
+            virtual void addFrame(StampedImage stampedImg);
+            virtual void finish();
+
+            static const bool DEFAULT_SEGMENT_FLAG;
+            static const unsigned long DEFAULT_MAX_FRAMES;
+            static const unsigned long DEFAULT_MAX_MEGABYTES;
+            static const double DEFAULT_MAX_SECONDS;
+            static const unsigned long SIZE_CHECK_INTERVAL;
+            static const QString SEGMENT_TAG;
+            static const QString MANIFEST_TAG;
+            static const QString MANIFEST_EXT;
+            static const VideoWriterParams_segment DEFAULT_PARAMS;
+
+        protected:
+
+            struct SegmentInfo
+            {
+                unsigned int index;
+                QString fileName;
+                unsigned long firstFrameCount;
+                unsigned long numberOfFrames;
+                double startTime;
+                double endTime;
+            };
+
+            bool isFirst_;
+            unsigned long maxFrames_;
+            unsigned long long maxBytes_;
+            double maxSeconds_;
+
+            VideoWriterFactory writerFactory_;
+            std::shared_ptr<VideoWriter> currentWriterPtr_;
+            std::shared_ptr<VideoWriter> nextWriterPtr_;
+            bool nextWriterQueued_;
+
+            QFileInfo baseFileInfo_;
+            QString manifestFileName_;
+            std::vector<SegmentInfo> segmentInfoVec_;
+
+            QPointer<QThread> workerThreadPtr_;
+            VideoWriterSegmentWorker *workerPtr_;
+
+            void setupSegments();
+            QString getSegmentFileName(unsigned int index);
+            QString getManifestFileName(unsigned int verNum);
+            std::shared_ptr<VideoWriter> createSegmentWriter(unsigned int index);
+            bool isSegmentFull(StampedImage &stampedImg);
+            void startNextSegment(StampedImage &stampedImg);
+            void stopWorker();
+            void writeManifest(bool complete);
+
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_VIDEO_WRITER_SEGMENTED_HPP
@@ -1,19 +1,24 @@
 #include "video_writer_ufmf.hpp"
 #include "basic_types.hpp"
 #include "exception.hpp"
+#include "utils.hpp"
 #include "lockable.hpp"
 #include "background_data_ufmf.hpp"
 #include "background_histogram_ufmf.hpp"
 #include "background_median_ufmf.hpp"
+#include "background_running_median_ufmf.hpp"
 #include <QThreadPool>
 #include <QFileInfo>
 #include <QDir>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
 namespace bias
 {
     // Static Constants
     // ----------------------------------------------------------------------------------
+    const int COMPRESSOR_WAIT_TIMEOUT = 10;  // msec
     const unsigned int VideoWriter_ufmf::FRAMES_TODO_MAX_QUEUE_SIZE   = 250;
     const unsigned int VideoWriter_ufmf::FRAMES_FINISHED_MAX_SET_SIZE = 250;
     const unsigned int VideoWriter_ufmf::FRAMES_WAIT_MAX_QUEUE_SIZE   =  50;
@@ -37,6 +42,22 @@ namespace bias
     const unsigned int VideoWriter_ufmf::MIN_DILATE_WINDOW_SIZE = 1;
     const unsigned int VideoWriter_ufmf::MAX_DILATE_WINDOW_SIZE = 20;
 
+    const QString VideoWriter_ufmf::BACKGROUND_MODEL_HISTOGRAM("histogram");
+    const QString VideoWriter_ufmf::BACKGROUND_MODEL_RUNNING_MEDIAN("runningMedian");
+    const QString VideoWriter_ufmf::DEFAULT_BACKGROUND_MODEL(BACKGROUND_MODEL_HISTOGRAM);
+
+    const bool VideoWriter_ufmf::DEFAULT_KEYFRAME_DELTA_FLAG = false;
+    const unsigned int VideoWriter_ufmf::DEFAULT_KEYFRAME_TILE_SIZE = 32;
+    const unsigned int VideoWriter_ufmf::MIN_KEYFRAME_TILE_SIZE = 8;
+    const unsigned int VideoWriter_ufmf::MAX_KEYFRAME_TILE_SIZE = 512;
+    const unsigned int VideoWriter_ufmf::DEFAULT_KEYFRAME_FULL_INTERVAL = 10;
+    const unsigned int VideoWriter_ufmf::MIN_KEYFRAME_FULL_INTERVAL = 1;
+
+    const bool VideoWriter_ufmf::DEFAULT_COMPRESS_PAYLOAD_FLAG = false;
+    const int VideoWriter_ufmf::DEFAULT_COMPRESS_PAYLOAD_LEVEL = 1;
+    const int VideoWriter_ufmf::MIN_COMPRESS_PAYLOAD_LEVEL = 0;
+    const int VideoWriter_ufmf::MAX_COMPRESS_PAYLOAD_LEVEL = 9;
+
     const VideoWriterParams_ufmf VideoWriter_ufmf::DEFAULT_PARAMS = 
         VideoWriterParams_ufmf();
 
@@ -44,10 +65,16 @@ namespace bias
     const QString VideoWriter_ufmf::DUMMY_FILENAME("dummy.ufmf");
     const QString VideoWriter_ufmf::UFMF_HEADER_STRING("ufmf");
     const unsigned int VideoWriter_ufmf::UFMF_VERSION_NUMBER = 4;
+    const unsigned int VideoWriter_ufmf::UFMF_EXTENDED_VERSION_NUMBER = 5;
 
     const unsigned int VideoWriter_ufmf::KEYFRAME_CHUNK_ID   = 0;
     const unsigned int VideoWriter_ufmf::FRAME_CHUNK_ID      = 1;
     const unsigned int VideoWriter_ufmf::INDEX_DICT_CHUNK_ID = 2;
+    const unsigned int VideoWriter_ufmf::COMPRESSED_FRAME_CHUNK_ID = 3;
+    const unsigned int VideoWriter_ufmf::DELTA_KEYFRAME_CHUNK_ID = 4;
+
+    const QString VideoWriter_ufmf::KEYFRAME_TYPE_MEAN("mean");
+    const QString VideoWriter_ufmf::KEYFRAME_TYPE_MEAN_DELTA("meandelta");
 
     const char VideoWriter_ufmf::CHAR_FOR_DICT  = 'd';
     const char VideoWriter_ufmf::CHAR_FOR_ARRAY = 'a';
@@ -74,6 +101,7 @@ namespace bias
         : VideoWriter(fileName,cameraNumber,parent) 
     {
         isFirst_ = true;
+        finished_ = false;
         skipReported_ = false;
 
         backgroundThreshold_ = params.backgroundThreshold;
@@ -84,6 +112,16 @@ namespace bias
         numberOfCompressors_ = params.numberOfCompressors;
         dilateState_ = params.dilateState;
         dilateWindowSize_ = params.dilateWindowSize; 
+        backgroundModel_ = params.backgroundModel;
+        keyFrameDeltaFlag_ = params.keyFrameDeltaFlag;
+        // Tile size is written to the file as uint16 - MAX_KEYFRAME_TILE_SIZE keeps it in range
+        keyFrameTileSize_ = std::min(
+                std::max(params.keyFrameTileSize, MIN_KEYFRAME_TILE_SIZE), 
+                MAX_KEYFRAME_TILE_SIZE
+                );
+        keyFrameFullInterval_ = std::max(params.keyFrameFullInterval, MIN_KEYFRAME_FULL_INTERVAL);
+        compressPayloadFlag_ = params.compressPayloadFlag;
+        compressPayloadLevel_ = params.compressPayloadLevel;
 
         // ----------------------------------------------------------------------------
         //std::cout << params.toString() << std::endl;
@@ -105,6 +143,7 @@ namespace bias
         framesWaitQueuePtr_ = std::make_shared<CompressedFrameQueue_ufmf>();
         framesFinishedSetPtr_ = std::make_shared<CompressedFrameSet_ufmf>();
         framesSkippedIndexListPtr_ = std::make_shared<Lockable<std::list<unsigned long>>>();
+        frameDrainPtr_ = std::make_shared<FrameDrain>();
 
         isFixedSize_ = false;
         colorCoding_ = QString(DEFAULT_COLOR_CODING);
@@ -112,6 +151,7 @@ namespace bias
         indexLocation_ = 0;
         nextFrameToWrite_ = 0;
         numKeyFramesWritten_ = 0;
+        keyFramesSinceFull_ = 0;
         bgUpdateCount_ = 0;
         bgModelFrameCount_ = 0;
         bgModelTimeStamp_ = 0.0;
@@ -121,21 +161,20 @@ namespace bias
 
     VideoWriter_ufmf::~VideoWriter_ufmf() 
     {
-        stopBackgroundModeling();
-        stopCompressors();
-        threadPoolPtr_ -> waitForDone();
+        // Worker threads are already stopped when finish() has run 
+        if (!finished_)
+        {
+            stopBackgroundModeling();
+            stopCompressors();
+        }
         finishWriting();
     } 
 
 
-    void VideoWriter_ufmf::addFrame(StampedImage stampedImg) 
+    void VideoWriter_ufmf::prepare(StampedImage stampedImg)
     {
-        bool skipFrame = false;
-        bool haveNewMedianImage = false;
-
-        currentImage_ = stampedImg;
-
-        // On first call - setup output file, background modeling, start compressors, ...
+        // The initial background and first keyframe come from the first frame
+        // added, not from stampedImg.
         if (isFirst_)
         {
             checkImageFormat(stampedImg);
@@ -144,18 +183,33 @@ namespace bias
             setupOutputFile(stampedImg);
             writeHeader();
 
+            // Start background model and frame compressors
+            startBackgroundModeling();
+            startCompressors();
+
+            isFirst_ = false;
+        }
+    }
+
+
+    void VideoWriter_ufmf::addFrame(StampedImage stampedImg) 
+    {
+        bool skipFrame = false;
+        bool haveNewMedianImage = false;
+
+        currentImage_ = stampedImg;
+
+        // On first call - setup output file, background modeling, start compressors, ...
+        prepare(stampedImg);
+
+        if (numKeyFramesWritten_ == 0)
+        {
             // Set initial bg median image - just use current image.
             bgMedianImage_ = stampedImg.image;
             bgMembershipImage_.create(stampedImg.image.rows, stampedImg.image.cols,CV_8UC1);
             cv::add(bgMedianImage_,  backgroundThreshold_, bgUpperBoundImage_);
             cv::subtract(bgMedianImage_, backgroundThreshold_, bgLowerBoundImage_); 
-
-            // Start background model and frame compressors
-            startBackgroundModeling();
-            startCompressors();
             writeKeyFrame();
-
-            isFirst_ = false;
         }
 
 
@@ -198,6 +252,7 @@ namespace bias
             CompressedFrame_ufmf compressedFrame(boxLength_);
             compressedFrame.dilateEnabled(dilateState_);
             compressedFrame.setDilateWindowSize(dilateWindowSize_);
+            compressedFrame.setPayloadCompression(compressPayloadFlag_, compressPayloadLevel_);
 
             if (!(framesWaitQueuePtr_ -> empty()))
             {
@@ -218,6 +273,7 @@ namespace bias
             if (framesToDoQueueSize < FRAMES_TODO_MAX_QUEUE_SIZE)
             {
                 // Insert new (uncalculated) compressed frame into "to do" queue.
+                frameDrainPtr_ -> frameQueued();
                 framesToDoQueuePtr_ -> push(compressedFrame);
                 framesToDoQueuePtr_ -> wakeOne();
             }
@@ -230,6 +286,7 @@ namespace bias
             if (skipFrame)
             {
                 // Queue is full - skip frame
+                frameDrainPtr_ -> frameSkipped();
                 framesSkippedIndexListPtr_ -> acquireLock();
                 framesSkippedIndexListPtr_ -> push_back(stampedImg.frameCount);
                 framesSkippedIndexListPtr_ -> releaseLock();
@@ -267,9 +324,71 @@ namespace bias
     }
 
 
+    FrameDrainPtr VideoWriter_ufmf::getFrameDrain() const
+    {
+        return frameDrainPtr_;
+    }
+
+
     void VideoWriter_ufmf::finish()
     {
-        while (clearFinishedFrames() > 0);
+        if (isFirst_)
+        {
+            return;
+        }
+
+        // Wait for the compressors to work through the queued frames, writing
+        // finished frames as they arrive, then shut down the worker threads. 
+        // Frames still queued when the finish timeout expires are dropped.
+        unsigned long numberDroppedBefore = frameDrainPtr_ -> numberDropped();
+        bool drained = waitForFrameDrain(frameDrainPtr_, [this]() { clearFinishedFrames(); });
+        if (!drained)
+        {
+            dropQueuedFrames();
+        }
+        stopBackgroundModeling();
+        stopCompressors();
+        flushFinishedFrames();
+
+        if (!drained)
+        {
+            reportDroppedFrames(frameDrainPtr_ -> numberDropped() - numberDroppedBefore);
+        }
+        finished_ = true;
+    }
+
+
+    void VideoWriter_ufmf::dropQueuedFrames()
+    {
+        // Discard frames still waiting for a compressor. They are marked as
+        // skipped so that writing can continue past them.
+        unsigned long numberDropped = 0;
+        framesToDoQueuePtr_ -> acquireLock();
+        framesSkippedIndexListPtr_ -> acquireLock();
+        while (!(framesToDoQueuePtr_ -> empty()))
+        {
+            framesSkippedIndexListPtr_ -> push_back(framesToDoQueuePtr_ -> front().getFrameCount());
+            framesToDoQueuePtr_ -> pop();
+            numberDropped++;
+        }
+        framesSkippedIndexListPtr_ -> releaseLock();
+        framesToDoQueuePtr_ -> releaseLock();
+        frameDrainPtr_ -> frameDropped(numberDropped);
+    }
+
+
+    void VideoWriter_ufmf::flushFinishedFrames()
+    {
+        // Compressors have stopped - any gap left in the finished set is a 
+        // frame which will never arrive so write what remains in order. 
+        unsigned int framesFinishedSetSize = clearFinishedFrames();
+        while (framesFinishedSetSize > 0)
+        {
+            framesFinishedSetPtr_ -> acquireLock();
+            nextFrameToWrite_ = framesFinishedSetPtr_ -> begin() -> getFrameCount();
+            framesFinishedSetPtr_ -> releaseLock();
+            framesFinishedSetSize = clearFinishedFrames();
+        }
     }
 
 
@@ -365,6 +484,11 @@ namespace bias
             unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
             std::string errorMsg("video writer ufmf setup failed:\n\n"); 
             errorMsg += "image depth must be CV_8U";
+            if (bayerPattern_ != BAYER_PATTERN_NONE)
+            {
+                errorMsg += " - raw Bayer logging to ufmf needs an 8 bit Bayer pixel format, ";
+                errorMsg += "use fmf for 16 bit raw frames";
+            }
             throw RuntimeError(errorId,errorMsg);
         }
     }
@@ -413,7 +537,14 @@ namespace bias
             unsigned int headerStrLen = UFMF_HEADER_STRING.size();
             file_.write((char*) headerStrArray.data(), headerStrLen*sizeof(char));
 
+            // Compressed frame and delta keyframe chunks need a version 5 
+            // reader - version 4 readers don't know the chunk ids and reject
+            // the file rather than misparse it.
             uint32_t ufmf_version = uint32_t(UFMF_VERSION_NUMBER);
+            if (compressPayloadFlag_ || keyFrameDeltaFlag_)
+            {
+                ufmf_version = uint32_t(UFMF_EXTENDED_VERSION_NUMBER);
+            }
             file_.write((char*) &ufmf_version, sizeof(uint32_t));
 
             indexLocationPtr_ = file_.tellp();
@@ -438,6 +569,10 @@ namespace bias
             uint8_t isFixedSize_uint8 = uint8_t(isFixedSize_);
             file_.write((char*) &isFixedSize_uint8, sizeof(uint8_t));
 
+            if (bayerPattern_ != BAYER_PATTERN_NONE)
+            {
+                colorCoding_ = QString("RAW8:") + QString::fromStdString(getBayerPatternString(bayerPattern_));
+            }
             uint8_t colorCodingLength = uint8_t(colorCoding_.size());
             file_.write((char*) &colorCodingLength, sizeof(uint8_t));
 
@@ -555,27 +690,61 @@ namespace bias
 
         // Write char for dict and number of keys
         file_.write((char*) &CHAR_FOR_DICT, sizeof(char)); 
-        numKeys = 1;
+        numKeys = (bgDeltaKeyFramePosList_.empty()) ? 1 : 2;
         file_.write((char*) &numKeys, sizeof(uint8_t));
 
         // Write index -> keyframe -> mean
         // --------------------------------------------------------------------
+        writeKeyFrameIndex(KEYFRAME_TYPE_MEAN, bgKeyFramePosList_, bgKeyFrameTimeStampList_);
+
+        // Write index -> keyframe -> meandelta (only when delta keyframes present)
+        // --------------------------------------------------------------------
+        if (!bgDeltaKeyFramePosList_.empty())
+        {
+            writeKeyFrameIndex(
+                    KEYFRAME_TYPE_MEAN_DELTA, 
+                    bgDeltaKeyFramePosList_, 
+                    bgDeltaKeyFrameTimeStampList_
+                    );
+        }
+
+        // End write index -> keyframe
+        // --------------------------------------------------------------------
 
-        // Write length of key and key for mean
-        const char meanString[] = "mean";
-        uint16_t meanStringLength = uint16_t(sizeof(meanString)-1);
-        file_.write((char*) &meanStringLength, sizeof(uint16_t));
-        file_.write((char*) meanString, meanStringLength*sizeof(char));
+        // End index
+        // --------------------------------------------------------------------
+
+        // Write the index location
+        file_.seekp(indexLocationPtr_, std::ios_base::beg);
+        uint64_t indexLocation_uint64 = uint64_t(indexLocation_);
+        file_.write((char*) &indexLocation_uint64, sizeof(uint64_t));
+
+        // Close the file
+        file_.close();
+    }
+
+
+    void VideoWriter_ufmf::writeKeyFrameIndex(
+            const QString &keyFrameType,
+            const std::list<std::streampos> &posList,
+            const std::list<double> &timeStampList
+            )
+    {
+        // Write key length and key for keyframe type
+        QByteArray typeArray = keyFrameType.toLatin1();
+        uint16_t typeLength = uint16_t(typeArray.size());
+        file_.write((char*) &typeLength, sizeof(uint16_t));
+        file_.write((char*) typeArray.data(), typeLength*sizeof(char));
 
         // Write char for dict and number of keys
         file_.write((char*) &CHAR_FOR_DICT, sizeof(char));
-        numKeys = 2;
+        uint8_t numKeys = 2;
         file_.write((char*) &numKeys, sizeof(uint8_t));
 
-        // Write index -> keyframe -> mean -> loc
+        // Write index -> keyframe -> type -> loc
         // --------------------------------------------------------------------
-
-        // Write key length and key for location
+        const char locString[] = "loc";
+        uint16_t locStringLength = uint16_t(sizeof(locString) - 1);
         file_.write((char*) &locStringLength, sizeof(uint16_t));
         file_.write((char*) locString, locStringLength*sizeof(char));
 
@@ -584,24 +753,22 @@ namespace bias
         file_.write((char*) &CHAR_FOR_DTYPE_UINT64, sizeof(char));
 
         // Write number of bytes and keyframe positions
-        numBytes = uint32_t(bgKeyFramePosList_.size()*sizeof(uint64_t));
+        uint32_t numBytes = uint32_t(posList.size()*sizeof(uint64_t));
         file_.write((char*) &numBytes, sizeof(uint32_t));
         for (
-                std::list<std::streampos>::iterator it = bgKeyFramePosList_.begin();
-                it != bgKeyFramePosList_.end();
+                std::list<std::streampos>::const_iterator it = posList.begin();
+                it != posList.end();
                 it++
             )
         {
             uint64_t pos = *it;
             file_.write((char*) &pos, sizeof(uint64_t));
         }
-        // End write index -> keyframe -> mean -> loc
-        // --------------------------------------------------------------------
-        
-        // Write index -> keyframe -> mean -> timestamp
-        // --------------------------------------------------------------------
 
-        // write key length and key for time stamp
+        // Write index -> keyframe -> type -> timestamp
+        // --------------------------------------------------------------------
+        const char timeStampString[] = "timestamp";
+        uint16_t timeStampStringLength = uint16_t(sizeof(timeStampString)-1);
         file_.write((char*) &timeStampStringLength, sizeof(uint16_t));
         file_.write((char*) timeStampString, timeStampStringLength*sizeof(char));
 
@@ -610,36 +777,17 @@ namespace bias
         file_.write((char*) &CHAR_FOR_DTYPE_DOUBLE, sizeof(char));
 
         // Write number of bytes and keyframe time stamps
-        numBytes = uint32_t(bgKeyFrameTimeStampList_.size()*sizeof(double));
+        numBytes = uint32_t(timeStampList.size()*sizeof(double));
         file_.write((char*) &numBytes, sizeof(uint32_t));
         for (
-                std::list<double>::iterator it = bgKeyFrameTimeStampList_.begin(); 
-                it != bgKeyFrameTimeStampList_.end();
+                std::list<double>::const_iterator it = timeStampList.begin(); 
+                it != timeStampList.end();
                 it++
             )
         {
             double ts = *it;
             file_.write((char*) &ts, sizeof(double));
         }
-        // End write index -> keyframe -> mean -> timestamp
-        // --------------------------------------------------------------------
-
-        // End write index -> keyframe -> mean
-        // --------------------------------------------------------------------
-        
-        // End write index -> keyframe
-        // --------------------------------------------------------------------
-
-        // End index
-        // --------------------------------------------------------------------
-
-        // Write the index location
-        file_.seekp(indexLocationPtr_, std::ios_base::beg);
-        uint64_t indexLocation_uint64 = uint64_t(indexLocation_);
-        file_.write((char*) &indexLocation_uint64, sizeof(uint64_t));
-
-        // Close the file
-        file_.close();
     }
 
 
@@ -654,6 +802,12 @@ namespace bias
         framePosList_.push_back(filePosBegin);
         frameTimeStampList_.push_back(timeStamp);
 
+        if (frame.isPayloadCompressed())
+        {
+            writeCompressedPayloadFrame(frame);
+            return;
+        }
+
         // Write keyframe chunk identifier
         uint8_t chunkId = uint8_t(FRAME_CHUNK_ID);
         file_.write((char*) &chunkId, sizeof(uint8_t));
@@ -702,7 +856,65 @@ namespace bias
     }
 
 
+    void VideoWriter_ufmf::writeCompressedPayloadFrame(CompressedFrame_ufmf frame)
+    {
+        // Compressed frame chunk (version 5) - chunk id, time stamp, number of
+        // boxes, size of the uncompressed payload, size of the zlib stream and 
+        // the zlib stream. See CompressedFrame_ufmf::createCompressedPayload for
+        // the layout of the uncompressed payload.
+        double timeStamp = frame.getTimeStamp();
+        std::shared_ptr<QByteArray> payloadPtr = frame.getPayloadPtr();
+
+        // qCompress prefixes the stream with a 4 byte length - skip it
+        const unsigned int qCompressHeaderSize = 4;
+        uint32_t rawSize = uint32_t(frame.getPayloadRawSize());
+        uint32_t compressedSize = uint32_t(payloadPtr -> size() - qCompressHeaderSize);
+
+        uint8_t chunkId = uint8_t(COMPRESSED_FRAME_CHUNK_ID);
+        file_.write((char*) &chunkId, sizeof(uint8_t));
+        file_.write((char*) &timeStamp, sizeof(double));
+
+        uint32_t numConnectedComp = uint32_t(frame.getNumConnectedComp());
+        file_.write((char*) &numConnectedComp, sizeof(uint32_t));
+
+        file_.write((char*) &rawSize, sizeof(uint32_t));
+        file_.write((char*) &compressedSize, sizeof(uint32_t));
+        file_.write(payloadPtr -> constData() + qCompressHeaderSize, compressedSize);
+    }
+
+
     void VideoWriter_ufmf::writeKeyFrame()
+    {
+        // Use a delta keyframe when enabled and the previous keyframe is usable as 
+        // a reference. A full keyframe is forced every keyFrameFullInterval_ 
+        // keyframes so that readers can seek without replaying the whole file.
+        bool useDelta = keyFrameDeltaFlag_;
+        useDelta &= (numKeyFramesWritten_ > 0);
+        useDelta &= (keyFramesSinceFull_ + 1 < keyFrameFullInterval_);
+        useDelta &= (bgKeyFrameImage_.size() == bgMedianImage_.size());
+
+        if (useDelta)
+        {
+            writeDeltaKeyFrame();
+            keyFramesSinceFull_++;
+        }
+        else
+        {
+            writeFullKeyFrame();
+            keyFramesSinceFull_ = 0;
+        }
+
+        if (keyFrameDeltaFlag_)
+        {
+            // Save reference for next delta - median images are replaced, not 
+            // modified in place, but clone anyway as the initial one is the frame.
+            bgKeyFrameImage_ = bgMedianImage_.clone();
+        }
+        numKeyFramesWritten_++;
+    }
+
+
+    void VideoWriter_ufmf::writeFullKeyFrame()
     {
         // Get position and time stamp for index
         bgKeyFramePosList_.push_back(file_.tellp());
@@ -713,10 +925,10 @@ namespace bias
         file_.write((char*) &chunkId, sizeof(uint8_t));
 
         // Write keyframe type
-        const char keyFrameType[] = "mean";
-        uint8_t keyFrameTypeLength = sizeof(keyFrameType)-1;
+        QByteArray keyFrameTypeArray = KEYFRAME_TYPE_MEAN.toLatin1();
+        uint8_t keyFrameTypeLength = uint8_t(keyFrameTypeArray.size());
         file_.write((char*) &keyFrameTypeLength, sizeof(uint8_t));
-        file_.write((char*) keyFrameType, keyFrameTypeLength*sizeof(char));
+        file_.write((char*) keyFrameTypeArray.data(), keyFrameTypeLength*sizeof(char));
 
         // Discrepancy ... what about number of points/boxes
 
@@ -740,6 +952,93 @@ namespace bias
     }
 
 
+    void VideoWriter_ufmf::writeDeltaKeyFrame()
+    {
+        // Delta keyframe layout (version 5) - DELTA_KEYFRAME_CHUNK_ID, then
+        // the same header as a full keyframe followed by the tile size, the
+        // number of changed tiles and then, for each changed tile, (col, row,
+        // width, height) as uint16 and the tile pixels. Tiles replace the
+        // corresponding region of the previous keyframe.
+
+        unsigned int numRow = (unsigned int)(bgMedianImage_.rows);
+        unsigned int numCol = (unsigned int)(bgMedianImage_.cols);
+
+        // Find tiles which differ from the previous keyframe
+        std::vector<cv::Rect> changedTileVec;
+        for (unsigned int row=0; row<numRow; row+=keyFrameTileSize_)
+        {
+            unsigned int hgt = std::min(keyFrameTileSize_, numRow-row);
+            for (unsigned int col=0; col<numCol; col+=keyFrameTileSize_)
+            {
+                unsigned int wdt = std::min(keyFrameTileSize_, numCol-col);
+                for (unsigned int i=row; i<row+hgt; i++)
+                {
+                    const uchar *currPtr = bgMedianImage_.ptr<uchar>(i) + col;
+                    const uchar *prevPtr = bgKeyFrameImage_.ptr<uchar>(i) + col;
+                    if (std::memcmp(currPtr, prevPtr, wdt) != 0)
+                    {
+                        changedTileVec.push_back(cv::Rect(col,row,wdt,hgt));
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Get position and time stamp for index
+        bgDeltaKeyFramePosList_.push_back(file_.tellp());
+        bgDeltaKeyFrameTimeStampList_.push_back(bgModelTimeStamp_);
+
+        // Write delta keyframe chunk identifier
+        uint8_t chunkId = uint8_t(DELTA_KEYFRAME_CHUNK_ID);
+        file_.write((char*) &chunkId, sizeof(uint8_t));
+
+        // Write keyframe type
+        QByteArray keyFrameTypeArray = KEYFRAME_TYPE_MEAN_DELTA.toLatin1();
+        uint8_t keyFrameTypeLength = uint8_t(keyFrameTypeArray.size());
+        file_.write((char*) &keyFrameTypeLength, sizeof(uint8_t));
+        file_.write((char*) keyFrameTypeArray.data(), keyFrameTypeLength*sizeof(char));
+
+        // Write char specifying data type
+        file_.write((char*) &CHAR_FOR_DTYPE_UINT8, sizeof(char));
+
+        // Write width and height
+        uint16_t width = uint16_t(numCol);
+        file_.write((char*) &width, sizeof(uint16_t));
+
+        uint16_t height = uint16_t(numRow);
+        file_.write((char*) &height, sizeof(uint16_t));
+
+        // Write timestamp
+        file_.write((char*) &bgModelTimeStamp_, sizeof(double));
+
+        // Write tile size and number of changed tiles
+        uint16_t tileSize = uint16_t(keyFrameTileSize_);
+        file_.write((char*) &tileSize, sizeof(uint16_t));
+
+        uint32_t numTiles = uint32_t(changedTileVec.size());
+        file_.write((char*) &numTiles, sizeof(uint32_t));
+
+        // Write each changed tile
+        for (unsigned int i=0; i<changedTileVec.size(); i++)
+        {
+            cv::Rect tile = changedTileVec[i];
+            uint16_t col = uint16_t(tile.x);
+            uint16_t row = uint16_t(tile.y);
+            uint16_t wdt = uint16_t(tile.width);
+            uint16_t hgt = uint16_t(tile.height);
+
+            file_.write((char*) &col, sizeof(uint16_t));
+            file_.write((char*) &row, sizeof(uint16_t));
+            file_.write((char*) &wdt, sizeof(uint16_t));
+            file_.write((char*) &hgt, sizeof(uint16_t));
+            for (int j=tile.y; j<tile.y+tile.height; j++)
+            {
+                file_.write((char*) (bgMedianImage_.ptr<uchar>(j) + tile.x), wdt*sizeof(char));
+            }
+        }
+    }
+
+
     void VideoWriter_ufmf::startBackgroundModeling()
     {
         bgImageQueuePtr_ -> clear();
@@ -747,6 +1046,20 @@ namespace bias
         bgOldDataQueuePtr_ -> clear();
         medianMatQueuePtr_ -> clear();
 
+        if (backgroundModel_ == BACKGROUND_MODEL_RUNNING_MEDIAN)
+        {
+            // Streaming model - single thread, one byte of state per pixel
+            bgRunningMedianPtr_ = new BackgroundRunningMedian_ufmf(
+                    bgImageQueuePtr_,
+                    medianMatQueuePtr_,
+                    cameraNumber_
+                    );
+            bgRunningMedianPtr_ -> setMedianUpdateCount(medianUpdateCount_);
+            bgRunningMedianPtr_ -> setMedianUpdateInterval(medianUpdateInterval_);
+            threadPoolPtr_ -> start(bgRunningMedianPtr_);
+            return;
+        }
+
         bgHistogramPtr_ = new BackgroundHistogram_ufmf(
                 bgImageQueuePtr_,
                 bgNewDataQueuePtr_,
@@ -772,6 +1085,17 @@ namespace bias
     void VideoWriter_ufmf::stopBackgroundModeling()
     {
         // Signal for background modeling threads to stop
+        if (!bgRunningMedianPtr_.isNull())
+        {
+            bgRunningMedianPtr_ -> acquireLock();
+            bgRunningMedianPtr_ -> stop();
+            bgRunningMedianPtr_ -> releaseLock();
+
+            bgImageQueuePtr_ -> acquireLock();
+            bgImageQueuePtr_ -> signalNotEmpty();
+            bgImageQueuePtr_ -> releaseLock();
+        }
+
         if (!bgMedianPtr_.isNull())
         {
             bgMedianPtr_ -> acquireLock();
@@ -809,6 +1133,7 @@ namespace bias
                     framesToDoQueuePtr_,
                     framesFinishedSetPtr_,
                     framesSkippedIndexListPtr_,
+                    frameDrainPtr_,
                     cameraNumber_
                     );
             threadPoolPtr_ -> start(compressorPtrVec_[i]);
@@ -816,7 +1141,8 @@ namespace bias
                     compressorPtrVec_[i],
                     SIGNAL(imageLoggingError(unsigned int, QString)),
                     this,
-                    SLOT(onCompressorError(unsigned int, QString))
+                    SLOT(onCompressorError(unsigned int, QString)),
+                    Qt::DirectConnection
                    );
         }
     }
@@ -834,18 +1160,42 @@ namespace bias
             }
         }
 
-        // Wait until all compressor threads are null
-        for (unsigned int i=0; i<compressorPtrVec_.size(); i++)
+        // Wait for the worker threads to exit - blocking, waking any which are
+        // still waiting on an empty queue. The pool is shared with background 
+        // modeling so it must be stopped first.
+        while (!(threadPoolPtr_ -> waitForDone(COMPRESSOR_WAIT_TIMEOUT)))
         {
-            while (!(compressorPtrVec_[i].isNull()))
-            {
-                framesToDoQueuePtr_ -> acquireLock();
-                framesToDoQueuePtr_ -> wakeOne();
-                framesToDoQueuePtr_ -> releaseLock();
-            }
+            framesToDoQueuePtr_ -> acquireLock();
+            framesToDoQueuePtr_ -> signalNotEmpty();
+            framesToDoQueuePtr_ -> releaseLock();
+
+            bgImageQueuePtr_ -> acquireLock();
+            bgImageQueuePtr_ -> signalNotEmpty();
+            bgImageQueuePtr_ -> releaseLock();
+
+            bgNewDataQueuePtr_ -> acquireLock();
+            bgNewDataQueuePtr_ -> signalNotEmpty();
+            bgNewDataQueuePtr_ -> releaseLock();
         }
     }
 
+    // Static methods
+    // ----------------------------------------------------------------------------------
+    QStringList VideoWriter_ufmf::getListOfAllowedBackgroundModels()
+    {
+        QStringList modelList;
+        modelList << BACKGROUND_MODEL_HISTOGRAM;
+        modelList << BACKGROUND_MODEL_RUNNING_MEDIAN;
+        return modelList;
+    }
+
+
+    bool VideoWriter_ufmf::isAllowedBackgroundModel(QString modelString)
+    {
+        QStringList allowedModelList = getListOfAllowedBackgroundModels();
+        return allowedModelList.contains(modelString);
+    }
+
     // Private slots
     // ----------------------------------------------------------------------------------
     void VideoWriter_ufmf::onCompressorError(unsigned int errorId, QString errorMsg)
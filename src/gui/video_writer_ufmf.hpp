@@ -9,6 +9,7 @@
 #include <vector>
 #include <list>
 #include <QPointer>
+#include <QStringList>
 #include <opencv2/core/core.hpp>
 #include <fstream>
 
@@ -19,6 +20,7 @@ namespace bias
     class BackgroundData_ufmf;
     class BackgroundHistogram_ufmf;
     class BackgroundMedian_ufmf;
+    class BackgroundRunningMedian_ufmf;
     template <class T> class Lockable;
     template <class T> class LockableQueue;
 
@@ -38,8 +40,10 @@ namespace bias
                     );
 
             virtual ~VideoWriter_ufmf();
+            virtual void prepare(StampedImage stampedImg);
             virtual void addFrame(StampedImage stampedImg);
             virtual void finish();
+            virtual FrameDrainPtr getFrameDrain() const;
 
             // Static members
             static const unsigned int FRAMES_TODO_MAX_QUEUE_SIZE;
@@ -65,8 +69,25 @@ namespace bias
             static const unsigned int MIN_DILATE_WINDOW_SIZE;
             static const unsigned int MAX_DILATE_WINDOW_SIZE;
 
+            static const QString BACKGROUND_MODEL_HISTOGRAM;
+            static const QString BACKGROUND_MODEL_RUNNING_MEDIAN;
+            static const QString DEFAULT_BACKGROUND_MODEL;
+
+            static const bool DEFAULT_KEYFRAME_DELTA_FLAG;
+            static const unsigned int DEFAULT_KEYFRAME_TILE_SIZE;
+            static const unsigned int MIN_KEYFRAME_TILE_SIZE;
+            static const unsigned int MAX_KEYFRAME_TILE_SIZE;
+            static const unsigned int DEFAULT_KEYFRAME_FULL_INTERVAL;
+            static const unsigned int MIN_KEYFRAME_FULL_INTERVAL;
+
+            static const bool DEFAULT_COMPRESS_PAYLOAD_FLAG;
+            static const int DEFAULT_COMPRESS_PAYLOAD_LEVEL;
+            static const int MIN_COMPRESS_PAYLOAD_LEVEL;
+            static const int MAX_COMPRESS_PAYLOAD_LEVEL;
+
             static const VideoWriterParams_ufmf DEFAULT_PARAMS;
             static const unsigned int UFMF_VERSION_NUMBER;
+            static const unsigned int UFMF_EXTENDED_VERSION_NUMBER;
 
             static const QString DEFAULT_COLOR_CODING;
             static const QString DUMMY_FILENAME;
@@ -75,6 +96,11 @@ namespace bias
             static const unsigned int KEYFRAME_CHUNK_ID;
             static const unsigned int FRAME_CHUNK_ID;
             static const unsigned int INDEX_DICT_CHUNK_ID;
+            static const unsigned int COMPRESSED_FRAME_CHUNK_ID;
+            static const unsigned int DELTA_KEYFRAME_CHUNK_ID;
+
+            static const QString KEYFRAME_TYPE_MEAN;
+            static const QString KEYFRAME_TYPE_MEAN_DELTA;
 
             static const char CHAR_FOR_DICT;
             static const char CHAR_FOR_ARRAY;
@@ -84,9 +110,14 @@ namespace bias
             static const char CHAR_FOR_DTYPE_UINT64;
             static const char CHAR_FOR_DTYPE_DOUBLE;
 
+            // Static methods
+            static QStringList getListOfAllowedBackgroundModels();
+            static bool isAllowedBackgroundModel(QString modelString);
+
         protected:
 
             bool isFirst_;
+            bool finished_;
             bool skipReported_;
             unsigned int backgroundThreshold_;
             unsigned int medianUpdateCount_;
@@ -99,6 +130,16 @@ namespace bias
             bool dilateState_;
             unsigned int dilateWindowSize_;
 
+            QString backgroundModel_;
+
+            bool keyFrameDeltaFlag_;
+            unsigned int keyFrameTileSize_;
+            unsigned int keyFrameFullInterval_;
+            unsigned long keyFramesSinceFull_;
+
+            bool compressPayloadFlag_;
+            int compressPayloadLevel_;
+
             std::fstream file_;
             std::streampos indexLocation_;
             std::streampos indexLocationPtr_;
@@ -116,16 +157,21 @@ namespace bias
             std::list<double> frameTimeStampList_;
             std::list<double> bgKeyFrameTimeStampList_;
 
+            std::list<std::streampos> bgDeltaKeyFramePosList_;
+            std::list<double> bgDeltaKeyFrameTimeStampList_;
+
             StampedImage currentImage_;
 
             cv::Mat bgMedianImage_;
             cv::Mat bgUpperBoundImage_;
             cv::Mat bgLowerBoundImage_;
             cv::Mat bgMembershipImage_;
+            cv::Mat bgKeyFrameImage_;
 
             QPointer<QThreadPool> threadPoolPtr_;
             QPointer<BackgroundHistogram_ufmf> bgHistogramPtr_;
             QPointer<BackgroundMedian_ufmf> bgMedianPtr_;
+            QPointer<BackgroundRunningMedian_ufmf> bgRunningMedianPtr_;
 
             std::vector<QPointer<Compressor_ufmf>> compressorPtrVec_;
 
@@ -138,13 +184,24 @@ namespace bias
             CompressedFrameQueuePtr_ufmf framesWaitQueuePtr_;
             CompressedFrameSetPtr_ufmf framesFinishedSetPtr_;
             std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr_;
+            FrameDrainPtr frameDrainPtr_;
 
             unsigned int clearFinishedFrames();
+            void flushFinishedFrames();
+            void dropQueuedFrames();
             void checkImageFormat(StampedImage stampedImg);
             void setupOutputFile(StampedImage stampedImg);
             void writeHeader();
             void writeKeyFrame();
+            void writeFullKeyFrame();
+            void writeDeltaKeyFrame();
+            void writeKeyFrameIndex(
+                    const QString &keyFrameType,
+                    const std::list<std::streampos> &posList,
+                    const std::list<double> &timeStampList
+                    );
             void writeCompressedFrame(CompressedFrame_ufmf frame);
+            void writeCompressedPayloadFrame(CompressedFrame_ufmf frame);
             void finishWriting();
 
             void startBackgroundModeling();
@@ -0,0 +1,563 @@
+#include "video_writer_zfmf.hpp"
+#include "basic_types.hpp"
+#include "exception.hpp"
+#include <iostream>
+#include <algorithm>
+#include <QThreadPool>
+#include <stdexcept>
+
+namespace bias
+{
+    const std::string VideoWriter_zfmf::ZFMF_HEADER_MAGIC = std::string("zfmf");
+    const unsigned int VideoWriter_zfmf::ZFMF_VERSION = 1;
+    const uint8_t VideoWriter_zfmf::FRAME_CHUNK_ID = 1;
+    const uint8_t VideoWriter_zfmf::INDEX_CHUNK_ID = 2;
+    const unsigned int VideoWriter_zfmf::FRAMES_TODO_MAX_QUEUE_SIZE = 250;
+    const unsigned int VideoWriter_zfmf::FRAMES_FINISHED_MAX_SET_SIZE = 250;
+    const unsigned int VideoWriter_zfmf::DEFAULT_FRAME_SKIP = 1;
+    const unsigned int VideoWriter_zfmf::DEFAULT_NUMBER_OF_COMPRESSORS = 4;
+    const int VideoWriter_zfmf::DEFAULT_COMPRESSION_LEVEL = 1;
+    const int VideoWriter_zfmf::MIN_COMPRESSION_LEVEL = 0;
+    const int VideoWriter_zfmf::MAX_COMPRESSION_LEVEL = 9;
+    const bool VideoWriter_zfmf::DEFAULT_DELTA_FLAG = false;
+    const unsigned int VideoWriter_zfmf::DEFAULT_KEYFRAME_INTERVAL = 30;
+    const unsigned int VideoWriter_zfmf::MIN_KEYFRAME_INTERVAL = 1;
+    const unsigned int VideoWriter_zfmf::DEFAULT_TILE_ROWS = 64;
+    const unsigned int VideoWriter_zfmf::MIN_TILE_ROWS = 1;
+    const unsigned int VideoWriter_zfmf::MAX_TILE_ROWS = 4096;
+    const QString DUMMY_FILENAME("dummy.zfmf");
+    const int COMPRESSOR_WAIT_TIMEOUT = 10;  // msec
+    const VideoWriterParams_zfmf VideoWriter_zfmf::DEFAULT_PARAMS = VideoWriterParams_zfmf();
+
+    // VideoWriter_zfmf methods
+    VideoWriter_zfmf::VideoWriter_zfmf(QObject *parent)
+        : VideoWriter_zfmf(DEFAULT_PARAMS,DUMMY_FILENAME,0,parent)
+    {}
+
+    VideoWriter_zfmf::VideoWriter_zfmf(
+            VideoWriterParams_zfmf params,
+            QString fileName,
+            unsigned int cameraNumber,
+            QObject *parent
+            ) : VideoWriter(fileName,cameraNumber,parent)
+    {
+        isFirst_ = true;
+        skipReported_ = false;
+        compressorsRunning_ = false;
+        nextFrameToWrite_ = 0;
+        refFrameCount_ = 0;
+        framesSinceKeyFrame_ = 0;
+        haveWrittenFrame_ = false;
+        lastWrittenFrameCount_ = 0;
+        indexLocPos_ = 0;
+
+        setFrameSkip(params.frameSkip);
+        numberOfCompressors_ = params.numberOfCompressors;
+        compressionLevel_ = params.compressionLevel;
+        deltaFlag_ = params.deltaFlag;
+        keyFrameInterval_ = std::max(params.keyFrameInterval, MIN_KEYFRAME_INTERVAL);
+        tileRows_ = std::max(params.tileRows, MIN_TILE_ROWS);
+
+        threadPoolPtr_ = new QThreadPool(this);
+        threadPoolPtr_ -> setMaxThreadCount(numberOfCompressors_);
+        framesToDoQueuePtr_ = std::make_shared<CompressedFrameQueue_zfmf>();
+        framesFinishedSetPtr_ = std::make_shared<CompressedFrameSet_zfmf>();
+        framesSkippedIndexListPtr_ = std::make_shared<Lockable<std::list<unsigned long>>>();
+        frameDrainPtr_ = std::make_shared<FrameDrain>();
+    }
+
+
+    VideoWriter_zfmf::~VideoWriter_zfmf()
+    {
+        stopCompressors();
+        file_.close();
+    }
+
+
+    void VideoWriter_zfmf::prepare(StampedImage stampedImg)
+    {
+        if (isFirst_)
+        {
+            checkImageFormat(stampedImg);
+            setupOutputFile(stampedImg);
+            startCompressors();
+            isFirst_= false;
+        }
+    }
+
+
+    void VideoWriter_zfmf::addFrame(StampedImage stampedImg)
+    {
+        bool skipFrame = false;
+
+        prepare(stampedImg);
+
+        if (frameCount_%frameSkip_==0)
+        {
+            CompressedFrame_zfmf compressedFrame(stampedImg, tileRows_, compressionLevel_);
+
+            bool isKeyFrame = (!deltaFlag_) || refImage_.empty() || (framesSinceKeyFrame_ >= keyFrameInterval_);
+            if (!isKeyFrame)
+            {
+                compressedFrame.setReference(refImage_, refFrameCount_);
+            }
+
+            framesToDoQueuePtr_ -> acquireLock();
+            unsigned int framesToDoQueueSize = framesToDoQueuePtr_ -> size();
+            if (framesToDoQueueSize < FRAMES_TODO_MAX_QUEUE_SIZE)
+            {
+                frameDrainPtr_ -> frameQueued();
+                framesToDoQueuePtr_ -> push(compressedFrame);
+                framesToDoQueuePtr_ -> wakeOne();
+            }
+            else
+            {
+                skipFrame = true;
+            }
+            framesToDoQueuePtr_ -> releaseLock();
+
+            if (skipFrame)
+            {
+                frameDrainPtr_ -> frameSkipped();
+                framesSkippedIndexListPtr_ -> acquireLock();
+                framesSkippedIndexListPtr_ -> push_back(stampedImg.frameCount);
+                framesSkippedIndexListPtr_ -> releaseLock();
+
+                // Chain is broken - next frame must be a key frame
+                refImage_ = cv::Mat();
+            }
+            else if (deltaFlag_)
+            {
+                refImage_ = stampedImg.image;
+                refFrameCount_ = stampedImg.frameCount;
+                framesSinceKeyFrame_ = isKeyFrame ? 1 : framesSinceKeyFrame_ + 1;
+            }
+        }
+
+        if ((skipFrame) && (!skipReported_))
+        {
+            std::cout << "warning: logging overflow - skipped frame -" << std::endl;
+            unsigned int errorId = ERROR_FRAMES_TODO_MAX_QUEUE_SIZE;
+            QString errorMsg("logger framesToDoQueue has exceeded the maximum allowed size");
+            emit imageLoggingError(errorId, errorMsg);
+            skipReported_ = true;
+        }
+
+        clearFinishedFrames();
+        frameCount_++;
+    }
+
+
+    FrameDrainPtr VideoWriter_zfmf::getFrameDrain() const
+    {
+        return frameDrainPtr_;
+    }
+
+
+    void VideoWriter_zfmf::finish()
+    {
+        if (isFirst_)
+        {
+            return;
+        }
+
+        // Wait for the compressors to work through the queued frames, writing
+        // finished frames as they arrive, then shut them down. Frames still 
+        // queued when the finish timeout expires are dropped.
+        unsigned long numberDroppedBefore = frameDrainPtr_ -> numberDropped();
+        bool drained = waitForFrameDrain(frameDrainPtr_, [this]() { clearFinishedFrames(); });
+        if (!drained)
+        {
+            dropQueuedFrames();
+        }
+        stopCompressors();
+        flushFinishedFrames();
+
+        if (!drained)
+        {
+            reportDroppedFrames(frameDrainPtr_ -> numberDropped() - numberDroppedBefore);
+        }
+
+        try
+        {
+            writeIndex();
+        }
+        catch (std::ifstream::failure &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_FINISH;
+            std::string errorMsg("video writer zfmf finish - failed to write index:\n\n");
+            errorMsg += exc.what();
+            throw RuntimeError(errorId, errorMsg);
+        }
+    }
+
+
+    void VideoWriter_zfmf::checkImageFormat(StampedImage stampedImg)
+    {
+        int depth = stampedImg.image.depth();
+        if ((depth != CV_8U) && (depth != CV_16U))
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            std::string errorMsg("video writer zfmf setup failed:\n\n");
+            errorMsg += "image depth must be CV_8U or CV_16U";
+            throw RuntimeError(errorId,errorMsg);
+        }
+    }
+
+
+    void VideoWriter_zfmf::setupOutputFile(StampedImage stampedImg)
+    {
+        // Set error control state, set exceptions mask
+        file_.clear();
+        file_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+        // Get unique name for file and open for writing
+        QString incrFileName = getUniqueFileName();
+
+        try
+        {
+            file_.open(incrFileName.toStdString(), std::ios::binary | std::ios::out);
+        }
+        catch (std::ifstream::failure &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            std::string errorMsg("video writer unable to open file:\n\n");
+            errorMsg += exc.what();
+            throw RuntimeError(errorId, errorMsg);
+        }
+
+        if (!file_.is_open())
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            std::string errorMsg("video writer unable to open file:\n\n");
+            errorMsg += "no exception thrown";
+            throw RuntimeError(errorId, errorMsg);
+        }
+
+        setSize(stampedImg.image.size());
+
+        try
+        {
+            writeHeader(stampedImg);
+        }
+        catch (std::ifstream::failure &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            std::string errorMsg("video writer unable to write zfmf header:\n\n");
+            errorMsg += exc.what();
+            throw RuntimeError(errorId, errorMsg);
+        }
+    }
+
+
+    void VideoWriter_zfmf::writeHeader(StampedImage stampedImg)
+    {
+        uint32_t version = uint32_t(ZFMF_VERSION);
+        uint64_t indexLoc = 0;
+        uint32_t width = uint32_t(size_.width);
+        uint32_t height = uint32_t(size_.height);
+        uint32_t channels = uint32_t(stampedImg.image.channels());
+        uint32_t bytesPerChannel = uint32_t(stampedImg.image.elemSize1());
+        uint32_t tileRows = uint32_t(tileRows_);
+
+        file_.write(ZFMF_HEADER_MAGIC.c_str(), ZFMF_HEADER_MAGIC.size());
+        file_.write((char*) &version, sizeof(uint32_t));
+
+        // Placeholder for index location - filled in by writeIndex
+        indexLocPos_ = uint64_t(file_.tellp());
+        file_.write((char*) &indexLoc, sizeof(uint64_t));
+
+        file_.write((char*) &width, sizeof(uint32_t));
+        file_.write((char*) &height, sizeof(uint32_t));
+        file_.write((char*) &channels, sizeof(uint32_t));
+        file_.write((char*) &bytesPerChannel, sizeof(uint32_t));
+        file_.write((char*) &tileRows, sizeof(uint32_t));
+    }
+
+
+    void VideoWriter_zfmf::writeCompressedFrame(CompressedFrame_zfmf &frame)
+    {
+        if (!frame.haveEncoding())
+        {
+            return;
+        }
+
+        std::vector<QByteArray> &tileVec = frame.getEncodedTileVec();
+
+        // qCompress prepends the uncompressed size (4 bytes, big endian) which
+        // is redundant here - only the zlib stream is written.
+        const int qHeaderSize = 4;
+
+        uint64_t framePos = uint64_t(file_.tellp());
+        uint8_t chunkId = FRAME_CHUNK_ID;
+        uint64_t frameCount = uint64_t(frame.getFrameCount());
+        double timeStamp = frame.getTimeStamp();
+        uint8_t isDelta = frame.isDelta() ? 1 : 0;
+        uint32_t numTiles = uint32_t(tileVec.size());
+
+        try
+        {
+            file_.write((char*) &chunkId, sizeof(uint8_t));
+            file_.write((char*) &frameCount, sizeof(uint64_t));
+            file_.write((char*) &timeStamp, sizeof(double));
+            file_.write((char*) &isDelta, sizeof(uint8_t));
+            file_.write((char*) &numTiles, sizeof(uint32_t));
+            for (unsigned int i=0; i<tileVec.size(); i++)
+            {
+                uint32_t tileSize = uint32_t(tileVec[i].size() - qHeaderSize);
+                file_.write((char*) &tileSize, sizeof(uint32_t));
+            }
+            for (unsigned int i=0; i<tileVec.size(); i++)
+            {
+                file_.write(tileVec[i].constData() + qHeaderSize, tileVec[i].size() - qHeaderSize);
+            }
+        }
+        catch (std::ifstream::failure &exc)
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_ADD_FRAME;
+            std::string errorMsg("video writer zfmf failed to write frame:\n\n");
+            errorMsg += exc.what();
+            throw RuntimeError(errorId, errorMsg);
+        }
+
+        framePosList_.push_back(framePos);
+        frameTimeStampList_.push_back(timeStamp);
+        frameIsKeyList_.push_back(isDelta ? 0 : 1);
+    }
+
+
+    void VideoWriter_zfmf::writeIndex()
+    {
+        file_.seekp(0, std::ios_base::end);
+        uint64_t indexLoc = uint64_t(file_.tellp());
+
+        uint8_t chunkId = INDEX_CHUNK_ID;
+        uint64_t numFrames = uint64_t(framePosList_.size());
+        file_.write((char*) &chunkId, sizeof(uint8_t));
+        file_.write((char*) &numFrames, sizeof(uint64_t));
+        if (numFrames > 0)
+        {
+            file_.write((char*) &framePosList_[0], numFrames*sizeof(uint64_t));
+            file_.write((char*) &frameTimeStampList_[0], numFrames*sizeof(double));
+            file_.write((char*) &frameIsKeyList_[0], numFrames*sizeof(uint8_t));
+        }
+
+        // Fill in index location in header
+        file_.seekp(indexLocPos_);
+        file_.write((char*) &indexLoc, sizeof(uint64_t));
+        file_.seekp(0, std::ios_base::end);
+        file_.flush();
+    }
+
+
+    void VideoWriter_zfmf::startCompressors()
+    {
+        framesToDoQueuePtr_ -> clear();
+        compressorPtrVec_.resize(numberOfCompressors_);
+        for (unsigned int i=0; i<compressorPtrVec_.size(); i++)
+        {
+            compressorPtrVec_[i] = new Compressor_zfmf(
+                    framesToDoQueuePtr_,
+                    framesFinishedSetPtr_,
+                    framesSkippedIndexListPtr_,
+                    frameDrainPtr_,
+                    cameraNumber_
+                    );
+            threadPoolPtr_ -> start(compressorPtrVec_[i]);
+            compressorsRunning_ = true;
+            connect(
+                    compressorPtrVec_[i],
+                    SIGNAL(imageLoggingError(unsigned int, QString)),
+                    this,
+                    SLOT(onCompressorError(unsigned int, QString)),
+                    Qt::DirectConnection
+                   );
+        }
+    }
+
+
+    void VideoWriter_zfmf::stopCompressors()
+    {
+        compressorsRunning_ = false;
+
+        // Send all compressor threads a stop signal
+        for (unsigned int i=0; i<compressorPtrVec_.size(); i++)
+        {
+            if (!(compressorPtrVec_[i].isNull()))
+            {
+                compressorPtrVec_[i] -> acquireLock();
+                compressorPtrVec_[i] -> stop();
+                compressorPtrVec_[i] -> releaseLock();
+            }
+        }
+
+        // Wait for the compressor threads to exit - blocking, waking any which 
+        // are still waiting on the empty queue.
+        while (!(threadPoolPtr_ -> waitForDone(COMPRESSOR_WAIT_TIMEOUT)))
+        {
+            framesToDoQueuePtr_ -> acquireLock();
+            framesToDoQueuePtr_ -> signalNotEmpty();
+            framesToDoQueuePtr_ -> releaseLock();
+        }
+    }
+
+
+    void VideoWriter_zfmf::dropQueuedFrames()
+    {
+        // Discard frames still waiting for a compressor. They are marked as
+        // skipped so that writing can continue past them.
+        unsigned long numberDropped = 0;
+        framesToDoQueuePtr_ -> acquireLock();
+        framesSkippedIndexListPtr_ -> acquireLock();
+        while (!(framesToDoQueuePtr_ -> empty()))
+        {
+            framesSkippedIndexListPtr_ -> push_back(framesToDoQueuePtr_ -> front().getFrameCount());
+            framesToDoQueuePtr_ -> pop();
+            numberDropped++;
+        }
+        framesSkippedIndexListPtr_ -> releaseLock();
+        framesToDoQueuePtr_ -> releaseLock();
+        frameDrainPtr_ -> frameDropped(numberDropped);
+    }
+
+
+    void VideoWriter_zfmf::flushFinishedFrames()
+    {
+        // Compressors have stopped - any gap left in the finished set is a 
+        // frame which will never arrive so write what remains in order. Delta
+        // frames whose reference was lost are re-encoded as key frames here,
+        // there is no compressor left to send them to.
+        unsigned int framesFinishedSetSize = clearFinishedFrames();
+        while (framesFinishedSetSize > 0)
+        {
+            framesFinishedSetPtr_ -> acquireLock();
+            nextFrameToWrite_ = framesFinishedSetPtr_ -> begin() -> getFrameCount();
+            framesFinishedSetPtr_ -> releaseLock();
+            framesFinishedSetSize = clearFinishedFrames();
+        }
+    }
+
+
+    unsigned int VideoWriter_zfmf::clearFinishedFrames()
+    {
+        framesFinishedSetPtr_ -> acquireLock();
+        bool framesFinishedSetEmpty = framesFinishedSetPtr_ -> empty();
+        framesFinishedSetPtr_ -> releaseLock();
+
+        if (!framesFinishedSetEmpty)
+        {
+            bool writeDone = false;
+            while ( (!writeDone) && (!framesFinishedSetEmpty) )
+            {
+                // Handle skipped frames.
+                // --------------------------------------------------------------------------------
+                framesSkippedIndexListPtr_ -> acquireLock();
+                if (framesSkippedIndexListPtr_ -> size() > 0)
+                {
+                    std::list<unsigned long>::iterator skippedIndexIt = framesSkippedIndexListPtr_ -> begin();
+                    bool done = false;
+
+                    while (!done)
+                    {
+                        if (*skippedIndexIt == nextFrameToWrite_)
+                        {
+                            nextFrameToWrite_ += frameSkip_;
+                        }
+                        else if (*skippedIndexIt < nextFrameToWrite_)
+                        {
+                            if (framesSkippedIndexListPtr_ -> size() > 1)
+                            {
+                                skippedIndexIt++;
+                            }
+                            else
+                            {
+                                done = true;
+                            }
+                            framesSkippedIndexListPtr_ -> pop_front();
+                        }
+                        else
+                        {
+                            done = true;
+                        }
+                    }
+                }
+                framesSkippedIndexListPtr_ -> releaseLock();
+
+                // Write next frame to file
+                // --------------------------------------------------------------------------------
+                bool requeueFrame = false;
+                framesFinishedSetPtr_ -> acquireLock();
+                CompressedFrameSet_zfmf::iterator frameIt = framesFinishedSetPtr_ -> begin();
+                CompressedFrame_zfmf compressedFrame = *frameIt;
+
+                if (compressedFrame.getFrameCount() == nextFrameToWrite_)
+                {
+                    framesFinishedSetPtr_ -> erase(frameIt);
+
+                    // A delta frame is only decodable if its reference is the
+                    // frame written just before it. When the reference was
+                    // dropped (skipped) fall back to a key frame - encoded by
+                    // a compressor, writing resumes once it comes back.
+                    bool refOk = true;
+                    if (compressedFrame.isDelta())
+                    {
+                        refOk = haveWrittenFrame_;
+                        refOk &= (compressedFrame.getRefFrameCount() == lastWrittenFrameCount_);
+                        if (!refOk)
+                        {
+                            compressedFrame.clearReference();
+                        }
+                    }
+
+                    if (!refOk && compressorsRunning_)
+                    {
+                        requeueFrame = true;
+                        writeDone = true;
+                    }
+                    else
+                    {
+                        if (!refOk)
+                        {
+                            compressedFrame.encode();
+                        }
+                        nextFrameToWrite_ += frameSkip_;
+                        writeCompressedFrame(compressedFrame);
+                        haveWrittenFrame_ = true;
+                        lastWrittenFrameCount_ = compressedFrame.getFrameCount();
+                    }
+                }
+                else
+                {
+                    writeDone = true;
+                }
+                framesFinishedSetEmpty = framesFinishedSetPtr_ -> empty();
+                framesFinishedSetPtr_ -> releaseLock();
+
+                if (requeueFrame)
+                {
+                    frameDrainPtr_ -> frameQueued();
+                    framesToDoQueuePtr_ -> acquireLock();
+                    framesToDoQueuePtr_ -> push(compressedFrame);
+                    framesToDoQueuePtr_ -> wakeOne();
+                    framesToDoQueuePtr_ -> releaseLock();
+                }
+
+            } // while ( (!writeDone) && (!framesFinishedSetEmpty) )
+
+        } // if (!framesFinishedSetEmpty)
+
+        framesFinishedSetPtr_ -> acquireLock();
+        unsigned int framesFinishedSetSize = framesFinishedSetPtr_ -> size();
+        framesFinishedSetPtr_ -> releaseLock();
+        return framesFinishedSetSize;
+    }
+
+
+    // Private slots
+    // ----------------------------------------------------------------------------------
+    void VideoWriter_zfmf::onCompressorError(unsigned int errorId, QString errorMsg)
+    {
+        emit imageLoggingError(errorId, errorMsg);
+    }
+
+} // namespace bias
@@ -0,0 +1,129 @@
+#ifndef BIAS_VIDEO_WRITER_ZFMF_HPP
+#define BIAS_VIDEO_WRITER_ZFMF_HPP
+#include "video_writer.hpp"
+#include "video_writer_params.hpp"
+#include "compressed_frame_zfmf.hpp"
+#include "compressor_zfmf.hpp"
+#include <QPointer>
+#include <QString>
+#include <vector>
+#include <list>
+#include <string>
+#include <fstream>
+#include <stdint.h>
+
+class QThreadPool;
+
+namespace bias
+{
+
+    // Lossless full frame writer. Frames are compressed (zlib) in parallel by
+    // a pool of compressors - optionally as the wrap around difference from
+    // the previous frame - and written in frame order to a single chunked file
+    // which ends with a seek index.
+    //
+    // File layout (little endian):
+    //
+    //   header:  "zfmf" | version u32 | indexLoc u64 | width u32 | height u32 |
+    //            channels u32 | bytesPerChannel u32 | tileRows u32
+    //   frame:   FRAME_CHUNK_ID u8 | frameCount u64 | timeStamp f64 | isDelta u8 |
+    //            numTiles u32 | tileSize u32 x numTiles | zlib streams
+    //   index:   INDEX_CHUNK_ID u8 | numFrames u64 | pos u64 x numFrames |
+    //            timeStamp f64 x numFrames | isKeyFrame u8 x numFrames
+
+    class VideoWriter_zfmf : public VideoWriter
+    {
+        Q_OBJECT
+
+        public:
+
+            VideoWriter_zfmf(QObject *parent=0);
+            explicit VideoWriter_zfmf(
+                    VideoWriterParams_zfmf params,
+                    QString fileName,
+                    unsigned int cameraNumber,
+                    QObject *parent=0
+                    );
+
+            virtual ~VideoWriter_zfmf();
+            virtual void prepare(StampedImage stampedImg);
+            virtual void addFrame(StampedImage stampedImg);
+            virtual void finish();
+            virtual FrameDrainPtr getFrameDrain() const;
+
+            static const std::string ZFMF_HEADER_MAGIC;
+            static const unsigned int ZFMF_VERSION;
+            static const uint8_t FRAME_CHUNK_ID;
+            static const uint8_t INDEX_CHUNK_ID;
+            static const unsigned int FRAMES_TODO_MAX_QUEUE_SIZE;
+            static const unsigned int FRAMES_FINISHED_MAX_SET_SIZE;
+            static const unsigned int DEFAULT_FRAME_SKIP;
+            static const unsigned int DEFAULT_NUMBER_OF_COMPRESSORS;
+            static const int DEFAULT_COMPRESSION_LEVEL;
+            static const int MIN_COMPRESSION_LEVEL;
+            static const int MAX_COMPRESSION_LEVEL;
+            static const bool DEFAULT_DELTA_FLAG;
+            static const unsigned int DEFAULT_KEYFRAME_INTERVAL;
+            static const unsigned int MIN_KEYFRAME_INTERVAL;
+            static const unsigned int DEFAULT_TILE_ROWS;
+            static const unsigned int MIN_TILE_ROWS;
+            static const unsigned int MAX_TILE_ROWS;
+            static const VideoWriterParams_zfmf DEFAULT_PARAMS;
+
+        protected:
+
+            bool isFirst_;
+            bool skipReported_;
+            bool compressorsRunning_;
+            unsigned int numberOfCompressors_;
+            int compressionLevel_;
+            bool deltaFlag_;
+            unsigned int keyFrameInterval_;
+            unsigned int tileRows_;
+
+            unsigned long nextFrameToWrite_;
+
+            // Reference for the next delta frame (last frame queued)
+            cv::Mat refImage_;
+            unsigned long refFrameCount_;
+            unsigned int framesSinceKeyFrame_;
+
+            // Last frame actually written - delta frames must reference it
+            bool haveWrittenFrame_;
+            unsigned long lastWrittenFrameCount_;
+
+            std::fstream file_;
+            uint64_t indexLocPos_;
+            std::vector<uint64_t> framePosList_;
+            std::vector<double> frameTimeStampList_;
+            std::vector<uint8_t> frameIsKeyList_;
+
+            std::vector<QPointer<Compressor_zfmf>> compressorPtrVec_;
+
+            CompressedFrameQueuePtr_zfmf framesToDoQueuePtr_;
+            CompressedFrameSetPtr_zfmf framesFinishedSetPtr_;
+            std::shared_ptr<Lockable<std::list<unsigned long>>> framesSkippedIndexListPtr_;
+            FrameDrainPtr frameDrainPtr_;
+
+            QPointer<QThreadPool> threadPoolPtr_;
+
+            void checkImageFormat(StampedImage stampedImg);
+            void setupOutputFile(StampedImage stampedImg);
+            void writeHeader(StampedImage stampedImg);
+            void writeCompressedFrame(CompressedFrame_zfmf &frame);
+            void writeIndex();
+
+            void startCompressors();
+            void stopCompressors();
+            unsigned int clearFinishedFrames();
+            void flushFinishedFrames();
+            void dropQueuedFrames();
+
+        private slots:
+            void onCompressorError(unsigned int errorId, QString errorMsg);
+
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_VIDEO_WRITER_ZFMF_HPP
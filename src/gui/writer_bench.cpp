@@ -0,0 +1,548 @@
+#include "writer_bench.hpp"
+#include "video_writer.hpp"
+#include "video_writer_factory.hpp"
+#include "video_reader.hpp"
+#include "image_logger.hpp"
+#include "exception.hpp"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace bias
+{
+    // Constants
+    // -------------------------------------------------------------------------------------------------------
+    const unsigned long WriterBench::DEFAULT_NUMBER_OF_FRAMES = 1000;
+    const unsigned long WriterBench::DEFAULT_NUMBER_OF_PRELOAD = 200;
+    const unsigned long WriterBench::DEFAULT_MAX_PENDING = 100;
+    const cv::Size WriterBench::DEFAULT_IMAGE_SIZE = cv::Size(1024,1024);
+    const unsigned int WriterBench::DEFAULT_NUMBER_OF_BLOBS = 10;
+
+    const int LOGGER_WAIT_TIMEOUT = 10;             // msec
+    const unsigned long FEED_SLEEP_INTERVAL = 200;  // usec
+    const double BYTES_PER_MEGABYTE = 1.0e6;
+
+
+    // WriterBenchParams
+    // -------------------------------------------------------------------------------------------------------
+    WriterBenchParams::WriterBenchParams()
+    {
+        videoFileFormat = VIDEOFILE_FORMAT_UFMF;
+        outputDir = QDir::tempPath();
+        numberOfFrames = WriterBench::DEFAULT_NUMBER_OF_FRAMES;
+        numberOfPreload = WriterBench::DEFAULT_NUMBER_OF_PRELOAD;
+        frameRate = 0.0;
+        maxPending = WriterBench::DEFAULT_MAX_PENDING;
+        imageSize = WriterBench::DEFAULT_IMAGE_SIZE;
+        colorFlag = false;
+        keepOutput = false;
+    }
+
+
+    std::string WriterBenchParams::toString()
+    {
+        std::stringstream ss;
+        ss << "format: " << getVideoFileExtensionMap()[videoFileFormat].toStdString() << std::endl;
+        ss << "outputDir: " << outputDir.toStdString() << std::endl;
+        ss << "inputFileName: " << inputFileName.toStdString() << std::endl;
+        ss << "numberOfFrames: " << numberOfFrames << std::endl;
+        ss << "numberOfPreload: " << numberOfPreload << std::endl;
+        ss << "frameRate: " << frameRate << std::endl;
+        ss << "maxPending: " << maxPending << std::endl;
+        ss << "imageSize: " << imageSize.width << "x" << imageSize.height << std::endl;
+        ss << "colorFlag: " << std::boolalpha << colorFlag << std::noboolalpha << std::endl;
+        ss << "keepOutput: " << std::boolalpha << keepOutput << std::noboolalpha << std::endl;
+        return ss.str();
+    }
+
+
+    // WriterBenchResults
+    // -------------------------------------------------------------------------------------------------------
+    WriterBenchResults::WriterBenchResults()
+    {
+        numberOfFrames = 0;
+        numberSkipped = 0;
+        numberLogSkipped = 0;
+        numberDropped = 0;
+        numberOfErrors = 0;
+        logQueueMax = 0;
+        writerPendingMax = 0;
+        feedTime = 0.0;
+        elapsedTime = 0.0;
+        cpuTime = 0.0;
+        bytesPerFrame = 0.0;
+        outputBytes = 0;
+    }
+
+
+    double WriterBenchResults::framesPerSec() const
+    {
+        unsigned long numberWritten = numberOfFrames - numberSkipped - numberLogSkipped - numberDropped;
+        return (elapsedTime > 0.0) ? numberWritten/elapsedTime : 0.0;
+    }
+
+
+    double WriterBenchResults::inputMegaBytesPerSec() const
+    {
+        return framesPerSec()*bytesPerFrame/BYTES_PER_MEGABYTE;
+    }
+
+
+    double WriterBenchResults::outputMegaBytesPerSec() const
+    {
+        return (elapsedTime > 0.0) ? (outputBytes/BYTES_PER_MEGABYTE)/elapsedTime : 0.0;
+    }
+
+
+    double WriterBenchResults::cpuMilliSecPerFrame() const
+    {
+        return (numberOfFrames > 0) ? 1000.0*cpuTime/numberOfFrames : 0.0;
+    }
+
+
+    double WriterBenchResults::compressionRatio() const
+    {
+        unsigned long numberWritten = numberOfFrames - numberSkipped - numberLogSkipped - numberDropped;
+        return (outputBytes > 0) ? (numberWritten*bytesPerFrame)/outputBytes : 0.0;
+    }
+
+
+    std::string WriterBenchResults::toString() const
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        ss << "format:             " << formatName.toStdString() << std::endl;
+        ss << "frames:             " << numberOfFrames << std::endl;
+        ss << "skipped:            " << numberSkipped << std::endl;
+        ss << "skipped log queue:  " << numberLogSkipped << std::endl;
+        ss << "dropped at finish:  " << numberDropped << std::endl;
+        ss << "errors:             " << numberOfErrors << std::endl;
+        ss << "feed time:          " << feedTime << " s" << std::endl;
+        ss << "elapsed time:       " << elapsedTime << " s" << std::endl;
+        ss << "sustained fps:      " << framesPerSec() << std::endl;
+        ss << "input rate:         " << inputMegaBytesPerSec() << " MB/s" << std::endl;
+        ss << "output rate:        " << outputMegaBytesPerSec() << " MB/s" << std::endl;
+        ss << "cpu per frame:      " << cpuMilliSecPerFrame() << " ms" << std::endl;
+        ss << "log queue max:      " << logQueueMax << std::endl;
+        ss << "writer pending max: " << writerPendingMax << std::endl;
+        ss << "output size:        " << outputBytes/BYTES_PER_MEGABYTE << " MB" << std::endl;
+        ss << "compression ratio:  " << compressionRatio() << std::endl;
+        for (int i=0; i<errorMessages.size(); i++)
+        {
+            ss << "error:              " << errorMessages[i].toStdString() << std::endl;
+        }
+        return ss.str();
+    }
+
+
+    QString WriterBenchResults::csvHeader()
+    {
+        QStringList header;
+        header << "format" << "frames" << "skipped" << "log_skipped" << "dropped" << "errors";
+        header << "feed_s" << "elapsed_s" << "fps" << "input_MBps" << "output_MBps";
+        header << "cpu_ms_per_frame" << "log_queue_max" << "writer_pending_max"; 
+        header << "output_bytes" << "compression_ratio";
+        return header.join(",");
+    }
+
+
+    QString WriterBenchResults::toCsvRow() const
+    {
+        QStringList row;
+        row << formatName;
+        row << QString::number(numberOfFrames);
+        row << QString::number(numberSkipped);
+        row << QString::number(numberLogSkipped);
+        row << QString::number(numberDropped);
+        row << QString::number(numberOfErrors);
+        row << QString::number(feedTime, 'f', 4);
+        row << QString::number(elapsedTime, 'f', 4);
+        row << QString::number(framesPerSec(), 'f', 2);
+        row << QString::number(inputMegaBytesPerSec(), 'f', 2);
+        row << QString::number(outputMegaBytesPerSec(), 'f', 2);
+        row << QString::number(cpuMilliSecPerFrame(), 'f', 3);
+        row << QString::number(logQueueMax);
+        row << QString::number(writerPendingMax);
+        row << QString::number(outputBytes);
+        row << QString::number(compressionRatio(), 'f', 2);
+        return row.join(",");
+    }
+
+
+    // WriterBench
+    // -------------------------------------------------------------------------------------------------------
+    WriterBench::WriterBench(WriterBenchParams params, QObject *parent) : QObject(parent)
+    {
+        params_ = params;
+    }
+
+
+    WriterBenchResults WriterBench::run()
+    {
+        WriterBenchResults results;
+        results.formatName = getVideoFileExtensionMap()[params_.videoFileFormat];
+
+        if (sourceFrames_.empty())
+        {
+            loadSourceFrames();
+        }
+        const cv::Mat &firstImage = sourceFrames_[0].image;
+        results.bytesPerFrame = double(firstImage.total()*firstImage.elemSize());
+
+        // Each run writes into its own directory so the output size is easy to get 
+        QString runName = QString("bias_bench_%1_%2").arg(results.formatName)
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz"));
+        QDir outputDir(params_.outputDir);
+        if (!outputDir.mkpath(runName))
+        {
+            unsigned int errorId = ERROR_VIDEO_WRITER_INITIALIZE;
+            std::string errorMsg("benchmark unable to create output directory:\n\n"); 
+            errorMsg += outputDir.absoluteFilePath(runName).toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+        QString runDir = outputDir.absoluteFilePath(runName);
+
+        QString videoFileName = getVideoFileName(runDir);
+        std::shared_ptr<VideoWriter> videoWriterPtr = createVideoWriter(
+                params_.videoFileFormat,
+                params_.videoWriterParams,
+                videoFileName,
+                0
+                );
+        videoWriterPtr -> setFileName(videoFileName);
+        videoWriterPtr -> setVersioning(false);
+
+        std::shared_ptr<LockableQueue<StampedImage>> logImageQueuePtr = 
+            std::make_shared<LockableQueue<StampedImage>>();
+
+        ImageLogger *imageLoggerPtr = new ImageLogger(0, videoWriterPtr, logImageQueuePtr, this);
+        imageLoggerPtr -> setAutoDelete(false);
+
+        errorMessages_.clear();
+        connect(
+                videoWriterPtr.get(),
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                this,
+                SLOT(onImageLoggingError(unsigned int, QString)),
+                Qt::DirectConnection
+               );
+        connect(
+                imageLoggerPtr,
+                SIGNAL(imageLoggingError(unsigned int, QString)),
+                this,
+                SLOT(onImageLoggingError(unsigned int, QString)),
+                Qt::DirectConnection
+               );
+
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(1);
+
+        double cpuTimeStart = getProcessCpuTime();
+        QElapsedTimer timer;
+        timer.start();
+        threadPool.start(imageLoggerPtr);
+
+        for (unsigned long i=0; i<params_.numberOfFrames; i++)
+        {
+            const StampedImage &srcImage = sourceFrames_[i%sourceFrames_.size()];
+            StampedImage stampedImage;
+            stampedImage.image = srcImage.image;
+            stampedImage.frameCount = i;
+
+            if (params_.frameRate > 0.0)
+            {
+                // Fixed rate - like a camera, the writer skips frames it cannot keep up with
+                double dt = 1.0/params_.frameRate;
+                qint64 dueTime = qint64(1.0e9*i*dt);
+                while (timer.nsecsElapsed() < dueTime)
+                {
+                    qint64 waitTime = (dueTime - timer.nsecsElapsed())/1000;
+                    if (waitTime > 2*qint64(FEED_SLEEP_INTERVAL))
+                    {
+                        QThread::usleep(FEED_SLEEP_INTERVAL);
+                    }
+                }
+                stampedImage.timeStamp = i*dt;
+                stampedImage.dtEstimate = dt;
+            }
+            else
+            {
+                // Unlimited rate - hold back while the logger or the writer 
+                // has maxPending frames outstanding so nothing is skipped.
+                while (true)
+                {
+                    unsigned long pending = getLogQueueSize(logImageQueuePtr);
+                    FrameDrainPtr frameDrainPtr = videoWriterPtr -> getFrameDrain();
+                    if (frameDrainPtr) 
+                    {
+                        pending = std::max(pending, frameDrainPtr -> numberPending());
+                    }
+                    if (pending < params_.maxPending)
+                    {
+                        break;
+                    }
+                    QThread::usleep(FEED_SLEEP_INTERVAL);
+                }
+                stampedImage.timeStamp = 1.0e-9*timer.nsecsElapsed();
+                stampedImage.dtEstimate = srcImage.dtEstimate;
+            }
+
+            // In fixed rate mode the log queue is held to the limit the logger 
+            // enforces in live capture - frames arriving while it is full are 
+            // skipped and counted rather than queued without bound.
+            bool skipFrame = false;
+            logImageQueuePtr -> acquireLock();
+            if ((params_.frameRate > 0.0) && 
+                    (logImageQueuePtr -> size() >= ImageLogger::MAX_LOG_QUEUE_SIZE))
+            {
+                skipFrame = true;
+            }
+            else
+            {
+                logImageQueuePtr -> push(stampedImage);
+                logImageQueuePtr -> signalNotEmpty();
+            }
+            unsigned long logQueueSize = logImageQueuePtr -> size();
+            logImageQueuePtr -> releaseLock();
+
+            if (skipFrame)
+            {
+                results.numberLogSkipped++;
+            }
+            results.logQueueMax = std::max(results.logQueueMax, logQueueSize);
+        }
+        results.feedTime = 1.0e-9*timer.nsecsElapsed();
+
+        // Let the logger work through its queue, then stop it - the writer 
+        // is finished on the logger thread as in live capture.
+        while (getLogQueueSize(logImageQueuePtr) > 0)
+        {
+            QThread::usleep(FEED_SLEEP_INTERVAL);
+        }
+        imageLoggerPtr -> acquireLock();
+        imageLoggerPtr -> stop();
+        imageLoggerPtr -> releaseLock();
+
+        bool threadsDone = false;
+        while (!threadsDone)
+        {
+            threadsDone = threadPool.waitForDone(LOGGER_WAIT_TIMEOUT);
+            logImageQueuePtr -> acquireLock();
+            logImageQueuePtr -> signalNotEmpty();
+            logImageQueuePtr -> releaseLock();
+        }
+        results.elapsedTime = 1.0e-9*timer.nsecsElapsed();
+        results.cpuTime = getProcessCpuTime() - cpuTimeStart;
+
+        results.numberOfFrames = params_.numberOfFrames;
+        FrameDrainPtr frameDrainPtr = videoWriterPtr -> getFrameDrain();
+        if (frameDrainPtr)
+        {
+            results.numberSkipped = frameDrainPtr -> numberSkipped();
+            results.numberDropped = frameDrainPtr -> numberDropped();
+            results.writerPendingMax = frameDrainPtr -> maxNumberPending();
+        }
+
+        // Release the writer so all files are closed before they are measured 
+        delete imageLoggerPtr;
+        videoWriterPtr.reset();
+
+        results.outputBytes = getDirectorySize(runDir);
+        errorMutex_.lock();
+        results.errorMessages = errorMessages_;
+        results.numberOfErrors = errorMessages_.size();
+        errorMutex_.unlock();
+
+        if (!params_.keepOutput)
+        {
+            QDir(runDir).removeRecursively();
+        }
+        return results;
+    }
+
+
+    void WriterBench::onImageLoggingError(unsigned int errorId, QString errorMsg)
+    {
+        errorMutex_.lock();
+        errorMessages_.append(QString("(%1) %2").arg(errorId).arg(errorMsg));
+        errorMutex_.unlock();
+    }
+
+
+    void WriterBench::loadSourceFrames()
+    {
+        if (params_.inputFileName.isEmpty())
+        {
+            createSyntheticFrames();
+        }
+        else
+        {
+            loadRecordedFrames();
+        }
+    }
+
+
+    void WriterBench::loadRecordedFrames()
+    {
+        // Frames are preloaded so disk reads do not count against the writer
+        VideoReaderPtr readerPtr = createVideoReader(params_.inputFileName);
+        sourceFrames_.clear();
+        for (unsigned long i=0; i<params_.numberOfPreload; i++)
+        {
+            StampedImage stampedImage;
+            if (!readerPtr -> readFrame(stampedImage))
+            {
+                break;
+            }
+            if (params_.colorFlag && (stampedImage.image.channels() == 1))
+            {
+                cv::cvtColor(stampedImage.image, stampedImage.image, cv::COLOR_GRAY2BGR);
+            }
+            else if (!params_.colorFlag && (stampedImage.image.channels() == 3))
+            {
+                cv::cvtColor(stampedImage.image, stampedImage.image, cv::COLOR_BGR2GRAY);
+            }
+            sourceFrames_.push_back(stampedImage);
+        }
+
+        if (sourceFrames_.empty())
+        {
+            unsigned int errorId = ERROR_VIDEO_READER_READ_FRAME;
+            std::string errorMsg("benchmark input file contains no frames:\n\n"); 
+            errorMsg += params_.inputFileName.toStdString();
+            throw RuntimeError(errorId, errorMsg); 
+        }
+    }
+
+
+    void WriterBench::createSyntheticFrames()
+    {
+        // Static textured background with dark blobs moving across it, roughly
+        // what the ufmf writer sees in an arena.
+        cv::Size size = params_.imageSize;
+        cv::Mat background(size, CV_8UC1);
+        cv::RNG rng(0x5eed);
+        rng.fill(background, cv::RNG::UNIFORM, 150, 200);
+        cv::GaussianBlur(background, background, cv::Size(0,0), 3.0);
+
+        double dtEstimate = (params_.frameRate > 0.0) ? 1.0/params_.frameRate : VideoReader::DEFAULT_DT_ESTIMATE;
+        int blobRadius = std::max(3, std::min(size.width, size.height)/80);
+
+        std::vector<cv::Point2d> blobPos(DEFAULT_NUMBER_OF_BLOBS);
+        std::vector<cv::Point2d> blobVel(DEFAULT_NUMBER_OF_BLOBS);
+        for (unsigned int j=0; j<DEFAULT_NUMBER_OF_BLOBS; j++)
+        {
+            blobPos[j] = cv::Point2d(rng.uniform(0.0, double(size.width)), rng.uniform(0.0, double(size.height)));
+            double angle = rng.uniform(0.0, 2.0*CV_PI);
+            blobVel[j] = cv::Point2d(2.0*std::cos(angle), 2.0*std::sin(angle));
+        }
+
+        unsigned long numberToCreate = std::max(params_.numberOfPreload, 1ul);
+        sourceFrames_.clear();
+        for (unsigned long i=0; i<numberToCreate; i++)
+        {
+            cv::Mat image = background.clone();
+            for (unsigned int j=0; j<DEFAULT_NUMBER_OF_BLOBS; j++)
+            {
+                cv::Point2d &pos = blobPos[j];
+                cv::Point2d &vel = blobVel[j];
+                pos += vel;
+                if ((pos.x < 0) || (pos.x >= size.width))  { vel.x = -vel.x; }
+                if ((pos.y < 0) || (pos.y >= size.height)) { vel.y = -vel.y; }
+                cv::circle(image, cv::Point(int(pos.x), int(pos.y)), blobRadius, cv::Scalar(20), -1);
+            }
+            if (params_.colorFlag)
+            {
+                cv::cvtColor(image, image, cv::COLOR_GRAY2BGR);
+            }
+            StampedImage stampedImage;
+            stampedImage.image = image;
+            stampedImage.timeStamp = i*dtEstimate;
+            stampedImage.dtEstimate = dtEstimate;
+            stampedImage.frameCount = i;
+            sourceFrames_.push_back(stampedImage);
+        }
+    }
+
+
+    QString WriterBench::getVideoFileName(QString runDir)
+    {
+        // Same naming as the camera window - image sequences get no extension 
+        QString fileName("bench_video");
+        if (params_.videoFileFormat != VIDEOFILE_FORMAT_BMP)
+        {
+            fileName += "." + getVideoFileExtensionMap()[params_.videoFileFormat];
+        }
+        return QDir(runDir).absoluteFilePath(fileName);
+    }
+
+
+    unsigned long WriterBench::getLogQueueSize(std::shared_ptr<LockableQueue<StampedImage>> queuePtr)
+    {
+        queuePtr -> acquireLock();
+        unsigned long size = queuePtr -> size();
+        queuePtr -> releaseLock();
+        return size;
+    }
+
+
+    double WriterBench::getProcessCpuTime()
+    {
+#ifdef WIN32
+        FILETIME createTime;
+        FILETIME exitTime;
+        FILETIME kernelTime;
+        FILETIME userTime;
+        if (!GetProcessTimes(GetCurrentProcess(), &createTime, &exitTime, &kernelTime, &userTime))
+        {
+            return 0.0;
+        }
+        ULARGE_INTEGER kernel;
+        ULARGE_INTEGER user;
+        kernel.LowPart = kernelTime.dwLowDateTime;
+        kernel.HighPart = kernelTime.dwHighDateTime;
+        user.LowPart = userTime.dwLowDateTime;
+        user.HighPart = userTime.dwHighDateTime;
+        return 1.0e-7*double(kernel.QuadPart + user.QuadPart);
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0.0;
+        }
+        double userTime = usage.ru_utime.tv_sec + 1.0e-6*usage.ru_utime.tv_usec;
+        double systemTime = usage.ru_stime.tv_sec + 1.0e-6*usage.ru_stime.tv_usec;
+        return userTime + systemTime;
+#endif
+    }
+
+
+    qint64 WriterBench::getDirectorySize(QString dirName)
+    {
+        qint64 size = 0;
+        QDirIterator it(dirName, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            it.next();
+            size += it.fileInfo().size();
+        }
+        return size;
+    }
+
+} // namespace bias
@@ -0,0 +1,108 @@
+#ifndef BIAS_WRITER_BENCH_HPP
+#define BIAS_WRITER_BENCH_HPP
+#include "basic_types.hpp"
+#include "video_writer_params.hpp"
+#include "stamped_image.hpp"
+#include "lockable.hpp"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <memory>
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace bias
+{
+    class VideoWriter;
+
+    struct WriterBenchParams
+    {
+        VideoFileFormat videoFileFormat;
+        VideoWriterParams videoWriterParams;
+        QString outputDir;
+        QString inputFileName;      // recording to replay, synthetic frames if empty
+        unsigned long numberOfFrames;
+        unsigned long numberOfPreload;
+        double frameRate;           // Hz, 0 = as fast as the writer accepts frames
+        unsigned long maxPending;   // back pressure when frameRate = 0
+        cv::Size imageSize;
+        bool colorFlag;
+        bool keepOutput;
+        WriterBenchParams();
+        std::string toString();
+    };
+
+
+    struct WriterBenchResults
+    {
+        QString formatName;
+        unsigned long numberOfFrames;
+        unsigned long numberSkipped;
+        unsigned long numberLogSkipped;   // fixed rate, log queue at its limit
+        unsigned long numberDropped;
+        unsigned long numberOfErrors;
+        unsigned long logQueueMax;
+        unsigned long writerPendingMax;
+        double feedTime;            // sec, first frame to last frame queued
+        double elapsedTime;         // sec, first frame to writer finished
+        double cpuTime;             // sec, process user + system
+        double bytesPerFrame;
+        qint64 outputBytes;
+        QStringList errorMessages;
+        WriterBenchResults();
+
+        double framesPerSec() const;
+        double inputMegaBytesPerSec() const;
+        double outputMegaBytesPerSec() const;
+        double cpuMilliSecPerFrame() const;
+        double compressionRatio() const;
+
+        std::string toString() const;
+        static QString csvHeader();
+        QString toCsvRow() const;
+    };
+
+
+    class WriterBench : public QObject
+    {
+        // Feeds recorded or synthetic frames through a video writer using the 
+        // same ImageLogger path as live capture and measures throughput. 
+
+        Q_OBJECT
+
+        public:
+
+            WriterBench(WriterBenchParams params, QObject *parent=0);
+            WriterBenchResults run();
+
+            static const unsigned long DEFAULT_NUMBER_OF_FRAMES;
+            static const unsigned long DEFAULT_NUMBER_OF_PRELOAD;
+            static const unsigned long DEFAULT_MAX_PENDING;
+            static const cv::Size DEFAULT_IMAGE_SIZE;
+            static const unsigned int DEFAULT_NUMBER_OF_BLOBS;
+
+        protected slots:
+
+            void onImageLoggingError(unsigned int errorId, QString errorMsg);
+
+        protected:
+
+            WriterBenchParams params_;
+            std::vector<StampedImage> sourceFrames_;
+            QMutex errorMutex_;
+            QStringList errorMessages_;
+
+            void loadSourceFrames();
+            void loadRecordedFrames();
+            void createSyntheticFrames();
+            QString getVideoFileName(QString runDir);
+            unsigned long getLogQueueSize(std::shared_ptr<LockableQueue<StampedImage>> queuePtr);
+
+            static double getProcessCpuTime();
+            static qint64 getDirectorySize(QString dirName);
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_WRITER_BENCH_HPP
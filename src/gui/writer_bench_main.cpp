@@ -0,0 +1,141 @@
+#include "writer_bench.hpp"
+#include "video_writer_factory.hpp"
+#include "exception.hpp"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <iostream>
+
+
+// ------------------------------------------------------------------------
+// Video writer benchmark. Feeds recorded or synthetic frames through
+// one or more video writers and reports sustained throughput, e.g.
+//
+//   writer_bench --format jpg,ufmf --frames 2000 --threads 4
+//   writer_bench --format ufmf --input pilot.fmf --rate 200 --csv bench.csv
+// ------------------------------------------------------------------------
+int main (int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("writer_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("BIAS video writer benchmark");
+    parser.addHelpOption();
+
+    QCommandLineOption formatOption("format", "Comma separated video formats (bmp,jpg,avi,fmf,ufmf,zfmf) or all.", "formats", "ufmf");
+    QCommandLineOption framesOption("frames", "Number of frames to write.", "count", QString::number(bias::WriterBench::DEFAULT_NUMBER_OF_FRAMES));
+    QCommandLineOption rateOption("rate", "Frame rate in Hz, 0 feeds frames as fast as the writer accepts them.", "hz", "0");
+    QCommandLineOption inputOption("input", "Recording (fmf, avi or image directory) to replay, synthetic frames are used if not given.", "file");
+    QCommandLineOption preloadOption("preload", "Number of source frames held in memory and cycled.", "count", QString::number(bias::WriterBench::DEFAULT_NUMBER_OF_PRELOAD));
+    QCommandLineOption widthOption("width", "Synthetic image width.", "pixels", QString::number(bias::WriterBench::DEFAULT_IMAGE_SIZE.width));
+    QCommandLineOption heightOption("height", "Synthetic image height.", "pixels", QString::number(bias::WriterBench::DEFAULT_IMAGE_SIZE.height));
+    QCommandLineOption colorOption("color", "Use 3 channel images (bmp, jpg and avi only).");
+    QCommandLineOption threadsOption("threads", "Number of compressor/writer/encoder threads.", "count");
+    QCommandLineOption pendingOption("max-pending", "Frames outstanding in the logger or writer before feeding waits (rate 0 only).", "count", QString::number(bias::WriterBench::DEFAULT_MAX_PENDING));
+    QCommandLineOption outputOption("output", "Directory for the benchmark output.", "dir");
+    QCommandLineOption keepOption("keep", "Keep the files written.");
+    QCommandLineOption csvOption("csv", "Append results to a csv file.", "file");
+
+    parser.addOption(formatOption);
+    parser.addOption(framesOption);
+    parser.addOption(rateOption);
+    parser.addOption(inputOption);
+    parser.addOption(preloadOption);
+    parser.addOption(widthOption);
+    parser.addOption(heightOption);
+    parser.addOption(colorOption);
+    parser.addOption(threadsOption);
+    parser.addOption(pendingOption);
+    parser.addOption(outputOption);
+    parser.addOption(keepOption);
+    parser.addOption(csvOption);
+    parser.process(app);
+
+    bias::WriterBenchParams params;
+    params.numberOfFrames = parser.value(framesOption).toULong();
+    params.frameRate = parser.value(rateOption).toDouble();
+    params.inputFileName = parser.value(inputOption);
+    params.numberOfPreload = parser.value(preloadOption).toULong();
+    params.imageSize = cv::Size(parser.value(widthOption).toInt(), parser.value(heightOption).toInt());
+    params.colorFlag = parser.isSet(colorOption);
+    params.maxPending = std::max(parser.value(pendingOption).toULong(), 1ul);
+    params.keepOutput = parser.isSet(keepOption);
+    if (parser.isSet(outputOption))
+    {
+        params.outputDir = parser.value(outputOption);
+    }
+
+    if ((params.numberOfFrames == 0) || (params.imageSize.width <= 0) || (params.imageSize.height <= 0))
+    {
+        std::cerr << "error: frames, width and height must be > 0" << std::endl;
+        return 1;
+    }
+
+    if (parser.isSet(threadsOption))
+    {
+        unsigned int numberOfThreads = std::max(parser.value(threadsOption).toUInt(), 1u);
+        params.videoWriterParams.bmp.numberOfWriters = numberOfThreads;
+        params.videoWriterParams.jpg.numberOfCompressors = numberOfThreads;
+        params.videoWriterParams.avi.numberOfEncoders = numberOfThreads;
+        params.videoWriterParams.ufmf.numberOfCompressors = numberOfThreads;
+        params.videoWriterParams.zfmf.numberOfCompressors = numberOfThreads;
+    }
+
+    QStringList formatList = parser.value(formatOption).toLower().split(",", QString::SkipEmptyParts);
+    if (formatList.contains("all"))
+    {
+        formatList = bias::getVideoFileExtensionMap().values();
+    }
+
+    QFile csvFile;
+    QTextStream csvStream;
+    if (parser.isSet(csvOption))
+    {
+        csvFile.setFileName(parser.value(csvOption));
+        bool writeHeader = !csvFile.exists() || (csvFile.size() == 0);
+        if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        {
+            std::cerr << "error: unable to open " << csvFile.fileName().toStdString() << std::endl;
+            return 1;
+        }
+        csvStream.setDevice(&csvFile);
+        if (writeHeader)
+        {
+            csvStream << bias::WriterBenchResults::csvHeader() << endl;
+        }
+    }
+
+    int rtnValue = 0;
+    for (int i=0; i<formatList.size(); i++)
+    {
+        bias::VideoFileFormat videoFileFormat = bias::getVideoFileFormatFromExtension(formatList[i].trimmed());
+        if (videoFileFormat == bias::VIDEOFILE_FORMAT_UNSPECIFIED)
+        {
+            std::cerr << "error: unknown format " << formatList[i].toStdString() << std::endl;
+            rtnValue = 1;
+            continue;
+        }
+        params.videoFileFormat = videoFileFormat;
+
+        try
+        {
+            bias::WriterBench writerBench(params);
+            bias::WriterBenchResults results = writerBench.run();
+            std::cout << results.toString() << std::endl;
+            if (csvFile.isOpen())
+            {
+                csvStream << results.toCsvRow() << endl;
+            }
+        }
+        catch (bias::RuntimeError &runtimeError)
+        {
+            std::cerr << "error: " << formatList[i].toStdString() << " benchmark failed (";
+            std::cerr << runtimeError.id() << "): " << runtimeError.what() << std::endl;
+            rtnValue = 1;
+        }
+    }
+    return rtnValue;
+}
@@ -1,6 +1,7 @@
 #include "bias_plugin.hpp"
 #include <QtDebug>
 #include <opencv2/core/core.hpp>
+#include <algorithm>
 #include "camera_window.hpp"
 
 namespace bias
@@ -10,6 +11,8 @@ namespace bias
     const QString BiasPlugin::PLUGIN_DISPLAY_NAME = QString("Base Plugin"); 
     const QString BiasPlugin::LOG_FILE_EXTENSION = QString("txt");
     const QString BiasPlugin::LOG_FILE_POSTFIX = QString("plugin_log");
+    const unsigned int BiasPlugin::DEFAULT_FRAME_QUEUE_SIZE = 500;
+    const unsigned int BiasPlugin::DEFAULT_MAX_IN_FLIGHT = 8;
 
     // Pulbic
     // ------------------------------------------------------------------------
@@ -18,6 +21,11 @@ namespace bias
     { 
         active_ = false;
         setRequireTimer(false);
+        setRequireColor(true);
+        setSubscriptionMode(PLUGIN_SUBSCRIBE_EVERY_FRAME);
+        setFrameQueueSize(DEFAULT_FRAME_QUEUE_SIZE);
+        setReentrant(false);
+        setMaxInFlight(DEFAULT_MAX_IN_FLIGHT);
     }
 
     void BiasPlugin::reset()
@@ -53,6 +61,51 @@ namespace bias
         return requireTimer_;
     }
 
+
+    bool BiasPlugin::requireColor()
+    {
+        // When false raw Bayer frames are passed to the plugin undemosaiced
+        return requireColor_;
+    }
+
+
+    PluginSubscriptionMode BiasPlugin::subscriptionMode()
+    {
+        return subscriptionMode_;
+    }
+
+
+    unsigned int BiasPlugin::subscriptionInterval()
+    {
+        return subscriptionInterval_;
+    }
+
+
+    unsigned int BiasPlugin::frameQueueSize()
+    {
+        return frameQueueSize_;
+    }
+
+
+    bool BiasPlugin::isReentrant()
+    {
+        return reentrant_;
+    }
+
+
+    unsigned int BiasPlugin::maxInFlight()
+    {
+        // Maximum number of frames being processed or waiting to be 
+        // delivered in order - only used for reentrant plugins
+        return maxInFlight_;
+    }
+
+
+    void BiasPlugin::setMaxInFlight(unsigned int value)
+    {
+        maxInFlight_ = std::max(value, 1u);
+    }
+
     void BiasPlugin::processFrames(QList<StampedImage> frameList) 
     { 
         acquireLock();
@@ -65,12 +118,44 @@ namespace bias
     } 
 
 
-    cv::Mat BiasPlugin::getCurrentImage()
+    PluginFrameResult BiasPlugin::processFrameConcurrent(StampedImage stampedImage)
+    {
+        PluginFrameResult result;
+        result.stampedImage = stampedImage;
+        return result;
+    }
+
+
+    void BiasPlugin::processFrameResults(QList<PluginFrameResult> resultList)
     {
         acquireLock();
-        cv::Mat currentImageCopy = currentImage_.clone();
+        PluginFrameResult latestResult = resultList.back();
+        currentImage_ = latestResult.stampedImage.image;
+        timeStamp_ = latestResult.stampedImage.timeStamp;
+        frameCount_ = latestResult.stampedImage.frameCount;
         releaseLock();
-        return currentImageCopy;
+    }
+
+
+    PluginPreview BiasPlugin::getPreview(QSize maxSize)
+    {
+        // No copy under the lock - the preview shares the current image
+        acquireLock();
+        cv::Mat currentImage = currentImage_;
+        releaseLock();
+        return makePluginPreview(currentImage, maxSize);
+    }
+
+
+    FrameResultRing *BiasPlugin::getResultRing()
+    {
+        return &resultRing_;
+    }
+
+
+    void BiasPlugin::acknowledgeResultPublished()
+    {
+        resultPending_ = false;
     }
 
 
@@ -139,6 +224,12 @@ namespace bias
         return LOG_FILE_EXTENSION;
     }
 
+    bool BiasPlugin::isBinaryLogEnabled()
+    {
+        return false;
+    }
+
+
     QString BiasPlugin::getLogFilePostfix()
     {
         return LOG_FILE_POSTFIX;
@@ -183,6 +274,69 @@ namespace bias
     }
 
 
+    void BiasPlugin::setRequireColor(bool value)
+    {
+        requireColor_ = value;
+    }
+
+
+    void BiasPlugin::setSubscriptionMode(PluginSubscriptionMode mode, unsigned int interval)
+    {
+        subscriptionMode_ = mode;
+        subscriptionInterval_ = std::max(interval, 1u);
+    }
+
+
+    void BiasPlugin::setFrameQueueSize(unsigned int size)
+    {
+        frameQueueSize_ = std::max(size, 1u);
+    }
+
+
+    void BiasPlugin::setReentrant(bool value)
+    {
+        reentrant_ = value;
+    }
+
+
+    void BiasPlugin::setLogSchema(PluginLogSchema schema)
+    {
+        logSchema_ = schema;
+    }
+
+
+    void BiasPlugin::setResultFields(QStringList fieldNames)
+    {
+        // Call from reset only - not while frames are being processed
+        resultRing_.setFieldNames(fieldNames);
+    }
+
+
+    void BiasPlugin::publishResult(
+            unsigned long frameCount, 
+            double timeStamp, 
+            const std::vector<double> &valueVec
+            )
+    {
+        // Call once per frame. Values are in the order given to 
+        // setResultFields. The ring takes a single writer, so calls from 
+        // processFrameConcurrent workers are serialized here. At most one 
+        // resultPublished is queued at a time, the receiver reads everything
+        // new in the ring when it gets it.
+        if (resultRing_.fieldNames().isEmpty())
+        {
+            return;
+        }
+        resultRingMutex_.lock();
+        resultRing_.append(frameCount, timeStamp, valueVec);
+        resultRingMutex_.unlock();
+        if (!resultPending_.exchange(true))
+        {
+            emit resultPublished();
+        }
+    }
+
+
     void BiasPlugin::openLogFile()
     {
         loggingEnabled_ = getCameraWindow() -> isLoggingEnabled();
@@ -190,6 +344,21 @@ namespace bias
         {
             QString logFileFullPath = getLogFileFullPath(true);
             qDebug() << logFileFullPath;
+            if (!logSchema_.isEmpty() && isBinaryLogEnabled())
+            {
+                RtnStatus rtnStatus = logWriter_.open(logFileFullPath, getName(), logSchema_);
+                if (rtnStatus.success)
+                {
+                    return;
+                }
+                // Fall back to the text log rather than logging nothing
+                QFileInfo logFileInfo(logFileFullPath);
+                logFileFullPath = logFileInfo.dir().absoluteFilePath(
+                        logFileInfo.completeBaseName() + QString(".") + LOG_FILE_EXTENSION
+                        );
+                qWarning() << "binary plugin log failed:" << rtnStatus.message;
+                qWarning() << "writing text log" << logFileFullPath;
+            }
             logFile_.setFileName(logFileFullPath);
             bool isOpen = logFile_.open(QIODevice::WriteOnly | QIODevice::Text);
             if (isOpen)
@@ -202,6 +371,7 @@ namespace bias
 
     void BiasPlugin::closeLogFile()
     {
+        logWriter_.close();
         if (loggingEnabled_ && logFile_.isOpen())
         {
             logStream_.flush();
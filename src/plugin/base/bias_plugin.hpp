@@ -6,8 +6,13 @@
 #include "lockable.hpp"
 #include "stamped_image.hpp"
 #include "rtn_status.hpp"
+#include "plugin_log.hpp"
+#include "plugin_preview.hpp"
+#include "frame_result_ring.hpp"
 #include <QDir>
+#include <QMutex>
 #include <QTextStream>
+#include <atomic>
 
 namespace cv
 {
@@ -19,6 +24,24 @@ namespace bias
 
     class CameraWindow;
 
+    // How frames are delivered to a plugin. Frames a plugin won't use are 
+    // dropped by the image dispatcher rather than held in the plugin queue.
+    enum PluginSubscriptionMode
+    {
+        PLUGIN_SUBSCRIBE_EVERY_FRAME,      // bounded queue, oldest dropped when full
+        PLUGIN_SUBSCRIBE_LATEST_FRAME,     // single conflating slot
+        PLUGIN_SUBSCRIBE_EVERY_NTH_FRAME,  // every Nth frame, bounded queue
+    };
+
+    // Result of processing one frame on a worker thread (reentrant plugins 
+    // only). The plugin handler hands results back to the plugin in frame 
+    // order, whatever order the workers finish in.
+    struct PluginFrameResult
+    {
+        StampedImage stampedImage;
+        QVariantMap data;
+    };
+
     class BiasPlugin : public QDialog, public Lockable<Empty>
     {
         Q_OBJECT
@@ -29,12 +52,21 @@ namespace bias
             static const QString PLUGIN_DISPLAY_NAME;
             static const QString LOG_FILE_EXTENSION;
             static const QString LOG_FILE_POSTFIX;
+            static const unsigned int DEFAULT_FRAME_QUEUE_SIZE;
+            static const unsigned int DEFAULT_MAX_IN_FLIGHT;
 
             BiasPlugin(QWidget *parent=0);
             bool pluginsEnabled();
             void setPluginsEnabled(bool value);
 
             bool requireTimer();
+            bool requireColor();
+            PluginSubscriptionMode subscriptionMode();
+            unsigned int subscriptionInterval();
+            unsigned int frameQueueSize();
+            bool isReentrant();
+            unsigned int maxInFlight();
+            void setMaxInFlight(unsigned int value);
             bool isActive();
             QPointer<CameraWindow> getCameraWindow();
 
@@ -42,9 +74,18 @@ namespace bias
             virtual void stop();
             virtual void setActive(bool value);
             virtual void processFrames(QList<StampedImage> frameList);
+
+            // Reentrant plugins - processFrameConcurrent runs on worker threads,
+            // several frames at once, and must only read state which is fixed
+            // while capturing. processFrameResults runs on the plugin handler 
+            // thread with results in frame order and does everything else 
+            // (signals, log lines, triggers, current image).
+            virtual PluginFrameResult processFrameConcurrent(StampedImage stampedImage);
+            virtual void processFrameResults(QList<PluginFrameResult> resultList);
+
             virtual void setFileAutoNamingString(QString autoNamingString);
             virtual void setFileVersionNumber(unsigned verNum);
-            virtual cv::Mat getCurrentImage();
+            virtual PluginPreview getPreview(QSize maxSize);
             virtual QString getName();
             virtual QString getDisplayName();
             virtual QVariantMap getConfigAsMap();  
@@ -53,17 +94,32 @@ namespace bias
             virtual RtnStatus runCmdFromMap(QVariantMap cmdMap, bool showErrorDlg=true);
             virtual QString getLogFileExtension();
             virtual QString getLogFilePostfix();
+            virtual bool isBinaryLogEnabled();
             virtual QString getLogFileName(bool includeAutoNaming);
             virtual QString getLogFileFullPath(bool includeAutoNaming);
 
+            FrameResultRing *getResultRing();
+
+            // resultPublished is coalesced - it is only emitted again once the
+            // receiver has called this, before reading the result ring.
+            void acknowledgeResultPublished();
+
         signals:
 
             void setCaptureDurationRequest(unsigned long);
+            void recordTriggerRequest(double timeStamp);
+            void resultPublished();
 
         protected:
 
             bool active_;
             bool requireTimer_;
+            bool requireColor_;
+            PluginSubscriptionMode subscriptionMode_;
+            unsigned int subscriptionInterval_;
+            unsigned int frameQueueSize_;
+            bool reentrant_;
+            unsigned int maxInFlight_;
             cv::Mat currentImage_;
 
             double timeStamp_;
@@ -77,7 +133,25 @@ namespace bias
             QFile logFile_;
             QTextStream logStream_;
 
+            // Binary logging - used instead of logStream_ when the plugin
+            // sets a schema and enables it (isBinaryLogEnabled), text is the 
+            // default. Write records with logWriter_.write if it is open.
+            PluginLogSchema logSchema_;
+            PluginLogWriter logWriter_;
+
+            // Per-frame results for external controllers, see publishResult
+            FrameResultRing resultRing_;
+            QMutex resultRingMutex_;                 // one writer at a time
+            std::atomic<bool> resultPending_{false}; // resultPublished queued
+
             void setRequireTimer(bool value);
+            void setRequireColor(bool value);
+            void setSubscriptionMode(PluginSubscriptionMode mode, unsigned int interval=1);
+            void setFrameQueueSize(unsigned int size);
+            void setReentrant(bool value);
+            void setLogSchema(PluginLogSchema schema);
+            void setResultFields(QStringList fieldNames);
+            void publishResult(unsigned long frameCount, double timeStamp, const std::vector<double> &valueVec);
             void openLogFile();
             void closeLogFile();
 
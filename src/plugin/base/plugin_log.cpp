@@ -0,0 +1,641 @@
+#include "plugin_log.hpp"
+#include "json.hpp"
+#include <QtEndian>
+#include <QTextStream>
+#include <QStringList>
+#include <algorithm>
+#include <iostream>
+
+namespace bias
+{
+
+    // PluginLogSchema
+    // ------------------------------------------------------------------------
+
+    PluginLogSchema::PluginLogSchema()
+    {
+        recordSize_ = 0;
+    }
+
+
+    int PluginLogSchema::addField(QString name, PluginLogFieldType type)
+    {
+        nameVec_.push_back(name);
+        typeVec_.push_back(type);
+        offsetVec_.push_back(recordSize_);
+        recordSize_ += typeSize(type);
+        return int(nameVec_.size()) - 1;
+    }
+
+
+    int PluginLogSchema::numberOfFields() const
+    {
+        return int(nameVec_.size());
+    }
+
+
+    size_t PluginLogSchema::recordSize() const
+    {
+        return recordSize_;
+    }
+
+
+    bool PluginLogSchema::isEmpty() const
+    {
+        return nameVec_.empty();
+    }
+
+
+    QString PluginLogSchema::fieldName(int index) const
+    {
+        return nameVec_[index];
+    }
+
+
+    PluginLogFieldType PluginLogSchema::fieldType(int index) const
+    {
+        return typeVec_[index];
+    }
+
+
+    size_t PluginLogSchema::fieldOffset(int index) const
+    {
+        return offsetVec_[index];
+    }
+
+
+    QVariantMap PluginLogSchema::toMap() const
+    {
+        QVariantList fieldList;
+        for (int i=0; i<numberOfFields(); i++)
+        {
+            QVariantMap fieldMap;
+            fieldMap.insert("name", nameVec_[i]);
+            fieldMap.insert("type", typeToString(typeVec_[i]));
+            fieldMap.insert("offset", qulonglong(offsetVec_[i]));
+            fieldList.append(fieldMap);
+        }
+        QVariantMap schemaMap;
+        schemaMap.insert("recordSize", qulonglong(recordSize_));
+        schemaMap.insert("fields", fieldList);
+        return schemaMap;
+    }
+
+
+    RtnStatus PluginLogSchema::fromMap(QVariantMap schemaMap)
+    {
+        RtnStatus rtnStatus;
+        rtnStatus.success = true;
+        rtnStatus.message = QString("");
+
+        PluginLogSchema schema;
+        QVariantList fieldList = schemaMap["fields"].toList();
+        for (QVariant fieldVar : fieldList)
+        {
+            QVariantMap fieldMap = fieldVar.toMap();
+            PluginLogFieldType type;
+            if (!typeFromString(fieldMap["type"].toString(), type))
+            {
+                rtnStatus.success = false;
+                rtnStatus.message = QString("unknown field type %1").arg(fieldMap["type"].toString());
+                return rtnStatus;
+            }
+            schema.addField(fieldMap["name"].toString(), type);
+        }
+        if (schema.recordSize() != schemaMap["recordSize"].toULongLong())
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("record size doesn't match fields");
+            return rtnStatus;
+        }
+        *this = schema;
+        return rtnStatus;
+    }
+
+
+    size_t PluginLogSchema::typeSize(PluginLogFieldType type)
+    {
+        switch (type)
+        {
+            case PLUGIN_LOG_UINT8:
+                return 1;
+            case PLUGIN_LOG_INT32:
+            case PLUGIN_LOG_UINT32:
+            case PLUGIN_LOG_FLOAT32:
+                return 4;
+            case PLUGIN_LOG_INT64:
+            case PLUGIN_LOG_UINT64:
+            case PLUGIN_LOG_FLOAT64:
+                return 8;
+        }
+        return 0;
+    }
+
+
+    QString PluginLogSchema::typeToString(PluginLogFieldType type)
+    {
+        switch (type)
+        {
+            case PLUGIN_LOG_UINT8:
+                return QString("uint8");
+            case PLUGIN_LOG_INT32:
+                return QString("int32");
+            case PLUGIN_LOG_UINT32:
+                return QString("uint32");
+            case PLUGIN_LOG_INT64:
+                return QString("int64");
+            case PLUGIN_LOG_UINT64:
+                return QString("uint64");
+            case PLUGIN_LOG_FLOAT32:
+                return QString("float32");
+            case PLUGIN_LOG_FLOAT64:
+                return QString("float64");
+        }
+        return QString("unknown");
+    }
+
+
+    bool PluginLogSchema::typeFromString(QString typeString, PluginLogFieldType &type)
+    {
+        static const PluginLogFieldType typeList[] = {
+            PLUGIN_LOG_UINT8, PLUGIN_LOG_INT32, PLUGIN_LOG_UINT32, PLUGIN_LOG_INT64,
+            PLUGIN_LOG_UINT64, PLUGIN_LOG_FLOAT32, PLUGIN_LOG_FLOAT64
+        };
+        for (PluginLogFieldType typeTmp : typeList)
+        {
+            if (typeString == typeToString(typeTmp))
+            {
+                type = typeTmp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    // PluginLogRecord
+    // ------------------------------------------------------------------------
+
+    PluginLogRecord::PluginLogRecord() {}
+
+
+    PluginLogRecord::PluginLogRecord(PluginLogSchema schema)
+    {
+        schema_ = schema;
+        data_.resize(schema.recordSize(), 0);
+    }
+
+
+    const char *PluginLogRecord::data() const
+    {
+        return data_.data();
+    }
+
+
+    size_t PluginLogRecord::size() const
+    {
+        return data_.size();
+    }
+
+
+    // PluginLogWriter
+    // ------------------------------------------------------------------------
+
+    const size_t PluginLogWriter::DEFAULT_BLOCK_SIZE = 1 << 20;
+    const unsigned int PluginLogWriter::DEFAULT_NUMBER_OF_BLOCKS = 8;
+    const double PluginLogWriter::DEFAULT_FLUSH_INTERVAL = 1.0;
+    const char PluginLogWriter::MAGIC[8] = {'B','I','A','S','P','L','O','G'};
+    const uint32_t PluginLogWriter::FORMAT_VERSION = 1;
+    const QString PluginLogWriter::FILE_EXTENSION = QString("plog");
+
+    PluginLogWriter::PluginLogWriter(QObject *parent) : QThread(parent)
+    {
+        recordSize_ = 0;
+        blockSize_ = 0;
+        stopping_ = false;
+        currentBlock_ = -1;
+        numberWritten_ = 0;
+        numberDropped_ = 0;
+    }
+
+
+    PluginLogWriter::~PluginLogWriter()
+    {
+        close();
+    }
+
+
+    RtnStatus PluginLogWriter::open(QString fileName, QString source, PluginLogSchema schema)
+    {
+        RtnStatus rtnStatus;
+        rtnStatus.success = true;
+        rtnStatus.message = QString("");
+
+        close();
+
+        if (schema.isEmpty())
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("plugin log schema has no fields");
+            return rtnStatus;
+        }
+
+        QVariantMap headerMap = schema.toMap();
+        headerMap.insert("source", source);
+        headerMap.insert("byteOrder", (Q_BYTE_ORDER == Q_LITTLE_ENDIAN) ? QString("little") : QString("big"));
+        bool ok = true;
+        QByteArray headerJson = QtJson::serialize(headerMap, ok);
+        if (!ok)
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unable to serialize plugin log header");
+            return rtnStatus;
+        }
+
+        file_.setFileName(fileName);
+        if (!file_.open(QIODevice::WriteOnly))
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unable to open plugin log file %1").arg(fileName);
+            return rtnStatus;
+        }
+
+        uint32_t version = qToLittleEndian(FORMAT_VERSION);
+        uint32_t headerSize = qToLittleEndian(uint32_t(headerJson.size()));
+
+        file_.write(MAGIC, sizeof(MAGIC));
+        file_.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        file_.write(reinterpret_cast<const char*>(&headerSize), sizeof(headerSize));
+        if (file_.write(headerJson) != headerJson.size())
+        {
+            file_.close();
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unable to write plugin log header to %1").arg(fileName);
+            return rtnStatus;
+        }
+
+        recordSize_ = schema.recordSize();
+        blockSize_ = std::max(DEFAULT_BLOCK_SIZE/recordSize_, size_t(1))*recordSize_;
+        blockVec_.assign(DEFAULT_NUMBER_OF_BLOCKS, std::vector<char>(blockSize_));
+        blockFillVec_.assign(DEFAULT_NUMBER_OF_BLOCKS, 0);
+        freeBlockVec_.clear();
+        fullBlockVec_.clear();
+        for (unsigned int i=0; i<DEFAULT_NUMBER_OF_BLOCKS; i++)
+        {
+            freeBlockVec_.push_back(int(i));
+        }
+        stopping_ = false;
+        currentBlock_ = -1;
+        numberWritten_ = 0;
+        numberDropped_ = 0;
+
+        start();
+        return rtnStatus;
+    }
+
+
+    void PluginLogWriter::close()
+    {
+        // Call once the plugin has stopped writing records
+        if (!file_.isOpen())
+        {
+            return;
+        }
+        mutex_.lock();
+        handOffCurrentBlock();
+        stopping_ = true;
+        waitCond_.wakeAll();
+        mutex_.unlock();
+        wait();
+
+        file_.close();
+        blockVec_.clear();
+        if (numberDropped_ > 0)
+        {
+            std::cerr << "warning: plugin log " << file_.fileName().toStdString();
+            std::cerr << " dropped " << numberDropped_.load() << " records" << std::endl;
+        }
+    }
+
+
+    bool PluginLogWriter::isOpen()
+    {
+        return file_.isOpen();
+    }
+
+
+    bool PluginLogWriter::write(const PluginLogRecord &record)
+    {
+        if (!file_.isOpen() || (record.size() != recordSize_))
+        {
+            return false;
+        }
+
+        // The writer thread may take a partial block at any time, so the 
+        // current block is only touched under the lock. It is never held 
+        // while writing to the file.
+        mutex_.lock();
+        if (currentBlock_ < 0)
+        {
+            if (freeBlockVec_.empty())
+            {
+                mutex_.unlock();
+                numberDropped_++;
+                return false;
+            }
+            currentBlock_ = freeBlockVec_.back();
+            freeBlockVec_.pop_back();
+            blockFillVec_[currentBlock_] = 0;
+            blockTimer_.start();
+        }
+
+        size_t &fill = blockFillVec_[currentBlock_];
+        std::memcpy(&blockVec_[currentBlock_][fill], record.data(), recordSize_);
+        fill += recordSize_;
+        if (fill + recordSize_ > blockSize_)
+        {
+            handOffCurrentBlock();
+        }
+        mutex_.unlock();
+
+        numberWritten_++;
+        return true;
+    }
+
+
+    unsigned long PluginLogWriter::numberWritten()
+    {
+        return numberWritten_;
+    }
+
+
+    unsigned long PluginLogWriter::numberDropped()
+    {
+        return numberDropped_;
+    }
+
+
+    void PluginLogWriter::run()
+    {
+        while (true)
+        {
+            unsigned long flushInterval = (unsigned long)(1000*DEFAULT_FLUSH_INTERVAL);
+            mutex_.lock();
+            while (fullBlockVec_.empty() && !stopping_)
+            {
+                waitCond_.wait(&mutex_, flushInterval);
+                if ((currentBlock_ >= 0) && (blockTimer_.elapsed() >= qint64(flushInterval)))
+                {
+                    handOffCurrentBlock();
+                }
+            }
+            if (fullBlockVec_.empty())
+            {
+                mutex_.unlock();
+                break;
+            }
+            int block = fullBlockVec_.front();
+            fullBlockVec_.erase(fullBlockVec_.begin());
+            mutex_.unlock();
+
+            file_.write(blockVec_[block].data(), blockFillVec_[block]);
+            file_.flush();
+
+            mutex_.lock();
+            freeBlockVec_.push_back(block);
+            mutex_.unlock();
+        }
+        file_.flush();
+    }
+
+
+    void PluginLogWriter::handOffCurrentBlock()
+    {
+        if (currentBlock_ < 0)
+        {
+            return;
+        }
+        if (blockFillVec_[currentBlock_] > 0)
+        {
+            fullBlockVec_.push_back(currentBlock_);
+            waitCond_.wakeAll();
+        }
+        else
+        {
+            freeBlockVec_.push_back(currentBlock_);
+        }
+        currentBlock_ = -1;
+    }
+
+
+    // PluginLogReader
+    // ------------------------------------------------------------------------
+
+    PluginLogReader::PluginLogReader()
+    {
+        swapBytes_ = false;
+    }
+
+
+    RtnStatus PluginLogReader::open(QString fileName)
+    {
+        RtnStatus rtnStatus;
+        rtnStatus.success = true;
+        rtnStatus.message = QString("");
+
+        close();
+        file_.setFileName(fileName);
+        if (!file_.open(QIODevice::ReadOnly))
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unable to open plugin log file %1").arg(fileName);
+            return rtnStatus;
+        }
+
+        char magic[sizeof(PluginLogWriter::MAGIC)];
+        uint32_t version = 0;
+        uint32_t headerSize = 0;
+        bool ok = (file_.read(magic, sizeof(magic)) == sizeof(magic));
+        ok = ok && (std::memcmp(magic, PluginLogWriter::MAGIC, sizeof(magic)) == 0);
+        ok = ok && (file_.read(reinterpret_cast<char*>(&version), sizeof(version)) == sizeof(version));
+        ok = ok && (file_.read(reinterpret_cast<char*>(&headerSize), sizeof(headerSize)) == sizeof(headerSize));
+        if (!ok)
+        {
+            file_.close();
+            rtnStatus.success = false;
+            rtnStatus.message = QString("%1 is not a plugin log file").arg(fileName);
+            return rtnStatus;
+        }
+        if (qFromLittleEndian(version) != PluginLogWriter::FORMAT_VERSION)
+        {
+            file_.close();
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unsupported plugin log version %1").arg(qFromLittleEndian(version));
+            return rtnStatus;
+        }
+
+        QByteArray headerJson = file_.read(qFromLittleEndian(headerSize));
+        QVariantMap headerMap = QtJson::parse(QString(headerJson), ok).toMap();
+        if (!ok)
+        {
+            file_.close();
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unable to parse plugin log header");
+            return rtnStatus;
+        }
+        rtnStatus = schema_.fromMap(headerMap);
+        if (!rtnStatus.success)
+        {
+            file_.close();
+            return rtnStatus;
+        }
+        source_ = headerMap["source"].toString();
+        QString hostByteOrder = (Q_BYTE_ORDER == Q_LITTLE_ENDIAN) ? QString("little") : QString("big");
+        swapBytes_ = (headerMap["byteOrder"].toString() != hostByteOrder);
+        return rtnStatus;
+    }
+
+
+    void PluginLogReader::close()
+    {
+        if (file_.isOpen())
+        {
+            file_.close();
+        }
+    }
+
+
+    QString PluginLogReader::source()
+    {
+        return source_;
+    }
+
+
+    PluginLogSchema PluginLogReader::schema()
+    {
+        return schema_;
+    }
+
+
+    bool PluginLogReader::readRecord(std::vector<char> &recordData)
+    {
+        // False at the end of the file - a partial last record is ignored
+        recordData.resize(schema_.recordSize());
+        qint64 size = qint64(recordData.size());
+        if (!file_.isOpen() || (file_.read(recordData.data(), size) != size))
+        {
+            return false;
+        }
+        if (swapBytes_)
+        {
+            for (int i=0; i<schema_.numberOfFields(); i++)
+            {
+                char *fieldPtr = &recordData[schema_.fieldOffset(i)];
+                std::reverse(fieldPtr, fieldPtr + PluginLogSchema::typeSize(schema_.fieldType(i)));
+            }
+        }
+        return true;
+    }
+
+
+    QString PluginLogReader::recordToCsv(const std::vector<char> &recordData)
+    {
+        QStringList valueList;
+        for (int i=0; i<schema_.numberOfFields(); i++)
+        {
+            const char *fieldPtr = &recordData[schema_.fieldOffset(i)];
+            switch (schema_.fieldType(i))
+            {
+                case PLUGIN_LOG_UINT8:
+                    {
+                        uint8_t value;
+                        std::memcpy(&value, fieldPtr, sizeof(value));
+                        valueList.append(QString::number(value));
+                    }
+                    break;
+                case PLUGIN_LOG_INT32:
+                    {
+                        int32_t value;
+                        std::memcpy(&value, fieldPtr, sizeof(value));
+                        valueList.append(QString::number(value));
+                    }
+                    break;
+                case PLUGIN_LOG_UINT32:
+                    {
+                        uint32_t value;
+                        std::memcpy(&value, fieldPtr, sizeof(value));
+                        valueList.append(QString::number(value));
+                    }
+                    break;
+                case PLUGIN_LOG_INT64:
+                    {
+                        qint64 value;
+                        std::memcpy(&value, fieldPtr, sizeof(value));
+                        valueList.append(QString::number(value));
+                    }
+                    break;
+                case PLUGIN_LOG_UINT64:
+                    {
+                        quint64 value;
+                        std::memcpy(&value, fieldPtr, sizeof(value));
+                        valueList.append(QString::number(value));
+                    }
+                    break;
+                case PLUGIN_LOG_FLOAT32:
+                    {
+                        float value;
+                        std::memcpy(&value, fieldPtr, sizeof(value));
+                        valueList.append(QString::number(value, 'g', 9));
+                    }
+                    break;
+                case PLUGIN_LOG_FLOAT64:
+                    {
+                        double value;
+                        std::memcpy(&value, fieldPtr, sizeof(value));
+                        valueList.append(QString::number(value, 'g', 17));
+                    }
+                    break;
+            }
+        }
+        return valueList.join(",");
+    }
+
+
+    QString PluginLogReader::headerToCsv()
+    {
+        QStringList nameList;
+        for (int i=0; i<schema_.numberOfFields(); i++)
+        {
+            nameList.append(schema_.fieldName(i));
+        }
+        return nameList.join(",");
+    }
+
+
+    RtnStatus PluginLogReader::exportCsv(QString csvFileName)
+    {
+        RtnStatus rtnStatus;
+        rtnStatus.success = true;
+        rtnStatus.message = QString("");
+
+        QFile csvFile(csvFileName);
+        if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Text))
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unable to open csv file %1").arg(csvFileName);
+            return rtnStatus;
+        }
+        QTextStream csvStream(&csvFile);
+        csvStream << headerToCsv() << '\n';
+
+        std::vector<char> recordData;
+        while (readRecord(recordData))
+        {
+            csvStream << recordToCsv(recordData) << '\n';
+        }
+        csvStream.flush();
+        csvFile.close();
+        return rtnStatus;
+    }
+
+}
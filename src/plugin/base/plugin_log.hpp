@@ -0,0 +1,234 @@
+#ifndef BIAS_PLUGIN_LOG_HPP
+#define BIAS_PLUGIN_LOG_HPP
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QString>
+#include <QFile>
+#include <QVariantMap>
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include "rtn_status.hpp"
+
+// Binary plugin log files
+// ----------------------------------------------------------------------------
+//
+// File layout:
+//
+//   char[8]     magic "BIASPLOG"
+//   uint32      format version
+//   uint32      schema size (bytes)
+//   char[]      schema, json - source plugin, byte order, record size and
+//               the name, type and offset of each field
+//   records     fixed size records, host byte order, back to back
+//
+// Use plugin_log_to_csv to convert a log to text.
+
+namespace bias
+{
+
+    enum PluginLogFieldType
+    {
+        PLUGIN_LOG_UINT8,
+        PLUGIN_LOG_INT32,
+        PLUGIN_LOG_UINT32,
+        PLUGIN_LOG_INT64,
+        PLUGIN_LOG_UINT64,
+        PLUGIN_LOG_FLOAT32,
+        PLUGIN_LOG_FLOAT64,
+    };
+
+
+    class PluginLogSchema
+    {
+        public:
+
+            PluginLogSchema();
+
+            int addField(QString name, PluginLogFieldType type);
+            int numberOfFields() const;
+            size_t recordSize() const;
+            bool isEmpty() const;
+
+            QString fieldName(int index) const;
+            PluginLogFieldType fieldType(int index) const;
+            size_t fieldOffset(int index) const;
+
+            QVariantMap toMap() const;
+            RtnStatus fromMap(QVariantMap schemaMap);
+
+            static size_t typeSize(PluginLogFieldType type);
+            static QString typeToString(PluginLogFieldType type);
+            static bool typeFromString(QString typeString, PluginLogFieldType &type);
+
+        private:
+
+            std::vector<QString> nameVec_;
+            std::vector<PluginLogFieldType> typeVec_;
+            std::vector<size_t> offsetVec_;
+            size_t recordSize_;
+    };
+
+
+    class PluginLogRecord
+    {
+        // One record laid out as in the schema. Plugins keep one around and
+        // refill it for every frame - set doesn't allocate.
+
+        public:
+
+            PluginLogRecord();
+            PluginLogRecord(PluginLogSchema schema);
+
+            template<typename T>
+            void set(int index, T value);
+
+            const char *data() const;
+            size_t size() const;
+
+        private:
+
+            PluginLogSchema schema_;
+            std::vector<char> data_;
+
+            template<typename S, typename T>
+            void store(int index, T value);
+    };
+
+
+    class PluginLogWriter : public QThread
+    {
+        // Records are copied into preallocated blocks. Full blocks are handed
+        // to this thread which writes them to disk. The thread also wakes up
+        // every flush interval and takes the partial block, so records reach
+        // the file even when the plugin stops writing. write is called from 
+        // one thread only (the plugin's) and never blocks on the file - if 
+        // every block is waiting to be written the record is dropped and 
+        // counted.
+
+        public:
+
+            static const size_t DEFAULT_BLOCK_SIZE;
+            static const unsigned int DEFAULT_NUMBER_OF_BLOCKS;
+            static const double DEFAULT_FLUSH_INTERVAL;
+            static const char MAGIC[8];
+            static const uint32_t FORMAT_VERSION;
+            static const QString FILE_EXTENSION;
+
+            PluginLogWriter(QObject *parent=0);
+            ~PluginLogWriter();
+
+            RtnStatus open(QString fileName, QString source, PluginLogSchema schema);
+            void close();
+            bool isOpen();
+
+            bool write(const PluginLogRecord &record);
+
+            unsigned long numberWritten();
+            unsigned long numberDropped();
+
+        protected:
+
+            void run();
+
+        private:
+
+            QFile file_;
+            size_t recordSize_;
+            size_t blockSize_;
+
+            std::vector<std::vector<char>> blockVec_;
+            std::vector<size_t> blockFillVec_;   // use mutex_
+            std::vector<int> freeBlockVec_;      // use mutex_
+            std::vector<int> fullBlockVec_;      // use mutex_, oldest first
+            int currentBlock_;                   // use mutex_
+            QElapsedTimer blockTimer_;           // use mutex_
+            bool stopping_;                      // use mutex_
+            QMutex mutex_;
+            QWaitCondition waitCond_;
+
+            // Updated by the writing thread, read from any thread
+            std::atomic<unsigned long> numberWritten_;
+            std::atomic<unsigned long> numberDropped_;
+
+            void handOffCurrentBlock();          // call with mutex_ locked
+    };
+
+
+    class PluginLogReader
+    {
+        public:
+
+            PluginLogReader();
+
+            RtnStatus open(QString fileName);
+            void close();
+
+            QString source();
+            PluginLogSchema schema();
+
+            bool readRecord(std::vector<char> &recordData);
+            QString recordToCsv(const std::vector<char> &recordData);
+            QString headerToCsv();
+
+            RtnStatus exportCsv(QString csvFileName);
+
+        private:
+
+            QFile file_;
+            QString source_;
+            PluginLogSchema schema_;
+            bool swapBytes_;
+    };
+
+
+    // Template methods
+    // ------------------------------------------------------------------------
+
+    template<typename T>
+    void PluginLogRecord::set(int index, T value)
+    {
+        if ((index < 0) || (index >= schema_.numberOfFields()))
+        {
+            return;
+        }
+        switch (schema_.fieldType(index))
+        {
+            case PLUGIN_LOG_UINT8:
+                store<uint8_t>(index, value);
+                break;
+            case PLUGIN_LOG_INT32:
+                store<int32_t>(index, value);
+                break;
+            case PLUGIN_LOG_UINT32:
+                store<uint32_t>(index, value);
+                break;
+            case PLUGIN_LOG_INT64:
+                store<int64_t>(index, value);
+                break;
+            case PLUGIN_LOG_UINT64:
+                store<uint64_t>(index, value);
+                break;
+            case PLUGIN_LOG_FLOAT32:
+                store<float>(index, value);
+                break;
+            case PLUGIN_LOG_FLOAT64:
+                store<double>(index, value);
+                break;
+        }
+    }
+
+
+    template<typename S, typename T>
+    void PluginLogRecord::store(int index, T value)
+    {
+        S storeValue = static_cast<S>(value);
+        std::memcpy(&data_[schema_.fieldOffset(index)], &storeValue, sizeof(S));
+    }
+
+}
+
+#endif
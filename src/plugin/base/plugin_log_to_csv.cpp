@@ -0,0 +1,44 @@
+#include "plugin_log.hpp"
+#include <QFileInfo>
+#include <QDir>
+#include <iostream>
+
+// Converts a binary plugin log file to csv - one column per schema field, 
+// with the field names as the first line.
+//
+// usage: plugin_log_to_csv <log file> [csv file]
+
+int main(int argc, char *argv[])
+{
+    if ((argc < 2) || (argc > 3))
+    {
+        std::cerr << "usage: plugin_log_to_csv <log file> [csv file]" << std::endl;
+        return 1;
+    }
+
+    QString logFileName = QString::fromLocal8Bit(argv[1]);
+    QString csvFileName;
+    if (argc == 3)
+    {
+        csvFileName = QString::fromLocal8Bit(argv[2]);
+    }
+    else
+    {
+        QFileInfo logFileInfo(logFileName);
+        csvFileName = logFileInfo.dir().absoluteFilePath(logFileInfo.completeBaseName() + QString(".csv"));
+    }
+
+    bias::PluginLogReader reader;
+    bias::RtnStatus rtnStatus = reader.open(logFileName);
+    if (rtnStatus.success)
+    {
+        rtnStatus = reader.exportCsv(csvFileName);
+    }
+    if (!rtnStatus.success)
+    {
+        std::cerr << "error: " << rtnStatus.message.toStdString() << std::endl;
+        return 1;
+    }
+    std::cout << reader.source().toStdString() << " log written to " << csvFileName.toStdString() << std::endl;
+    return 0;
+}
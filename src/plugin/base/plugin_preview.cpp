@@ -0,0 +1,84 @@
+#include "plugin_preview.hpp"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+
+namespace bias
+{
+
+    PluginOverlayBox::PluginOverlayBox()
+    {
+        lineWidth = 2;
+    }
+
+
+    PluginOverlayBox::PluginOverlayBox(QRect rect_, QColor color_, int lineWidth_)
+    {
+        rect = rect_;
+        color = color_;
+        lineWidth = lineWidth_;
+    }
+
+
+    PluginOverlayText::PluginOverlayText()
+    {
+        pointSize = 14;
+    }
+
+
+    PluginOverlayText::PluginOverlayText(QString text_, QPoint position_, QColor color_, int pointSize_)
+    {
+        text = text_;
+        position = position_;
+        color = color_;
+        pointSize = pointSize_;
+    }
+
+
+    bool PluginOverlay::isEmpty() const
+    {
+        return boxList.isEmpty() && textList.isEmpty();
+    }
+
+
+    void PluginOverlay::clear()
+    {
+        boxList.clear();
+        textList.clear();
+    }
+
+
+    PluginPreview::PluginPreview()
+    {
+        scale = 1.0;
+    }
+
+
+    bool PluginPreview::isEmpty() const
+    {
+        return image.empty();
+    }
+
+
+    PluginPreview makePluginPreview(cv::Mat image, QSize maxSize)
+    {
+        PluginPreview preview;
+        preview.image = image;
+        if (image.empty() || maxSize.isEmpty())
+        {
+            return preview;
+        }
+
+        double scaleX = double(maxSize.width())/double(image.cols);
+        double scaleY = double(maxSize.height())/double(image.rows);
+        double scale = std::min(scaleX, scaleY);
+        if (scale < 1.0)
+        {
+            int cols = std::max(int(scale*image.cols), 1);
+            int rows = std::max(int(scale*image.rows), 1);
+            cv::resize(image, preview.image, cv::Size(cols,rows), 0, 0, cv::INTER_AREA);
+            preview.scale = double(cols)/double(image.cols);
+        }
+        return preview;
+    }
+
+}
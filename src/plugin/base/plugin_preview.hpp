@@ -0,0 +1,65 @@
+#ifndef BIAS_PLUGIN_PREVIEW_HPP
+#define BIAS_PLUGIN_PREVIEW_HPP
+#include <QRect>
+#include <QPoint>
+#include <QSize>
+#include <QColor>
+#include <QString>
+#include <QList>
+#include <opencv2/core/core.hpp>
+
+namespace bias
+{
+
+    struct PluginOverlayBox
+    {
+        QRect rect;        // frame pixels
+        QColor color;
+        int lineWidth;     // display pixels
+        PluginOverlayBox();
+        PluginOverlayBox(QRect rect, QColor color, int lineWidth=2);
+    };
+
+
+    struct PluginOverlayText
+    {
+        QString text;
+        QPoint position;   // frame pixels, top center of the text
+        QColor color;
+        int pointSize;
+        PluginOverlayText();
+        PluginOverlayText(QString text, QPoint position, QColor color, int pointSize=14);
+    };
+
+
+    struct PluginOverlay
+    {
+        QList<PluginOverlayBox> boxList;
+        QList<PluginOverlayText> textList;
+        bool isEmpty() const;
+        void clear();
+    };
+
+
+    // What the gui shows in the plugin preview tab. The image is shared with
+    // the plugin, not copied - plugins publish a new cv::Mat for each frame
+    // and never write into one which has been published. It may be a 
+    // downscaled copy of the frame, scale is preview pixels per frame pixel.
+    // The overlay is drawn by the gui after scaling to the display.
+    struct PluginPreview
+    {
+        cv::Mat image;
+        double scale;
+        PluginOverlay overlay;
+        PluginPreview();
+        bool isEmpty() const;
+    };
+
+
+    // Shares the image if it fits in maxSize, otherwise returns an area 
+    // downscaled copy. An empty maxSize means no limit.
+    PluginPreview makePluginPreview(cv::Mat image, QSize maxSize);
+
+}
+
+#endif
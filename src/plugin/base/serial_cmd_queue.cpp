@@ -0,0 +1,212 @@
+#include "serial_cmd_queue.hpp"
+#include <QIODevice>
+
+namespace bias
+{
+
+    // Public methods
+    // ----------------------------------------------------------------------------------
+    SerialCmdQueue::SerialCmdQueue(QObject *parent) : QThread(parent)
+    {
+        numberCoalesced_ = 0;
+        stopping_ = false;
+        devicePtr_ = nullptr;
+        returnThread_ = nullptr;
+        clock_.start();
+    }
+
+
+    SerialCmdQueue::~SerialCmdQueue()
+    {
+        stop();
+    }
+
+
+    void SerialCmdQueue::attach(QObject *devicePtr)
+    {
+        // Call before the device is opened - from the thread which owns it
+        devicePtr -> moveToThread(this);
+        mutex_.lock();
+        devicePtr_ = devicePtr;
+        returnThread_ = nullptr;
+        stopping_ = false;
+        mutex_.unlock();
+        start(QThread::TimeCriticalPriority);
+    }
+
+
+    void SerialCmdQueue::stop()
+    {
+        // Pending commands are run before the thread exits, then the device
+        // is closed and handed back to this thread (see run)
+        mutex_.lock();
+        returnThread_ = QThread::currentThread();
+        stopping_ = true;
+        waitCond_.wakeAll();
+        mutex_.unlock();
+        wait();
+    }
+
+
+    std::shared_future<bool> SerialCmdQueue::submit(
+            QString name, 
+            Cmd cmd, 
+            bool coalesce, 
+            Callback callback
+            )
+    {
+        std::shared_ptr<std::promise<bool>> promisePtr = std::make_shared<std::promise<bool>>();
+        std::shared_future<bool> future = promisePtr -> get_future().share();
+        qint64 submitTime = clock_.nsecsElapsed();
+
+        mutex_.lock();
+        if (!isRunning() || stopping_)
+        {
+            mutex_.unlock();
+            promisePtr -> set_value(false);
+            if (callback)
+            {
+                callback(false);
+            }
+            return future;
+        }
+
+        PendingCmd *pendingPtr = nullptr;
+        if (coalesce)
+        {
+            for (PendingCmd &pending : pendingList_)
+            {
+                if (pending.coalesce && (pending.name == name))
+                {
+                    pendingPtr = &pending;
+                    pendingPtr -> submitTime = submitTime;
+                    numberCoalesced_++;
+                    break;
+                }
+            }
+        }
+        if (pendingPtr == nullptr)
+        {
+            pendingList_.push_back(PendingCmd());
+            pendingPtr = &pendingList_.back();
+            pendingPtr -> name = name;
+            pendingPtr -> coalesce = coalesce;
+            pendingPtr -> submitTime = submitTime;
+        }
+        pendingPtr -> cmd = cmd;
+        pendingPtr -> promiseVec.push_back(promisePtr);
+        if (callback)
+        {
+            pendingPtr -> callbackVec.push_back(callback);
+        }
+        waitCond_.wakeAll();
+        mutex_.unlock();
+
+        return future;
+    }
+
+
+    bool SerialCmdQueue::runSync(QString name, Cmd cmd)
+    {
+        if (QThread::currentThread() == this)
+        {
+            return cmd();
+        }
+        return submit(name, cmd).get();
+    }
+
+
+    QVariantMap SerialCmdQueue::getLatencyMap()
+    {
+        QVariantMap map;
+        mutex_.lock();
+        for (QString name : latencyMap_.keys())
+        {
+            map.insert(name, latencyMap_[name].toMap());
+        }
+        map.insert("numberCoalesced", qulonglong(numberCoalesced_));
+        mutex_.unlock();
+        return map;
+    }
+
+
+    void SerialCmdQueue::clearLatency()
+    {
+        mutex_.lock();
+        latencyMap_.clear();
+        numberCoalesced_ = 0;
+        mutex_.unlock();
+    }
+
+
+    unsigned long SerialCmdQueue::numberCoalesced()
+    {
+        mutex_.lock();
+        unsigned long numberCoalesced = numberCoalesced_;
+        mutex_.unlock();
+        return numberCoalesced;
+    }
+
+
+    // Protected methods
+    // ----------------------------------------------------------------------------------
+    void SerialCmdQueue::run()
+    {
+        while (true)
+        {
+            mutex_.lock();
+            while (pendingList_.empty() && !stopping_)
+            {
+                waitCond_.wait(&mutex_);
+            }
+            if (pendingList_.empty())
+            {
+                detachDevice();
+                mutex_.unlock();
+                break;
+            }
+            PendingCmd pending = pendingList_.front();
+            pendingList_.pop_front();
+            mutex_.unlock();
+
+            bool ok = pending.cmd();
+            double latency = 1.0e-9*(clock_.nsecsElapsed() - pending.submitTime);
+
+            mutex_.lock();
+            latencyMap_[pending.name].add(latency);
+            mutex_.unlock();
+
+            for (auto promisePtr : pending.promiseVec)
+            {
+                promisePtr -> set_value(ok);
+            }
+            for (auto callback : pending.callbackVec)
+            {
+                callback(ok);
+            }
+        }
+    }
+
+
+    void SerialCmdQueue::detachDevice()
+    {
+        // Runs on the queue thread with the lock held. A device destroyed 
+        // while it still belongs to the finished queue thread would tear 
+        // down its socket notifiers from the wrong thread.
+        if (devicePtr_ == nullptr)
+        {
+            return;
+        }
+        QIODevice *ioDevicePtr = qobject_cast<QIODevice*>(devicePtr_);
+        if ((ioDevicePtr != nullptr) && (ioDevicePtr -> isOpen()))
+        {
+            ioDevicePtr -> close();
+        }
+        if (returnThread_ != nullptr)
+        {
+            devicePtr_ -> moveToThread(returnThread_);
+        }
+        devicePtr_ = nullptr;
+    }
+
+} // namespace bias
@@ -0,0 +1,91 @@
+#ifndef BIAS_SERIAL_CMD_QUEUE_HPP
+#define BIAS_SERIAL_CMD_QUEUE_HPP
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVariantMap>
+#include <QMap>
+#include <functional>
+#include <future>
+#include <memory>
+#include <list>
+#include <vector>
+#include "latency_histogram.hpp"
+
+namespace bias
+{
+
+    class SerialCmdQueue : public QThread
+    {
+        // Dedicated I/O thread for a serial device (e.g. PulseDevice). The
+        // device is moved to this thread by attach and after that must only
+        // be used from commands run by the queue - its blocking write/read 
+        // calls then stall this thread rather than the caller. Stopping the
+        // queue closes the device on the queue thread and moves it back to 
+        // the thread calling stop, before stop returns.
+        //
+        // Commands run in submission order. A coalescing command replaces a
+        // pending (not yet started) command with the same name, e.g. only the
+        // latest of several setPulseLength requests is sent, and its latency
+        // is measured from the latest submit. The time from 
+        // submit to the command returning (write acknowledged or response 
+        // read) is recorded in a latency histogram per command name.
+
+        public:
+
+            typedef std::function<bool()> Cmd;
+            typedef std::function<void(bool)> Callback;
+
+            SerialCmdQueue(QObject *parent=0);
+            ~SerialCmdQueue();
+
+            void attach(QObject *devicePtr);
+            void stop();
+
+            // Non-blocking. The callback, if any, is called from the queue 
+            // thread with the command's return value.
+            std::shared_future<bool> submit(
+                    QString name, 
+                    Cmd cmd, 
+                    bool coalesce=false, 
+                    Callback callback=nullptr
+                    );
+
+            // Blocks the caller until the command has run
+            bool runSync(QString name, Cmd cmd);
+
+            QVariantMap getLatencyMap();
+            void clearLatency();
+            unsigned long numberCoalesced();
+
+        protected:
+
+            struct PendingCmd
+            {
+                QString name;
+                Cmd cmd;
+                bool coalesce;
+                qint64 submitTime;
+                std::vector<std::shared_ptr<std::promise<bool>>> promiseVec;
+                std::vector<Callback> callbackVec;
+            };
+
+            QMutex mutex_;
+            QWaitCondition waitCond_;
+            QObject *devicePtr_;
+            QThread *returnThread_;
+            QElapsedTimer clock_;
+            std::list<PendingCmd> pendingList_;
+            QMap<QString, LatencyHistogram> latencyMap_;
+            unsigned long numberCoalesced_;
+            bool stopping_;
+
+            void run();
+            void detachDevice();
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_SERIAL_CMD_QUEUE_HPP
@@ -27,6 +27,9 @@ namespace bias
     const int GrabDetectorConfig::DEFAULT_TRIGGER_THRESHOLD = 100;
     const int GrabDetectorConfig::DEFAULT_TRIGGER_MEDIAN_FILTER = 3;
 
+    // Log parameters
+    const bool GrabDetectorConfig::DEFAULT_BINARY_LOG = false;
+
 
     GrabDetectorConfig::GrabDetectorConfig()
     {
@@ -46,6 +49,8 @@ namespace bias
             triggerInverted = DEFAULT_TRIGGER_INVERTED;
             triggerThreshold = DEFAULT_TRIGGER_THRESHOLD;
             triggerMedianFilter = DEFAULT_TRIGGER_MEDIAN_FILTER;
+
+            binaryLog = DEFAULT_BINARY_LOG;
     }
 
 
@@ -69,11 +74,47 @@ namespace bias
             setTriggerFromMap(oldConfigMap["trigger"].toMap());
         }
 
+        // Extra detection boxes - optional, parsed after the trigger so that 
+        // boxes without a threshold get the trigger threshold.
+        RtnStatus rtnStatusExtraBoxes;
+        rtnStatusExtraBoxes.success = true;
+        if (configMap.contains("extraDetectBoxes"))
+        {
+            rtnStatusExtraBoxes = setExtraDetectBoxesFromList(configMap["extraDetectBoxes"].toList());
+        }
+
+        // Binary log - optional, text log when missing
+        RtnStatus rtnStatusBinaryLog;
+        rtnStatusBinaryLog.success = true;
+        binaryLog = DEFAULT_BINARY_LOG;
+        if (configMap.contains("binaryLog"))
+        {
+            if (configMap["binaryLog"].canConvert<bool>())
+            {
+                binaryLog = configMap["binaryLog"].toBool();
+            }
+            else
+            {
+                rtnStatusBinaryLog.success = false;
+                rtnStatusBinaryLog.message = QString("Unable to convert binaryLog to bool");
+            }
+        }
+
         RtnStatus rtnStatus;
         rtnStatus.success =  rtnStatusDevice.success && rtnStatusDetectBox.success && rtnStatusTrigger.success;
+        rtnStatus.success = rtnStatus.success && rtnStatusExtraBoxes.success;
+        rtnStatus.success = rtnStatus.success && rtnStatusBinaryLog.success;
         rtnStatus.message += rtnStatusDevice.message + QString(", ");  
         rtnStatus.message += rtnStatusDetectBox.message + QString(", ");
         rtnStatus.message += rtnStatusTrigger.message;
+        if (!rtnStatusExtraBoxes.success)
+        {
+            rtnStatus.message += QString(", ") + rtnStatusExtraBoxes.message;
+        }
+        if (!rtnStatusBinaryLog.success)
+        {
+            rtnStatus.message += QString(", ") + rtnStatusBinaryLog.message;
+        }
         return rtnStatus;
     }
 
@@ -327,6 +368,71 @@ namespace bias
     }
 
 
+    RtnStatus GrabDetectorConfig::setExtraDetectBoxesFromList(QVariantList boxList)
+    {
+        RtnStatus rtnStatus;
+        rtnStatus.success = true;
+        rtnStatus.message = QString("");
+
+        QList<GrabDetectorBox> newBoxList;
+        QStringList intKeys = {"xPos", "yPos", "width", "height"};
+
+        for (int i=0; i<boxList.size(); i++)
+        {
+            QVariantMap boxMap = boxList[i].toMap();
+            GrabDetectorBox box;
+            box.threshold = triggerThreshold;
+            box.inverted = triggerInverted;
+
+            for (QString key : intKeys)
+            {
+                if (!boxMap.contains(key) || !boxMap[key].canConvert<int>())
+                {
+                    rtnStatus.success = false;
+                    rtnStatus.appendMessage(QString("extra detect box %1: unable to convert %2 to int").arg(i).arg(key));
+                    return rtnStatus;
+                }
+            }
+            box.xPos = boxMap["xPos"].toInt();
+            box.yPos = boxMap["yPos"].toInt();
+            box.width = boxMap["width"].toInt();
+            box.height = boxMap["height"].toInt();
+
+            if (boxMap.contains("threshold"))
+            {
+                if (boxMap["threshold"].canConvert<int>())
+                {
+                    box.threshold = boxMap["threshold"].toInt();
+                }
+                else
+                {
+                    rtnStatus.success = false;
+                    rtnStatus.appendMessage(QString("extra detect box %1: unable to convert threshold to int").arg(i));
+                    return rtnStatus;
+                }
+            }
+
+            if (boxMap.contains("inverted"))
+            {
+                if (boxMap["inverted"].canConvert<bool>())
+                {
+                    box.inverted = boxMap["inverted"].toBool();
+                }
+                else
+                {
+                    rtnStatus.success = false;
+                    rtnStatus.appendMessage(QString("extra detect box %1: unable to convert inverted to bool").arg(i));
+                    return rtnStatus;
+                }
+            }
+            newBoxList.append(box);
+        }
+
+        extraDetectBoxList = newBoxList;
+        return rtnStatus;
+    }
+
+
     QVariantMap GrabDetectorConfig::toMap()
     {
         // Create Device map
@@ -354,11 +460,27 @@ namespace bias
         triggerMap.insert("threshold", triggerThreshold);
         triggerMap.insert("medianFilter", triggerMedianFilter);
 
+        // Create extra detection box list
+        QVariantList extraDetectBoxes;
+        for (GrabDetectorBox box : extraDetectBoxList)
+        {
+            QVariantMap boxMap;
+            boxMap.insert("xPos", box.xPos);
+            boxMap.insert("yPos", box.yPos);
+            boxMap.insert("width", box.width);
+            boxMap.insert("height", box.height);
+            boxMap.insert("threshold", box.threshold);
+            boxMap.insert("inverted", box.inverted);
+            extraDetectBoxes.append(boxMap);
+        }
+
         // Create map for whole configuration
         QVariantMap configMap;
         configMap.insert("device", deviceMap);
         configMap.insert("detectBox", detectBoxMap);
         configMap.insert("trigger", triggerMap);
+        configMap.insert("extraDetectBoxes", extraDetectBoxes);
+        configMap.insert("binaryLog", binaryLog);
 
         return configMap;
     }
@@ -422,6 +544,15 @@ namespace bias
         configStr.append(QString("  armedState:     %1\n").arg(triggerArmedState));
         configStr.append(QString("  threshold:      %1\n").arg(triggerThreshold));
         configStr.append(QString("  medianFilter:   %1\n").arg(triggerMedianFilter));
+
+        configStr.append(QString("\n"));
+        configStr.append(QString("ExtraDetectBoxes: %1\n").arg(extraDetectBoxList.size()));
+        for (GrabDetectorBox box : extraDetectBoxList)
+        {
+            configStr.append(QString("  (%1, %2, %3, %4), threshold %5, inverted %6\n")
+                    .arg(box.xPos).arg(box.yPos).arg(box.width).arg(box.height)
+                    .arg(box.threshold).arg(box.inverted));
+        }
         configStr.append(QString("\n"));
         return configStr;
     }
@@ -3,12 +3,27 @@
 
 #include "rtn_status.hpp"
 #include <QVariantMap>
+#include <QVariantList>
 #include <QColor>
+#include <QList>
 
 
 namespace bias
 {
 
+    // Additional detection box - e.g. one per well of a multi-well plate. 
+    // Each box is thresholded independently of the others.
+    struct GrabDetectorBox
+    {
+        int xPos;
+        int yPos;
+        int width;
+        int height;
+        int threshold;
+        bool inverted;
+    };
+
+
     class GrabDetectorConfig
     {
 
@@ -34,6 +49,9 @@ namespace bias
             static const int DEFAULT_TRIGGER_THRESHOLD;
             static const int DEFAULT_TRIGGER_MEDIAN_FILTER;
 
+            // Default log parameters
+            static const bool DEFAULT_BINARY_LOG;
+
             // Device parameters
             QString devicePortName;
             bool deviceAutoConnect;
@@ -54,11 +72,18 @@ namespace bias
             int triggerThreshold;
             int triggerMedianFilter;
 
+            // Extra detection boxes - in addition to the box above
+            QList<GrabDetectorBox> extraDetectBoxList;
+
+            // Log parameters - binary (.plog) instead of text log
+            bool binaryLog;
+
             GrabDetectorConfig();
 
             RtnStatus setDeviceFromMap(QVariantMap configMap);
             RtnStatus setDetectBoxFromMap(QVariantMap configMap);
             RtnStatus setTriggerFromMap(QVariantMap configMap);
+            RtnStatus setExtraDetectBoxesFromList(QVariantList boxList);
             RtnStatus fromMap(QVariantMap configMap);
             QVariantMap toMap();
 
@@ -1,5 +1,6 @@
 #include "grab_detector_plugin.hpp"
 #include "image_label.hpp"
+#include "json.hpp"
 #include <QtDebug>
 #include <QTimer>
 #include <QMessageBox>
@@ -19,9 +20,70 @@ namespace bias
     int GrabDetectorPlugin::DEFAULT_LIVEPLOT_UPDATE_DT = 75;
     double GrabDetectorPlugin::DEFAULT_LIVEPLOT_TIME_WINDOW = 10.0; 
     double GrabDetectorPlugin::DEFAULT_LIVEPLOT_SIGNAL_WINDOW = 255.0;
+    unsigned int GrabDetectorPlugin::DEFAULT_LIVEPLOT_MAX_POINTS = 2000;
     const QString GrabDetectorPlugin::LOG_FILE_EXTENSION = QString("txt");
     const QString GrabDetectorPlugin::LOG_FILE_POSTFIX = QString("grab_detector_log");
 
+    // Binary log record fields - in schema order
+    enum 
+    {
+        LOG_FRAME_COUNT,
+        LOG_TIME_STAMP,
+        LOG_THRESHOLD,
+        LOG_SIGNAL,
+        LOG_BOX_INDEX,
+    };
+
+    // Published result fields - in setResultFields order, followed by the 
+    // signal of each detection box
+    enum
+    {
+        RESULT_FOUND,
+        RESULT_FOUND_INDEX,
+        RESULT_SIGNAL_MIN,
+        RESULT_SIGNAL_MAX,
+        RESULT_TRIGGERED,
+        RESULT_BOX_SIGNAL,
+    };
+
+
+    // Helper functions
+    // ------------------------------------------------------------------------
+    bool getBoxSignal(
+            const cv::Mat &image, 
+            cv::Rect boxRect, 
+            int medianFilterSize, 
+            double &signalMin, 
+            double &signalMax
+            )
+    {
+        // Median filter only the box plus a margin of half the filter size, 
+        // so pixels at the box edges see the same neighbourhood as they would
+        // if the whole frame was filtered. The frame itself isn't copied. 
+        cv::Rect imageRect(0, 0, image.cols, image.rows);
+        boxRect &= imageRect;
+        if (boxRect.area() == 0)
+        {
+            return false;
+        }
+
+        int margin = medianFilterSize/2;
+        cv::Rect padRect(
+                boxRect.x - margin, 
+                boxRect.y - margin, 
+                boxRect.width + 2*margin, 
+                boxRect.height + 2*margin
+                );
+        padRect &= imageRect;
+
+        cv::Mat filterImage;
+        cv::medianBlur(image(padRect), filterImage, medianFilterSize);
+
+        cv::Rect innerRect(boxRect.x - padRect.x, boxRect.y - padRect.y, boxRect.width, boxRect.height);
+        cv::minMaxLoc(filterImage(innerRect), &signalMin, &signalMax);
+        return true;
+    }
+
 
     // Public Methods
     // ------------------------------------------------------------------------
@@ -36,6 +98,19 @@ namespace bias
 
     void GrabDetectorPlugin::reset()
     {
+        livePlotRing_.clear();
+
+        QStringList resultFields;
+        resultFields << "found" << "foundIndex" << "signalMin" << "signalMax" << "triggered";
+        int numberOfBoxes = getDetectionBoxVec().size();
+        for (int i=0; i<numberOfBoxes; i++)
+        {
+            resultFields << QString("signal%1").arg(i);
+        }
+        setResultFields(resultFields);
+        resultValueVec_.assign(resultFields.size(), 0.0);
+        updateDetectSettings();
+
         openLogFile();
     }
 
@@ -51,109 +126,225 @@ namespace bias
         // --------------------------------------------------------------
         // NOTE: called in separate thread.
         // --------------------------------------------------------------
-        
 
-        int medianFilterSize = getMedianFilter();
-        int threshold = getThreshold();
-        bool inverted = getInverted();
-        bool found = false;
-        double signalMin; 
-        double signalMax;
+        // Only used if the plugin handler runs frames serially - same work 
+        // as the concurrent path, for the latest frame.
+        QList<PluginFrameResult> resultList;
+        resultList.append(processFrameConcurrent(frameList.back()));
+        frameList.clear();
+        processFrameResults(resultList);
+    }
 
-        int frameListSize = frameList.size();
 
-        StampedImage latestFrame = frameList.back();
-        frameList.clear();
+    PluginFrameResult GrabDetectorPlugin::processFrameConcurrent(StampedImage stampedImage)
+    {
+        // Runs on the plugin handler's worker threads, several frames at a 
+        // time - box signals only, everything else is in processFrameResults.
+        PluginFrameResult result;
+        result.stampedImage = stampedImage;
+
+        acquireLock();
+        QVector<GrabDetectorBox> boxVec = detectBoxVec_;
+        int medianFilterSize = detectMedianFilter_;
+        releaseLock();
 
-        cv::Mat workingImage = latestFrame.image.clone();
-        if ((workingImage.rows != 0) && (workingImage.cols != 0))
+        // Note, frames aren't modified so the image is shared rather than 
+        // cloned - the preview shares it too and the gui draws the boxes.
+        const cv::Mat &image = stampedImage.image;
+        if ((image.rows == 0) || (image.cols == 0))
         {
-            cv::Rect boxRect = getDetectionBoxCv();
-            cv::Mat roiImage = workingImage(boxRect);
-            cv::medianBlur(roiImage,roiImage,medianFilterSize);
-            cv::minMaxLoc(roiImage,&signalMin,&signalMax);
+            return result;
+        }
+
+        bool found = false;
+        int foundIndex = -1;
+        double foundThreshold = 0.0;
+        double signalMin = 0.0; 
+        double signalMax = 0.0;
+        QVariantList boxSignalList;
+        QVariantList boxFoundList;
+
+        for (int i=0; i<boxVec.size(); i++)
+        {
+            GrabDetectorBox box = boxVec[i];
+            cv::Rect boxRect(box.xPos, box.yPos, box.width, box.height);
+            double boxMin = 0.0;
+            double boxMax = 0.0;
+            if (!getBoxSignal(image, boxRect, medianFilterSize, boxMin, boxMax))
+            {
+                boxSignalList.append(0.0);
+                boxFoundList.append(false);
+                continue;
+            }
 
             bool thresholdTest = false;
-            if (inverted)
+            if (box.inverted)
             {
-                thresholdTest = signalMax < double(threshold);
+                thresholdTest = boxMax < double(box.threshold);
             }
             else
             {
-                thresholdTest = signalMax > double(threshold);
+                thresholdTest = boxMax > double(box.threshold);
             }
 
-            if (thresholdTest)
+            boxSignalList.append(boxMax);
+            boxFoundList.append(thresholdTest);
+            if (thresholdTest && !found)
             {
                 found = true;
+                foundIndex = i;
+                foundThreshold = double(box.threshold);
             }
-            else
-            { 
-                found = false;
+            if (i == 0)
+            {
+                signalMin = boxMin;
+                signalMax = boxMax;
+            }
+        }
+
+        result.data.insert("found", found);
+        result.data.insert("foundIndex", foundIndex);
+        result.data.insert("foundThreshold", foundThreshold);
+        result.data.insert("signalMin", signalMin);
+        result.data.insert("signalMax", signalMax);
+        result.data.insert("boxSignal", boxSignalList);
+        result.data.insert("boxFound", boxFoundList);
+        return result;
+    }
+
+
+    void GrabDetectorPlugin::processFrameResults(QList<PluginFrameResult> resultList)
+    {
+        // Plugin handler thread, results in frame order
+        for (PluginFrameResult &result : resultList)
+        {
+            if (result.data.isEmpty())
+            {
+                continue;
+            }
+            const StampedImage &frame = result.stampedImage;
+            bool found = result.data["found"].toBool();
+            int foundIndex = result.data["foundIndex"].toInt();
+            double signalMin = result.data["signalMin"].toDouble();
+            double signalMax = result.data["signalMax"].toDouble();
+            bool triggered = false;
+
+            QVector<double> boxSignalVec;
+            for (QVariant boxSignal : result.data["boxSignal"].toList())
+            {
+                boxSignalVec.append(boxSignal.toDouble());
+            }
+            QVector<bool> boxFoundVec;
+            for (QVariant boxFound : result.data["boxFound"].toList())
+            {
+                boxFoundVec.append(boxFound.toBool());
             }
 
             acquireLock();
-            currentImage_ = workingImage;
+            currentImage_ = frame.image;
             signalMin_ = signalMin;
             signalMax_ = signalMax;
             found_ = found;
-            frameCount_ = latestFrame.frameCount;
-            livePlotTimeVec_.append(latestFrame.timeStamp);
-            livePlotSignalVec_.append(signalMax);
+            boxSignalVec_ = boxSignalVec;
+            boxFoundVec_ = boxFoundVec;
+            frameCount_ = frame.frameCount;
             if (found && config_.triggerArmedState)
             {
                 if (config_.triggerEnabled)
                 {
+                    // Pulse is sent from here rather than from the gui thread
+                    // so trigger to pulse latency doesn't depend on the event
+                    // loop. Disarm now so later frames don't pulse again. 
+                    config_.triggerArmedState = false;
+                    triggered = true;
+                    if (pulseDeviceOpen_)
+                    {
+                        pulseDeviceQueue_.submit(
+                                QString("triggerPulse"), 
+                                [this]() { return pulseDevice_.startPulse(); }
+                                );
+                    }
+
                     TriggerData triggerData;
-                    triggerData.frameCount = latestFrame.frameCount;
-                    triggerData.timeStamp = latestFrame.timeStamp;
-                    triggerData.threshold = double(threshold);
-                    triggerData.signal = signalMax;
+                    triggerData.frameCount = frame.frameCount;
+                    triggerData.timeStamp = frame.timeStamp;
+                    triggerData.threshold = result.data["foundThreshold"].toDouble();
+                    triggerData.signal = boxSignalVec[foundIndex];
+                    triggerData.boxIndex = foundIndex;
                     emit triggerFired(triggerData);
                 }
             }
             releaseLock();
+
+            // Single writer - the live plot timer reads without the lock
+            livePlotRing_.append(frame.timeStamp, signalMax);
+
+            // Box count is fixed at reset, boxes added since aren't published
+            resultValueVec_[RESULT_FOUND] = found ? 1.0 : 0.0;
+            resultValueVec_[RESULT_FOUND_INDEX] = double(foundIndex);
+            resultValueVec_[RESULT_SIGNAL_MIN] = signalMin;
+            resultValueVec_[RESULT_SIGNAL_MAX] = signalMax;
+            resultValueVec_[RESULT_TRIGGERED] = triggered ? 1.0 : 0.0;
+            for (size_t i=RESULT_BOX_SIGNAL; i<resultValueVec_.size(); i++)
+            {
+                int boxIndex = int(i) - RESULT_BOX_SIGNAL;
+                resultValueVec_[i] = (boxIndex < boxSignalVec.size()) ? boxSignalVec[boxIndex] : 0.0;
+            }
+            publishResult(frame.frameCount, frame.timeStamp, resultValueVec_);
         }
+
+        // Box or filter edits reach the workers from the next frames on
+        updateDetectSettings();
+    }
+
+
+    void GrabDetectorPlugin::updateDetectSettings()
+    {
+        QVector<GrabDetectorBox> boxVec = getDetectionBoxVec();
+        int medianFilterSize = getMedianFilter();
+        acquireLock();
+        detectBoxVec_ = boxVec;
+        detectMedianFilter_ = medianFilterSize;
+        releaseLock();
     }
 
-    cv::Mat GrabDetectorPlugin::getCurrentImage()
+    PluginPreview GrabDetectorPlugin::getPreview(QSize maxSize)
     {
         acquireLock();
         cv::Mat currentImage = currentImage_;
-        int signalMin = signalMin_;
-        int signalMax = signalMax_;
         bool found = found_;
-        int frameCount = frameCount_;
+        QVector<bool> boxFoundVec = boxFoundVec_;
         releaseLock();
 
-        cv::Rect boxRect = getDetectionBoxCv();
-        int red = config_.detectBoxColor.red();
-        int green = config_.detectBoxColor.green();
-        int blue = config_.detectBoxColor.blue();
-        cv::Scalar boxColor(blue,green,red);
-        int boxLineWidth = 2;
+        PluginPreview preview = makePluginPreview(currentImage, maxSize);
+        if (preview.isEmpty())
+        {
+            return preview;
+        }
 
-        std::stringstream foundStream;
+        QVector<GrabDetectorBox> boxVec = getDetectionBoxVec();
+        int boxLineWidth = 2;
+        for (int i=0; i<boxVec.size(); i++)
+        {
+            GrabDetectorBox box = boxVec[i];
+            QRect boxRect(box.xPos, box.yPos, box.width, box.height);
+            bool boxFound = (i < boxFoundVec.size()) && boxFoundVec[i];
+            preview.overlay.boxList.append(PluginOverlayBox(
+                        boxRect, 
+                        config_.detectBoxColor, 
+                        boxFound ? 2*boxLineWidth : boxLineWidth
+                        ));
+        }
         if (found)
         {
-            foundStream << "object found";
+            QPoint textPoint(currentImage.cols/2, 0);
+            preview.overlay.textList.append(PluginOverlayText(
+                        QString("object found"), 
+                        textPoint, 
+                        config_.detectBoxColor
+                        ));
         }
-        cv::Mat currentImageBGR;
-        //cv::cvtColor(currentImage, currentImageBGR, CV_GRAY2BGR);
-        cv::cvtColor(currentImage, currentImageBGR, cv::COLOR_GRAY2BGR);
-        cv::rectangle(currentImageBGR, boxRect,boxColor, boxLineWidth);
-
-        double fontScale = 1.0;
-        int thickness = 2;
-        int baseline = 0;
-
-
-        //cv::Size textSize = cv::getTextSize(foundStream.str(), CV_FONT_HERSHEY_SIMPLEX, fontScale, thickness, &baseline);
-        cv::Size textSize = cv::getTextSize(foundStream.str(), cv::FONT_HERSHEY_SIMPLEX, fontScale, thickness, &baseline);
-        cv::Point textPoint(currentImage.cols/2 - textSize.width/2, textSize.height+baseline);
-        //cv::putText(currentImageBGR, foundStream.str(), textPoint, CV_FONT_HERSHEY_SIMPLEX, fontScale, boxColor,thickness);
-        cv::putText(currentImageBGR, foundStream.str(), textPoint, cv::FONT_HERSHEY_SIMPLEX, fontScale, boxColor,thickness);
-        return currentImageBGR;
+        return preview;
     }
 
 
@@ -164,6 +355,31 @@ namespace bias
         return boxCv;
     }
 
+    QVector<GrabDetectorBox> GrabDetectorPlugin::getDetectionBoxVec()
+    {
+        // The box set in the dialog followed by the extra configuration boxes
+        QVector<GrabDetectorBox> boxVec;
+
+        QRect box = getDetectionBox();
+        GrabDetectorBox mainBox;
+        mainBox.xPos = box.x();
+        mainBox.yPos = box.y();
+        mainBox.width = box.width();
+        mainBox.height = box.height();
+        mainBox.threshold = getThreshold();
+        mainBox.inverted = getInverted();
+        boxVec.append(mainBox);
+
+        acquireLock();
+        for (GrabDetectorBox extraBox : config_.extraDetectBoxList)
+        {
+            boxVec.append(extraBox);
+        }
+        releaseLock();
+        return boxVec;
+    }
+
+
     QRect GrabDetectorPlugin::getDetectionBox()
     {
         QRect box = QRect( 
@@ -279,6 +495,16 @@ namespace bias
         {
             rtnStatus = disconnectTriggerDev();
         }
+        else if (cmd == QString("get-latency"))
+        {
+            bool ok = true;
+            QByteArray latencyJson = QtJson::serialize(pulseDeviceQueue_.getLatencyMap(), ok);
+            rtnStatus.message = QString(latencyJson);
+        }
+        else if (cmd == QString("clear-latency"))
+        {
+            pulseDeviceQueue_.clearLatency();
+        }
         else if (cmd == QString("set-config"))
         {
             QVariantMap configMap = cmdMap["config"].toMap();
@@ -338,7 +564,13 @@ namespace bias
 
     QString GrabDetectorPlugin::getLogFileExtension()
     {
-        return LOG_FILE_EXTENSION;
+        return isBinaryLogEnabled() ? PluginLogWriter::FILE_EXTENSION : LOG_FILE_EXTENSION;
+    }
+
+
+    bool GrabDetectorPlugin::isBinaryLogEnabled()
+    {
+        return config_.binaryLog;
     }
 
 
@@ -362,7 +594,7 @@ namespace bias
         tabWidgetPtr -> setEnabled(false);
         tabWidgetPtr -> repaint(); 
 
-        if (pulseDevice_.isOpen())
+        if (pulseDeviceOpen_)
         {
             tabWidgetPtr -> setEnabled(true);
             rtnStatus.success = true;
@@ -376,12 +608,17 @@ namespace bias
         {
             int index = comPortComboBoxPtr -> currentIndex();
             QSerialPortInfo serialInfo = serialInfoList_.at(index);
-            pulseDevice_.setPort(serialInfo);
-            pulseDevice_.open();
+            pulseDeviceQueue_.runSync(QString("open"), [this,serialInfo]() 
+            { 
+                pulseDevice_.setPort(serialInfo);
+                bool ok = pulseDevice_.open();
+                pulseDeviceOpen_ = pulseDevice_.isOpen();
+                return ok;
+            });
         }
 
         // Check to see if device is opene or closed and set status string accordingly
-        if (pulseDevice_.isOpen())
+        if (pulseDeviceOpen_)
         {
             statusLabelPtr -> setText(QString("Status: connected"));
             connectPushButtonPtr -> setText("Disconnect");
@@ -390,8 +627,13 @@ namespace bias
             devOutputGroupBoxPtr -> setEnabled(true);
 
             // Get list of allowed output pins
-            bool ok;
-            QVector<int> allowedOutputPin = pulseDevice_.getAllowedOutputPin(&ok);
+            QVector<int> allowedOutputPin;
+            bool ok = pulseDeviceQueue_.runSync(QString("getAllowedOutputPin"), [this,&allowedOutputPin]() 
+            { 
+                bool pinOk = false;
+                allowedOutputPin = pulseDevice_.getAllowedOutputPin(&pinOk);
+                return pinOk;
+            });
             if (ok)
             {
                 allowedOutputPin_ = allowedOutputPin;
@@ -421,7 +663,7 @@ namespace bias
             if (pinAllowed)
             {
                 outputPinComboBoxPtr -> setCurrentIndex(pinIndex);
-                ok = pulseDevice_.setOutputPin(config_.outputPin);
+                ok = setOutputPinOnDev(config_.outputPin);
             }
             else
             {
@@ -429,7 +671,7 @@ namespace bias
                 {
                     outputPinComboBoxPtr -> setCurrentIndex(0);
                     config_.outputPin = allowedOutputPin_[0];
-                    ok = pulseDevice_.setOutputPin(config_.outputPin);
+                    ok = setOutputPinOnDev(config_.outputPin);
                 }
             }
 
@@ -444,7 +686,11 @@ namespace bias
             }
 
             // Set pulse length 
-            ok =  pulseDevice_.setPulseLength(1.0e6*config_.devicePulseDuration);
+            unsigned long pulseLength_us = (unsigned long)(1.0e6*config_.devicePulseDuration);
+            ok = pulseDeviceQueue_.runSync(QString("setPulseLength"), [this,pulseLength_us]() 
+            { 
+                return pulseDevice_.setPulseLength(pulseLength_us);
+            });
             if (ok)
             {
                 durationDblSpinBoxPtr -> setValue(config_.devicePulseDuration);
@@ -478,11 +724,16 @@ namespace bias
         tabWidgetPtr -> setEnabled(false);
         tabWidgetPtr -> repaint(); 
 
-        if (pulseDevice_.isOpen())
+        if (pulseDeviceOpen_)
         {
             statusLabelPtr -> setText(QString("Status: disconnecting ... "));
             statusLabelPtr -> repaint();
-            pulseDevice_.close();
+            pulseDeviceQueue_.runSync(QString("close"), [this]() 
+            { 
+                pulseDevice_.close(); 
+                pulseDeviceOpen_ = pulseDevice_.isOpen();
+                return true;
+            });
         }
         else
         {
@@ -514,10 +765,12 @@ namespace bias
         RtnStatus rtnStatus;
 
         GrabDetectorConfig oldConfig = config_;
+        acquireLock();
         config_= config;
+        releaseLock();
 
         bool reconnect = false;
-        if (pulseDevice_.isOpen())
+        if (pulseDeviceOpen_)
         {
             disconnectTriggerDev();
             reconnect = true;
@@ -578,7 +831,7 @@ namespace bias
             rtnStatus.appendMessage(QString("port %1 not found").arg(config_.devicePortName));
         }
 
-        if (!pulseDevice_.isOpen())
+        if (!pulseDeviceOpen_)
         {
             statusLabelPtr -> setText(QString("Status: not connected "));
             devOutputGroupBoxPtr -> setEnabled(false);
@@ -692,6 +945,9 @@ namespace bias
 
     void GrabDetectorPlugin::initialize()
     {
+        // All pulse device I/O runs on the queue's thread from here on
+        pulseDeviceQueue_.attach(&pulseDevice_);
+
         found_ = false;
         signalMax_ = 0.0;
         signalMin_ = 0.0;
@@ -700,6 +956,7 @@ namespace bias
         livePlotUpdateDt_ = DEFAULT_LIVEPLOT_UPDATE_DT;
         livePlotTimeWindow_ = DEFAULT_LIVEPLOT_TIME_WINDOW;
         livePlotSignalWindow_ = DEFAULT_LIVEPLOT_SIGNAL_WINDOW;
+        livePlotMaxPoints_ = DEFAULT_LIVEPLOT_MAX_POINTS;
 
         // Setup live plot
         livePlotPtr -> addGraph();
@@ -722,7 +979,23 @@ namespace bias
 
         setFromConfig(config_);
         setRequireTimer(false);
-
+        setRequireColor(false);
+        setSubscriptionMode(PLUGIN_SUBSCRIBE_LATEST_FRAME);
+
+        // Box signals are independent per frame - computed on the plugin 
+        // handler's worker threads (processFrameConcurrent)
+        setReentrant(true);
+
+        PluginLogSchema logSchema;
+        logSchema.addField(QString("frameCount"), PLUGIN_LOG_UINT64);
+        logSchema.addField(QString("timeStamp"), PLUGIN_LOG_FLOAT64);
+        logSchema.addField(QString("threshold"), PLUGIN_LOG_FLOAT64);
+        logSchema.addField(QString("signal"), PLUGIN_LOG_FLOAT64);
+        logSchema.addField(QString("boxIndex"), PLUGIN_LOG_INT32);
+        setLogSchema(logSchema);
+        logRecord_ = PluginLogRecord(logSchema);
+
+        updateDetectSettings();
     }
 
     void GrabDetectorPlugin::updateTrigStateInfo()
@@ -776,6 +1049,15 @@ namespace bias
     }
 
 
+    bool GrabDetectorPlugin::setOutputPinOnDev(int pin)
+    {
+        return pulseDeviceQueue_.runSync(QString("setOutputPin"), [this,pin]() 
+        { 
+            return pulseDevice_.setOutputPin(pin); 
+        });
+    }
+
+
     void GrabDetectorPlugin::updateColorExampleLabel()
     { 
         QPalette palette = colorExampleLabelPtr -> palette();
@@ -787,7 +1069,18 @@ namespace bias
 
     void GrabDetectorPlugin::writeLogData(TriggerData data)
     {
-        logStream_ << data.frameCount << " " << data.timeStamp << " " << data.threshold << " " << data.signal << '\n';
+        if (!logWriter_.isOpen())
+        {
+            logStream_ << data.frameCount << " " << data.timeStamp << " " << data.threshold << " " << data.signal;
+            logStream_ << " " << data.boxIndex << '\n';
+            return;
+        }
+        logRecord_.set(LOG_FRAME_COUNT, data.frameCount);
+        logRecord_.set(LOG_TIME_STAMP, data.timeStamp);
+        logRecord_.set(LOG_THRESHOLD, data.threshold);
+        logRecord_.set(LOG_SIGNAL, data.signal);
+        logRecord_.set(LOG_BOX_INDEX, data.boxIndex);
+        logWriter_.write(logRecord_);
     }
 
 
@@ -805,7 +1098,7 @@ namespace bias
 
     void GrabDetectorPlugin::connectPushButtonClicked()
     {
-        if (pulseDevice_.isOpen())
+        if (pulseDeviceOpen_)
         {
             disconnectTriggerDev();
         }
@@ -824,9 +1117,12 @@ namespace bias
 
     void GrabDetectorPlugin::outputTestPushButtonClicked()
     {
-        if (pulseDevice_.isOpen())
+        if (pulseDeviceOpen_)
         {
-            bool ok = pulseDevice_.startPulse(); 
+            bool ok = pulseDeviceQueue_.runSync(QString("testPulse"), [this]() 
+            { 
+                return pulseDevice_.startPulse(); 
+            });
             if (!ok)
             {
                 QString msgTitle("PulseDevice Error");
@@ -839,12 +1135,12 @@ namespace bias
 
     void GrabDetectorPlugin::outputPinComboBoxIndexChanged(int index)
     {
-        if (pulseDevice_.isOpen() && (index >= 0) && outputPinComboBoxReady_ )
+        if (pulseDeviceOpen_ && (index >= 0) && outputPinComboBoxReady_ )
         {
             int newOutputPin = allowedOutputPin_[index];
             if (config_.outputPin != newOutputPin)
             {
-                bool ok = pulseDevice_.setOutputPin(newOutputPin);
+                bool ok = setOutputPinOnDev(newOutputPin);
                 if (ok)
                 {
                     config_.outputPin = newOutputPin;
@@ -856,10 +1152,16 @@ namespace bias
 
     void GrabDetectorPlugin::durationDblSpinBoxValueChanged(double value)
     {
-        if (pulseDevice_.isOpen())
+        if (pulseDeviceOpen_)
         {
+            // Non-blocking - spin box steps are coalesced so only the latest
+            // pending length is sent.
             unsigned long pulseLength_us = (unsigned long)(value*1.0e6);
-            bool ok = pulseDevice_.setPulseLength(pulseLength_us);
+            pulseDeviceQueue_.submit(
+                    QString("setPulseLength"), 
+                    [this,pulseLength_us]() { return pulseDevice_.setPulseLength(pulseLength_us); },
+                    true
+                    );
         }
     }
 
@@ -916,29 +1218,16 @@ namespace bias
 
     void GrabDetectorPlugin::updateLivePlotOnTimer()
     {
-        if (livePlotTimeVec_.empty())
+        QVector<double> livePlotTimeVec;
+        QVector<double> livePlotSignalVec;
+        livePlotRing_.getWindow(livePlotTimeWindow_, livePlotMaxPoints_, livePlotTimeVec, livePlotSignalVec);
+        if (livePlotTimeVec.empty())
         {
             return;
         }
 
-        acquireLock();
-        double lastTime = livePlotTimeVec_.last();
-        double firstTime = livePlotTimeVec_.first();
-
-        if (lastTime < firstTime)
-        {
-            livePlotTimeVec_.clear();
-            livePlotSignalVec_.clear();
-            releaseLock();
-            return;
-        }
-
-        while (lastTime - firstTime > livePlotTimeWindow_)
-        {
-            livePlotTimeVec_.pop_front();
-            livePlotSignalVec_.pop_front();
-            firstTime = livePlotTimeVec_.first();
-        }
+        double lastTime = livePlotTimeVec.last();
+        double firstTime = livePlotTimeVec.first();
 
         double threshold = double(getThreshold());
         QVector<double> threshSignalVec = {threshold, threshold};
@@ -956,28 +1245,21 @@ namespace bias
             threshTimeVec = QVector<double>({firstTime, lastTime});
         }
 
-        livePlotPtr -> graph(0) -> setData(livePlotTimeVec_,livePlotSignalVec_);
+        livePlotPtr -> graph(0) -> setData(livePlotTimeVec,livePlotSignalVec);
 
         livePlotPtr -> graph(1) -> setData(threshTimeVec, threshSignalVec);
         livePlotPtr -> replot();
-        releaseLock();
 
     }
 
     void GrabDetectorPlugin::onTriggerFired(TriggerData data)
     {
-        if (config_.triggerArmedState)
+        // Pulse already sent and trigger disarmed by processFrames
+        emit recordTriggerRequest(data.timeStamp);
+        if (loggingEnabled_)
         {
-            if (pulseDevice_.isOpen())
-            {
-                pulseDevice_.startPulse();
-            }
-            config_.triggerArmedState = false;
-            if (loggingEnabled_)
-            {
-                writeLogData(data);
-            }
-            updateTrigStateInfo();
+            writeLogData(data);
         }
+        updateTrigStateInfo();
     }
 }
@@ -4,11 +4,14 @@
 #include "grab_detector_config.hpp"
 #include "bias_plugin.hpp"
 #include "pulse_device.hpp"
+#include "serial_cmd_queue.hpp"
+#include "time_series_ring.hpp"
 #include <QPointer>
 #include <QVector>
 #include <QList>
 #include <QSerialPort>
 #include <QSerialPortInfo>
+#include <atomic>
 
 class QTimer;
 
@@ -30,6 +33,7 @@ namespace bias
         double timeStamp;
         double threshold;
         double signal;
+        int boxIndex;
     };
 
 
@@ -44,6 +48,7 @@ namespace bias
             static int DEFAULT_LIVEPLOT_UPDATE_DT;
             static double DEFAULT_LIVEPLOT_TIME_WINDOW; 
             static double DEFAULT_LIVEPLOT_SIGNAL_WINDOW;
+            static unsigned int DEFAULT_LIVEPLOT_MAX_POINTS;
             static const QString LOG_FILE_EXTENSION;
             static const QString LOG_FILE_POSTFIX;
 
@@ -52,7 +57,9 @@ namespace bias
             virtual void stop();
 
             virtual void processFrames(QList<StampedImage> frameList);
-            virtual cv::Mat getCurrentImage();
+            virtual PluginFrameResult processFrameConcurrent(StampedImage stampedImage);
+            virtual void processFrameResults(QList<PluginFrameResult> resultList);
+            virtual PluginPreview getPreview(QSize maxSize);
 
             virtual QString getName();
             virtual QString getDisplayName();
@@ -63,6 +70,7 @@ namespace bias
             virtual RtnStatus setConfigFromJson(QByteArray jsonArray);
             virtual QString getLogFileExtension();
             virtual QString getLogFilePostfix();
+            virtual bool isBinaryLogEnabled();
 
             void setTriggerEnabled(bool value);
             void resetTrigger();
@@ -82,26 +90,40 @@ namespace bias
             double signalMax_;
             double signalMin_;
             unsigned long frameCount_;
+            QVector<double> boxSignalVec_;
+            QVector<bool> boxFoundVec_;
             
             GrabDetectorConfig config_;
 
             int livePlotUpdateDt_;
             double livePlotTimeWindow_; 
             double livePlotSignalWindow_;
-            QVector<double> livePlotTimeVec_;
-            QVector<double> livePlotSignalVec_;
+            unsigned int livePlotMaxPoints_;
+            TimeSeriesRing livePlotRing_;
             QPointer<QTimer> livePlotUpdateTimerPtr_;
             QPointer<ImageLabel> imageLabelPtr_;
 
             QList<QSerialPortInfo> serialInfoList_;
             PulseDevice pulseDevice_;
+            SerialCmdQueue pulseDeviceQueue_;  // after pulseDevice_ so it is destroyed first
+            std::atomic<bool> pulseDeviceOpen_{false};  // set on the queue thread
             QVector<int> allowedOutputPin_;
             bool outputPinComboBoxReady_ = false;
 
+            PluginLogRecord logRecord_;
+            std::vector<double> resultValueVec_;  // processing thread only
+
+            // Detection settings used by processFrameConcurrent - use lock. 
+            // Refreshed from the dialog by reset and processFrameResults so
+            // the worker threads don't read the widgets.
+            QVector<GrabDetectorBox> detectBoxVec_;
+            int detectMedianFilter_;
+
             void connectWidgets();
             void initialize();
 
             cv::Rect getDetectionBoxCv();
+            QVector<GrabDetectorBox> getDetectionBoxVec();
             QRect getDetectionBox();
             void setDetectionBox(QRect box);
             bool isDetectionBoxLocked();
@@ -112,8 +134,10 @@ namespace bias
 
             void updateTrigStateInfo();
             void refreshPortList();
+            bool setOutputPinOnDev(int pin);
 
             void writeLogData(TriggerData data);
+            void updateDetectSettings();
 
             void updateColorExampleLabel();
 
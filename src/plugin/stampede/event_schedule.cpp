@@ -0,0 +1,136 @@
+#include "event_schedule.hpp"
+#include <algorithm>
+
+namespace bias
+{
+
+    // Public methods
+    // ------------------------------------------------------------------------
+
+    EventSchedule::EventSchedule()
+    {
+        clear();
+    }
+
+
+    void EventSchedule::clear()
+    {
+        startEdgeVec_.clear();
+        stopEdgeVec_.clear();
+        startCursor_ = 0;
+        stopCursor_ = 0;
+        deferredStopVec_.clear();
+        stateVec_.clear();
+        runningSet_.clear();
+    }
+
+
+    void EventSchedule::setEvents(
+            const std::vector<double> &startTimeVec, 
+            const std::vector<double> &stopTimeVec
+            )
+    {
+        clear();
+        size_t numEvents = std::min(startTimeVec.size(), stopTimeVec.size());
+        for (size_t i=0; i<numEvents; i++)
+        {
+            startEdgeVec_.push_back({startTimeVec[i], int(i)});
+            stopEdgeVec_.push_back({stopTimeVec[i], int(i)});
+        }
+        auto edgeLessThan = [](const Edge &edge0, const Edge &edge1)
+        {
+            return (edge0.time < edge1.time) || ((edge0.time == edge1.time) && (edge0.index < edge1.index));
+        };
+        std::sort(startEdgeVec_.begin(), startEdgeVec_.end(), edgeLessThan);
+        std::sort(stopEdgeVec_.begin(), stopEdgeVec_.end(), edgeLessThan);
+        stateVec_.assign(numEvents, WAITING);
+    }
+
+
+    void EventSchedule::advance(
+            double timeStamp, 
+            std::vector<int> &startIndexVec, 
+            std::vector<int> &stopIndexVec
+            )
+    {
+        startIndexVec.clear();
+        stopIndexVec.clear();
+
+        // Stops which passed before their event was running 
+        size_t numDeferred = 0;
+        for (int index : deferredStopVec_)
+        {
+            if (stateVec_[index] == RUNNING)
+            {
+                stateVec_[index] = COMPLETE;
+                runningSet_.erase(index);
+                stopIndexVec.push_back(index);
+            }
+            else
+            {
+                deferredStopVec_[numDeferred] = index;
+                numDeferred++;
+            }
+        }
+        deferredStopVec_.resize(numDeferred);
+
+        // Stops - only events started on an earlier frame 
+        while ((stopCursor_ < stopEdgeVec_.size()) && (stopEdgeVec_[stopCursor_].time < timeStamp))
+        {
+            int index = stopEdgeVec_[stopCursor_].index;
+            if (stateVec_[index] == RUNNING)
+            {
+                stateVec_[index] = COMPLETE;
+                runningSet_.erase(index);
+                stopIndexVec.push_back(index);
+            }
+            else
+            {
+                deferredStopVec_.push_back(index);
+            }
+            stopCursor_++;
+        }
+
+        // Starts
+        while ((startCursor_ < startEdgeVec_.size()) && (startEdgeVec_[startCursor_].time < timeStamp))
+        {
+            int index = startEdgeVec_[startCursor_].index;
+            if (stateVec_[index] == WAITING)
+            {
+                stateVec_[index] = RUNNING;
+                runningSet_.insert(index);
+                startIndexVec.push_back(index);
+            }
+            startCursor_++;
+        }
+    }
+
+
+    size_t EventSchedule::size() const
+    {
+        return stateVec_.size();
+    }
+
+
+    EventSchedule::EventState EventSchedule::state(int index) const
+    {
+        return stateVec_[index];
+    }
+
+
+    size_t EventSchedule::numberRunning() const
+    {
+        return runningSet_.size();
+    }
+
+
+    int EventSchedule::firstRunning() const
+    {
+        if (runningSet_.empty())
+        {
+            return -1;
+        }
+        return *runningSet_.begin();
+    }
+
+}
@@ -0,0 +1,56 @@
+#ifndef EVENT_SCHEDULE_HPP
+#define EVENT_SCHEDULE_HPP
+
+#include <vector>
+#include <set>
+#include <cstddef>
+
+namespace bias
+{
+    class EventSchedule
+    {
+        // Time ordered start/stop edges for a list of events. Each call to 
+        // advance moves cursors through the edges, so the work per frame is 
+        // proportional to the number of events starting or stopping rather 
+        // than to the total number of events.
+        //
+        // Same rules as the original per-frame scan: an event starts on the 
+        // first frame with startTime < timeStamp and stops on the first later
+        // frame with stopTime < timeStamp.
+
+        public:
+
+            enum EventState {WAITING, RUNNING, COMPLETE};
+
+            EventSchedule();
+
+            void clear();
+            void setEvents(const std::vector<double> &startTimeVec, const std::vector<double> &stopTimeVec);
+            void advance(double timeStamp, std::vector<int> &startIndexVec, std::vector<int> &stopIndexVec);
+
+            size_t size() const;
+            EventState state(int index) const;
+            size_t numberRunning() const;
+            int firstRunning() const;  // lowest index of a running event or -1
+
+        protected:
+
+            struct Edge
+            {
+                double time;
+                int index;
+            };
+
+            std::vector<Edge> startEdgeVec_;
+            std::vector<Edge> stopEdgeVec_;
+            size_t startCursor_;
+            size_t stopCursor_;
+            std::vector<int> deferredStopVec_;
+            std::vector<EventState> stateVec_;
+            std::set<int> runningSet_;
+
+    };
+
+}
+
+#endif
@@ -20,6 +20,25 @@ namespace bias
     const double StampedePlugin::VIBRATION_TEST_PERIOD = 0.5;
     const unsigned int StampedePlugin::VIBRATION_TEST_NUMBER = 5;
 
+    // Binary log record fields - in schema order
+    enum 
+    {
+        LOG_FRAME_COUNT,
+        LOG_TIME_STAMP,
+        LOG_VIBRATION_RUNNING,
+        LOG_DISPLAY_RUNNING,
+        LOG_DISPLAY_CONTROL_BIAS,
+    };
+
+    // Published result fields - in setResultFields order
+    enum
+    {
+        RESULT_VIBRATION_RUNNING,
+        RESULT_DISPLAY_RUNNING,
+        RESULT_DISPLAY_CONTROL_BIAS,
+        RESULT_NUMBER_OF_FIELDS,
+    };
+
     // Public Methods
     // ------------------------------------------------------------------------
     StampedePlugin::StampedePlugin(QWidget *parent) : BiasPlugin(parent)
@@ -32,30 +51,19 @@ namespace bias
     void StampedePlugin::reset()
     {
         resetEventStates();
-        if (vibrationDev_.isOpen())
-        {
-            vibrationDev_.stopAll();
-        }
-        if (displayDev_.isOpen())
-        {
-            displayDev_.stop();
-            displayDev_.allOff();
-        }
+        stopAllDevs();
+
+        QStringList resultFields;
+        resultFields << "vibrationRunning" << "displayRunning" << "displayControlBias";
+        setResultFields(resultFields);
+        resultValueVec_.assign(RESULT_NUMBER_OF_FIELDS, 0.0);
 
         openLogFile();
     }
 
     void StampedePlugin::stop()
     {
-        if (vibrationDev_.isOpen())
-        {
-            vibrationDev_.stopAll();
-        }
-        if (displayDev_.isOpen())
-        {
-            displayDev_.stop();
-            displayDev_.allOff();
-        }
+        stopAllDevs();
 
         closeLogFile();
     }
@@ -88,14 +96,6 @@ namespace bias
     }
 
 
-    cv::Mat StampedePlugin::getCurrentImage()
-    {
-        acquireLock();
-        cv::Mat currentImageCopy = currentImage_.clone();
-        releaseLock();
-        return currentImageCopy;
-    }
-
     QString StampedePlugin::getName()
     {
         return PLUGIN_NAME;
@@ -228,7 +228,7 @@ namespace bias
         rtnStatus.success = true;
         rtnStatus.message = QString("");
 
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             return rtnStatus;
         }
@@ -245,21 +245,26 @@ namespace bias
         vibrationDevStatusLabelPtr -> repaint();
 
         QSerialPortInfo  serialInfo(config_.vibrationPortName());
-        vibrationDev_.setPort(serialInfo);
-        vibrationDev_.open();
-
-        if (!vibrationDev_.isOpen())
-        {
-            rtnStatus.success = false;
-            rtnStatus.message = QString("unable to open device %1").arg(config_.vibrationPortName());
-
-        }
-        else
+        bool ok = vibrationDevQueue_.runSync(QString("open"), [this,serialInfo]() 
         {
+            vibrationDev_.setPort(serialInfo);
+            vibrationDev_.open();
+            vibrationDevOpen_ = vibrationDev_.isOpen();
+            if (!vibrationDevOpen_)
+            {
+                return false;
+            }
             for (int i=0; i<vibrationDev_.NUM_CHANNELS; i++)
             {
                 vibrationDev_.setNumPulse(i,0);
             }
+            return true;
+        });
+
+        if (!ok)
+        {
+            rtnStatus.success = false;
+            rtnStatus.message = QString("unable to open device %1").arg(config_.vibrationPortName());
         }
         updateConnectionStatusLabels();
         updateWidgetsEnabled();
@@ -274,16 +279,21 @@ namespace bias
         rtnStatus.success = true;
         rtnStatus.message = QString("");
 
-        if (!vibrationDev_.isOpen())
+        if (!vibrationDevOpen_)
         {
             return rtnStatus;
         }
 
         vibrationDevStatusLabelPtr -> setText(QString("disconnecting ..."));
         vibrationDevStatusLabelPtr -> repaint();
-        vibrationDev_.close();
+        vibrationDevQueue_.runSync(QString("close"), [this]() 
+        {
+            vibrationDev_.close();
+            vibrationDevOpen_ = vibrationDev_.isOpen();
+            return true;
+        });
 
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             rtnStatus.success = false;
             rtnStatus.message = QString("error disconnecting from device");
@@ -302,7 +312,7 @@ namespace bias
         rtnStatus.success = true;
         rtnStatus.message = QString("");
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
             return rtnStatus;
         }
@@ -319,20 +329,27 @@ namespace bias
         displayDevStatusLabelPtr -> repaint();
 
         QSerialPortInfo  serialInfo(config_.displayPortName());
-        displayDev_.setPort(serialInfo);
-        displayDev_.open();
+        uint8_t configId = uint8_t(config_.arenaConfigId());
+        bool ok = displayDevQueue_.runSync(QString("open"), [this,serialInfo,configId]() 
+        {
+            displayDev_.setPort(serialInfo);
+            displayDev_.open();
+            displayDevOpen_ = displayDev_.isOpen();
+            if (!displayDevOpen_)
+            {
+                return false;
+            }
+            displayDev_.stop();
+            displayDev_.allOff();
+            displayDev_.setConfigId(configId);
+            return true;
+        });
 
-        if (!displayDev_.isOpen())
+        if (!ok)
         {
             rtnStatus.success = false;
             rtnStatus.message = QString("unable to open device %1").arg(config_.displayPortName());
         }
-        else
-        {
-            displayDev_.stop();
-            displayDev_.allOff();
-            displayDev_.setConfigId(uint8_t(config_.arenaConfigId()));
-        }
         updateConnectionStatusLabels();
         updateWidgetsEnabled();
         updateConnectPushButtonText();
@@ -346,7 +363,7 @@ namespace bias
         rtnStatus.success = true;
         rtnStatus.message = QString("");
 
-        if (!displayDev_.isOpen())
+        if (!displayDevOpen_)
         {
             return rtnStatus;
         }
@@ -354,11 +371,16 @@ namespace bias
         displayDevStatusLabelPtr -> setText(QString("disconnecting ..."));
         displayDevStatusLabelPtr -> repaint();
 
-        displayDev_.stop();
-        displayDev_.allOff();
-        displayDev_.close();
+        displayDevQueue_.runSync(QString("close"), [this]() 
+        {
+            displayDev_.stop();
+            displayDev_.allOff();
+            displayDev_.close();
+            displayDevOpen_ = displayDev_.isOpen();
+            return true;
+        });
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
             rtnStatus.success = false;
             rtnStatus.message = QString("error disconnecting from device");
@@ -377,7 +399,7 @@ namespace bias
         rtnStatus.success = true;
         rtnStatus.message = QString("");
 
-        if (!vibrationDev_.isOpen())
+        if (!vibrationDevOpen_)
         {
             RtnStatus rtnConnectVibDev = connectVibrationDev();
             if (!rtnConnectVibDev.success)
@@ -386,7 +408,7 @@ namespace bias
                 rtnStatus.appendMessage(rtnConnectVibDev.message);
             }
         }
-        if (!displayDev_.isOpen())
+        if (!displayDevOpen_)
         {
             RtnStatus rtnConnectDspDev = connectDisplayDev();
             if (!rtnConnectDspDev.success)
@@ -405,7 +427,7 @@ namespace bias
         rtnStatus.success = true;
         rtnStatus.message = QString("");
 
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             RtnStatus rtnDisconnectVibDev = disconnectVibrationDev();
             if (!rtnDisconnectVibDev.success)
@@ -415,7 +437,7 @@ namespace bias
             }
         }
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
             RtnStatus rtnDisconnectDspDev = disconnectDisplayDev();
             if (!rtnDisconnectDspDev.success)
@@ -430,7 +452,13 @@ namespace bias
 
     QString StampedePlugin::getLogFileExtension()
     {
-        return LOG_FILE_EXTENSION;
+        return isBinaryLogEnabled() ? PluginLogWriter::FILE_EXTENSION : LOG_FILE_EXTENSION;
+    }
+
+
+    bool StampedePlugin::isBinaryLogEnabled()
+    {
+        return config_.binaryLog();
     }
 
 
@@ -444,6 +472,9 @@ namespace bias
     // ------------------------------------------------------------------------
     void StampedePlugin::initialize()
     {
+        // All device I/O runs on the queue threads from here on
+        vibrationDevQueue_.attach(&vibrationDev_);
+        displayDevQueue_.attach(&displayDev_);
 
         QFont monoSpaceFont("Monospace");
         monoSpaceFont.setStyleHint(QFont::TypeWriter);
@@ -458,6 +489,17 @@ namespace bias
         configFileNameLabelPtr -> setText(QString("Default Configuration"));
 
         setRequireTimer(true);
+        setSubscriptionMode(PLUGIN_SUBSCRIBE_LATEST_FRAME);
+
+        PluginLogSchema logSchema;
+        logSchema.addField(QString("frameCount"), PLUGIN_LOG_UINT64);
+        logSchema.addField(QString("timeStamp"), PLUGIN_LOG_FLOAT64);
+        logSchema.addField(QString("vibrationRunning"), PLUGIN_LOG_UINT8);
+        logSchema.addField(QString("displayRunning"), PLUGIN_LOG_UINT8);
+        logSchema.addField(QString("displayControlBias"), PLUGIN_LOG_INT32);
+        setLogSchema(logSchema);
+        logRecord_ = PluginLogRecord(logSchema);
+
         acquireLock();
         config_.setToDefaultConfig();
         releaseLock();
@@ -543,31 +585,71 @@ namespace bias
         qRegisterMetaType<VibrationEvent>("VibrationEvent");
         qRegisterMetaType<DisplayEvent>("DisplayEvent");
 
+        // Event slots run directly on the processing thread and only queue
+        // device commands, so stimulus timing doesn't wait on the gui thread.
         connect(
                 this, 
                 SIGNAL(startVibrationEvent(int,VibrationEvent)), 
                 this, 
-                SLOT(onStartVibrationEvent(int,VibrationEvent))
+                SLOT(onStartVibrationEvent(int,VibrationEvent)),
+                Qt::DirectConnection
                 );
 
         connect(
                 this, 
                 SIGNAL(stopVibrationEvent(int,VibrationEvent)),  
-                this, SLOT(onStopVibrationEvent(int,VibrationEvent))
+                this, 
+                SLOT(onStopVibrationEvent(int,VibrationEvent)),
+                Qt::DirectConnection
                 );
 
         connect(
                 this, 
                 SIGNAL(startDisplayEvent(int,DisplayEvent)),   
                 this, 
-                SLOT(onStartDisplayEvent(int,DisplayEvent))
+                SLOT(onStartDisplayEvent(int,DisplayEvent)),
+                Qt::DirectConnection
                 ); 
 
         connect(
                 this, 
                 SIGNAL(stopDisplayEvent(int,DisplayEvent)),   
                 this, 
-                SLOT(onStopDisplayEvent(int,DisplayEvent))
+                SLOT(onStopDisplayEvent(int,DisplayEvent)),
+                Qt::DirectConnection
+                );
+    }
+
+
+    void StampedePlugin::stopAllDevs()
+    {
+        if (vibrationDevOpen_)
+        {
+            vibrationDevQueue_.submit(QString("stopVibration"), [this]() 
+            { 
+                return vibrationDev_.stopAll(); 
+            });
+        }
+        if (displayDevOpen_)
+        {
+            displayDevQueue_.submit(QString("stopDisplay"), [this]() 
+            {
+                bool ok = displayDev_.stop();
+                ok = ok && displayDev_.allOff();
+                return ok;
+            });
+        }
+    }
+
+
+    void StampedePlugin::setDisplayDevConfigId()
+    {
+        // Coalesced - only the latest pending config id is sent
+        uint8_t configId = uint8_t(config_.arenaConfigId());
+        displayDevQueue_.submit(
+                QString("setConfigId"), 
+                [this,configId]() { return displayDev_.setConfigId(configId); },
+                true
                 );
     }
 
@@ -594,13 +676,13 @@ namespace bias
 
     void StampedePlugin::updateWidgetsEnabled()
     {
-        vibrationDevTestPushButtonPtr -> setEnabled(vibrationDev_.isOpen());
-        displayDevBlinkPushButtonPtr -> setEnabled(displayDev_.isOpen());
+        vibrationDevTestPushButtonPtr -> setEnabled(vibrationDevOpen_);
+        displayDevBlinkPushButtonPtr -> setEnabled(displayDevOpen_);
     }
 
     void StampedePlugin::updateConnectionStatusLabels()
     {
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             vibrationDevStatusLabelPtr -> setText("connected");
         }
@@ -609,7 +691,7 @@ namespace bias
             vibrationDevStatusLabelPtr -> setText("not connected");
         }
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
             displayDevStatusLabelPtr -> setText("connected");
         }
@@ -621,7 +703,7 @@ namespace bias
 
     void StampedePlugin::updateConnectPushButtonText()
     {
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             vibrationDevConnectPushButtonPtr -> setText("Disconnect");
         }
@@ -630,7 +712,7 @@ namespace bias
             vibrationDevConnectPushButtonPtr -> setText("Connect");
         }
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
             displayDevConnectPushButtonPtr -> setText("Disconnect");
         }
@@ -639,7 +721,7 @@ namespace bias
             displayDevConnectPushButtonPtr -> setText("Connect");
         }
 
-        if (vibrationDev_.isOpen() && displayDev_.isOpen())
+        if (vibrationDevOpen_ && displayDevOpen_)
         {
             devConnectAllPushButtonPtr -> setText("Disconnect All");
         }
@@ -675,17 +757,25 @@ namespace bias
     void StampedePlugin::resetEventStates()
     {
         acquireLock();
-        vibrationEventStateList_.clear();
-        for (auto event : config_.vibrationEventList())
+        vibrationEventList_ = config_.vibrationEventList();
+        std::vector<double> startTimeVec;
+        std::vector<double> stopTimeVec;
+        for (auto event : vibrationEventList_)
         {
-            vibrationEventStateList_.append(WAITING);
+            startTimeVec.push_back(event.startTime());
+            stopTimeVec.push_back(event.stopTime());
         }
+        vibrationSchedule_.setEvents(startTimeVec, stopTimeVec);
 
-        displayEventStateList_.clear();
-        for (auto event : config_.displayEventList())
+        displayEventList_ = config_.displayEventList();
+        startTimeVec.clear();
+        stopTimeVec.clear();
+        for (auto event : displayEventList_)
         {
-            displayEventStateList_.append(WAITING);
+            startTimeVec.push_back(event.startTime());
+            stopTimeVec.push_back(event.stopTime());
         } 
+        displaySchedule_.setEvents(startTimeVec, stopTimeVec);
         releaseLock();
     }
 
@@ -695,10 +785,7 @@ namespace bias
         // -----------------------------------------------
         // Note: called by separate thread (from main gui)
         // -----------------------------------------------
-        if (loggingEnabled_)
-        {
-            writeLogData();
-        }
+        writeEventStates();
 
         processVibrationEvents();
         processDisplayEvents();
@@ -713,35 +800,15 @@ namespace bias
         // -----------------------------------------------
 
         acquireLock();
-        QList<VibrationEvent> vibrationEventList= config_.vibrationEventList();
-        for (auto i=0; i<vibrationEventList.size(); i++) 
+        vibrationSchedule_.advance(timeStamp_, startIndexVec_, stopIndexVec_);
+        for (int i : stopIndexVec_)
         {
-            VibrationEvent event = vibrationEventList[i];
-            double startTime = event.startTime();
-            double stopTime = event.stopTime();
-
-            if  (startTime < timeStamp_) 
-            {
-                switch (vibrationEventStateList_[i])
-                {
-                    case WAITING:
-                        vibrationEventStateList_[i] = RUNNING;
-                        emit startVibrationEvent(i,event);
-                        break;
-
-                    case RUNNING:
-                        if (stopTime < timeStamp_)
-                        {
-                            vibrationEventStateList_[i] = COMPLETE;
-                            emit stopVibrationEvent(i,event);
-                        }
-                        break;
-
-                    default:
-                        break;
-                }
-            }
-        } // for (auto i=0 ...
+            emit stopVibrationEvent(i,vibrationEventList_[i]);
+        }
+        for (int i : startIndexVec_)
+        {
+            emit startVibrationEvent(i,vibrationEventList_[i]);
+        }
         releaseLock();
     }
 
@@ -752,76 +819,62 @@ namespace bias
         // -----------------------------------------------
 
         acquireLock();
-        QList<DisplayEvent> displayEventList = config_.displayEventList();
-        for (auto i=0; i<displayEventList.size(); i++)
+        displaySchedule_.advance(timeStamp_, startIndexVec_, stopIndexVec_);
+        for (int i : stopIndexVec_)
         {
-            DisplayEvent event = displayEventList[i];
-            double startTime = event.startTime();
-            double stopTime = event.stopTime();
-
-            if  (startTime < timeStamp_) 
-            {
-                switch (displayEventStateList_[i])
-                {
-                    case WAITING:
-                        displayEventStateList_[i] = RUNNING;
-                        emit startDisplayEvent(i,event);
-                        break;
-
-                    case RUNNING:
-                        if (stopTime < timeStamp_)
-                        {
-                            displayEventStateList_[i] = COMPLETE;
-                            emit stopDisplayEvent(i,event);
-                        }
-                        break;
-
-                    default: 
-                        break;
-                }
-            }
-        } // for (auto i=0 ...
+            emit stopDisplayEvent(i,displayEventList_[i]);
+        }
+        for (int i : startIndexVec_)
+        {
+            emit startDisplayEvent(i,displayEventList_[i]);
+        }
         releaseLock();
     }
 
 
-    void StampedePlugin::writeLogData()
+    void StampedePlugin::writeEventStates()
     {
         // -----------------------------------------------
         // Note: called by separate thread (from main gui)
         // -----------------------------------------------
 
+        // Only gather values under the lock - they are copied to the log 
+        // writer's buffer and the result ring after release.
         acquireLock();
-        logStream_ << frameCount_ << " " << timeStamp_; 
-
-        bool vibrationRunning = false;
-        for (auto state : vibrationEventStateList_)
-        {
-            if (state == RUNNING)
-            {
-                vibrationRunning = true;
-                break;
-            }
-        }
-        logStream_ << " " << vibrationRunning;
-
+        unsigned long frameCount = frameCount_;
+        double timeStamp = timeStamp_;
+        bool vibrationRunning = (vibrationSchedule_.numberRunning() > 0);
 
-        QList<DisplayEvent> displayEventList = config_.displayEventList();
+        // Lowest index running display event sets the control bias
         bool displayRunning = false;
         int displayControlBias = 0;
-        for (int i=0; i<displayEventList.size(); i++)
+        int displayIndex = displaySchedule_.firstRunning();
+        if (displayIndex >= 0)
         {
-            DisplayEvent event = displayEventList[i];
-            EventState displayState = displayEventStateList_[i];
-            if (displayState == RUNNING)
-            {
-                displayRunning = true;
-                displayControlBias = event.controlBias();
-                break;
-            }
+            displayRunning = true;
+            displayControlBias = displayEventList_[displayIndex].controlBias();
         }
-        logStream_ << " " << displayRunning << " " << displayControlBias << '\n';
         releaseLock();
+
+        if (loggingEnabled_ && !logWriter_.isOpen())
+        {
+            logStream_ << frameCount << " " << timeStamp << " " << vibrationRunning;
+            logStream_ << " " << displayRunning << " " << displayControlBias << '\n';
+        }
+        else if (loggingEnabled_)
+        {
+            logRecord_.set(LOG_FRAME_COUNT, frameCount);
+            logRecord_.set(LOG_TIME_STAMP, timeStamp);
+            logRecord_.set(LOG_VIBRATION_RUNNING, vibrationRunning);
+            logRecord_.set(LOG_DISPLAY_RUNNING, displayRunning);
+            logRecord_.set(LOG_DISPLAY_CONTROL_BIAS, displayControlBias);
+            logWriter_.write(logRecord_);
+        }
+
+        resultValueVec_[RESULT_VIBRATION_RUNNING] = vibrationRunning ? 1.0 : 0.0;
+        resultValueVec_[RESULT_DISPLAY_RUNNING] = displayRunning ? 1.0 : 0.0;
+        resultValueVec_[RESULT_DISPLAY_CONTROL_BIAS] = double(displayControlBias);
+        publishResult(frameCount, timeStamp, resultValueVec_);
     }
 
     // Private slots
@@ -830,7 +883,7 @@ namespace bias
     void StampedePlugin::onVibrationDevConnectClicked()
     {
         RtnStatus rtnStatus;
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             rtnStatus = disconnectVibrationDev();
         }
@@ -849,14 +902,18 @@ namespace bias
 
     void StampedePlugin::onVibrationDevTestClicked() 
     {
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             for (auto pin : vibrationPinList_)
             {
                 int periodMS = int(1000*VIBRATION_TEST_PERIOD);
-                vibrationDev_.setPeriod(pin,periodMS);
-                vibrationDev_.setNumPulse(pin,VIBRATION_TEST_NUMBER);
-                vibrationDev_.startAll();
+                vibrationDevQueue_.submit(QString("testPulse"), [this,pin,periodMS]()
+                {
+                    bool ok = vibrationDev_.setPeriod(pin,periodMS);
+                    ok = ok && vibrationDev_.setNumPulse(pin,VIBRATION_TEST_NUMBER);
+                    ok = ok && vibrationDev_.startAll();
+                    return ok;
+                });
             }
         }
     }
@@ -865,7 +922,7 @@ namespace bias
     {
         RtnStatus rtnStatus;
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
             rtnStatus = disconnectDisplayDev();
         }
@@ -884,16 +941,19 @@ namespace bias
 
     void StampedePlugin::onDisplayDevBlinkClicked()
     {
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
-            displayDev_.blinkLED();
+            displayDevQueue_.submit(QString("blinkLED"), [this]() 
+            { 
+                return displayDev_.blinkLED(); 
+            });
         }
     }
 
     void StampedePlugin::onDevConnectAllClicked()
     {
         RtnStatus rtnStatus;
-        if ( vibrationDev_.isOpen() && displayDev_.isOpen())
+        if ( vibrationDevOpen_ && displayDevOpen_)
         {
             rtnStatus = disconnectAll();
         }
@@ -917,9 +977,9 @@ namespace bias
         if (!configFileString.isEmpty())
         {
             loadConfigFromFile(configFileString);
-            if (displayDev_.isOpen())
+            if (displayDevOpen_)
             {
-                displayDev_.setConfigId(config_.arenaConfigId());
+                setDisplayDevConfigId();
             }
         }
     }
@@ -928,9 +988,9 @@ namespace bias
     {
         QString configFileFullPath = getConfigFileFullPath();
         loadConfigFromFile(configFileFullPath);
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
-            displayDev_.setConfigId(config_.arenaConfigId());
+            setDisplayDevConfigId();
         }
     }
 
@@ -947,9 +1007,9 @@ namespace bias
         if (!configFileString.isEmpty())
         {
             saveConfigToFile(configFileString);
-            if (displayDev_.isOpen())
+            if (displayDevOpen_)
             {
-                displayDev_.setConfigId(config_.arenaConfigId());
+                setDisplayDevConfigId();
             }
         }
 
@@ -978,14 +1038,19 @@ namespace bias
         qDebug() << "  period        " << event.period();
         qDebug() << "  number        " << event.number();
 
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
             for (auto pin : vibrationPinList_)
             {
                 int periodMS = int(1000*event.period());
-                vibrationDev_.setPeriod(pin,periodMS);
-                vibrationDev_.setNumPulse(pin,event.number());
-                vibrationDev_.startAll();
+                int number = event.number();
+                vibrationDevQueue_.submit(QString("startVibration"), [this,pin,periodMS,number]()
+                {
+                    bool ok = vibrationDev_.setPeriod(pin,periodMS);
+                    ok = ok && vibrationDev_.setNumPulse(pin,number);
+                    ok = ok && vibrationDev_.startAll();
+                    return ok;
+                });
             }
         }
         else
@@ -1002,9 +1067,12 @@ namespace bias
         qDebug() << "stop vibration";
         qDebug() << "  index         " << index;
 
-        if (vibrationDev_.isOpen())
+        if (vibrationDevOpen_)
         {
-            vibrationDev_.stopAll();
+            vibrationDevQueue_.submit(QString("stopVibration"), [this]() 
+            { 
+                return vibrationDev_.stopAll(); 
+            });
         }
         else
         {
@@ -1023,11 +1091,17 @@ namespace bias
         qDebug() << "  stopTime      " << event.stopTime();
         qDebug() << "  controalBias  " << event.controlBias();
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
-            displayDev_.setPatternId(uint8_t(event.patternId()));
-            displayDev_.setGainAndBias(0,int8_t(event.controlBias()),0,0);
-            displayDev_.start();
+            uint8_t patternId = uint8_t(event.patternId());
+            int8_t controlBias = int8_t(event.controlBias());
+            displayDevQueue_.submit(QString("startDisplay"), [this,patternId,controlBias]()
+            {
+                bool ok = displayDev_.setPatternId(patternId);
+                ok = ok && displayDev_.setGainAndBias(0,controlBias,0,0);
+                ok = ok && displayDev_.start();
+                return ok;
+            });
         }
         else
         {
@@ -1042,10 +1116,14 @@ namespace bias
         qDebug() << "stop display";
         qDebug() << "  index         " << index;
 
-        if (displayDev_.isOpen())
+        if (displayDevOpen_)
         {
-            displayDev_.stop();
-            displayDev_.allOff();
+            displayDevQueue_.submit(QString("stopDisplay"), [this]() 
+            {
+                bool ok = displayDev_.stop();
+                ok = ok && displayDev_.allOff();
+                return ok;
+            });
         }
         else
         {
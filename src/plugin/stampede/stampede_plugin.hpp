@@ -5,7 +5,11 @@
 #include "stampede_plugin_config.hpp"
 #include "panels_controller.hpp"
 #include "nano_ssr_pulse.hpp"
+#include "serial_cmd_queue.hpp"
+#include "event_schedule.hpp"
 #include "rtn_status.hpp"
+#include <vector>
+#include <atomic>
 
 namespace cv
 { 
@@ -19,8 +23,6 @@ namespace bias
     {
         Q_OBJECT
 
-        enum EventState {WAITING, RUNNING, COMPLETE};
-
         public:
 
             static const QString PLUGIN_NAME;
@@ -39,13 +41,13 @@ namespace bias
             virtual void stop();
             virtual void setActive(bool value);
             virtual void processFrames(QList<StampedImage> frameList);
-            virtual cv::Mat getCurrentImage();
             virtual QString getName();
             virtual QString getDisplayName();
             virtual QVariantMap getConfigAsMap();  
             virtual RtnStatus runCmdFromMap(QVariantMap cmdMap,bool showErrorDlg=true);
             virtual QString getLogFileExtension();
             virtual QString getLogFilePostfix();
+            virtual bool isBinaryLogEnabled();
 
             RtnStatus loadConfigFromFile(QString fileName, bool showErrorDlg=true);
             RtnStatus saveConfigToFile(QString fileName, bool showErrorDlg=true);
@@ -76,10 +78,28 @@ namespace bias
             PanelsController displayDev_;
             NanoSSRPulse vibrationDev_;
 
-            QList<EventState> vibrationEventStateList_;
-            QList<EventState> displayEventStateList_;
+            // Declared after the devices so they are destroyed first
+            SerialCmdQueue displayDevQueue_;
+            SerialCmdQueue vibrationDevQueue_;
+
+            // Device open state - set by the open/close commands on the queue
+            // threads, the devices themselves are only touched there
+            std::atomic<bool> displayDevOpen_{false};
+            std::atomic<bool> vibrationDevOpen_{false};
+
+            // Snapshot of the configured events taken by resetEventStates 
+            // and their precomputed schedules - use lock 
+            QList<VibrationEvent> vibrationEventList_;
+            QList<DisplayEvent> displayEventList_;
+            EventSchedule vibrationSchedule_;
+            EventSchedule displaySchedule_;
+            std::vector<int> startIndexVec_;
+            std::vector<int> stopIndexVec_;
             QList<int> vibrationPinList_;
 
+            PluginLogRecord logRecord_;  // processing thread only
+            std::vector<double> resultValueVec_;  // processing thread only
+
             //QDir logFileDir_;
             //bool loggingEnabled_;
             //QFile logFile_;
@@ -87,6 +107,8 @@ namespace bias
 
             void initialize();
             void connectWidgets();
+            void stopAllDevs();
+            void setDisplayDevConfigId();
             void updateWidgetsEnabled();
             void updateConnectionStatusLabels();
             void updateConnectPushButtonText();
@@ -102,7 +124,7 @@ namespace bias
             void processDisplayEvents();
             void processVibrationEvents();
 
-            void writeLogData();
+            void writeEventStates();
 
             //QString getLogFileName(bool includeAutoNaming);
             //QString getLogFileFullPath(bool includeAutoNaming);
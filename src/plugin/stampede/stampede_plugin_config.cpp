@@ -187,6 +187,18 @@ namespace bias
     }
 
 
+    bool StampedePluginConfig::binaryLog()
+    {
+        return binaryLog_;
+    }
+
+
+    void StampedePluginConfig::setBinaryLog(bool value)
+    {
+        binaryLog_ = value;
+    }
+
+
     QString StampedePluginConfig::toString() 
     {
         QString configStr;
@@ -194,6 +206,7 @@ namespace bias
         configStr.append(QString("vibration port:   %1\n").arg(vibrationPortName_));
         configStr.append(QString("display   port:   %1\n").arg(displayPortName_));
         configStr.append(QString("arena config id:  %1\n").arg(arenaConfigId_));
+        configStr.append(QString("binary log:       %1\n").arg(binaryLog_));
         configStr.append(QString("\n"));
 
         for (auto i=0; i<vibrationEventList_.size(); i++)
@@ -240,6 +253,7 @@ namespace bias
         configMap.insert("duration", (long long)(duration_));
         configMap.insert("vibration", vibrationMap);
         configMap.insert("display", displayMap);
+        configMap.insert("binaryLog", binaryLog_);
         return configMap;
     }
 
@@ -326,6 +340,22 @@ namespace bias
             rtnStatus.appendMessage("display field missing");
         }
 
+        // Get binary log flag - optional, text log when missing
+        // --------------------------------------------------------------------
+        setBinaryLog(false);
+        if (configMap.contains("binaryLog"))
+        {
+            if (configMap["binaryLog"].canConvert<bool>())
+            {
+                setBinaryLog(configMap["binaryLog"].toBool());
+            }
+            else
+            {
+                rtnStatus.success = false;
+                rtnStatus.appendMessage(QString("unable to convert binaryLog to bool"));
+            }
+        }
+
         // Check for overlapping events
         RtnStatus rtnCheckEvents = checkEvents();
         if (!rtnCheckEvents.success)
@@ -663,6 +693,7 @@ namespace bias
         setVibrationPortName("ttyUSB0");
         setDisplayPortName("ttyUSB1");
         setArenaConfigId(1);
+        setBinaryLog(false);
 
         // Add Vibration events
         clearVibrationEventList();
@@ -39,6 +39,9 @@ namespace bias
             unsigned int arenaConfigId();
             RtnStatus setArenaConfigId(unsigned int id);
 
+            bool binaryLog();
+            void setBinaryLog(bool value);
+
             QString toString();
             QVariantMap toMap();
             QByteArray toJson();
@@ -59,6 +62,7 @@ namespace bias
 
             unsigned long duration_ = 0; 
             unsigned int arenaConfigId_ = 1; 
+            bool binaryLog_ = false;
             QString vibrationPortName_;
             QString displayPortName_;
             QList<VibrationEvent> vibrationEventList_;
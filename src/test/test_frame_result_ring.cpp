@@ -0,0 +1,118 @@
+#include <iostream>
+#include <vector>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include "frame_result_ring.hpp"
+
+// Checks FrameResultRing::getSince sequence number arithmetic - wraparound,
+// drop counting, maxResults and readers ahead of the ring. Returns nonzero
+// on failure.
+
+using namespace bias;
+
+static int numFailed = 0;
+
+static void check(bool value, const char *what)
+{
+    if (!value)
+    {
+        std::cout << "FAILED: " << what << std::endl;
+        numFailed++;
+    }
+}
+
+static void appendResults(FrameResultRing &ring, unsigned long long beg, unsigned long long end)
+{
+    for (unsigned long long i=beg; i<end; i++)
+    {
+        std::vector<double> valueVec = {double(i), 2.0*double(i)};
+        ring.append(100 + i, 0.1*double(i), valueVec);
+    }
+}
+
+static bool checkSeq(QVariantList &resultList, unsigned long long firstSeq)
+{
+    for (int n=0; n<resultList.size(); n++)
+    {
+        QVariantMap resultMap = resultList[n].toMap();
+        unsigned long long seq = resultMap["seq"].toULongLong();
+        if (seq != firstSeq + n) 
+        {
+            return false;
+        }
+        if (resultMap["frameCount"].toULongLong() != 100 + seq)
+        {
+            return false;
+        }
+        if (resultMap["data"].toMap()["b"].toDouble() != 2.0*double(seq))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+    const unsigned int capacity = 8;
+    FrameResultRing ring(capacity);
+    QStringList fieldNames;
+    fieldNames << "a" << "b";
+    ring.setFieldNames(fieldNames);
+
+    QVariantList resultList;
+    unsigned long long numDropped = 0;
+    unsigned long long nextSeq = 0;
+
+    // Partly filled 
+    appendResults(ring, 0, 5);
+    nextSeq = ring.getSince(0, 100, resultList, numDropped);
+    check(nextSeq == 5, "partial: next sequence number");
+    check(resultList.size() == 5, "partial: number of results");
+    check(numDropped == 0, "partial: nothing dropped");
+    check(checkSeq(resultList, 0), "partial: results in order");
+
+    // Wrapped - the slot after the newest result isn't readable, so the 
+    // oldest readable result is 20 - capacity + 1
+    appendResults(ring, 5, 20);
+    nextSeq = ring.getSince(nextSeq, 100, resultList, numDropped);
+    check(nextSeq == 20, "wrapped: next sequence number");
+    check(numDropped == 8, "wrapped: overwritten results counted as dropped");
+    check(resultList.size() == int(capacity) - 1, "wrapped: number of results");
+    check(checkSeq(resultList, 13), "wrapped: results in order");
+
+    // Up to date reader gets nothing
+    nextSeq = ring.getSince(nextSeq, 100, resultList, numDropped);
+    check(nextSeq == 20, "current: next sequence number");
+    check(resultList.isEmpty() && (numDropped == 0), "current: no results");
+
+    // maxResults 
+    nextSeq = ring.getSince(13, 3, resultList, numDropped);
+    check(nextSeq == 16, "maxResults: next sequence number");
+    check(resultList.size() == 3, "maxResults: number of results");
+    check(checkSeq(resultList, 13), "maxResults: results in order");
+
+    // Reader ahead of the ring (writer restarted) starts from the oldest
+    nextSeq = ring.getSince(1000, 100, resultList, numDropped);
+    check(nextSeq == 20, "ahead: next sequence number");
+    check(numDropped == 0, "ahead: nothing dropped");
+    check(checkSeq(resultList, 13) && (resultList.size() == 7), "ahead: from the oldest result");
+
+    // Clear starts a new generation
+    unsigned int generation = ring.generation();
+    ring.clear();
+    check(ring.generation() == generation + 1, "clear: generation incremented");
+    check(ring.numberWritten() == 0, "clear: no results written");
+    nextSeq = ring.getSince(0, 100, resultList, numDropped);
+    check((nextSeq == 0) && resultList.isEmpty(), "clear: no results");
+
+    if (numFailed > 0)
+    {
+        std::cout << numFailed << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -45,6 +45,8 @@ namespace bias
     }
     QMap<QString,QString> ESCAPE_TO_CHAR_MAP = createEscapeToCharMap();
 
+    const char *BasicHttpServer::STREAM_PROPERTY = "biasHttpStream";
+
 
     // Methods - public
     // -------------------------------------------------------------------------
@@ -64,7 +66,7 @@ namespace bias
 
     // Protected methods
     // ------------------------------------------------------------------------
-    void BasicHttpServer::handleGetRequest(QTcpSocket *socketPtr, QStringList &tokens)
+    bool BasicHttpServer::handleGetRequest(QTcpSocket *socketPtr, QStringList &tokens)
     { 
         QTextStream os(socketPtr);
         os.setAutoDetectUnicode(true);
@@ -73,7 +75,7 @@ namespace bias
         if (tokens.size() < 2)
         {
             sendBadRequestResp(os,"not enought tokens");
-            return;
+            return false;
         }
 
         // Parse tokens
@@ -83,7 +85,7 @@ namespace bias
         if (paramsString.length() == 1)
         {
             sendRunningResp(os);
-            return;
+            return false;
         }
         else if (paramsString.length() > 1)
         {
@@ -92,24 +94,35 @@ namespace bias
             if (secondChar != QChar('?'))
             {
                 sendBadRequestResp(os, "no ? character preceeding parameters");
-                return;
+                return false;
             }
 
             paramsString.remove(0,2);
             QStringList paramsList = paramsString.split("&",QString::SkipEmptyParts);
+            if (paramsList.size() == 1)
+            {
+                QStringList parts = paramsList[0].split("=",QString::SkipEmptyParts);
+                if ((parts.size() > 0) && (parts.size() <= 2) && isStreamRequest(parts[0]))
+                {
+                    QString value = (parts.size() == 2) ? parts[1] : QString("");
+                    return handleStreamRequest(socketPtr, parts[0], value);
+                }
+            }
+
             if (!paramsList.isEmpty())
             {
                 // We have some parameters - send appropriate response
                 handleParamsRequest(os, paramsList);
-                return;
+                return false;
             }
             else
             {
                 // No parameters follow '?' character
                 sendBadRequestResp(os,"not parameters following ? char");
-                return;
+                return false;
             }
         }
+        return false;
     }
     
 
@@ -200,22 +213,98 @@ namespace bias
     }
 
 
+    bool BasicHttpServer::isStreamRequest(QString name)
+    {
+        return false;
+    }
+
+
+    bool BasicHttpServer::handleStreamRequest(QTcpSocket *socketPtr, QString name, QString value)
+    {
+        QTextStream os(socketPtr);
+        sendBadRequestResp(os, "streaming not supported");
+        return false;
+    }
+
+
+    void BasicHttpServer::writeStreamHeader(QTcpSocket *socketPtr)
+    {
+        // Chunked so the client can parse each line as it arrives, no delay
+        // so small chunks aren't held back waiting for more data.
+        socketPtr -> setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        socketPtr -> setProperty(STREAM_PROPERTY, true);
+        QByteArray header;
+        header.append("HTTP/1.1 200 Ok\r\n");
+        header.append("Content-Type: application/x-ndjson; charset=\"utf-8\"\r\n");
+        header.append("Cache-Control: no-cache\r\n");
+        header.append("Transfer-Encoding: chunked\r\n\r\n");
+        socketPtr -> write(header);
+        socketPtr -> flush();
+    }
+
+
+    bool BasicHttpServer::writeStreamChunk(QTcpSocket *socketPtr, QByteArray data)
+    {
+        if (data.isEmpty() || (socketPtr -> state() != QAbstractSocket::ConnectedState))
+        {
+            return false;
+        }
+        QByteArray chunk = QByteArray::number(data.size(), 16);
+        chunk.append("\r\n");
+        chunk.append(data);
+        chunk.append("\r\n");
+        socketPtr -> write(chunk);
+        socketPtr -> flush();
+        return true;
+    }
+
+
+    void BasicHttpServer::endStream(QTcpSocket *socketPtr)
+    {
+        if (socketPtr -> state() == QAbstractSocket::ConnectedState)
+        {
+            socketPtr -> write("0\r\n\r\n");
+        }
+        socketPtr -> setProperty(STREAM_PROPERTY, false);
+        socketPtr -> close();
+    }
+
+
+    bool BasicHttpServer::isStreaming(QTcpSocket *socketPtr)
+    {
+        return socketPtr -> property(STREAM_PROPERTY).toBool();
+    }
+
+
     // Protected slots
     // ------------------------------------------------------------------------
     void BasicHttpServer::readClient()
     {
         QTcpSocket* socketPtr = (QTcpSocket*) sender();
+        if (isStreaming(socketPtr))
+        {
+            // Nothing more is expected from a streaming client
+            socketPtr -> readAll();
+            return;
+        }
         if (socketPtr->canReadLine()) 
         {
             QString requestString = QString(socketPtr->readLine());
             QStringList tokens = splitRequestString(requestString);
+            bool keepOpen = false;
             if (!tokens.isEmpty()) 
             {
                 if (tokens[0] == "GET") 
                 {
-                    handleGetRequest(socketPtr, tokens);
+                    keepOpen = handleGetRequest(socketPtr, tokens);
                 } 
             }
+            if (keepOpen)
+            {
+                // Rest of the request headers
+                socketPtr -> readAll();
+                return;
+            }
             socketPtr -> close();
             if (socketPtr -> state() == QTcpSocket::UnconnectedState)
             {
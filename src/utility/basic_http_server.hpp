@@ -8,7 +8,7 @@
 #include <QTextStream>
 #include <QVariantMap>
 
-class QTcpSockect;
+class QTcpSocket;
 
 namespace bias
 {
@@ -20,16 +20,31 @@ namespace bias
         Q_OBJECT
 
         public:
+            static const char *STREAM_PROPERTY;
+
             BasicHttpServer(QObject *parent=0);
             virtual void incomingConnection(qintptr socket);
 
         protected:
-            virtual void handleGetRequest(QTcpSocket *socket, QStringList &tokens);
+            // Returns true when the socket has been kept open for streaming
+            virtual bool handleGetRequest(QTcpSocket *socket, QStringList &tokens);
             virtual void handleParamsRequest(QTextStream &os, QStringList &paramsList);
             virtual void sendBadRequestResp(QTextStream &os, QString msg);
             virtual void sendRunningResp(QTextStream &os);
             virtual QVariantMap paramsRequestSwitchYard(QString name, QString value);
 
+            // Streaming responses - a request with a single parameter for 
+            // which isStreamRequest is true is passed to handleStreamRequest
+            // instead of the switch yard. If that returns true the socket 
+            // stays open and the subclass sends chunks (one json object per 
+            // line) with writeStreamChunk until the client disconnects. 
+            virtual bool isStreamRequest(QString name);
+            virtual bool handleStreamRequest(QTcpSocket *socket, QString name, QString value);
+            void writeStreamHeader(QTcpSocket *socket);
+            bool writeStreamChunk(QTcpSocket *socket, QByteArray data);
+            void endStream(QTcpSocket *socket);
+            bool isStreaming(QTcpSocket *socket);
+
         protected slots:
             virtual void readClient();
             virtual void discardClient();
@@ -101,4 +101,45 @@ namespace bias
         return imgModified;
     }
 
+
+    cv::Mat demosaicBayer(cv::Mat img, BayerPattern pattern)
+    {
+        // Converts a raw (single channel, 8 or 16 bit) Bayer image to BGR.
+        // Images which aren't raw, or have no pattern, are returned as is. 
+        //
+        // Note, opencv names its Bayer codes after the 2x2 block starting at
+        // the second row and column - so e.g. an RGGB sensor is BayerBG.
+        if ((img.channels() != 1) || (pattern == BAYER_PATTERN_NONE))
+        {
+            return img;
+        }
+
+        int code;
+        switch (pattern)
+        {
+            case BAYER_PATTERN_RGGB:
+                code = cv::COLOR_BayerBG2BGR;
+                break;
+
+            case BAYER_PATTERN_GRBG:
+                code = cv::COLOR_BayerGB2BGR;
+                break;
+
+            case BAYER_PATTERN_GBRG:
+                code = cv::COLOR_BayerGR2BGR;
+                break;
+
+            case BAYER_PATTERN_BGGR:
+                code = cv::COLOR_BayerRG2BGR;
+                break;
+
+            default:
+                return img;
+        }
+
+        cv::Mat imgColor;
+        cv::cvtColor(img, imgColor, code);
+        return imgColor;
+    }
+
 } // namespace bias
@@ -1,12 +1,14 @@
 #ifndef BASIC_IMAGE_PROC_HPP
 #define BASIC_IAMGE_PROC_HPP
 #include <opencv2/core/core.hpp>
+#include "basic_types.hpp"
 
 namespace bias
 {
     cv::Mat bwAreaOpen(cv::Mat img, unsigned int areaThreshold);
     cv::Mat imCloseWithDiskElem(cv::Mat img, unsigned int radius);
     cv::Mat findMaxConnectedComponent(cv::Mat img);
+    cv::Mat demosaicBayer(cv::Mat img, BayerPattern pattern);
 }
 
 #endif // #ifndef BASIC_IMAGE_PROC_HPP
@@ -0,0 +1,161 @@
+#include "frame_result_ring.hpp"
+#include <QVariantMap>
+#include <algorithm>
+
+namespace bias
+{
+
+    const unsigned int FrameResultRing::DEFAULT_CAPACITY = 4096;
+
+
+    FrameResultRing::FrameResultRing(unsigned int capacity)
+    {
+        capacity_ = std::max(capacity, 2u);
+        writeCount_ = 0;
+        generation_ = 0;
+        setFieldNames(QStringList());
+    }
+
+
+    void FrameResultRing::setFieldNames(QStringList fieldNames)
+    {
+        fieldNames_ = fieldNames;
+        frameCountBuf_.assign(capacity_, 0);
+        timeStampBuf_.assign(capacity_, 0.0);
+        valueBuf_.assign(capacity_*fieldNames_.size(), 0.0);
+        clear();
+    }
+
+
+    void FrameResultRing::clear()
+    {
+        writeCount_.store(0);
+        generation_++;
+    }
+
+
+    void FrameResultRing::append(
+            unsigned long long frameCount, 
+            double timeStamp, 
+            const std::vector<double> &valueVec
+            )
+    {
+        unsigned long long count = writeCount_.load(std::memory_order_relaxed);
+        unsigned int index = getIndex(count);
+        size_t numFields = size_t(fieldNames_.size());
+        frameCountBuf_[index] = frameCount;
+        timeStampBuf_[index] = timeStamp;
+        for (size_t i=0; i<numFields; i++)
+        {
+            valueBuf_[index*numFields + i] = (i < valueVec.size()) ? valueVec[i] : 0.0;
+        }
+        writeCount_.store(count+1, std::memory_order_release);
+    }
+
+
+    unsigned int FrameResultRing::capacity() const
+    {
+        return capacity_;
+    }
+
+
+    QStringList FrameResultRing::fieldNames() const
+    {
+        return fieldNames_;
+    }
+
+
+    unsigned long long FrameResultRing::numberWritten() const
+    {
+        return writeCount_.load(std::memory_order_acquire);
+    }
+
+
+    unsigned int FrameResultRing::generation() const
+    {
+        return generation_.load();
+    }
+
+
+    unsigned long long FrameResultRing::getSince(
+            unsigned long long since, 
+            unsigned int maxResults,
+            QVariantList &resultList,
+            unsigned long long &numDropped
+            ) const
+    {
+        resultList.clear();
+        numDropped = 0;
+
+        // The slot for endCount may be being written, it holds endCount - capacity_
+        unsigned long long endCount = writeCount_.load(std::memory_order_acquire);
+        unsigned long long oldestCount = (endCount >= capacity_) ? (endCount - capacity_ + 1) : 0;
+        if (since > endCount)
+        {
+            since = oldestCount;
+        }
+        if (since < oldestCount)
+        {
+            numDropped = oldestCount - since;
+            since = oldestCount;
+        }
+        endCount = std::min(endCount, since + (unsigned long long)(maxResults));
+
+        // Copy out 
+        size_t numFields = size_t(fieldNames_.size());
+        std::vector<unsigned long long> frameCountCopy;
+        std::vector<double> timeStampCopy;
+        std::vector<double> valueCopy;
+        frameCountCopy.reserve(endCount - since);
+        timeStampCopy.reserve(endCount - since);
+        valueCopy.reserve((endCount - since)*numFields);
+        for (unsigned long long count=since; count<endCount; count++)
+        {
+            unsigned int index = getIndex(count);
+            frameCountCopy.push_back(frameCountBuf_[index]);
+            timeStampCopy.push_back(timeStampBuf_[index]);
+            for (size_t i=0; i<numFields; i++)
+            {
+                valueCopy.push_back(valueBuf_[index*numFields + i]);
+            }
+        }
+
+        // Drop any results the writer may have overwritten during the copy. The 
+        // fence keeps the buffer reads above from moving past the count reload.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        unsigned long long newCount = writeCount_.load(std::memory_order_relaxed);
+        size_t numInvalid = 0;
+        if (newCount >= capacity_)
+        {
+            unsigned long long validCount = newCount - capacity_ + 1;
+            if (validCount > since)
+            {
+                numInvalid = size_t(std::min(validCount - since, (unsigned long long)(frameCountCopy.size())));
+            }
+        }
+        numDropped += numInvalid;
+
+        for (size_t n=numInvalid; n<frameCountCopy.size(); n++)
+        {
+            QVariantMap dataMap;
+            for (size_t i=0; i<numFields; i++)
+            {
+                dataMap.insert(fieldNames_[int(i)], valueCopy[n*numFields + i]);
+            }
+            QVariantMap resultMap;
+            resultMap.insert("seq", qulonglong(since + n));
+            resultMap.insert("frameCount", qulonglong(frameCountCopy[n]));
+            resultMap.insert("timeStamp", timeStampCopy[n]);
+            resultMap.insert("data", dataMap);
+            resultList.append(resultMap);
+        }
+        return endCount;
+    }
+
+
+    unsigned int FrameResultRing::getIndex(unsigned long long count) const
+    {
+        return (unsigned int)(count % capacity_);
+    }
+
+} // namespace bias
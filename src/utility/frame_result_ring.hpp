@@ -0,0 +1,72 @@
+#ifndef BIAS_FRAME_RESULT_RING_HPP
+#define BIAS_FRAME_RESULT_RING_HPP
+
+#include <QStringList>
+#include <QVariantList>
+#include <atomic>
+#include <vector>
+
+namespace bias
+{
+
+    // Fixed capacity ring of per-frame results - frame count, time stamp
+    // and a value for each of a fixed set of named fields.
+    //
+    // As for TimeSeriesRing one thread appends (a plugin's processFrames) 
+    // while others copy out results without sharing a lock. Each result 
+    // has a sequence number so readers can ask for everything since the 
+    // last result they saw. Results overwritten before a reader copies 
+    // them are counted as dropped.
+    class FrameResultRing
+    {
+
+        public:
+
+            static const unsigned int DEFAULT_CAPACITY;
+
+            FrameResultRing(unsigned int capacity=DEFAULT_CAPACITY);
+
+            // Not thread safe - only call when there is no writer
+            void setFieldNames(QStringList fieldNames);
+            void clear();
+
+            // Writer - values in field name order
+            void append(unsigned long long frameCount, double timeStamp, const std::vector<double> &valueVec);
+
+            // Reader
+            unsigned int capacity() const;
+            QStringList fieldNames() const;
+            unsigned long long numberWritten() const;
+
+            // Incremented by setFieldNames and clear - sequence numbers from
+            // an earlier generation no longer refer to the same results.
+            unsigned int generation() const;
+
+            // Copies up to maxResults results starting at sequence number 
+            // since, each as a map {seq, frameCount, timeStamp, data}. If
+            // since is ahead of the ring (e.g. the writer restarted) copying
+            // starts from the oldest result. Returns the sequence number to 
+            // ask for next.
+            unsigned long long getSince(
+                    unsigned long long since, 
+                    unsigned int maxResults,
+                    QVariantList &resultList,
+                    unsigned long long &numDropped
+                    ) const;
+
+        private:
+
+            unsigned int capacity_;
+            QStringList fieldNames_;
+            std::vector<unsigned long long> frameCountBuf_;
+            std::vector<double> timeStampBuf_;
+            std::vector<double> valueBuf_;
+            std::atomic<unsigned long long> writeCount_;
+            std::atomic<unsigned int> generation_;
+
+            unsigned int getIndex(unsigned long long count) const;
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_FRAME_RESULT_RING_HPP
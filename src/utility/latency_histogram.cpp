@@ -0,0 +1,146 @@
+#include "latency_histogram.hpp"
+#include <QVariantList>
+#include <algorithm>
+#include <cmath>
+
+namespace bias
+{
+    // Constants
+    // ----------------------------------------------------------------------------------
+    const double LatencyHistogram::MIN_LATENCY = 1.0e-5;
+    const double LatencyHistogram::MAX_LATENCY = 10.0;
+    const unsigned int LatencyHistogram::BINS_PER_DECADE = 5;
+
+
+    // Public methods
+    // ----------------------------------------------------------------------------------
+    LatencyHistogram::LatencyHistogram()
+    {
+        clear();
+    }
+
+
+    void LatencyHistogram::clear()
+    {
+        // Bin 0 is underflow and the last bin is overflow 
+        unsigned int numDecades = (unsigned int)(std::round(std::log10(MAX_LATENCY/MIN_LATENCY)));
+        binCountVec_.assign(numDecades*BINS_PER_DECADE + 2, 0);
+        count_ = 0;
+        min_ = 0.0;
+        max_ = 0.0;
+        sum_ = 0.0;
+    }
+
+
+    void LatencyHistogram::add(double latency)
+    {
+        unsigned int numBins = (unsigned int)(binCountVec_.size());
+        unsigned int bin = 0;
+        if (latency >= MIN_LATENCY)
+        {
+            double pos = BINS_PER_DECADE*std::log10(latency/MIN_LATENCY);
+            bin = std::min((unsigned int)(pos) + 1, numBins - 1);
+        }
+        binCountVec_[bin]++;
+
+        if (count_ == 0)
+        {
+            min_ = latency;
+            max_ = latency;
+        }
+        else
+        {
+            min_ = std::min(min_, latency);
+            max_ = std::max(max_, latency);
+        }
+        sum_ += latency;
+        count_++;
+    }
+
+
+    unsigned long LatencyHistogram::count() const
+    {
+        return count_;
+    }
+
+
+    double LatencyHistogram::min() const
+    {
+        return min_;
+    }
+
+
+    double LatencyHistogram::max() const
+    {
+        return max_;
+    }
+
+
+    double LatencyHistogram::mean() const
+    {
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+        return sum_/count_;
+    }
+
+
+    double LatencyHistogram::percentile(double fraction) const
+    {
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+        unsigned long target = (unsigned long)(std::ceil(fraction*count_));
+        target = std::max(target, 1ul);
+        unsigned long cumCount = 0;
+        for (unsigned int bin=0; bin<binCountVec_.size(); bin++)
+        {
+            cumCount += binCountVec_[bin];
+            if (cumCount >= target)
+            {
+                return std::min(binUpperEdge(bin), max_);
+            }
+        }
+        return max_;
+    }
+
+
+    QVariantMap LatencyHistogram::toMap() const
+    {
+        QVariantMap map;
+        map.insert("count", qulonglong(count_));
+        map.insert("min", min_);
+        map.insert("max", max_);
+        map.insert("mean", mean());
+        map.insert("p50", percentile(0.5));
+        map.insert("p99", percentile(0.99));
+
+        // Bins as (upper edge, count) - the overflow bin has edge -1
+        QVariantList edgeList;
+        QVariantList countList;
+        for (unsigned int bin=0; bin<binCountVec_.size(); bin++)
+        {
+            bool isOverflow = (bin == binCountVec_.size() - 1);
+            edgeList.append(isOverflow ? -1.0 : binUpperEdge(bin));
+            countList.append(qulonglong(binCountVec_[bin]));
+        }
+        map.insert("binUpperEdges", edgeList);
+        map.insert("binCounts", countList);
+        return map;
+    }
+
+
+    // Private methods
+    // ----------------------------------------------------------------------------------
+    double LatencyHistogram::binUpperEdge(unsigned int bin) const
+    {
+        if (bin >= binCountVec_.size() - 1)
+        {
+            return max_;
+        }
+        return MIN_LATENCY*std::pow(10.0, double(bin)/BINS_PER_DECADE);
+    }
+
+} // namespace bias
@@ -0,0 +1,51 @@
+#ifndef BIAS_LATENCY_HISTOGRAM_HPP
+#define BIAS_LATENCY_HISTOGRAM_HPP
+
+#include <QVariantMap>
+#include <vector>
+
+namespace bias
+{
+
+    // Histogram of latencies (seconds) in log spaced bins from MIN_LATENCY 
+    // to MAX_LATENCY, with under/overflow bins and running min, max, mean.
+    // Not thread safe.
+    class LatencyHistogram
+    {
+
+        public:
+
+            static const double MIN_LATENCY;
+            static const double MAX_LATENCY;
+            static const unsigned int BINS_PER_DECADE;
+
+            LatencyHistogram();
+
+            void clear();
+            void add(double latency);
+
+            unsigned long count() const;
+            double min() const;
+            double max() const;
+            double mean() const;
+
+            // Upper edge of the bin containing the given fraction (0-1) of the
+            // samples - resolution is limited to the bin width.
+            double percentile(double fraction) const;
+
+            QVariantMap toMap() const;
+
+        private:
+
+            std::vector<unsigned long> binCountVec_;
+            unsigned long count_;
+            double min_;
+            double max_;
+            double sum_;
+
+            double binUpperEdge(unsigned int bin) const;
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_LATENCY_HISTOGRAM_HPP
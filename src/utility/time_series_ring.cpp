@@ -0,0 +1,185 @@
+#include "time_series_ring.hpp"
+#include <algorithm>
+
+namespace bias
+{
+
+    const unsigned int TimeSeriesRing::DEFAULT_CAPACITY = 16384;
+
+
+    TimeSeriesRing::TimeSeriesRing(unsigned int capacity)
+    {
+        writeCount_ = 0;
+        setCapacity(capacity);
+    }
+
+
+    void TimeSeriesRing::setCapacity(unsigned int capacity)
+    {
+        capacity_ = std::max(capacity, 2u);
+        timeBuf_.assign(capacity_, 0.0);
+        valueBuf_.assign(capacity_, 0.0);
+        writeCount_.store(0);
+    }
+
+
+    void TimeSeriesRing::clear()
+    {
+        writeCount_.store(0);
+    }
+
+
+    void TimeSeriesRing::append(double time, double value)
+    {
+        unsigned long long count = writeCount_.load(std::memory_order_relaxed);
+        unsigned int index = getIndex(count);
+        timeBuf_[index] = time;
+        valueBuf_[index] = value;
+        writeCount_.store(count+1, std::memory_order_release);
+    }
+
+
+    unsigned int TimeSeriesRing::capacity() const
+    {
+        return capacity_;
+    }
+
+
+    unsigned long long TimeSeriesRing::numberWritten() const
+    {
+        return writeCount_.load(std::memory_order_acquire);
+    }
+
+
+    bool TimeSeriesRing::getLast(double &time, double &value) const
+    {
+        unsigned long long count = writeCount_.load(std::memory_order_acquire);
+        if (count == 0)
+        {
+            return false;
+        }
+        unsigned int index = getIndex(count-1);
+        time = timeBuf_[index];
+        value = valueBuf_[index];
+        return true;
+    }
+
+
+    void TimeSeriesRing::getWindow(
+            double windowLength, 
+            unsigned int maxPoints,
+            QVector<double> &timeVec, 
+            QVector<double> &valueVec
+            ) const
+    {
+        timeVec.clear();
+        valueVec.clear();
+
+        unsigned long long endCount = writeCount_.load(std::memory_order_acquire);
+        if (endCount == 0)
+        {
+            return;
+        }
+
+        // Walk back from the latest sample to the start of the window. The slot 
+        // for endCount may be being written, it holds endCount - capacity_.
+        unsigned long long oldestCount = (endCount >= capacity_) ? (endCount - capacity_ + 1) : 0;
+        double lastTime = timeBuf_[getIndex(endCount-1)];
+        unsigned long long begCount = endCount-1;
+        double prevTime = lastTime;
+        while (begCount > oldestCount)
+        {
+            double time = timeBuf_[getIndex(begCount-1)];
+            if ((time > prevTime) || (lastTime - time > windowLength))
+            {
+                break;
+            }
+            prevTime = time;
+            begCount--;
+        }
+
+        // The writer may have lapped the walk - only keep what is still valid
+        std::atomic_thread_fence(std::memory_order_acquire);
+        unsigned long long walkCount = writeCount_.load(std::memory_order_relaxed);
+        if (walkCount >= capacity_)
+        {
+            begCount = std::max(begCount, std::min(walkCount - capacity_ + 1, endCount));
+        }
+
+        // Copy out the window  
+        std::vector<double> timeCopy;
+        std::vector<double> valueCopy;
+        timeCopy.reserve(endCount - begCount);
+        valueCopy.reserve(endCount - begCount);
+        for (unsigned long long count=begCount; count<endCount; count++)
+        {
+            unsigned int index = getIndex(count);
+            timeCopy.push_back(timeBuf_[index]);
+            valueCopy.push_back(valueBuf_[index]);
+        }
+
+        // Drop any samples the writer may have overwritten during the copy 
+        std::atomic_thread_fence(std::memory_order_acquire);
+        unsigned long long newCount = writeCount_.load(std::memory_order_relaxed);
+        size_t numInvalid = 0;
+        if (newCount >= capacity_) 
+        {
+            unsigned long long validCount = newCount - capacity_ + 1;
+            if (validCount > begCount)
+            {
+                numInvalid = size_t(std::min(validCount - begCount, (unsigned long long)(timeCopy.size())));
+            }
+        }
+
+        size_t numSamples = timeCopy.size() - numInvalid;
+        unsigned int numBuckets = std::max(maxPoints/2, 1u);
+
+        if ((maxPoints == 0) || (numSamples <= maxPoints))
+        {
+            timeVec.reserve(int(numSamples));
+            valueVec.reserve(int(numSamples));
+            for (size_t i=numInvalid; i<timeCopy.size(); i++)
+            {
+                timeVec.append(timeCopy[i]);
+                valueVec.append(valueCopy[i]);
+            }
+            return;
+        }
+
+        // Decimate - min and max of each bucket in time order
+        timeVec.reserve(2*numBuckets);
+        valueVec.reserve(2*numBuckets);
+        for (unsigned int n=0; n<numBuckets; n++)
+        {
+            size_t i0 = numInvalid + (numSamples*n)/numBuckets;
+            size_t i1 = numInvalid + (numSamples*(n+1))/numBuckets;
+            if (i1 <= i0)
+            {
+                continue;
+            }
+            size_t iMin = i0;
+            size_t iMax = i0;
+            for (size_t i=i0; i<i1; i++)
+            {
+                if (valueCopy[i] < valueCopy[iMin]) { iMin = i; }
+                if (valueCopy[i] > valueCopy[iMax]) { iMax = i; }
+            }
+            size_t iFirst = std::min(iMin, iMax);
+            size_t iSecond = std::max(iMin, iMax);
+            timeVec.append(timeCopy[iFirst]);
+            valueVec.append(valueCopy[iFirst]);
+            if (iSecond != iFirst)
+            {
+                timeVec.append(timeCopy[iSecond]);
+                valueVec.append(valueCopy[iSecond]);
+            }
+        }
+    }
+
+
+    unsigned int TimeSeriesRing::getIndex(unsigned long long count) const
+    {
+        return (unsigned int)(count % capacity_);
+    }
+
+} // namespace bias
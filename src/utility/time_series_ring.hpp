@@ -0,0 +1,62 @@
+#ifndef BIAS_TIME_SERIES_RING_HPP
+#define BIAS_TIME_SERIES_RING_HPP
+
+#include <QVector>
+#include <atomic>
+#include <vector>
+
+namespace bias
+{
+
+    // Fixed capacity ring of (time, value) samples for live plots. 
+    //
+    // One thread appends (e.g. a plugin's processFrames) while another reads
+    // a window of the latest samples (e.g. a display timer) without sharing
+    // a lock. Samples the writer overwrites while the reader is copying 
+    // them are discarded by the reader.
+    class TimeSeriesRing
+    {
+
+        public:
+
+            static const unsigned int DEFAULT_CAPACITY;
+
+            TimeSeriesRing(unsigned int capacity=DEFAULT_CAPACITY);
+
+            // Not thread safe - only call when there is no writer
+            void setCapacity(unsigned int capacity);
+            void clear();
+
+            // Writer
+            void append(double time, double value);
+
+            // Reader
+            unsigned int capacity() const;
+            unsigned long long numberWritten() const;
+            bool getLast(double &time, double &value) const;
+
+            // Copies the samples within windowLength of the latest sample. 
+            // Samples before a backwards jump in time (e.g. capture restart) 
+            // are left out. When there are more than maxPoints samples they
+            // are decimated to the min and max of equal sized buckets so that
+            // peaks are still visible.
+            void getWindow(
+                    double windowLength, 
+                    unsigned int maxPoints,
+                    QVector<double> &timeVec, 
+                    QVector<double> &valueVec
+                    ) const;
+
+        private:
+
+            unsigned int capacity_;
+            std::vector<double> timeBuf_;
+            std::vector<double> valueBuf_;
+            std::atomic<unsigned long long> writeCount_;
+
+            unsigned int getIndex(unsigned long long count) const;
+    };
+
+} // namespace bias
+
+#endif // #ifndef BIAS_TIME_SERIES_RING_HPP